@@ -32376,7 +32376,7 @@ int _wrap_SpatialInertiaRaw_getRotationalInertiaWrtFrameOrigin(int resc, mxArray
   void *argp1 = 0 ;
   int res1 = 0 ;
   mxArray * _out;
-  iDynTree::RotationalInertiaRaw *result = 0 ;
+  iDynTree::RotationalInertiaRaw result;
   
   if (!SWIG_check_num_args("SpatialInertiaRaw_getRotationalInertiaWrtFrameOrigin",argc,1,1,0)) {
     SWIG_fail;
@@ -32386,8 +32386,8 @@ int _wrap_SpatialInertiaRaw_getRotationalInertiaWrtFrameOrigin(int resc, mxArray
     SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "SpatialInertiaRaw_getRotationalInertiaWrtFrameOrigin" "', argument " "1"" of type '" "iDynTree::SpatialInertiaRaw const *""'"); 
   }
   arg1 = reinterpret_cast< iDynTree::SpatialInertiaRaw * >(argp1);
-  result = (iDynTree::RotationalInertiaRaw *) &((iDynTree::SpatialInertiaRaw const *)arg1)->getRotationalInertiaWrtFrameOrigin();
-  _out = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_iDynTree__RotationalInertiaRaw, 0 |  0 );
+  result = ((iDynTree::SpatialInertiaRaw const *)arg1)->getRotationalInertiaWrtFrameOrigin();
+  _out = SWIG_NewPointerObj((new iDynTree::RotationalInertiaRaw(static_cast< const iDynTree::RotationalInertiaRaw& >(result))), SWIGTYPE_p_iDynTree__RotationalInertiaRaw, SWIG_POINTER_OWN |  0 );
   if (_out) --resc, *resv++ = _out;
   return 0;
 fail:
@@ -33501,84 +33501,12 @@ int _wrap_new_ArticulatedBodyInertia(int resc, mxArray *resv[], int argc, mxArra
 }
 
 
-int _wrap_ArticulatedBodyInertia_getLinearLinearSubmatrix__SWIG_0(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
-  iDynTree::ArticulatedBodyInertia *arg1 = (iDynTree::ArticulatedBodyInertia *) 0 ;
-  void *argp1 = 0 ;
-  int res1 = 0 ;
-  mxArray * _out;
-  iDynTree::Matrix3x3 *result = 0 ;
-  
-  if (!SWIG_check_num_args("ArticulatedBodyInertia_getLinearLinearSubmatrix",argc,1,1,0)) {
-    SWIG_fail;
-  }
-  res1 = SWIG_ConvertPtr(argv[0], &argp1,SWIGTYPE_p_iDynTree__ArticulatedBodyInertia, 0 |  0 );
-  if (!SWIG_IsOK(res1)) {
-    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "ArticulatedBodyInertia_getLinearLinearSubmatrix" "', argument " "1"" of type '" "iDynTree::ArticulatedBodyInertia *""'"); 
-  }
-  arg1 = reinterpret_cast< iDynTree::ArticulatedBodyInertia * >(argp1);
-  result = (iDynTree::Matrix3x3 *) &(arg1)->getLinearLinearSubmatrix();
-  _out = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_iDynTree__MatrixFixSizeT_3_3_t, 0 |  0 );
-  if (_out) --resc, *resv++ = _out;
-  return 0;
-fail:
-  return 1;
-}
-
-
-int _wrap_ArticulatedBodyInertia_getLinearAngularSubmatrix__SWIG_0(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
-  iDynTree::ArticulatedBodyInertia *arg1 = (iDynTree::ArticulatedBodyInertia *) 0 ;
-  void *argp1 = 0 ;
-  int res1 = 0 ;
-  mxArray * _out;
-  iDynTree::Matrix3x3 *result = 0 ;
-  
-  if (!SWIG_check_num_args("ArticulatedBodyInertia_getLinearAngularSubmatrix",argc,1,1,0)) {
-    SWIG_fail;
-  }
-  res1 = SWIG_ConvertPtr(argv[0], &argp1,SWIGTYPE_p_iDynTree__ArticulatedBodyInertia, 0 |  0 );
-  if (!SWIG_IsOK(res1)) {
-    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "ArticulatedBodyInertia_getLinearAngularSubmatrix" "', argument " "1"" of type '" "iDynTree::ArticulatedBodyInertia *""'"); 
-  }
-  arg1 = reinterpret_cast< iDynTree::ArticulatedBodyInertia * >(argp1);
-  result = (iDynTree::Matrix3x3 *) &(arg1)->getLinearAngularSubmatrix();
-  _out = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_iDynTree__MatrixFixSizeT_3_3_t, 0 |  0 );
-  if (_out) --resc, *resv++ = _out;
-  return 0;
-fail:
-  return 1;
-}
-
-
-int _wrap_ArticulatedBodyInertia_getAngularAngularSubmatrix__SWIG_0(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
-  iDynTree::ArticulatedBodyInertia *arg1 = (iDynTree::ArticulatedBodyInertia *) 0 ;
-  void *argp1 = 0 ;
-  int res1 = 0 ;
-  mxArray * _out;
-  iDynTree::Matrix3x3 *result = 0 ;
-  
-  if (!SWIG_check_num_args("ArticulatedBodyInertia_getAngularAngularSubmatrix",argc,1,1,0)) {
-    SWIG_fail;
-  }
-  res1 = SWIG_ConvertPtr(argv[0], &argp1,SWIGTYPE_p_iDynTree__ArticulatedBodyInertia, 0 |  0 );
-  if (!SWIG_IsOK(res1)) {
-    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "ArticulatedBodyInertia_getAngularAngularSubmatrix" "', argument " "1"" of type '" "iDynTree::ArticulatedBodyInertia *""'"); 
-  }
-  arg1 = reinterpret_cast< iDynTree::ArticulatedBodyInertia * >(argp1);
-  result = (iDynTree::Matrix3x3 *) &(arg1)->getAngularAngularSubmatrix();
-  _out = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_iDynTree__MatrixFixSizeT_3_3_t, 0 |  0 );
-  if (_out) --resc, *resv++ = _out;
-  return 0;
-fail:
-  return 1;
-}
-
-
-int _wrap_ArticulatedBodyInertia_getLinearLinearSubmatrix__SWIG_1(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
+int _wrap_ArticulatedBodyInertia_getLinearLinearSubmatrix(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
   iDynTree::ArticulatedBodyInertia *arg1 = (iDynTree::ArticulatedBodyInertia *) 0 ;
   void *argp1 = 0 ;
   int res1 = 0 ;
   mxArray * _out;
-  iDynTree::Matrix3x3 *result = 0 ;
+  iDynTree::Matrix3x3 result;
   
   if (!SWIG_check_num_args("ArticulatedBodyInertia_getLinearLinearSubmatrix",argc,1,1,0)) {
     SWIG_fail;
@@ -33588,8 +33516,8 @@ int _wrap_ArticulatedBodyInertia_getLinearLinearSubmatrix__SWIG_1(int resc, mxAr
     SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "ArticulatedBodyInertia_getLinearLinearSubmatrix" "', argument " "1"" of type '" "iDynTree::ArticulatedBodyInertia const *""'"); 
   }
   arg1 = reinterpret_cast< iDynTree::ArticulatedBodyInertia * >(argp1);
-  result = (iDynTree::Matrix3x3 *) &((iDynTree::ArticulatedBodyInertia const *)arg1)->getLinearLinearSubmatrix();
-  _out = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_iDynTree__MatrixFixSizeT_3_3_t, 0 |  0 );
+  result = ((iDynTree::ArticulatedBodyInertia const *)arg1)->getLinearLinearSubmatrix();
+  _out = SWIG_NewPointerObj((new iDynTree::Matrix3x3(static_cast< const iDynTree::Matrix3x3& >(result))), SWIGTYPE_p_iDynTree__MatrixFixSizeT_3_3_t, SWIG_POINTER_OWN |  0 );
   if (_out) --resc, *resv++ = _out;
   return 0;
 fail:
@@ -33597,40 +33525,12 @@ fail:
 }
 
 
-int _wrap_ArticulatedBodyInertia_getLinearLinearSubmatrix(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
-  if (argc == 1) {
-    int _v;
-    void *vptr = 0;
-    int res = SWIG_ConvertPtr(argv[0], &vptr, SWIGTYPE_p_iDynTree__ArticulatedBodyInertia, 0);
-    _v = SWIG_CheckState(res);
-    if (_v) {
-      return _wrap_ArticulatedBodyInertia_getLinearLinearSubmatrix__SWIG_0(resc,resv,argc,argv);
-    }
-  }
-  if (argc == 1) {
-    int _v;
-    void *vptr = 0;
-    int res = SWIG_ConvertPtr(argv[0], &vptr, SWIGTYPE_p_iDynTree__ArticulatedBodyInertia, 0);
-    _v = SWIG_CheckState(res);
-    if (_v) {
-      return _wrap_ArticulatedBodyInertia_getLinearLinearSubmatrix__SWIG_1(resc,resv,argc,argv);
-    }
-  }
-  
-  SWIG_Error(SWIG_RuntimeError, "No matching function for overload function 'ArticulatedBodyInertia_getLinearLinearSubmatrix'."
-    "  Possible C/C++ prototypes are:\n"
-    "    iDynTree::ArticulatedBodyInertia::getLinearLinearSubmatrix()\n"
-    "    iDynTree::ArticulatedBodyInertia::getLinearLinearSubmatrix() const\n");
-  return 1;
-}
-
-
-int _wrap_ArticulatedBodyInertia_getLinearAngularSubmatrix__SWIG_1(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
+int _wrap_ArticulatedBodyInertia_getLinearAngularSubmatrix(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
   iDynTree::ArticulatedBodyInertia *arg1 = (iDynTree::ArticulatedBodyInertia *) 0 ;
   void *argp1 = 0 ;
   int res1 = 0 ;
   mxArray * _out;
-  iDynTree::Matrix3x3 *result = 0 ;
+  iDynTree::Matrix3x3 result;
   
   if (!SWIG_check_num_args("ArticulatedBodyInertia_getLinearAngularSubmatrix",argc,1,1,0)) {
     SWIG_fail;
@@ -33640,8 +33540,8 @@ int _wrap_ArticulatedBodyInertia_getLinearAngularSubmatrix__SWIG_1(int resc, mxA
     SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "ArticulatedBodyInertia_getLinearAngularSubmatrix" "', argument " "1"" of type '" "iDynTree::ArticulatedBodyInertia const *""'"); 
   }
   arg1 = reinterpret_cast< iDynTree::ArticulatedBodyInertia * >(argp1);
-  result = (iDynTree::Matrix3x3 *) &((iDynTree::ArticulatedBodyInertia const *)arg1)->getLinearAngularSubmatrix();
-  _out = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_iDynTree__MatrixFixSizeT_3_3_t, 0 |  0 );
+  result = ((iDynTree::ArticulatedBodyInertia const *)arg1)->getLinearAngularSubmatrix();
+  _out = SWIG_NewPointerObj((new iDynTree::Matrix3x3(static_cast< const iDynTree::Matrix3x3& >(result))), SWIGTYPE_p_iDynTree__MatrixFixSizeT_3_3_t, SWIG_POINTER_OWN |  0 );
   if (_out) --resc, *resv++ = _out;
   return 0;
 fail:
@@ -33649,40 +33549,12 @@ fail:
 }
 
 
-int _wrap_ArticulatedBodyInertia_getLinearAngularSubmatrix(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
-  if (argc == 1) {
-    int _v;
-    void *vptr = 0;
-    int res = SWIG_ConvertPtr(argv[0], &vptr, SWIGTYPE_p_iDynTree__ArticulatedBodyInertia, 0);
-    _v = SWIG_CheckState(res);
-    if (_v) {
-      return _wrap_ArticulatedBodyInertia_getLinearAngularSubmatrix__SWIG_0(resc,resv,argc,argv);
-    }
-  }
-  if (argc == 1) {
-    int _v;
-    void *vptr = 0;
-    int res = SWIG_ConvertPtr(argv[0], &vptr, SWIGTYPE_p_iDynTree__ArticulatedBodyInertia, 0);
-    _v = SWIG_CheckState(res);
-    if (_v) {
-      return _wrap_ArticulatedBodyInertia_getLinearAngularSubmatrix__SWIG_1(resc,resv,argc,argv);
-    }
-  }
-  
-  SWIG_Error(SWIG_RuntimeError, "No matching function for overload function 'ArticulatedBodyInertia_getLinearAngularSubmatrix'."
-    "  Possible C/C++ prototypes are:\n"
-    "    iDynTree::ArticulatedBodyInertia::getLinearAngularSubmatrix()\n"
-    "    iDynTree::ArticulatedBodyInertia::getLinearAngularSubmatrix() const\n");
-  return 1;
-}
-
-
-int _wrap_ArticulatedBodyInertia_getAngularAngularSubmatrix__SWIG_1(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
+int _wrap_ArticulatedBodyInertia_getAngularAngularSubmatrix(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
   iDynTree::ArticulatedBodyInertia *arg1 = (iDynTree::ArticulatedBodyInertia *) 0 ;
   void *argp1 = 0 ;
   int res1 = 0 ;
   mxArray * _out;
-  iDynTree::Matrix3x3 *result = 0 ;
+  iDynTree::Matrix3x3 result;
   
   if (!SWIG_check_num_args("ArticulatedBodyInertia_getAngularAngularSubmatrix",argc,1,1,0)) {
     SWIG_fail;
@@ -33692,8 +33564,8 @@ int _wrap_ArticulatedBodyInertia_getAngularAngularSubmatrix__SWIG_1(int resc, mx
     SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "ArticulatedBodyInertia_getAngularAngularSubmatrix" "', argument " "1"" of type '" "iDynTree::ArticulatedBodyInertia const *""'"); 
   }
   arg1 = reinterpret_cast< iDynTree::ArticulatedBodyInertia * >(argp1);
-  result = (iDynTree::Matrix3x3 *) &((iDynTree::ArticulatedBodyInertia const *)arg1)->getAngularAngularSubmatrix();
-  _out = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_iDynTree__MatrixFixSizeT_3_3_t, 0 |  0 );
+  result = ((iDynTree::ArticulatedBodyInertia const *)arg1)->getAngularAngularSubmatrix();
+  _out = SWIG_NewPointerObj((new iDynTree::Matrix3x3(static_cast< const iDynTree::Matrix3x3& >(result))), SWIGTYPE_p_iDynTree__MatrixFixSizeT_3_3_t, SWIG_POINTER_OWN |  0 );
   if (_out) --resc, *resv++ = _out;
   return 0;
 fail:
@@ -33701,34 +33573,6 @@ fail:
 }
 
 
-int _wrap_ArticulatedBodyInertia_getAngularAngularSubmatrix(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
-  if (argc == 1) {
-    int _v;
-    void *vptr = 0;
-    int res = SWIG_ConvertPtr(argv[0], &vptr, SWIGTYPE_p_iDynTree__ArticulatedBodyInertia, 0);
-    _v = SWIG_CheckState(res);
-    if (_v) {
-      return _wrap_ArticulatedBodyInertia_getAngularAngularSubmatrix__SWIG_0(resc,resv,argc,argv);
-    }
-  }
-  if (argc == 1) {
-    int _v;
-    void *vptr = 0;
-    int res = SWIG_ConvertPtr(argv[0], &vptr, SWIGTYPE_p_iDynTree__ArticulatedBodyInertia, 0);
-    _v = SWIG_CheckState(res);
-    if (_v) {
-      return _wrap_ArticulatedBodyInertia_getAngularAngularSubmatrix__SWIG_1(resc,resv,argc,argv);
-    }
-  }
-  
-  SWIG_Error(SWIG_RuntimeError, "No matching function for overload function 'ArticulatedBodyInertia_getAngularAngularSubmatrix'."
-    "  Possible C/C++ prototypes are:\n"
-    "    iDynTree::ArticulatedBodyInertia::getAngularAngularSubmatrix()\n"
-    "    iDynTree::ArticulatedBodyInertia::getAngularAngularSubmatrix() const\n");
-  return 1;
-}
-
-
 int _wrap_ArticulatedBodyInertia_combine(int resc, mxArray *resv[], int argc, mxArray *argv[]) {
   iDynTree::ArticulatedBodyInertia *arg1 = 0 ;
   iDynTree::ArticulatedBodyInertia *arg2 = 0 ;
@@ -43770,7 +43614,7 @@ int _wrap_IJoint_getTransform(int resc, mxArray *resv[], int argc, mxArray *argv
   int val4 ;
   int ecode4 = 0 ;
   mxArray * _out;
-  iDynTree::Transform *result = 0 ;
+  iDynTree::Transform result;
   
   if (!SWIG_check_num_args("IJoint_getTransform",argc,4,4,0)) {
     SWIG_fail;
@@ -43798,8 +43642,8 @@ int _wrap_IJoint_getTransform(int resc, mxArray *resv[], int argc, mxArray *argv
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "IJoint_getTransform" "', argument " "4"" of type '" "iDynTree::LinkIndex""'");
   } 
   arg4 = static_cast< iDynTree::LinkIndex >(val4);
-  result = (iDynTree::Transform *) &((iDynTree::IJoint const *)arg1)->getTransform((iDynTree::VectorDynSize const &)*arg2,arg3,arg4);
-  _out = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_iDynTree__Transform, 0 |  0 );
+  result = ((iDynTree::IJoint const *)arg1)->getTransform((iDynTree::VectorDynSize const &)*arg2,arg3,arg4);
+  _out = SWIG_NewPointerObj((new iDynTree::Transform(static_cast< const iDynTree::Transform& >(result))), SWIGTYPE_p_iDynTree__Transform, SWIG_POINTER_OWN |  0 );
   if (_out) --resc, *resv++ = _out;
   return 0;
 fail:
@@ -45347,7 +45191,7 @@ int _wrap_FixedJoint_getTransform(int resc, mxArray *resv[], int argc, mxArray *
   int val4 ;
   int ecode4 = 0 ;
   mxArray * _out;
-  iDynTree::Transform *result = 0 ;
+  iDynTree::Transform result;
   
   if (!SWIG_check_num_args("FixedJoint_getTransform",argc,4,4,0)) {
     SWIG_fail;
@@ -45375,8 +45219,8 @@ int _wrap_FixedJoint_getTransform(int resc, mxArray *resv[], int argc, mxArray *
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "FixedJoint_getTransform" "', argument " "4"" of type '" "iDynTree::LinkIndex""'");
   } 
   arg4 = static_cast< iDynTree::LinkIndex >(val4);
-  result = (iDynTree::Transform *) &((iDynTree::FixedJoint const *)arg1)->getTransform((iDynTree::VectorDynSize const &)*arg2,arg3,arg4);
-  _out = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_iDynTree__Transform, 0 |  0 );
+  result = ((iDynTree::FixedJoint const *)arg1)->getTransform((iDynTree::VectorDynSize const &)*arg2,arg3,arg4);
+  _out = SWIG_NewPointerObj((new iDynTree::Transform(static_cast< const iDynTree::Transform& >(result))), SWIGTYPE_p_iDynTree__Transform, SWIG_POINTER_OWN |  0 );
   if (_out) --resc, *resv++ = _out;
   return 0;
 fail:
@@ -48606,7 +48450,7 @@ int _wrap_RevoluteJoint_getTransform(int resc, mxArray *resv[], int argc, mxArra
   int val4 ;
   int ecode4 = 0 ;
   mxArray * _out;
-  iDynTree::Transform *result = 0 ;
+  iDynTree::Transform result;
   
   if (!SWIG_check_num_args("RevoluteJoint_getTransform",argc,4,4,0)) {
     SWIG_fail;
@@ -48634,8 +48478,8 @@ int _wrap_RevoluteJoint_getTransform(int resc, mxArray *resv[], int argc, mxArra
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "RevoluteJoint_getTransform" "', argument " "4"" of type '" "iDynTree::LinkIndex""'");
   } 
   arg4 = static_cast< iDynTree::LinkIndex >(val4);
-  result = (iDynTree::Transform *) &((iDynTree::RevoluteJoint const *)arg1)->getTransform((iDynTree::VectorDynSize const &)*arg2,arg3,arg4);
-  _out = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_iDynTree__Transform, 0 |  0 );
+  result = ((iDynTree::RevoluteJoint const *)arg1)->getTransform((iDynTree::VectorDynSize const &)*arg2,arg3,arg4);
+  _out = SWIG_NewPointerObj((new iDynTree::Transform(static_cast< const iDynTree::Transform& >(result))), SWIGTYPE_p_iDynTree__Transform, SWIG_POINTER_OWN |  0 );
   if (_out) --resc, *resv++ = _out;
   return 0;
 fail:
@@ -50284,7 +50128,7 @@ int _wrap_PrismaticJoint_getTransform(int resc, mxArray *resv[], int argc, mxArr
   int val4 ;
   int ecode4 = 0 ;
   mxArray * _out;
-  iDynTree::Transform *result = 0 ;
+  iDynTree::Transform result;
   
   if (!SWIG_check_num_args("PrismaticJoint_getTransform",argc,4,4,0)) {
     SWIG_fail;
@@ -50312,8 +50156,8 @@ int _wrap_PrismaticJoint_getTransform(int resc, mxArray *resv[], int argc, mxArr
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "PrismaticJoint_getTransform" "', argument " "4"" of type '" "iDynTree::LinkIndex""'");
   } 
   arg4 = static_cast< iDynTree::LinkIndex >(val4);
-  result = (iDynTree::Transform *) &((iDynTree::PrismaticJoint const *)arg1)->getTransform((iDynTree::VectorDynSize const &)*arg2,arg3,arg4);
-  _out = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_iDynTree__Transform, 0 |  0 );
+  result = ((iDynTree::PrismaticJoint const *)arg1)->getTransform((iDynTree::VectorDynSize const &)*arg2,arg3,arg4);
+  _out = SWIG_NewPointerObj((new iDynTree::Transform(static_cast< const iDynTree::Transform& >(result))), SWIGTYPE_p_iDynTree__Transform, SWIG_POINTER_OWN |  0 );
   if (_out) --resc, *resv++ = _out;
   return 0;
 fail:
@@ -47,6 +47,13 @@ endif()
 # Turn on compilation of geometrical relations semantics check.
 option(IDYNTREE_USES_SEMANTICS "Compile iDynTree semantics check" FALSE)
 
+#########################################################################
+# Select the implementation of the spatial algebra kernels used in the core library.
+# AVX2 requires a processor supporting the AVX2 and FMA instruction sets.
+set(IDYNTREE_SPATIAL_ALGEBRA_KERNELS "Scalar" CACHE STRING "Implementation of the spatial algebra kernels (Scalar or AVX2)")
+set_property(CACHE IDYNTREE_SPATIAL_ALGEBRA_KERNELS PROPERTY STRINGS "Scalar" "AVX2")
+mark_as_advanced(IDYNTREE_SPATIAL_ALGEBRA_KERNELS)
+
 #########################################################################
 # Deal with RPATH
 option(IDYNTREE_ENABLE_RPATH "Enable RPATH for the library" TRUE)
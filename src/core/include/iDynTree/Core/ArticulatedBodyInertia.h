@@ -21,6 +21,7 @@ namespace iDynTree
     class SpatialMotionVector;
     class Wrench;
     class SpatialAcc;
+    class Transform;
 
     /**
      * Class representing an Articulated Body Inertia.
@@ -29,18 +30,18 @@ namespace iDynTree
      * check Featherstone 2008, Chapter 7 .
      *
      * Storage:
-     * The symmetric articulated body inertia is stored as 3
-     * 3x3 matrices :
-     *  * the linearLinear is the top left submatrix
-     *  * the linearAngular is the top right submatrix
-     *  * the angularAngular is the bottom right submatrix
+     * The symmetric articulated body inertia is stored in a packed
+     * buffer of 21 doubles, containing its unique elements:
+     *  * the upper triangular part of the linearLinear (top left) symmetric submatrix,
+     *    stored row by row in the first 6 elements,
+     *  * the linearAngular (top right) submatrix, stored in row major order in the next 9 elements,
+     *  * the upper triangular part of the angularAngular (bottom right) symmetric submatrix,
+     *    stored row by row in the last 6 elements.
      *
      * The bottom left submatrix can be obtained as the
      * transpose of the linearAngular matrix.
      *
-     *
-     *
-     * \warning This class is exposing for convenience the IMatrix interface.
+     * \warning This class is exposing for convenience the packed buffer.
      *          Notice that using this methods you can damage the underlyng articulated body inertia.
      *          In doubt, don't use them and rely on more high level functions.
      *
@@ -48,10 +49,15 @@ namespace iDynTree
      */
     class ArticulatedBodyInertia
     {
+    public:
+        /**
+         * Number of unique elements of an articulated body inertia,
+         * i.e. the size of the packed buffer.
+         */
+        static const unsigned int PackedSize = 21;
+
     private:
-        Matrix3x3 linearLinear;
-        Matrix3x3 linearAngular;
-        Matrix3x3 angularAngular;
+        double m_packed[PackedSize];
 
     public:
         /**
@@ -82,12 +88,25 @@ namespace iDynTree
         /**
          * Low level data getters.
          */
-        Matrix3x3 & getLinearLinearSubmatrix();
-        Matrix3x3 & getLinearAngularSubmatrix();
-        Matrix3x3 & getAngularAngularSubmatrix();
-        const Matrix3x3 & getLinearLinearSubmatrix() const;
-        const Matrix3x3 & getLinearAngularSubmatrix() const;
-        const Matrix3x3 & getAngularAngularSubmatrix() const;
+        Matrix3x3 getLinearLinearSubmatrix() const;
+        Matrix3x3 getLinearAngularSubmatrix() const;
+        Matrix3x3 getAngularAngularSubmatrix() const;
+
+        /**
+         * Low level data setters.
+         *
+         * \note For the symmetric linearLinear and angularAngular
+         *       submatrices, only the upper triangular part is read.
+         */
+        void setLinearLinearSubmatrix(const Matrix3x3 & linearLinear);
+        void setLinearAngularSubmatrix(const Matrix3x3 & linearAngular);
+        void setAngularAngularSubmatrix(const Matrix3x3 & angularAngular);
+
+        /**
+         * Raw access to the packed buffer of PackedSize elements.
+         */
+        double * packedData();
+        const double * packedData() const;
 
         // Operations on SpatialInertia
         static ArticulatedBodyInertia combine(const ArticulatedBodyInertia & op1,
@@ -120,6 +139,26 @@ namespace iDynTree
         /** reset to zero (i.e. the inertia of body with zero mass) the ArticulatedBodyInertia */
         void zero();
 
+        /**
+         * Add to this articulated body inertia the articulated body inertia
+         * b_abi, expressed in frame b, once expressed in frame a.
+         *
+         * This is equivalent to (*this) += a_X_b*b_abi, i.e. it adds
+         * the congruence transform \f$ {}_a X_b^* {}^b I^A {}_b X_a \f$
+         * without building any temporary articulated body inertia.
+         * Used in the backward pass of the articulated body algorithm.
+         */
+        void addTransformed(const Transform & a_X_b, const ArticulatedBodyInertia & b_abi);
+
+        /**
+         * Subtract from this articulated body inertia the dyad \f$U d^{-1} U^\top\f$,
+         * i.e. apply the rank-1 downdate \f$ I^A - U d^{-1} U^\top \f$ in place.
+         *
+         * This is equivalent to (*this) = (*this) - ABADyadHelper(U,d), without building any temporary.
+         * Used in the backward pass of the articulated body algorithm.
+         */
+        void subtractABADyad(const SpatialForceVector & U, const double d);
+
         // Static helpers
 
         /**
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_COMPRESSED_COLUMN_JACOBIAN_H
+#define IDYNTREE_COMPRESSED_COLUMN_JACOBIAN_H
+
+#include <iDynTree/Core/VectorDynSize.h>
+#include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/SparseMatrix.h>
+
+#include <vector>
+
+namespace iDynTree
+{
+    /**
+     * \ingroup iDynTreeCore
+     *
+     * Jacobian stored only through its structurally nonzero columns.
+     *
+     * The jacobians of a kinematic tree are dense in the columns relative to the
+     * degrees of freedom in the path between the frame and the base, and zero elsewhere.
+     * This class stores only these columns (each one densely) and their indices.
+     *
+     * The storage is the Compressed Column Storage used by SparseMatrix<ColumnMajor>, in which
+     * all the rows of a nonzero column are stored, so the matrix can be mapped to an Eigen sparse
+     * matrix without copies (see toEigen in EigenSparseHelpers.h).
+     *
+     * The set of nonzero columns (i.e. the sparsity pattern) is set with setNonZeroColumns:
+     * setting again the same pattern does not perform any memory allocation.
+     */
+    class CompressedColumnJacobian
+    {
+    private:
+        unsigned m_rows;
+        unsigned m_columns;
+
+        std::vector<int> m_nonZeroColumns; /**< indices of the nonzero columns, in increasing order */
+        std::vector<int> m_outerStarts;    /**< for each column, index in m_values of its first element */
+        std::vector<int> m_innerIndices;   /**< row index of each element of m_values */
+        VectorDynSize m_values;            /**< the elements of the nonzero columns, column by column */
+
+    public:
+        /**
+         * Creates an empty jacobian.
+         */
+        CompressedColumnJacobian();
+
+        /**
+         * Creates a zero jacobian (without nonzero columns) with the specified dimensions.
+         */
+        CompressedColumnJacobian(unsigned rows, unsigned columns);
+
+        /**
+         * Resize the jacobian to the specified dimensions.
+         *
+         * \note if the dimensions changes, the nonzero columns are cleared.
+         */
+        void resize(unsigned rows, unsigned columns);
+
+        /**
+         * Set the structurally nonzero columns of the jacobian.
+         *
+         * If the pattern is different from the current one, the values of
+         * all the nonzero columns are set to zero.
+         *
+         * @param[in] nonZeroColumns indices of the nonzero columns, in strictly increasing order.
+         * @return true if all went well, false if the indices are not sorted or out of bounds.
+         */
+        bool setNonZeroColumns(const std::vector<int> & nonZeroColumns);
+
+        /**
+         * Get the indices of the nonzero columns, in increasing order.
+         */
+        const std::vector<int> & getNonZeroColumns() const;
+
+        /**
+         * Get the number of nonzero columns.
+         */
+        unsigned getNrOfNonZeroColumns() const;
+
+        /**
+         * Pointer to the rows() contiguous elements of the k-th nonzero column
+         * (i.e. of the column getNonZeroColumns()[k]).
+         */
+        double * nonZeroColumnBuffer(unsigned k);
+
+        const double * nonZeroColumnBuffer(unsigned k) const;
+
+        /**
+         * Set to zero the values of the nonzero columns, preserving the pattern.
+         */
+        void zero();
+
+        unsigned rows() const;
+
+        unsigned columns() const;
+
+        /**
+         * Number of stored elements, i.e. rows()*getNrOfNonZeroColumns().
+         */
+        unsigned numberOfNonZeros() const;
+
+        //Raw buffers access (Compressed Column Storage)
+        double * valuesBuffer();
+
+        double const * valuesBuffer() const;
+
+        int * innerIndicesBuffer();
+
+        int const * innerIndicesBuffer() const;
+
+        int * outerIndicesBuffer();
+
+        int const * outerIndicesBuffer() const;
+
+        /**
+         * Copy the jacobian in a SparseMatrix.
+         *
+         * @param[out] sparseMatrix the output matrix, resized if necessary.
+         */
+        void toSparseMatrix(SparseMatrix<iDynTree::ColumnMajor> & sparseMatrix) const;
+
+        void toSparseMatrix(SparseMatrix<iDynTree::RowMajor> & sparseMatrix) const;
+
+        /**
+         * Copy the jacobian in a dense matrix.
+         *
+         * @param[out] denseMatrix the output matrix, resized if necessary.
+         */
+        void toDense(MatrixDynSize & denseMatrix) const;
+
+        /**
+         * Returns a textual description of the nonzero elements of the jacobian.
+         */
+        std::string toString() const;
+    };
+}
+
+#endif
@@ -20,6 +20,7 @@
 #include <iDynTree/Core/SpatialForceVector.h>
 #include <iDynTree/Core/Transform.h>
 #include <iDynTree/Core/Utils.h>
+#include <iDynTree/Core/MatrixView.h>
 
 #if __cplusplus > 199711L
 #include <iDynTree/Core/SparseMatrix.h>
@@ -73,6 +74,21 @@ inline Eigen::Map<Eigen::VectorXd> toEigen(iDynTree::Span<double> vec)
 {
     return Eigen::Map<Eigen::VectorXd>(vec.data(),vec.size());
 }
+
+/**
+ * Map a MatrixView, with any storage ordering and strides, to an Eigen column major matrix map.
+ */
+inline Eigen::Map<const Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic,Eigen::Dynamic> > toEigen(MatrixView<const double> mat)
+{
+    return Eigen::Map<const Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic,Eigen::Dynamic> >
+            (mat.data(),mat.rows(),mat.cols(),Eigen::Stride<Eigen::Dynamic,Eigen::Dynamic>(mat.colStride(),mat.rowStride()));
+}
+
+inline Eigen::Map<Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic,Eigen::Dynamic> > toEigen(MatrixView<double> mat)
+{
+    return Eigen::Map<Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic,Eigen::Dynamic> >
+            (mat.data(),mat.rows(),mat.cols(),Eigen::Stride<Eigen::Dynamic,Eigen::Dynamic>(mat.colStride(),mat.rowStride()));
+}
 #endif
 
 inline Eigen::Map<const Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > toEigen(const MatrixDynSize & mat)
@@ -13,6 +13,7 @@
 
 #include <Eigen/SparseCore>
 #include <iDynTree/Core/SparseMatrix.h>
+#include <iDynTree/Core/CompressedColumnJacobian.h>
 
 namespace iDynTree
 {
@@ -62,6 +63,29 @@ inline Eigen::Map<const Eigen::SparseMatrix<double, Eigen::ColMajor> > toEigen(c
                                                                            0); //compressed format
 }
 
+//CompressedColumnJacobian helpers
+inline Eigen::Map< Eigen::SparseMatrix<double, Eigen::ColMajor> > toEigen(iDynTree::CompressedColumnJacobian & mat)
+{
+    return Eigen::Map<Eigen::SparseMatrix<double, Eigen::ColMajor> >(mat.rows(),
+                                                                     mat.columns(),
+                                                                     mat.numberOfNonZeros(),
+                                                                     mat.outerIndicesBuffer(),
+                                                                     mat.innerIndicesBuffer(),
+                                                                     mat.valuesBuffer(),
+                                                                     0); //compressed format
+}
+
+inline Eigen::Map<const Eigen::SparseMatrix<double, Eigen::ColMajor> > toEigen(const iDynTree::CompressedColumnJacobian & mat)
+{
+    return Eigen::Map<const Eigen::SparseMatrix<double, Eigen::ColMajor> >(mat.rows(),
+                                                                           mat.columns(),
+                                                                           mat.numberOfNonZeros(),
+                                                                           mat.outerIndicesBuffer(),
+                                                                           mat.innerIndicesBuffer(),
+                                                                           mat.valuesBuffer(),
+                                                                           0); //compressed format
+}
+
 }
 
 #endif /* IDYNTREE_EIGEN_SPARSE_HELPERS_H */
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_EXP_LOG_H
+#define IDYNTREE_EXP_LOG_H
+
+#include <iDynTree/Core/AngularMotionVector3.h>
+#include <iDynTree/Core/MatrixFixSize.h>
+#include <iDynTree/Core/Rotation.h>
+#include <iDynTree/Core/SpatialMotionVector.h>
+#include <iDynTree/Core/Transform.h>
+
+namespace iDynTree
+{
+    /**
+     * @name Exponential and logarithm maps of SO(3) and SE(3), and their Jacobians.
+     *
+     * The elements of so(3) are represented by an iDynTree::AngularMotionVector3 \f$ \phi \f$
+     * (the rotation vector), the elements of se(3) by an iDynTree::SpatialMotionVector
+     * \f$ \xi = \begin{bmatrix} v \\ \omega \end{bmatrix} \f$, with the usual iDynTree linear/angular
+     * serialization.
+     *
+     * Differently from Transform::log and SpatialMotionVector::exp, that map the rotation
+     * and the position separately (i.e. they are the maps of the SO(3) x R^3 group),
+     * expSE3 and logSE3 are the maps of SE(3), i.e. if \f$ \xi \f$ is a (constant) body-fixed
+     * twist of a frame B with respect to a frame A, \f$ {}^A H_B(t) = {}^A H_B(0) \exp(t \xi) \f$.
+     *
+     * The Jacobians are defined such that, for a small \f$ \delta \f$:
+     * \f[
+     *   \exp(\xi + \delta) \approx \exp(J_l(\xi) \delta) \exp(\xi) \approx \exp(\xi) \exp(J_r(\xi) \delta)
+     * \f]
+     * The same holds for SO(3).
+     *
+     * All the functions are in closed form, and switch to the Taylor expansions of
+     * their coefficients for small rotation angles.
+     *
+     * \ingroup iDynTreeCore
+     */
+    ///@{
+
+    /**
+     * Exponential map of SO(3), i.e. the rotation of an angle \f$ \|\phi\| \f$ around the axis \f$ \phi \f$.
+     */
+    Rotation expSO3(const AngularMotionVector3 & phi);
+
+    /**
+     * Logarithm map of SO(3). The returned rotation vector has norm in \f$ [0, \pi] \f$.
+     */
+    AngularMotionVector3 logSO3(const Rotation & rot);
+
+    /**
+     * Left Jacobian of SO(3).
+     */
+    Matrix3x3 leftJacobianSO3(const AngularMotionVector3 & phi);
+
+    /**
+     * Inverse of the left Jacobian of SO(3).
+     *
+     * \note The inverse is not defined for \f$ \|\phi\| = 2 k \pi, k \neq 0 \f$.
+     */
+    Matrix3x3 leftJacobianInverseSO3(const AngularMotionVector3 & phi);
+
+    /**
+     * Right Jacobian of SO(3), equal to the left Jacobian of \f$ -\phi \f$.
+     */
+    Matrix3x3 rightJacobianSO3(const AngularMotionVector3 & phi);
+
+    /**
+     * Inverse of the right Jacobian of SO(3).
+     */
+    Matrix3x3 rightJacobianInverseSO3(const AngularMotionVector3 & phi);
+
+    /**
+     * Exponential map of SE(3).
+     *
+     * The rotation of the result is expSO3(\f$ \omega \f$), the position is
+     * \f$ J_l(\omega) v \f$, where \f$ J_l \f$ is the left Jacobian of SO(3).
+     */
+    Transform expSE3(const SpatialMotionVector & xi);
+
+    /**
+     * Logarithm map of SE(3), inverse of expSE3.
+     */
+    SpatialMotionVector logSE3(const Transform & trans);
+
+    /**
+     * Left Jacobian of SE(3).
+     */
+    Matrix6x6 leftJacobianSE3(const SpatialMotionVector & xi);
+
+    /**
+     * Inverse of the left Jacobian of SE(3).
+     */
+    Matrix6x6 leftJacobianInverseSE3(const SpatialMotionVector & xi);
+
+    /**
+     * Right Jacobian of SE(3), equal to the left Jacobian of \f$ -\xi \f$.
+     */
+    Matrix6x6 rightJacobianSE3(const SpatialMotionVector & xi);
+
+    /**
+     * Inverse of the right Jacobian of SE(3).
+     */
+    Matrix6x6 rightJacobianInverseSE3(const SpatialMotionVector & xi);
+
+    ///@}
+}
+
+#endif
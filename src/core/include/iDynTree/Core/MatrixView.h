@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_MATRIX_VIEW_H
+#define IDYNTREE_MATRIX_VIEW_H
+
+#include <iDynTree/Core/Utils.h>
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace iDynTree
+{
+    namespace MatrixViewInternal
+    {
+        template <typename... Ts> struct make_void { typedef void type; };
+        template <typename... Ts> using void_t = typename make_void<Ts...>::type;
+
+        /**
+         * has_IsRowMajor is used to build a type-dependent expression SFINAE
+         * to detect the storage ordering of Eigen matrices and expressions.
+         */
+        template <typename T, typename = void>
+        struct has_IsRowMajor : std::false_type {};
+
+        template <typename T>
+        struct has_IsRowMajor<T, void_t<decltype(T::IsRowMajor)>> : std::true_type {};
+
+        /**
+         * has_strides is used to detect classes exposing innerStride() and outerStride(),
+         * i.e. Eigen matrices, maps and blocks.
+         */
+        template <typename T, typename = void>
+        struct has_strides : std::false_type {};
+
+        template <typename T>
+        struct has_strides<T, void_t<decltype(std::declval<T>().innerStride()),
+                                     decltype(std::declval<T>().outerStride())>> : std::true_type {};
+
+        /**
+         * is_matrix_container is true for classes exposing data(), rows() and cols().
+         */
+        template <typename T, typename = void>
+        struct is_matrix_container : std::false_type {};
+
+        template <typename T>
+        struct is_matrix_container<T, void_t<decltype(std::declval<T>().data()),
+                                             decltype(std::declval<T>().rows()),
+                                             decltype(std::declval<T>().cols())>> : std::true_type {};
+
+        template <typename Container>
+        typename std::enable_if<has_IsRowMajor<Container>::value, MatrixStorageOrdering>::type
+        storageOrder(const Container & /*cont*/)
+        {
+            return Container::IsRowMajor ? RowMajor : ColumnMajor;
+        }
+
+        template <typename Container>
+        typename std::enable_if<!has_IsRowMajor<Container>::value, MatrixStorageOrdering>::type
+        storageOrder(const Container & /*cont*/)
+        {
+            // iDynTree matrices are always row major
+            return RowMajor;
+        }
+
+        template <typename Container>
+        typename std::enable_if<has_strides<Container>::value, std::ptrdiff_t>::type
+        innerStride(const Container & cont)
+        {
+            return cont.innerStride();
+        }
+
+        template <typename Container>
+        typename std::enable_if<!has_strides<Container>::value, std::ptrdiff_t>::type
+        innerStride(const Container & /*cont*/)
+        {
+            return 1;
+        }
+
+        template <typename Container>
+        typename std::enable_if<has_strides<Container>::value, std::ptrdiff_t>::type
+        outerStride(const Container & cont)
+        {
+            return cont.outerStride();
+        }
+
+        template <typename Container>
+        typename std::enable_if<!has_strides<Container>::value, std::ptrdiff_t>::type
+        outerStride(const Container & cont)
+        {
+            return storageOrder(cont) == RowMajor ? cont.cols() : cont.rows();
+        }
+    }
+
+    /**
+     * MatrixView implements a non-owning view of a 2D matrix, stored
+     * in a buffer with an arbitrary storage ordering and arbitrary strides.
+     *
+     * It can be constructed from a raw pointer, or from any object exposing the
+     * data(), rows() and cols() methods, such as iDynTree::MatrixDynSize,
+     * iDynTree::MatrixFixSize, Eigen matrices and Eigen blocks. This permits to pass
+     * the memory of the caller (for example an Eigen matrix, or a buffer of a NumPy array)
+     * to the methods taking a MatrixView, that read or write it without copying it.
+     *
+     * Indicating with innerStride the distance between two consecutive elements of a row
+     * (for RowMajor) or of a column (for ColumnMajor), and with outerStride the distance
+     * between the first elements of two consecutive rows (RowMajor) or columns (ColumnMajor),
+     * the element (row,col) is stored in:
+     *  * data()[row*outerStride + col*innerStride] for RowMajor storage,
+     *  * data()[col*outerStride + row*innerStride] for ColumnMajor storage.
+     *
+     * \note The view does not own the memory, that must outlive the view.
+     *
+     * \ingroup iDynTreeCore
+     */
+    template <class ElementType>
+    class MatrixView
+    {
+    public:
+        using element_type = ElementType;
+        using value_type = typename std::remove_cv<ElementType>::type;
+        using index_type = std::ptrdiff_t;
+        using pointer = element_type*;
+        using reference = element_type&;
+
+    private:
+        pointer m_storage;
+        index_type m_rows;
+        index_type m_cols;
+        index_type m_innerStride;
+        index_type m_outerStride;
+        MatrixStorageOrdering m_storageOrder;
+
+        index_type rawIndex(index_type row, index_type col) const
+        {
+            if (m_storageOrder == RowMajor)
+            {
+                return row*m_outerStride + col*m_innerStride;
+            }
+            return col*m_outerStride + row*m_innerStride;
+        }
+
+    public:
+        /**
+         * Build an empty view.
+         */
+        MatrixView()
+        : m_storage(nullptr), m_rows(0), m_cols(0), m_innerStride(1), m_outerStride(0), m_storageOrder(RowMajor)
+        {
+        }
+
+        /**
+         * Build a view of a contiguous buffer of in_rows*in_cols elements.
+         */
+        MatrixView(pointer in_data,
+                   const index_type in_rows,
+                   const index_type in_cols,
+                   const MatrixStorageOrdering order = RowMajor)
+        : m_storage(in_data), m_rows(in_rows), m_cols(in_cols), m_innerStride(1),
+          m_outerStride(order == RowMajor ? in_cols : in_rows), m_storageOrder(order)
+        {
+            assert(in_rows >= 0 && in_cols >= 0);
+        }
+
+        /**
+         * Build a view of a strided buffer.
+         */
+        MatrixView(pointer in_data,
+                   const index_type in_rows,
+                   const index_type in_cols,
+                   const index_type in_innerStride,
+                   const index_type in_outerStride,
+                   const MatrixStorageOrdering order)
+        : m_storage(in_data), m_rows(in_rows), m_cols(in_cols), m_innerStride(in_innerStride),
+          m_outerStride(in_outerStride), m_storageOrder(order)
+        {
+            assert(in_rows >= 0 && in_cols >= 0);
+        }
+
+        MatrixView(const MatrixView & other) = default;
+        MatrixView& operator=(const MatrixView & other) = default;
+
+        /**
+         * Build a view of const elements from a view of non-const elements.
+         */
+        template <class OtherElementType,
+                  class = typename std::enable_if<std::is_convertible<OtherElementType(*)[], ElementType(*)[]>::value>::type>
+        MatrixView(const MatrixView<OtherElementType> & other)
+        : m_storage(other.data()), m_rows(other.rows()), m_cols(other.cols()), m_innerStride(other.innerStride()),
+          m_outerStride(other.outerStride()), m_storageOrder(other.storageOrder())
+        {
+        }
+
+        /**
+         * Build a view of a matrix container, i.e. an object exposing data(), rows() and cols().
+         */
+        template <class Container,
+                  class = typename std::enable_if<MatrixViewInternal::is_matrix_container<Container>::value &&
+                                                  !std::is_same<typename std::remove_cv<Container>::type, MatrixView>::value &&
+                                                  std::is_convertible<decltype(std::declval<Container&>().data()), pointer>::value>::type>
+        MatrixView(Container & cont)
+        : m_storage(cont.data()), m_rows(cont.rows()), m_cols(cont.cols()),
+          m_innerStride(MatrixViewInternal::innerStride(cont)),
+          m_outerStride(MatrixViewInternal::outerStride(cont)),
+          m_storageOrder(MatrixViewInternal::storageOrder(cont))
+        {
+        }
+
+        /**
+         * Build a view of a const matrix container, only if the elements of the view are const.
+         */
+        template <class Container,
+                  class = typename std::enable_if<std::is_const<element_type>::value &&
+                                                  MatrixViewInternal::is_matrix_container<Container>::value &&
+                                                  !std::is_same<Container, MatrixView>::value &&
+                                                  std::is_convertible<decltype(std::declval<const Container&>().data()), pointer>::value>::type>
+        MatrixView(const Container & cont)
+        : m_storage(cont.data()), m_rows(cont.rows()), m_cols(cont.cols()),
+          m_innerStride(MatrixViewInternal::innerStride(cont)),
+          m_outerStride(MatrixViewInternal::outerStride(cont)),
+          m_storageOrder(MatrixViewInternal::storageOrder(cont))
+        {
+        }
+
+        /**
+         * Access the element (row,col).
+         */
+        reference operator()(const index_type row, const index_type col) const
+        {
+            assert(row >= 0 && row < m_rows && col >= 0 && col < m_cols);
+            return m_storage[rawIndex(row,col)];
+        }
+
+        /**
+         * Return a view of the block of size nrows x ncols starting at (startRow,startCol).
+         */
+        MatrixView block(const index_type startRow, const index_type startCol,
+                         const index_type nrows, const index_type ncols) const
+        {
+            assert(startRow >= 0 && startCol >= 0 && startRow+nrows <= m_rows && startCol+ncols <= m_cols);
+            return MatrixView(m_storage+rawIndex(startRow,startCol),nrows,ncols,
+                              m_innerStride,m_outerStride,m_storageOrder);
+        }
+
+        pointer data() const
+        {
+            return m_storage;
+        }
+
+        index_type rows() const
+        {
+            return m_rows;
+        }
+
+        index_type cols() const
+        {
+            return m_cols;
+        }
+
+        index_type innerStride() const
+        {
+            return m_innerStride;
+        }
+
+        index_type outerStride() const
+        {
+            return m_outerStride;
+        }
+
+        MatrixStorageOrdering storageOrder() const
+        {
+            return m_storageOrder;
+        }
+
+        /**
+         * Distance in the buffer between the elements (row,col) and (row+1,col).
+         */
+        index_type rowStride() const
+        {
+            return m_storageOrder == RowMajor ? m_outerStride : m_innerStride;
+        }
+
+        /**
+         * Distance in the buffer between the elements (row,col) and (row,col+1).
+         */
+        index_type colStride() const
+        {
+            return m_storageOrder == RowMajor ? m_innerStride : m_outerStride;
+        }
+    };
+
+    template <class ElementType>
+    MatrixView<ElementType> make_matrix_view(ElementType* data,
+                                             const typename MatrixView<ElementType>::index_type rows,
+                                             const typename MatrixView<ElementType>::index_type cols,
+                                             const MatrixStorageOrdering order = RowMajor)
+    {
+        return MatrixView<ElementType>(data,rows,cols,order);
+    }
+
+    template <class Container,
+              class = typename std::enable_if<MatrixViewInternal::is_matrix_container<Container>::value>::type>
+    MatrixView<typename std::remove_pointer<decltype(std::declval<Container&>().data())>::type> make_matrix_view(Container & cont)
+    {
+        return MatrixView<typename std::remove_pointer<decltype(std::declval<Container&>().data())>::type>(cont);
+    }
+
+    template <class Container,
+              class = typename std::enable_if<MatrixViewInternal::is_matrix_container<Container>::value>::type>
+    MatrixView<typename std::remove_pointer<decltype(std::declval<const Container&>().data())>::type> make_matrix_view(const Container & cont)
+    {
+        return MatrixView<typename std::remove_pointer<decltype(std::declval<const Container&>().data())>::type>(cont);
+    }
+}
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+
+#ifndef IDYNTREE_MULTI_CUBIC_SPLINE_H
+#define IDYNTREE_MULTI_CUBIC_SPLINE_H
+
+#include <iDynTree/Core/Span.h>
+#include <iDynTree/Core/MatrixView.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace iDynTree
+{
+    /**
+     * Cubic spline interpolating several channels (for example the positions of all
+     * the joints of a robot) that share the same knot vector.
+     *
+     * Each channel is interpolated as in iDynTree::CubicSpline, but:
+     *  * the tridiagonal system giving the velocities at the knots depends only on the
+     *    knot times, so it is factorized once and solved for all the channels together,
+     *  * the coefficients are stored interleaved by channel, i.e. for each interval the
+     *    k-th coefficients of all the channels are contiguous in memory, so that the evaluation
+     *    of all the channels at a given time is a vectorized operation on contiguous buffers,
+     *  * the interval of the last evaluation is cached, so that the evaluation at monotonically
+     *    increasing times (the typical usage in a control loop) finds the interval in O(1).
+     *    Arbitrary times are still supported, falling back to a binary search.
+     *
+     * Position, velocity and acceleration are computed by the same call.
+     *
+     * The behaviour outside the time range of the knots is the same of iDynTree::CubicSpline:
+     * before the first knot the first value and the initial conditions are returned, after the
+     * last knot the last value and the final conditions are returned.
+     */
+    class MultiCubicSpline
+    {
+        size_t m_nrOfChannels;
+
+        // Knot times and durations of the intervals
+        std::vector<double> m_time;
+        std::vector<double> m_T;
+
+        // Values at the knots, stored knot by knot (m_y[knot*m_nrOfChannels+channel])
+        std::vector<double> m_y;
+
+        // Velocities at the knots, stored as m_y
+        std::vector<double> m_velocities;
+
+        // Coefficients, for each interval the four blocks of m_nrOfChannels
+        // coefficients of the powers 0..3 of the time since the beginning of the interval
+        std::vector<double> m_coefficients;
+
+        // Boundary conditions, one element for each channel
+        std::vector<double> m_v0;
+        std::vector<double> m_vf;
+        std::vector<double> m_a0;
+        std::vector<double> m_af;
+
+        // Interval of the last evaluation
+        size_t m_cursor;
+
+        bool computePhasesDuration();
+        void computeIntermediateVelocities();
+        void computeCoefficients();
+        size_t findInterval(const double t);
+
+        // Evaluate all the channels at time t, writing the outputs with the given strides.
+        // velocity and acceleration can be nullptr if they are not needed.
+        void evaluate(const double t,
+                      double* position, const std::ptrdiff_t positionStride,
+                      double* velocity, const std::ptrdiff_t velocityStride,
+                      double* acceleration, const std::ptrdiff_t accelerationStride);
+
+    public:
+        MultiCubicSpline();
+
+        /**
+         * Constructor, reserving the buffers for nrOfChannels channels and nrOfKnots knots.
+         */
+        MultiCubicSpline(size_t nrOfChannels, size_t nrOfKnots);
+
+        /**
+         * Set the knots of the spline and compute its coefficients.
+         *
+         * @param[in] time the strictly increasing vector of the times of the knots.
+         * @param[in] yData a matrix with a row for each channel and a column for each knot.
+         * @return true if all went well, false otherwise.
+         *
+         * \note The boundary conditions set before are used only if their size matches the
+         *       number of channels, otherwise they are reset to zero.
+         */
+        bool setData(Span<const double> time, MatrixView<const double> yData);
+
+        /**
+         * Set the initial velocity and acceleration of all the channels.
+         * If the data was already set, the coefficients are updated.
+         */
+        bool setInitialConditions(Span<const double> initialVelocities, Span<const double> initialAccelerations);
+
+        /**
+         * Set the final velocity and acceleration of all the channels.
+         * If the data was already set, the coefficients are updated.
+         */
+        bool setFinalConditions(Span<const double> finalVelocities, Span<const double> finalAccelerations);
+
+        /**
+         * Get the number of channels of the spline.
+         */
+        size_t getNrOfChannels() const;
+
+        /**
+         * Get the number of knots of the spline.
+         */
+        size_t getNrOfKnots() const;
+
+        /**
+         * Evaluate all the channels at the time t.
+         *
+         * @return true if all went well, false otherwise (i.e. if the data was not set or the outputs have the wrong size).
+         */
+        bool evaluatePoint(const double t, Span<double> position);
+
+        /**
+         * Evaluate all the channels and their first two derivatives at the time t.
+         *
+         * @return true if all went well, false otherwise (i.e. if the data was not set or the outputs have the wrong size).
+         */
+        bool evaluatePoint(const double t, Span<double> position, Span<double> velocity, Span<double> acceleration);
+
+        /**
+         * Evaluate all the channels and their first two derivatives at each time of the vector times.
+         *
+         * The outputs are matrices with a row for each channel and a column for each time.
+         * The evaluation is efficient if times is sorted, but this is not required.
+         *
+         * @return true if all went well, false otherwise (i.e. if the data was not set or the outputs have the wrong size).
+         */
+        bool evaluateBatch(Span<const double> times,
+                           MatrixView<double> positions,
+                           MatrixView<double> velocities,
+                           MatrixView<double> accelerations);
+
+        /**
+         * Reset the cached interval to the first one.
+         */
+        void resetCursor();
+    };
+}
+
+#endif
@@ -24,6 +24,7 @@ namespace iDynTree {
     
     class Triplet;
     class Triplets;
+    class CompressedColumnJacobian;
 }
 
 // MARK: - SparseMatrix class
@@ -50,9 +51,18 @@ private:
 
     unsigned m_allocatedSize; /**< size of the memory allocated for m_values and m_innerIndices */
 
+    std::vector<int> m_slotMap; /**< for each triplet of the frozen sparsity pattern,
+                                 *   contains the index in m_values of its element
+                                 */
+    bool m_isSparsityPatternFrozen; /**< true if m_slotMap describes the current sparsity pattern */
+
     unsigned m_rows;
     unsigned m_columns;
 
+    // CompressedColumnJacobian already stores its elements in the compressed column
+    // layout, so it fills the buffers of a column major matrix directly
+    friend class iDynTree::CompressedColumnJacobian;
+
     void initializeMatrix(unsigned outerSize, const double* vector, unsigned vectorSize);
 
     /**
@@ -186,6 +196,58 @@ public:
      */
     void setFromTriplets(iDynTree::Triplets& triplets);
 
+    /**
+     * Sets the content of this sparse matrix to the content of triplets,
+     * and freezes the resulting sparsity pattern.
+     *
+     * Besides building the matrix as setFromConstTriplets, this method stores
+     * for each triplet the index in the values buffer of the element it contributes to
+     * (the slot map). The values of the matrix can then be updated with setValuesFromTriplets,
+     * that simply writes the values in the precomputed slots, without sorting the triplets
+     * or allocating memory.
+     *
+     * As setFromConstTriplets, this function does not set the dimensions of the matrix
+     * which must be set beforehand.
+     *
+     * \note duplicate elements in triplets will be summed up, also in setValuesFromTriplets.
+     * \warning this function performs memory allocation
+     *
+     * @param triplets triplets describing the non zero elements
+     */
+    void freezeSparsityPattern(const iDynTree::Triplets& triplets);
+
+    /**
+     * Release the frozen sparsity pattern (if any).
+     *
+     * \note the content of the matrix is preserved.
+     */
+    void unfreezeSparsityPattern();
+
+    /**
+     * Returns true if the sparsity pattern has been frozen with freezeSparsityPattern.
+     *
+     * The pattern is released by any method that may change the structure
+     * of the matrix (i.e. setFromTriplets, setFromConstTriplets, resize, zero
+     * and the non-const operator() when it inserts an element outside of the pattern).
+     */
+    bool isSparsityPatternFrozen() const;
+
+    /**
+     * Update the values of a matrix with a frozen sparsity pattern.
+     *
+     * The triplets must have the same rows and columns (in the same order)
+     * of the ones passed to freezeSparsityPattern: only their values may change.
+     * Each value is written (or summed, for duplicate elements) directly in the values buffer,
+     * so this method is linear in the number of triplets and it performs no memory allocation.
+     *
+     * \note in debug builds it is asserted that the rows and columns of the triplets match
+     *       the frozen sparsity pattern.
+     *
+     * @param triplets triplets containing the new values of the non zero elements
+     * @return true if all went well, false if the pattern is not frozen or the number of triplets is wrong.
+     */
+    bool setValuesFromTriplets(const iDynTree::Triplets& triplets);
+
     static SparseMatrix sparseMatrixFromTriplets(unsigned rows,
                                                  unsigned cols,
                                                  const iDynTree::Triplets& nonZeroElements);
@@ -20,6 +20,8 @@
 
 namespace iDynTree
 {
+    class Transform;
+
     /**
      * @brief Class representing a six dimensional inertia.
      *
@@ -98,6 +100,16 @@ namespace iDynTree
          */
         Wrench biasWrench(const Twist & V) const;
 
+        /**
+         * Return the net wrench M*a + v.cross(M*v).
+         *
+         * Defining \f$ \mathbb{M} \f$ as this inertia, return the
+         * wrench \f$ \mathbb{M} \mathrm{a} + \mathrm{v} \bar\times^* \mathbb{M} \mathrm{v} \f$
+         * acting on a rigid body with velocity v and (proper) acceleration a, i.e. the
+         * result of (*this)*a + biasWrench(V) computed without temporaries.
+         */
+        Wrench netWrench(const SpatialAcc & a, const Twist & V) const;
+
         /**
          * @brief Return the derivative of the bias wrench with respect to the link 6D velocity.
          *
@@ -125,6 +137,16 @@ namespace iDynTree
          */
         Matrix6x6 biasWrenchDerivative(const Twist & V) const;
 
+        /**
+         * Add to this spatial inertia the spatial inertia b_I, expressed in frame b,
+         * once expressed in frame a.
+         *
+         * This is equivalent to (*this) = (*this) + a_X_b*b_I, but the transformed inertial
+         * parameters are accumulated directly, without building any temporary spatial inertia.
+         * Used in the backward pass of the composite rigid body algorithm.
+         */
+        void addTransformed(const Transform & a_X_b, const SpatialInertia & b_I);
+
         static SpatialInertia Zero();
 
 
@@ -27,13 +27,26 @@ namespace iDynTree
      *
      * \note in iDynTree, the spatial vector follows this serialization: the first three elements are
      *       the linear part and the second three elements are the angular part.
+     *
+     * Storage:
+     * The spatial inertia is stored as its 10 inertial parameters, in the same layout
+     * used by SpatialInertia::asVector and Model::getInertialParameters:
+     *  * the mass (element 0),
+     *  * the first moment of mass, i.e. mass * center of mass (elements 1-3),
+     *  * the upper triangular part of the rotational inertia with respect to the frame origin,
+     *    stored row by row, i.e. \f$ I_{xx}, I_{xy}, I_{xz}, I_{yy}, I_{yz}, I_{zz} \f$ (elements 4-9).
      */
     class SpatialInertiaRaw
     {
+    public:
+        /**
+         * Number of inertial parameters of a spatial inertia,
+         * i.e. the size of the packed buffer.
+         */
+        static const unsigned int PackedSize = 10;
+
     protected:
-        double m_mass; ///< Mass.
-        double m_mcom[3]; ///< First moment of mass (i.e. mass * center of mass).
-        RotationalInertiaRaw m_rotInertia; ///< Three dimensional rotational inertia.
+        double m_packed[PackedSize]; ///< Inertial parameters.
 
     public:
         /**
@@ -81,7 +94,7 @@ namespace iDynTree
          */
         double getMass() const;
         PositionRaw getCenterOfMass() const;
-        const RotationalInertiaRaw& getRotationalInertiaWrtFrameOrigin() const;
+        RotationalInertiaRaw getRotationalInertiaWrtFrameOrigin() const;
         RotationalInertiaRaw getRotationalInertiaWrtCenterOfMass() const;
 
 
@@ -99,6 +112,14 @@ namespace iDynTree
 
         /** reset to zero (i.e. the inertia of body with zero mass) the SpatialInertia */
         void zero();
+
+        /**
+         * Raw access to the packed buffer of the PackedSize inertial parameters.
+         *
+         * \warning Writing in the buffer changes the spatial inertia without any check.
+         */
+        double * packedData();
+        const double * packedData() const;
     };
 }
 
@@ -145,6 +145,9 @@ namespace iDynTree
         /**
          * Exp mapping between a  generic element of se(3) (iDynTree::SpatialMotionVector)
          * to the corresponding element of SE(3) (iDynTree::Transform).
+         *
+         * \note The angular part is mapped with the exp of SO(3), while the linear part is copied
+         *       in the position. For the exp map of SE(3), see iDynTree::expSE3 .
          */
         Transform exp() const;
     };
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_STATIC_SEMANTICS_H
+#define IDYNTREE_STATIC_SEMANTICS_H
+
+#include <iDynTree/Core/Position.h>
+#include <iDynTree/Core/Transform.h>
+#include <iDynTree/Core/Twist.h>
+#include <iDynTree/Core/Wrench.h>
+
+#include <type_traits>
+
+namespace iDynTree
+{
+/**
+ * Compile time checking of the semantics of geometric quantities.
+ *
+ * The classes in this namespace are thin wrappers of iDynTree::Transform, iDynTree::Position,
+ * iDynTree::Twist and iDynTree::Wrench, tagged with the frames (and bodies) the quantity refers to.
+ * The tags are arbitrary (even incomplete) types defined by the user, for example:
+ * ~~~
+ * struct World; struct Base; struct Hand;
+ *
+ * StaticSemantics::FrameTransform<World,Base> world_H_base(kinDyn.getWorldBaseTransform());
+ * StaticSemantics::FrameTransform<Base,Hand>  base_H_hand(kinDyn.getRelativeTransform("base","hand"));
+ * StaticSemantics::FrameTransform<World,Hand> world_H_hand = world_H_base*base_H_hand;  // ok
+ * world_H_base*world_H_hand; // compilation error: the frames do not match
+ * ~~~
+ *
+ * The operators are checked at compile time, and then forward to the operators
+ * of the underlying classes: each wrapper contains only the wrapped object and all its methods
+ * are inline, so the generated code is the same of the one using the raw classes.
+ * In this way the consistency of the frames is checked also in Release builds, differently
+ * from the runtime semantics checks enabled by the IDYNTREE_USES_SEMANTICS option.
+ *
+ * Conventions (see S. Traversaro, A. Saccon, Multibody Dynamics Notation, http://repository.tue.nl/849895):
+ *  * FrameTransform<A,B>        is the transform \f$ {}^A H_B \f$ (or equivalently \f$ {}^A X_B \f$ on 6D vectors),
+ *  * FramePosition<F,P>         is the position of the point P with respect to the origin of F, expressed in F,
+ *  * FrameTwist<Body,Ref,F>     is the twist of the frame Body with respect to the frame Ref, expressed in F,
+ *  * FrameWrench<Body,F>        is a wrench applied on Body, expressed in F.
+ *
+ * \ingroup iDynTreeCore
+ */
+namespace StaticSemantics
+{
+    template <class Frame, class Point> class FramePosition;
+    template <class Body, class RefBody, class Frame> class FrameTwist;
+    template <class Body, class Frame> class FrameWrench;
+
+    /**
+     * Transform \f$ {}^A H_B \f$, that changes the frame of a quantity from B to A.
+     */
+    template <class A, class B>
+    class FrameTransform
+    {
+    private:
+        Transform m_raw;
+
+    public:
+        typedef A ToFrame;
+        typedef B FromFrame;
+
+        FrameTransform() {}
+
+        /**
+         * Tag a raw transform, asserting that it is A_H_B.
+         */
+        explicit FrameTransform(const Transform & raw): m_raw(raw) {}
+
+        static FrameTransform Identity()
+        {
+            static_assert(std::is_same<A,B>::value, "StaticSemantics: the identity transform is only A_H_A");
+            return FrameTransform(Transform::Identity());
+        }
+
+        /** The underlying transform. */
+        const Transform & raw() const { return m_raw; }
+        Transform & raw() { return m_raw; }
+
+        /** B_H_A */
+        FrameTransform<B,A> inverse() const
+        {
+            return FrameTransform<B,A>(m_raw.inverse());
+        }
+
+        /** A_H_B * C_H_D, valid only if B == C */
+        template <class C, class D>
+        FrameTransform<A,D> operator*(const FrameTransform<C,D> & other) const
+        {
+            static_assert(std::is_same<B,C>::value, "StaticSemantics: A_H_B*C_H_D requires B == C");
+            return FrameTransform<A,D>(m_raw*other.raw());
+        }
+
+        /** A_H_B * C_p, valid only if B == C */
+        template <class C, class Point>
+        FramePosition<A,Point> operator*(const FramePosition<C,Point> & other) const
+        {
+            static_assert(std::is_same<B,C>::value, "StaticSemantics: A_H_B*C_p requires B == C");
+            return FramePosition<A,Point>(m_raw*other.raw());
+        }
+
+        /** A_X_B * C_v, valid only if B == C */
+        template <class Body, class RefBody, class C>
+        FrameTwist<Body,RefBody,A> operator*(const FrameTwist<Body,RefBody,C> & other) const
+        {
+            static_assert(std::is_same<B,C>::value, "StaticSemantics: A_X_B*C_v requires B == C");
+            return FrameTwist<Body,RefBody,A>(m_raw*other.raw());
+        }
+
+        /** A_X_B^* * C_f, valid only if B == C */
+        template <class Body, class C>
+        FrameWrench<Body,A> operator*(const FrameWrench<Body,C> & other) const
+        {
+            static_assert(std::is_same<B,C>::value, "StaticSemantics: A_X_B^* C_f requires B == C");
+            return FrameWrench<Body,A>(m_raw*other.raw());
+        }
+
+        /** B_X_A * C_v (without computing the inverse), valid only if A == C */
+        template <class Body, class RefBody, class C>
+        FrameTwist<Body,RefBody,B> applyInverse(const FrameTwist<Body,RefBody,C> & other) const
+        {
+            static_assert(std::is_same<A,C>::value, "StaticSemantics: (A_X_B)^-1*C_v requires A == C");
+            return FrameTwist<Body,RefBody,B>(m_raw.applyInverse(other.raw()));
+        }
+
+        /** B_X_A^* * C_f (without computing the inverse), valid only if A == C */
+        template <class Body, class C>
+        FrameWrench<Body,B> applyInverse(const FrameWrench<Body,C> & other) const
+        {
+            static_assert(std::is_same<A,C>::value, "StaticSemantics: (A_X_B^*)^-1*C_f requires A == C");
+            return FrameWrench<Body,B>(m_raw.applyInverse(other.raw()));
+        }
+    };
+
+    /**
+     * Position of the point Point with respect to the origin of Frame, expressed in Frame.
+     */
+    template <class Frame, class Point>
+    class FramePosition
+    {
+    private:
+        Position m_raw;
+
+    public:
+        FramePosition() {}
+        explicit FramePosition(const Position & raw): m_raw(raw) {}
+
+        const Position & raw() const { return m_raw; }
+        Position & raw() { return m_raw; }
+    };
+
+    /**
+     * Twist of the frame Body with respect to the frame RefBody, expressed in Frame.
+     */
+    template <class Body, class RefBody, class Frame>
+    class FrameTwist
+    {
+    private:
+        Twist m_raw;
+
+    public:
+        FrameTwist() {}
+        explicit FrameTwist(const Twist & raw): m_raw(raw) {}
+
+        const Twist & raw() const { return m_raw; }
+        Twist & raw() { return m_raw; }
+
+        /**
+         * Composition of relative twists: v_{Body,RefBody} + v_{RefBody,OtherRef} = v_{Body,OtherRef},
+         * valid only if the two twists are expressed in the same frame.
+         */
+        template <class OtherBody, class OtherRef, class OtherFrame>
+        FrameTwist<Body,OtherRef,Frame> operator+(const FrameTwist<OtherBody,OtherRef,OtherFrame> & other) const
+        {
+            static_assert(std::is_same<RefBody,OtherBody>::value,
+                          "StaticSemantics: v_{A,B}+v_{C,D} requires B == C");
+            static_assert(std::is_same<Frame,OtherFrame>::value,
+                          "StaticSemantics: the sum of twists requires them to be expressed in the same frame");
+            return FrameTwist<Body,OtherRef,Frame>(m_raw+other.raw());
+        }
+
+        /** v_{RefBody,Body}, expressed in Frame */
+        FrameTwist<RefBody,Body,Frame> operator-() const
+        {
+            return FrameTwist<RefBody,Body,Frame>(-m_raw);
+        }
+    };
+
+    /**
+     * Wrench applied on Body, expressed in Frame.
+     */
+    template <class Body, class Frame>
+    class FrameWrench
+    {
+    private:
+        Wrench m_raw;
+
+    public:
+        FrameWrench() {}
+        explicit FrameWrench(const Wrench & raw): m_raw(raw) {}
+
+        const Wrench & raw() const { return m_raw; }
+        Wrench & raw() { return m_raw; }
+
+        /** Sum of two wrenches applied on the same body and expressed in the same frame. */
+        template <class OtherBody, class OtherFrame>
+        FrameWrench operator+(const FrameWrench<OtherBody,OtherFrame> & other) const
+        {
+            static_assert(std::is_same<Body,OtherBody>::value,
+                          "StaticSemantics: the sum of wrenches requires them to be applied on the same body");
+            static_assert(std::is_same<Frame,OtherFrame>::value,
+                          "StaticSemantics: the sum of wrenches requires them to be expressed in the same frame");
+            return FrameWrench(m_raw+other.raw());
+        }
+
+        template <class OtherBody, class OtherFrame>
+        FrameWrench operator-(const FrameWrench<OtherBody,OtherFrame> & other) const
+        {
+            static_assert(std::is_same<Body,OtherBody>::value,
+                          "StaticSemantics: the difference of wrenches requires them to be applied on the same body");
+            static_assert(std::is_same<Frame,OtherFrame>::value,
+                          "StaticSemantics: the difference of wrenches requires them to be expressed in the same frame");
+            return FrameWrench(m_raw-other.raw());
+        }
+    };
+}
+}
+
+#endif
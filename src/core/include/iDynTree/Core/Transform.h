@@ -382,6 +382,45 @@ namespace iDynTree
          */
         ArticulatedBodyInertia operator*(const ArticulatedBodyInertia  & other) const;
 
+        /**
+         * Change the frame in which a motion vector is expressed, using the inverse of this transform.
+         *
+         * The result is the same of this->inverse()*other, but the inverse is not computed:
+         * \f[
+         * {}^{\texttt{frame}} V
+         * =
+         * {}^{\texttt{refFrame}}X_{\texttt{frame}}^{-1}
+         * {}^{\texttt{refFrame}} V
+         * =
+          \begin{bmatrix}
+         * R^T (v - p \times \omega) \\ R^T \omega
+         * \end{bmatrix}
+         * \f]
+         */
+        SpatialMotionVector applyInverse(const SpatialMotionVector & other) const;
+
+        Twist applyInverse(const Twist & other) const;
+
+        /**
+         * Change the frame in which a force vector is expressed, using the inverse of this transform.
+         *
+         * The result is the same of this->inverse()*other, i.e. the product \f$ X^T F \f$
+         * with the transpose of the velocity transform, but the inverse is not computed:
+         * \f[
+         * {}_{\texttt{frame}} F
+         * =
+         * {}^{\texttt{frame}}X_{\texttt{refFrame}}^T
+         * {}_{\texttt{refFrame}} F
+         * =
+          \begin{bmatrix}
+         * R^T f \\ R^T (\tau - p \times f)
+         * \end{bmatrix}
+         * \f]
+         */
+        SpatialForceVector applyInverse(const SpatialForceVector & other) const;
+
+        Wrench applyInverse(const Wrench & other) const;
+
 
         /**
          * Change the frame in which a Direction is expressed.
@@ -537,8 +576,11 @@ namespace iDynTree
         Matrix6x6 asAdjointTransformWrench() const;
 
         /*
-         * Exp mapping between a  generic element of se(3) (iDynTree::SpatialMotionVector)
-         * to the corresponding element of SE(3) (iDynTree::Transform).
+         * Log mapping between a  generic element of SE(3) (iDynTree::Transform)
+         * to the corresponding element of se(3) (iDynTree::SpatialMotionVector).
+         *
+         * \note The rotation is mapped with the log of SO(3), while the position is copied
+         *       in the linear part. For the log map of SE(3), see iDynTree::logSE3 .
          */
         SpatialMotionVector log() const;
 
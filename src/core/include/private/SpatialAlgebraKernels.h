@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_INTERNAL_SPATIAL_ALGEBRA_KERNELS_H
+#define IDYNTREE_INTERNAL_SPATIAL_ALGEBRA_KERNELS_H
+
+/**
+ * Kernels implementing the spatial algebra operations used in the inner loops
+ * of the recursive algorithms, operating directly on the raw buffers of the
+ * iDynTree classes:
+ *  - 3d vectors are 3 contiguous doubles,
+ *  - 6d spatial vectors are passed as two 3d vectors (linear and angular part),
+ *  - 3x3 matrices (rotations and rotational inertias) are 9 contiguous doubles, in row major order.
+ *
+ * The output buffers of the kernels operating on 6d vectors can alias their input buffers.
+ *
+ * Two implementations of the kernels exist, selected at build time with the
+ * IDYNTREE_SPATIAL_ALGEBRA_KERNELS CMake option:
+ *  - a portable scalar one (the default), defined inline in SpatialAlgebraKernelsImpl.h ,
+ *  - an AVX2/FMA one (if IDYNTREE_USES_AVX2_SPATIAL_KERNELS is defined), compiled out of line in
+ *    SpatialAlgebraKernelsAVX2.cpp . That is the only translation unit compiled with the AVX2 flags,
+ *    so that the rest of the library (and in particular the Eigen code) is compiled with the same
+ *    instruction set of the other iDynTree libraries and of the downstream users.
+ *
+ * \note This header is private to the idyntree-core library, as its content depends on the
+ *       compilation flags used to compile the library.
+ */
+
+#if defined(IDYNTREE_USES_AVX2_SPATIAL_KERNELS)
+#define IDYNTREE_SPATIAL_ALGEBRA_KERNEL
+#else
+#define IDYNTREE_SPATIAL_ALGEBRA_KERNEL inline
+#endif
+
+namespace iDynTree
+{
+namespace internal
+{
+namespace kernels
+{
+
+    /**
+     * Expand a 3x3 symmetric matrix, stored as its upper triangular part row by row
+     * in 6 doubles, to a row major 3x3 matrix.
+     */
+    inline void unpackSymmetric3(const double * packed, double * full)
+    {
+        full[0] = packed[0]; full[1] = packed[1]; full[2] = packed[2];
+        full[3] = packed[1]; full[4] = packed[3]; full[5] = packed[4];
+        full[6] = packed[2]; full[7] = packed[4]; full[8] = packed[5];
+    }
+
+    /**
+     * out = X^{-1}*v, with X the motion transform of the transform (R,p) and v a motion vector.
+     */
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void inverseTransformMotion(const double * R, const double * p,
+                                                                const double * vLin, const double * vAng,
+                                                                double * outLin, double * outAng);
+
+    /**
+     * out = X^T*f = (X^*)^{-1} f, with X the motion transform of the transform (R,p) and f a force vector.
+     */
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void inverseTransformForce(const double * R, const double * p,
+                                                               const double * fLin, const double * fAng,
+                                                               double * outLin, double * outAng);
+
+    /**
+     * out = v \times u, with v and u motion vectors.
+     */
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void crossMotion(const double * vLin, const double * vAng,
+                                                     const double * uLin, const double * uAng,
+                                                     double * outLin, double * outAng);
+
+    /**
+     * out = v \bar{\times}^* f, with v a motion vector and f a force vector.
+     */
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void crossForce(const double * vLin, const double * vAng,
+                                                    const double * fLin, const double * fAng,
+                                                    double * outLin, double * outAng);
+
+    /**
+     * out = I*v, with I the spatial inertia stored in its 10 inertial parameters
+     * (see SpatialInertiaRaw for the layout) and v a motion vector.
+     */
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void spatialInertiaTimesMotion(const double * inertia,
+                                                                   const double * vLin, const double * vAng,
+                                                                   double * outLin, double * outAng);
+
+    /**
+     * out = v \bar{\times}^* (I*v), with I the spatial inertia stored in its 10 inertial parameters
+     * and v a motion vector.
+     */
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void spatialInertiaBiasWrench(const double * inertia,
+                                                                  const double * vLin, const double * vAng,
+                                                                  double * outLin, double * outAng);
+
+    /**
+     * out = I*a + v \bar{\times}^* (I*v), with I the spatial inertia stored in its 10 inertial parameters,
+     * a and v motion vectors.
+     */
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void spatialInertiaNetWrench(const double * inertia,
+                                                                 const double * aLin, const double * aAng,
+                                                                 const double * vLin, const double * vAng,
+                                                                 double * outLin, double * outAng);
+}
+}
+}
+
+#if !defined(IDYNTREE_USES_AVX2_SPATIAL_KERNELS)
+#include "SpatialAlgebraKernelsImpl.h"
+#endif
+
+#endif
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_INTERNAL_SPATIAL_ALGEBRA_KERNELS_IMPL_H
+#define IDYNTREE_INTERNAL_SPATIAL_ALGEBRA_KERNELS_IMPL_H
+
+/**
+ * Definitions of the kernels declared in SpatialAlgebraKernels.h , implemented on top of a
+ * minimal set of 3d vector operations:
+ *  - in the scalar implementation, this header is included by SpatialAlgebraKernels.h
+ *    and the kernels are inline,
+ *  - in the AVX2/FMA implementation, this header is included only by SpatialAlgebraKernelsAVX2.cpp ,
+ *    and each 3d vector is stored in a 256 bit register whose fourth lane is always zero.
+ */
+
+#include "SpatialAlgebraKernels.h"
+
+#if defined(IDYNTREE_USES_AVX2_SPATIAL_KERNELS)
+#include <immintrin.h>
+#endif
+
+namespace iDynTree
+{
+namespace internal
+{
+namespace kernels
+{
+
+#if defined(IDYNTREE_USES_AVX2_SPATIAL_KERNELS)
+
+    typedef __m256d Vec3;
+
+    inline __m256i mask3()
+    {
+        return _mm256_set_epi64x(0,-1,-1,-1);
+    }
+
+    inline Vec3 load3(const double * v)
+    {
+        return _mm256_maskload_pd(v,mask3());
+    }
+
+    inline void store3(double * out, const Vec3 v)
+    {
+        _mm256_maskstore_pd(out,mask3(),v);
+    }
+
+    inline Vec3 add3(const Vec3 a, const Vec3 b)
+    {
+        return _mm256_add_pd(a,b);
+    }
+
+    inline Vec3 sub3(const Vec3 a, const Vec3 b)
+    {
+        return _mm256_sub_pd(a,b);
+    }
+
+    inline Vec3 scale3(const double s, const Vec3 a)
+    {
+        return _mm256_mul_pd(_mm256_set1_pd(s),a);
+    }
+
+    inline Vec3 cross3(const Vec3 a, const Vec3 b)
+    {
+        // a x b = a_yzx .* b_zxy - a_zxy .* b_yzx
+        const Vec3 a_yzx = _mm256_permute4x64_pd(a,_MM_SHUFFLE(3,0,2,1));
+        const Vec3 b_zxy = _mm256_permute4x64_pd(b,_MM_SHUFFLE(3,1,0,2));
+        const Vec3 a_zxy = _mm256_permute4x64_pd(a,_MM_SHUFFLE(3,1,0,2));
+        const Vec3 b_yzx = _mm256_permute4x64_pd(b,_MM_SHUFFLE(3,0,2,1));
+        return _mm256_fmsub_pd(a_yzx,b_zxy,_mm256_mul_pd(a_zxy,b_yzx));
+    }
+
+    /** M*v , with M a row major 3x3 matrix */
+    inline Vec3 mulMat3(const double * M, const Vec3 v)
+    {
+        const Vec3 p0 = _mm256_mul_pd(load3(M),v);
+        const Vec3 p1 = _mm256_mul_pd(load3(M+3),v);
+        const Vec3 p2 = _mm256_mul_pd(load3(M+6),v);
+        // h01 = (p0_0+p0_1, p1_0+p1_1, p0_2, p1_2) , h2 = (p2_0+p2_1, 0, p2_2, 0)
+        const Vec3 h01 = _mm256_hadd_pd(p0,p1);
+        const Vec3 h2  = _mm256_hadd_pd(p2,_mm256_setzero_pd());
+        return _mm256_add_pd(_mm256_permute2f128_pd(h01,h2,0x20),_mm256_permute2f128_pd(h01,h2,0x31));
+    }
+
+    /** M^T*v , with M a row major 3x3 matrix */
+    inline Vec3 mulMat3Transpose(const double * M, const Vec3 v)
+    {
+        Vec3 ret = _mm256_mul_pd(load3(M),_mm256_permute4x64_pd(v,_MM_SHUFFLE(3,0,0,0)));
+        ret = _mm256_fmadd_pd(load3(M+3),_mm256_permute4x64_pd(v,_MM_SHUFFLE(3,1,1,1)),ret);
+        return _mm256_fmadd_pd(load3(M+6),_mm256_permute4x64_pd(v,_MM_SHUFFLE(3,2,2,2)),ret);
+    }
+
+    /** S*v , with S a symmetric 3x3 matrix stored as in unpackSymmetric3 */
+    inline Vec3 mulSym3(const double * S, const Vec3 v)
+    {
+        double full[9];
+        unpackSymmetric3(S,full);
+        return mulMat3(full,v);
+    }
+
+#else
+
+    struct Vec3
+    {
+        double x, y, z;
+    };
+
+    inline Vec3 load3(const double * v)
+    {
+        Vec3 ret = {v[0], v[1], v[2]};
+        return ret;
+    }
+
+    inline void store3(double * out, const Vec3 v)
+    {
+        out[0] = v.x;
+        out[1] = v.y;
+        out[2] = v.z;
+    }
+
+    inline Vec3 add3(const Vec3 a, const Vec3 b)
+    {
+        Vec3 ret = {a.x+b.x, a.y+b.y, a.z+b.z};
+        return ret;
+    }
+
+    inline Vec3 sub3(const Vec3 a, const Vec3 b)
+    {
+        Vec3 ret = {a.x-b.x, a.y-b.y, a.z-b.z};
+        return ret;
+    }
+
+    inline Vec3 scale3(const double s, const Vec3 a)
+    {
+        Vec3 ret = {s*a.x, s*a.y, s*a.z};
+        return ret;
+    }
+
+    inline Vec3 cross3(const Vec3 a, const Vec3 b)
+    {
+        Vec3 ret = {a.y*b.z-a.z*b.y, a.z*b.x-a.x*b.z, a.x*b.y-a.y*b.x};
+        return ret;
+    }
+
+    /** M*v , with M a row major 3x3 matrix */
+    inline Vec3 mulMat3(const double * M, const Vec3 v)
+    {
+        Vec3 ret = {M[0]*v.x+M[1]*v.y+M[2]*v.z,
+                    M[3]*v.x+M[4]*v.y+M[5]*v.z,
+                    M[6]*v.x+M[7]*v.y+M[8]*v.z};
+        return ret;
+    }
+
+    /** M^T*v , with M a row major 3x3 matrix */
+    inline Vec3 mulMat3Transpose(const double * M, const Vec3 v)
+    {
+        Vec3 ret = {M[0]*v.x+M[3]*v.y+M[6]*v.z,
+                    M[1]*v.x+M[4]*v.y+M[7]*v.z,
+                    M[2]*v.x+M[5]*v.y+M[8]*v.z};
+        return ret;
+    }
+
+    /** S*v , with S a symmetric 3x3 matrix stored as in unpackSymmetric3 */
+    inline Vec3 mulSym3(const double * S, const Vec3 v)
+    {
+        Vec3 ret = {S[0]*v.x+S[1]*v.y+S[2]*v.z,
+                    S[1]*v.x+S[3]*v.y+S[4]*v.z,
+                    S[2]*v.x+S[4]*v.y+S[5]*v.z};
+        return ret;
+    }
+
+#endif
+
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void inverseTransformMotion(const double * R, const double * p,
+                                                                const double * vLin, const double * vAng,
+                                                                double * outLin, double * outAng)
+    {
+        const Vec3 ang = load3(vAng);
+        store3(outLin,mulMat3Transpose(R,sub3(load3(vLin),cross3(load3(p),ang))));
+        store3(outAng,mulMat3Transpose(R,ang));
+    }
+
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void inverseTransformForce(const double * R, const double * p,
+                                                               const double * fLin, const double * fAng,
+                                                               double * outLin, double * outAng)
+    {
+        const Vec3 lin = load3(fLin);
+        store3(outAng,mulMat3Transpose(R,sub3(load3(fAng),cross3(load3(p),lin))));
+        store3(outLin,mulMat3Transpose(R,lin));
+    }
+
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void crossMotion(const double * vLin, const double * vAng,
+                                                     const double * uLin, const double * uAng,
+                                                     double * outLin, double * outAng)
+    {
+        const Vec3 vAngVec = load3(vAng);
+        const Vec3 uAngVec = load3(uAng);
+        const Vec3 lin = add3(cross3(vAngVec,load3(uLin)),cross3(load3(vLin),uAngVec));
+        store3(outAng,cross3(vAngVec,uAngVec));
+        store3(outLin,lin);
+    }
+
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void crossForce(const double * vLin, const double * vAng,
+                                                    const double * fLin, const double * fAng,
+                                                    double * outLin, double * outAng)
+    {
+        const Vec3 vAngVec = load3(vAng);
+        const Vec3 fLinVec = load3(fLin);
+        const Vec3 ang = add3(cross3(load3(vLin),fLinVec),cross3(vAngVec,load3(fAng)));
+        store3(outLin,cross3(vAngVec,fLinVec));
+        store3(outAng,ang);
+    }
+
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void spatialInertiaTimesMotion(const double * inertia,
+                                                                   const double * vLin, const double * vAng,
+                                                                   double * outLin, double * outAng)
+    {
+        const Vec3 c = load3(inertia+1);
+        const Vec3 vLinVec = load3(vLin);
+        const Vec3 vAngVec = load3(vAng);
+        store3(outLin,sub3(scale3(inertia[0],vLinVec),cross3(c,vAngVec)));
+        store3(outAng,add3(cross3(c,vLinVec),mulSym3(inertia+4,vAngVec)));
+    }
+
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void spatialInertiaBiasWrench(const double * inertia,
+                                                                  const double * vLin, const double * vAng,
+                                                                  double * outLin, double * outAng)
+    {
+        const double mass = inertia[0];
+        const Vec3 c = load3(inertia+1);
+        const Vec3 vLinVec = load3(vLin);
+        const Vec3 vAngVec = load3(vAng);
+
+        // h = I*v
+        const Vec3 hLin = sub3(scale3(mass,vLinVec),cross3(c,vAngVec));
+        const Vec3 hAng = add3(cross3(c,vLinVec),mulSym3(inertia+4,vAngVec));
+
+        store3(outLin,cross3(vAngVec,hLin));
+        store3(outAng,add3(cross3(vLinVec,hLin),cross3(vAngVec,hAng)));
+    }
+
+    IDYNTREE_SPATIAL_ALGEBRA_KERNEL void spatialInertiaNetWrench(const double * inertia,
+                                                                 const double * aLin, const double * aAng,
+                                                                 const double * vLin, const double * vAng,
+                                                                 double * outLin, double * outAng)
+    {
+        const double mass = inertia[0];
+        const Vec3 c = load3(inertia+1);
+        const Vec3 vLinVec = load3(vLin);
+        const Vec3 vAngVec = load3(vAng);
+        const Vec3 aLinVec = load3(aLin);
+        const Vec3 aAngVec = load3(aAng);
+
+        double rotInertia[9];
+        unpackSymmetric3(inertia+4,rotInertia);
+
+        // h = I*v
+        const Vec3 hLin = sub3(scale3(mass,vLinVec),cross3(c,vAngVec));
+        const Vec3 hAng = add3(cross3(c,vLinVec),mulMat3(rotInertia,vAngVec));
+
+        // I*a + v \bar{\times}^* h
+        store3(outLin,add3(sub3(scale3(mass,aLinVec),cross3(c,aAngVec)),cross3(vAngVec,hLin)));
+        store3(outAng,add3(add3(cross3(c,aLinVec),mulMat3(rotInertia,aAngVec)),
+                           add3(cross3(vLinVec,hLin),cross3(vAngVec,hAng))));
+    }
+
+}
+}
+}
+
+#endif
@@ -13,6 +13,7 @@
 #include <iDynTree/Core/SpatialInertia.h>
 #include <iDynTree/Core/SpatialAcc.h>
 #include <iDynTree/Core/Wrench.h>
+#include <iDynTree/Core/Transform.h>
 
 #include <iDynTree/Core/EigenHelpers.h>
 
@@ -22,30 +23,39 @@
 #include <sstream>
 
 #include <cassert>
+#include <cstring>
+
+#include "SpatialAlgebraKernels.h"
 
 typedef Eigen::Matrix<double,3,3,Eigen::RowMajor> Matrix3dRowMajor;
 typedef Eigen::Matrix<double,6,6,Eigen::RowMajor> Matrix6dRowMajor;
 
-// \todo TODO have a unique mySkew
-template<class Derived>
-inline Eigen::Matrix<typename Derived::Scalar, 3, 3> mySkewABI(const Eigen::MatrixBase<Derived> & vec)
+namespace iDynTree
 {
-    EIGEN_STATIC_ASSERT_VECTOR_SPECIFIC_SIZE(Derived, 3);
-    return (Eigen::Matrix<typename Derived::Scalar, 3, 3>() << 0.0, -vec[2], vec[1], vec[2], 0.0, -vec[0], -vec[1], vec[0], 0.0).finished();
-}
 
+// Offsets of the blocks in the packed buffer
+static const unsigned int LINEAR_LINEAR_OFFSET = 0;
+static const unsigned int LINEAR_ANGULAR_OFFSET = 6;
+static const unsigned int ANGULAR_ANGULAR_OFFSET = 15;
 
-namespace iDynTree
+/**
+ * Store the upper triangular part of the 3x3 block of a 6x6 matrix starting at (row,col)
+ */
+template<typename MatrixType>
+inline void packSymmetricBlock(const MatrixType & mat, const int row, const int col, double * packed)
 {
+    packed[0] = mat(row,col);   packed[1] = mat(row,col+1);   packed[2] = mat(row,col+2);
+                                packed[3] = mat(row+1,col+1); packed[4] = mat(row+1,col+2);
+                                                              packed[5] = mat(row+2,col+2);
+}
 
 ArticulatedBodyInertia::ArticulatedBodyInertia()
 {
 }
 
-ArticulatedBodyInertia::ArticulatedBodyInertia(const ArticulatedBodyInertia& other):
-    linearLinear(other.linearLinear), linearAngular(other.linearAngular), angularAngular(other.angularAngular)
+ArticulatedBodyInertia::ArticulatedBodyInertia(const ArticulatedBodyInertia& other)
 {
-
+    std::memcpy(m_packed,other.m_packed,PackedSize*sizeof(double));
 }
 
 ArticulatedBodyInertia::ArticulatedBodyInertia(const SpatialInertia& rigidBodyInertia)
@@ -53,9 +63,9 @@ ArticulatedBodyInertia::ArticulatedBodyInertia(const SpatialInertia& rigidBodyIn
     Matrix6x6 rbi = rigidBodyInertia.asMatrix();
     Eigen::Map<Matrix6dRowMajor> rbiEigen(rbi.data());
 
-    toEigen(linearLinear)  = rbiEigen.block<3,3>(0,0);
-    toEigen(linearAngular) = rbiEigen.block<3,3>(0,3);
-    toEigen(angularAngular) = rbiEigen.block<3,3>(3,3);
+    packSymmetricBlock(rbiEigen,0,0,m_packed+LINEAR_LINEAR_OFFSET);
+    Eigen::Map<Matrix3dRowMajor>(m_packed+LINEAR_ANGULAR_OFFSET) = rbiEigen.block<3,3>(0,3);
+    packSymmetricBlock(rbiEigen,3,3,m_packed+ANGULAR_ANGULAR_OFFSET);
 }
 
 ArticulatedBodyInertia::ArticulatedBodyInertia(const double* in_data,
@@ -64,9 +74,9 @@ ArticulatedBodyInertia::ArticulatedBodyInertia(const double* in_data,
 {
     Eigen::Map<const Matrix6dRowMajor> rbiEigen(in_data);
 
-    toEigen(linearLinear)  = rbiEigen.block<3,3>(0,0);
-    toEigen(linearAngular) = rbiEigen.block<3,3>(0,3);
-    toEigen(angularAngular) = rbiEigen.block<3,3>(3,3);
+    packSymmetricBlock(rbiEigen,0,0,m_packed+LINEAR_LINEAR_OFFSET);
+    Eigen::Map<Matrix3dRowMajor>(m_packed+LINEAR_ANGULAR_OFFSET) = rbiEigen.block<3,3>(0,3);
+    packSymmetricBlock(rbiEigen,3,3,m_packed+ANGULAR_ANGULAR_OFFSET);
 }
 
 Matrix6x6 ArticulatedBodyInertia::asMatrix() const
@@ -75,10 +85,15 @@ Matrix6x6 ArticulatedBodyInertia::asMatrix() const
 
     Eigen::Map<Matrix6dRowMajor> retMatEigen(retMat.data());
 
-    retMatEigen.block<3,3>(0,0) = toEigen(linearLinear);
-    retMatEigen.block<3,3>(0,3) = toEigen(linearAngular);
-    retMatEigen.block<3,3>(3,0) = toEigen(linearAngular).transpose();
-    retMatEigen.block<3,3>(3,3) = toEigen(angularAngular);
+    Matrix3dRowMajor linearLinear, angularAngular;
+    internal::kernels::unpackSymmetric3(m_packed+LINEAR_LINEAR_OFFSET,linearLinear.data());
+    internal::kernels::unpackSymmetric3(m_packed+ANGULAR_ANGULAR_OFFSET,angularAngular.data());
+    Eigen::Map<const Matrix3dRowMajor> linearAngular(m_packed+LINEAR_ANGULAR_OFFSET);
+
+    retMatEigen.block<3,3>(0,0) = linearLinear;
+    retMatEigen.block<3,3>(0,3) = linearAngular;
+    retMatEigen.block<3,3>(3,0) = linearAngular.transpose();
+    retMatEigen.block<3,3>(3,3) = angularAngular;
 
     return retMat;
 }
@@ -88,9 +103,10 @@ ArticulatedBodyInertia ArticulatedBodyInertia::combine(const ArticulatedBodyIner
 {
     ArticulatedBodyInertia retABI;
 
-    toEigen(retABI.linearLinear) = toEigen(op1.linearLinear) + toEigen(op2.linearLinear);
-    toEigen(retABI.linearAngular) = toEigen(op1.linearAngular) + toEigen(op2.linearAngular);
-    toEigen(retABI.angularAngular) = toEigen(op1.angularAngular) + toEigen(op2.angularAngular);
+    for (unsigned int el = 0; el < PackedSize; el++)
+    {
+        retABI.m_packed[el] = op1.m_packed[el] + op2.m_packed[el];
+    }
 
     return retABI;
 }
@@ -100,14 +116,9 @@ SpatialAcc ArticulatedBodyInertia::applyInverse(const Wrench& wrench) const
     SpatialAcc acc;
 
     Eigen::Matrix<double,6,1> wrenchEigen = toEigen(wrench.asVector());
-    Eigen::Matrix<double,6,6> abi;
-
-    abi.block<3,3>(0,0) = toEigen(linearLinear);
-    abi.block<3,3>(0,3) = toEigen(linearAngular);
-    abi.block<3,3>(3,0) = toEigen(linearAngular).transpose();
-    abi.block<3,3>(3,3) = toEigen(angularAngular);
+    Matrix6x6 abi = this->asMatrix();
 
-    Eigen::Matrix<double,6,1> accEigen = abi.householderQr().solve(wrenchEigen);
+    Eigen::Matrix<double,6,1> accEigen = toEigen(abi).householderQr().solve(wrenchEigen);
 
     toEigen(acc.getLinearVec3()) = accEigen.block<3,1>(0,0);
     toEigen(acc.getAngularVec3()) = accEigen.block<3,1>(3,0);
@@ -119,48 +130,55 @@ Matrix6x6 ArticulatedBodyInertia::getInverse() const
 {
     Matrix6x6 ret;
 
-    Eigen::Matrix<double,6,6> abi;
+    Matrix6x6 abi = this->asMatrix();
 
-    abi.block<3,3>(0,0) = toEigen(linearLinear);
-    abi.block<3,3>(0,3) = toEigen(linearAngular);
-    abi.block<3,3>(3,0) = toEigen(linearAngular).transpose();
-    abi.block<3,3>(3,3) = toEigen(angularAngular);
-
-    toEigen(ret) = abi.inverse();
+    toEigen(ret) = toEigen(abi).inverse();
 
     return ret;
 }
 
+Matrix3x3 ArticulatedBodyInertia::getLinearLinearSubmatrix() const
+{
+    Matrix3x3 ret;
+    internal::kernels::unpackSymmetric3(m_packed+LINEAR_LINEAR_OFFSET,ret.data());
+    return ret;
+}
 
+Matrix3x3 ArticulatedBodyInertia::getLinearAngularSubmatrix() const
+{
+    return Matrix3x3(m_packed+LINEAR_ANGULAR_OFFSET,3,3);
+}
 
-Matrix3x3& ArticulatedBodyInertia::getLinearLinearSubmatrix()
+Matrix3x3 ArticulatedBodyInertia::getAngularAngularSubmatrix() const
 {
-    return linearLinear;
+    Matrix3x3 ret;
+    internal::kernels::unpackSymmetric3(m_packed+ANGULAR_ANGULAR_OFFSET,ret.data());
+    return ret;
 }
 
-const Matrix3x3& ArticulatedBodyInertia::getLinearLinearSubmatrix() const
+void ArticulatedBodyInertia::setLinearLinearSubmatrix(const Matrix3x3& linearLinear)
 {
-    return linearLinear;
+    packSymmetricBlock(linearLinear,0,0,m_packed+LINEAR_LINEAR_OFFSET);
 }
 
-Matrix3x3& ArticulatedBodyInertia::getAngularAngularSubmatrix()
+void ArticulatedBodyInertia::setLinearAngularSubmatrix(const Matrix3x3& linearAngular)
 {
-    return angularAngular;
+    std::memcpy(m_packed+LINEAR_ANGULAR_OFFSET,linearAngular.data(),9*sizeof(double));
 }
 
-const Matrix3x3& ArticulatedBodyInertia::getAngularAngularSubmatrix() const
+void ArticulatedBodyInertia::setAngularAngularSubmatrix(const Matrix3x3& angularAngular)
 {
-    return angularAngular;
+    packSymmetricBlock(angularAngular,0,0,m_packed+ANGULAR_ANGULAR_OFFSET);
 }
 
-Matrix3x3& ArticulatedBodyInertia::getLinearAngularSubmatrix()
+double* ArticulatedBodyInertia::packedData()
 {
-    return linearAngular;
+    return m_packed;
 }
 
-const Matrix3x3& ArticulatedBodyInertia::getLinearAngularSubmatrix() const
+const double* ArticulatedBodyInertia::packedData() const
 {
-    return linearAngular;
+    return m_packed;
 }
 
 ArticulatedBodyInertia ArticulatedBodyInertia::operator+(const ArticulatedBodyInertia& other) const
@@ -172,68 +190,138 @@ ArticulatedBodyInertia ArticulatedBodyInertia::operator-(const ArticulatedBodyIn
 {
     ArticulatedBodyInertia retABI;
 
-    toEigen(retABI.linearLinear)   = toEigen(this->linearLinear)   - toEigen(other.linearLinear);
-    toEigen(retABI.linearAngular)  = toEigen(this->linearAngular)  - toEigen(other.linearAngular);
-    toEigen(retABI.angularAngular) = toEigen(this->angularAngular) - toEigen(other.angularAngular);
+    for (unsigned int el = 0; el < PackedSize; el++)
+    {
+        retABI.m_packed[el] = this->m_packed[el] - other.m_packed[el];
+    }
 
     return retABI;
 }
 
 ArticulatedBodyInertia& ArticulatedBodyInertia::operator+=(const ArticulatedBodyInertia& other)
 {
-    toEigen(this->linearLinear)    = toEigen(this->linearLinear)   + toEigen(other.linearLinear);
-    toEigen(this->linearAngular)   = toEigen(this->linearAngular)  + toEigen(other.linearAngular);
-    toEigen(this->angularAngular)  = toEigen(this->angularAngular) + toEigen(other.angularAngular);
+    for (unsigned int el = 0; el < PackedSize; el++)
+    {
+        this->m_packed[el] += other.m_packed[el];
+    }
 
     return *this;
 }
 
+/**
+ * Compute the product of the packed articulated body inertia with a 6d vector
+ */
+inline void packedArticulatedBodyInertiaProduct(const double * packed,
+                                                const double * inLin, const double * inAng,
+                                                double * outLin, double * outAng)
+{
+    const double * LL = packed+LINEAR_LINEAR_OFFSET;
+    const double * LA = packed+LINEAR_ANGULAR_OFFSET;
+    const double * AA = packed+ANGULAR_ANGULAR_OFFSET;
+
+    const double l0 = inLin[0], l1 = inLin[1], l2 = inLin[2];
+    const double a0 = inAng[0], a1 = inAng[1], a2 = inAng[2];
+
+    outLin[0] = LL[0]*l0 + LL[1]*l1 + LL[2]*l2 + LA[0]*a0 + LA[1]*a1 + LA[2]*a2;
+    outLin[1] = LL[1]*l0 + LL[3]*l1 + LL[4]*l2 + LA[3]*a0 + LA[4]*a1 + LA[5]*a2;
+    outLin[2] = LL[2]*l0 + LL[4]*l1 + LL[5]*l2 + LA[6]*a0 + LA[7]*a1 + LA[8]*a2;
+
+    outAng[0] = LA[0]*l0 + LA[3]*l1 + LA[6]*l2 + AA[0]*a0 + AA[1]*a1 + AA[2]*a2;
+    outAng[1] = LA[1]*l0 + LA[4]*l1 + LA[7]*l2 + AA[1]*a0 + AA[3]*a1 + AA[4]*a2;
+    outAng[2] = LA[2]*l0 + LA[5]*l1 + LA[8]*l2 + AA[2]*a0 + AA[4]*a1 + AA[5]*a2;
+}
+
 Wrench ArticulatedBodyInertia::operator*(const SpatialAcc& other) const
 {
     Wrench ret;
 
-    toEigen(ret.getLinearVec3()) =   toEigen(this->linearLinear)*toEigen(other.getLinearVec3())
-                                   + toEigen(this->linearAngular)*toEigen(other.getAngularVec3());
+    packedArticulatedBodyInertiaProduct(m_packed,
+                                        other.getLinearVec3().data(),other.getAngularVec3().data(),
+                                        ret.getLinearVec3().data(),ret.getAngularVec3().data());
 
-    toEigen(ret.getAngularVec3()) =   toEigen(this->linearAngular).transpose()*toEigen(other.getLinearVec3())
-                                   + toEigen(this->angularAngular)*toEigen(other.getAngularVec3());
     return ret;
-
 }
 
 SpatialForceVector ArticulatedBodyInertia::operator*(const SpatialMotionVector& other) const
 {
     SpatialForceVector ret;
 
-    toEigen(ret.getLinearVec3()) =   toEigen(this->linearLinear)*toEigen(other.getLinearVec3())
-                                   + toEigen(this->linearAngular)*toEigen(other.getAngularVec3());
-
-    toEigen(ret.getAngularVec3()) =   toEigen(this->linearAngular).transpose()*toEigen(other.getLinearVec3())
-                                   + toEigen(this->angularAngular)*toEigen(other.getAngularVec3());
+    packedArticulatedBodyInertiaProduct(m_packed,
+                                        other.getLinearVec3().data(),other.getAngularVec3().data(),
+                                        ret.getLinearVec3().data(),ret.getAngularVec3().data());
 
     return ret;
 }
 
 void ArticulatedBodyInertia::zero()
 {
-    this->linearLinear.zero();
-    this->linearAngular.zero();
-    this->angularAngular.zero();
+    for (unsigned int el = 0; el < PackedSize; el++)
+    {
+        m_packed[el] = 0.0;
+    }
 }
 
+void ArticulatedBodyInertia::addTransformed(const Transform& a_X_b, const ArticulatedBodyInertia& b_abi)
+{
+    const ArticulatedBodyInertia a_abi = a_X_b*b_abi;
 
-ArticulatedBodyInertia ArticulatedBodyInertia::ABADyadHelper(const SpatialForceVector& U, const double d)
+    for (unsigned int el = 0; el < PackedSize; el++)
+    {
+        this->m_packed[el] += a_abi.m_packed[el];
+    }
+}
+
+/**
+ * Add to the packed articulated body inertia the (possibly unsymmetric) sum of dyads
+ * \f$ \sum_i x_i y_i^\top \f$ , of which only the elements in the packed storage are computed.
+ */
+inline void addPackedDyads(const double * x0, const double * y0, const double scale0,
+                           const double * x1, const double * y1, const double scale1,
+                           const double * x2, const double * y2, const double scale2,
+                           double * packed)
 {
-    ArticulatedBodyInertia ret;
+    for (int row = 0; row < 6; row++)
+    {
+        for (int col = row; col < 6; col++)
+        {
+            double value = scale0*x0[row]*y0[col];
+            if (x1)
+            {
+                value += scale1*x1[row]*y1[col] + scale2*x2[row]*y2[col];
+            }
+
+            if (col < 3)
+            {
+                // linearLinear block
+                packed[LINEAR_LINEAR_OFFSET+row*(5-row)/2+col] += value;
+            }
+            else if (row < 3)
+            {
+                // linearAngular block
+                packed[LINEAR_ANGULAR_OFFSET+3*row+col-3] += value;
+            }
+            else
+            {
+                // angularAngular block
+                packed[ANGULAR_ANGULAR_OFFSET+(row-3)*(5-(row-3))/2+col-3] += value;
+            }
+        }
+    }
+}
 
-    double inv_d = 1.0/d;
+void ArticulatedBodyInertia::subtractABADyad(const SpatialForceVector& U, const double d)
+{
+    const double U6[6] = {U(0), U(1), U(2), U(3), U(4), U(5)};
+    addPackedDyads(U6,U6,-1.0/d,0,0,0.0,0,0,0.0,m_packed);
+}
 
-    Eigen::Map<const Eigen::Vector3d> Ulin(U.getLinearVec3().data());
-    Eigen::Map<const Eigen::Vector3d> Uang(U.getAngularVec3().data());
+ArticulatedBodyInertia ArticulatedBodyInertia::ABADyadHelper(const SpatialForceVector& U, const double d)
+{
+    ArticulatedBodyInertia ret;
+    ret.zero();
 
-    toEigen(ret.getLinearLinearSubmatrix()) = (inv_d*Ulin)*Ulin.transpose();
-    toEigen(ret.getLinearAngularSubmatrix()) = (inv_d*Ulin)*Uang.transpose();
-    toEigen(ret.getAngularAngularSubmatrix()) = (inv_d*Uang)*Uang.transpose();
+    const double U6[6] = {U(0), U(1), U(2), U(3), U(4), U(5)};
+    addPackedDyads(U6,U6,1.0/d,0,0,0.0,0,0,0.0,ret.m_packed);
 
     return ret;
 }
@@ -242,28 +330,14 @@ ArticulatedBodyInertia ArticulatedBodyInertia::ABADyadHelperLin(const SpatialFor
                                                                 const SpatialForceVector& /*dU*/, const double d_inv_d)
 {
     ArticulatedBodyInertia ret;
+    ret.zero();
 
-    Eigen::Map<const Eigen::Vector3d> Ulin(U.getLinearVec3().data());
-    Eigen::Map<const Eigen::Vector3d> Uang(U.getAngularVec3().data());
+    const double U6[6] = {U(0), U(1), U(2), U(3), U(4), U(5)};
+    const double * dU6 = U6;
 
-    Eigen::Map<const Eigen::Vector3d> dUlin(U.getLinearVec3().data());
-    Eigen::Map<const Eigen::Vector3d> dUang(U.getAngularVec3().data());
-
-    toEigen(ret.getLinearLinearSubmatrix()) =   (d_inv_d*Ulin)*Ulin.transpose()
-                                              + (inv_d*dUlin)*Ulin.transpose()
-                                              + (inv_d*Ulin)*dUlin.transpose();
-    toEigen(ret.getLinearAngularSubmatrix()) =  (d_inv_d*Ulin)*Uang.transpose()
-                                              + (inv_d*dUlin)*Uang.transpose()
-                                              + (inv_d*Ulin)*dUang.transpose();
-    toEigen(ret.getAngularAngularSubmatrix()) = (d_inv_d*Uang)*Uang.transpose()
-                                              + (inv_d*dUang)*Uang.transpose()
-                                              + (inv_d*Uang)*dUang.transpose();
+    addPackedDyads(U6,U6,d_inv_d,dU6,U6,inv_d,U6,dU6,inv_d,ret.m_packed);
 
     return ret;
 }
 
-
-
-
-
 }
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Core/CompressedColumnJacobian.h>
+#include <iDynTree/Core/Triplets.h>
+#include <iDynTree/Core/Utils.h>
+
+#include <cassert>
+#include <sstream>
+
+namespace iDynTree
+{
+
+CompressedColumnJacobian::CompressedColumnJacobian(): m_rows(0), m_columns(0), m_outerStarts(1,0)
+{
+}
+
+CompressedColumnJacobian::CompressedColumnJacobian(unsigned rows, unsigned columns): m_rows(rows), m_columns(columns),
+                                                                                     m_outerStarts(columns+1,0)
+{
+}
+
+void CompressedColumnJacobian::resize(unsigned rows, unsigned columns)
+{
+    if (m_rows == rows && m_columns == columns)
+    {
+        return;
+    }
+
+    m_rows = rows;
+    m_columns = columns;
+    m_nonZeroColumns.clear();
+    m_outerStarts.assign(columns+1,0);
+    m_innerIndices.clear();
+    m_values.resize(0);
+}
+
+bool CompressedColumnJacobian::setNonZeroColumns(const std::vector<int>& nonZeroColumns)
+{
+    // If the pattern did not changed, we have nothing to do
+    if (nonZeroColumns == m_nonZeroColumns)
+    {
+        return true;
+    }
+
+    for (size_t k = 0; k < nonZeroColumns.size(); k++)
+    {
+        if (nonZeroColumns[k] < 0 || nonZeroColumns[k] >= static_cast<int>(m_columns) ||
+            (k > 0 && nonZeroColumns[k] <= nonZeroColumns[k-1]))
+        {
+            reportError("CompressedColumnJacobian","setNonZeroColumns","Column indices are out of bounds or not sorted");
+            return false;
+        }
+    }
+
+    m_nonZeroColumns = nonZeroColumns;
+
+    // Fill the outer starts: each nonzero column contains m_rows elements
+    size_t nextNonZeroColumn = 0;
+    int nnz = 0;
+    for (unsigned col = 0; col < m_columns; col++)
+    {
+        m_outerStarts[col] = nnz;
+        if (nextNonZeroColumn < m_nonZeroColumns.size() &&
+            m_nonZeroColumns[nextNonZeroColumn] == static_cast<int>(col))
+        {
+            nnz += m_rows;
+            nextNonZeroColumn++;
+        }
+    }
+    m_outerStarts[m_columns] = nnz;
+
+    m_innerIndices.resize(nnz);
+    for (int el = 0; el < nnz; el++)
+    {
+        m_innerIndices[el] = el % m_rows;
+    }
+
+    m_values.resize(nnz);
+    m_values.zero();
+
+    return true;
+}
+
+const std::vector<int>& CompressedColumnJacobian::getNonZeroColumns() const
+{
+    return m_nonZeroColumns;
+}
+
+unsigned CompressedColumnJacobian::getNrOfNonZeroColumns() const
+{
+    return m_nonZeroColumns.size();
+}
+
+double* CompressedColumnJacobian::nonZeroColumnBuffer(unsigned k)
+{
+    assert(k < m_nonZeroColumns.size());
+    return m_values.data() + k*m_rows;
+}
+
+const double* CompressedColumnJacobian::nonZeroColumnBuffer(unsigned k) const
+{
+    assert(k < m_nonZeroColumns.size());
+    return m_values.data() + k*m_rows;
+}
+
+void CompressedColumnJacobian::zero()
+{
+    m_values.zero();
+}
+
+unsigned CompressedColumnJacobian::rows() const
+{
+    return m_rows;
+}
+
+unsigned CompressedColumnJacobian::columns() const
+{
+    return m_columns;
+}
+
+unsigned CompressedColumnJacobian::numberOfNonZeros() const
+{
+    return m_values.size();
+}
+
+double* CompressedColumnJacobian::valuesBuffer()
+{
+    return m_values.data();
+}
+
+const double* CompressedColumnJacobian::valuesBuffer() const
+{
+    return m_values.data();
+}
+
+int* CompressedColumnJacobian::innerIndicesBuffer()
+{
+    return m_innerIndices.data();
+}
+
+const int* CompressedColumnJacobian::innerIndicesBuffer() const
+{
+    return m_innerIndices.data();
+}
+
+int* CompressedColumnJacobian::outerIndicesBuffer()
+{
+    return m_outerStarts.data();
+}
+
+const int* CompressedColumnJacobian::outerIndicesBuffer() const
+{
+    return m_outerStarts.data();
+}
+
+void CompressedColumnJacobian::toSparseMatrix(SparseMatrix<iDynTree::ColumnMajor>& sparseMatrix) const
+{
+    // The outer starts, inner indices and values of the jacobian are already
+    // the compressed column storage of the matrix: copy them without sorting
+    sparseMatrix.m_isSparsityPatternFrozen = false;
+    sparseMatrix.m_rows = m_rows;
+    sparseMatrix.m_columns = m_columns;
+    sparseMatrix.m_outerStarts = m_outerStarts;
+    sparseMatrix.m_innerIndices = m_innerIndices;
+    sparseMatrix.m_values = m_values;
+    if (sparseMatrix.m_allocatedSize < m_values.size())
+    {
+        sparseMatrix.m_allocatedSize = m_values.size();
+    }
+}
+
+void CompressedColumnJacobian::toSparseMatrix(SparseMatrix<iDynTree::RowMajor>& sparseMatrix) const
+{
+    sparseMatrix.resize(m_rows,m_columns);
+    sparseMatrix.zero();
+
+    Triplets triplets;
+    triplets.reserve(numberOfNonZeros());
+    for (unsigned k = 0; k < m_nonZeroColumns.size(); k++)
+    {
+        const double * column = nonZeroColumnBuffer(k);
+        for (unsigned row = 0; row < m_rows; row++)
+        {
+            triplets.pushTriplet(Triplet(row,m_nonZeroColumns[k],column[row]));
+        }
+    }
+
+    sparseMatrix.setFromTriplets(triplets);
+}
+
+void CompressedColumnJacobian::toDense(MatrixDynSize& denseMatrix) const
+{
+    denseMatrix.resize(m_rows,m_columns);
+    denseMatrix.zero();
+
+    for (unsigned k = 0; k < m_nonZeroColumns.size(); k++)
+    {
+        const double * column = nonZeroColumnBuffer(k);
+        for (unsigned row = 0; row < m_rows; row++)
+        {
+            denseMatrix(row,m_nonZeroColumns[k]) = column[row];
+        }
+    }
+}
+
+std::string CompressedColumnJacobian::toString() const
+{
+    std::stringstream ss;
+    for (unsigned k = 0; k < m_nonZeroColumns.size(); k++)
+    {
+        ss << "Column " << m_nonZeroColumns[k] << ":";
+        const double * column = nonZeroColumnBuffer(k);
+        for (unsigned row = 0; row < m_rows; row++)
+        {
+            ss << " " << column[row];
+        }
+        ss << std::endl;
+    }
+    return ss.str();
+}
+
+}
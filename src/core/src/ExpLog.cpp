@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Core/ExpLog.h>
+#include <iDynTree/Core/Position.h>
+#include <iDynTree/Core/EigenHelpers.h>
+
+#include <Eigen/Dense>
+
+#include <cmath>
+
+namespace iDynTree
+{
+
+namespace
+{
+    // Below this angle the coefficients are computed with their Taylor expansion up to
+    // the eighth order term. At the threshold both the truncation error of the expansion and
+    // the cancellation error of the closed form expressions are around 1e-13 (relative).
+    const double SMALL_ANGLE_THRESHOLD = 0.25;
+
+    typedef Eigen::Matrix<double,6,6,Eigen::RowMajor> Matrix6dRowMajor;
+
+    /**
+     * Coefficients of the left Jacobian of SO(3), J_l = I + a S + b S^2 with S = skew(phi):
+     * a = (1-cos(theta))/theta^2, b = (theta-sin(theta))/theta^3 .
+     * Note that the exponential is exp(S) = I + sin(theta)/theta S + a S^2 .
+     */
+    struct SO3Coefficients
+    {
+        double theta;
+        double sinc;
+        double a;
+        double b;
+
+        SO3Coefficients(const double theta_): theta(theta_)
+        {
+            const double theta2 = theta*theta;
+            if( theta < SMALL_ANGLE_THRESHOLD )
+            {
+                const double theta4 = theta2*theta2;
+                const double theta6 = theta4*theta2;
+                const double theta8 = theta4*theta4;
+                sinc = 1.0 - theta2/6.0 + theta4/120.0 - theta6/5040.0 + theta8/362880.0;
+                a = 0.5 - theta2/24.0 + theta4/720.0 - theta6/40320.0 + theta8/3628800.0;
+                b = 1.0/6.0 - theta2/120.0 + theta4/5040.0 - theta6/362880.0 + theta8/39916800.0;
+            }
+            else
+            {
+                const double sinTheta = std::sin(theta);
+                const double sinHalfTheta = std::sin(0.5*theta);
+                sinc = sinTheta/theta;
+                // 1-cos(theta) = 2 sin^2(theta/2) avoids the cancellation
+                a = 2.0*sinHalfTheta*sinHalfTheta/theta2;
+                b = (theta - sinTheta)/(theta2*theta);
+            }
+        }
+    };
+
+    // Coefficient of S^2 in the inverse of the left Jacobian, J_l^-1 = I - S/2 + c S^2:
+    // c = 1/theta^2 - (1+cos(theta))/(2 theta sin(theta)) = 1/theta^2 - 1/(2 theta tan(theta/2))
+    double inverseJacobianCoefficient(const double theta)
+    {
+        const double theta2 = theta*theta;
+        if( theta < SMALL_ANGLE_THRESHOLD )
+        {
+            const double theta4 = theta2*theta2;
+            return 1.0/12.0 + theta2/720.0 + theta4/30240.0 + theta4*theta2/1209600.0 + theta4*theta4/47900160.0;
+        }
+        else
+        {
+            return 1.0/theta2 - 1.0/(2.0*theta*std::tan(0.5*theta));
+        }
+    }
+
+    Eigen::Matrix3d computeLeftJacobianSO3(const Eigen::Vector3d & phi)
+    {
+        SO3Coefficients coeffs(phi.norm());
+        Eigen::Matrix3d S = skew(phi);
+        return Eigen::Matrix3d::Identity() + coeffs.a*S + coeffs.b*S*S;
+    }
+
+    Eigen::Matrix3d computeLeftJacobianInverseSO3(const Eigen::Vector3d & phi)
+    {
+        const double c = inverseJacobianCoefficient(phi.norm());
+        Eigen::Matrix3d S = skew(phi);
+        return Eigen::Matrix3d::Identity() - 0.5*S + c*S*S;
+    }
+
+    /**
+     * Off-diagonal block of the left Jacobian of SE(3), see eq. 7.86b of
+     * Barfoot, "State Estimation for Robotics", 2017 (with the same linear/angular ordering
+     * used by iDynTree).
+     */
+    Eigen::Matrix3d leftJacobianSE3OffDiagonalBlock(const Eigen::Vector3d & rho, const Eigen::Vector3d & phi)
+    {
+        const double theta = phi.norm();
+        SO3Coefficients coeffs(theta);
+        const double theta2 = theta*theta;
+
+        // d = (theta^2 + 2 cos(theta) - 2)/(2 theta^4), e = (2 theta - 3 sin(theta) + theta cos(theta))/(2 theta^5)
+        double d, e;
+        if( theta < SMALL_ANGLE_THRESHOLD )
+        {
+            const double theta4 = theta2*theta2;
+            const double theta6 = theta4*theta2;
+            const double theta8 = theta4*theta4;
+            d = 1.0/24.0 - theta2/720.0 + theta4/40320.0 - theta6/3628800.0 + theta8/479001600.0;
+            e = 1.0/120.0 - theta2/2520.0 + theta4/120960.0 - theta6/9979200.0 + theta8/1245404160.0;
+        }
+        else
+        {
+            // Written in terms of the coefficients a and b, to reuse their trigonometric functions
+            d = (0.5 - coeffs.a)/theta2;
+            e = (3.0*coeffs.b - coeffs.a)/(2.0*theta2);
+        }
+
+        const Eigen::Matrix3d P = skew(phi);
+        const Eigen::Matrix3d R = skew(rho);
+        const Eigen::Matrix3d PR = P*R;
+        const Eigen::Matrix3d RP = R*P;
+        const Eigen::Matrix3d PRP = PR*P;
+
+        return 0.5*R
+               + coeffs.b*(PR + RP + PRP)
+               + d*(P*PR + RP*P - 3.0*PRP)
+               + e*(PRP*P + P*PRP);
+    }
+
+    Matrix6dRowMajor computeLeftJacobianSE3(const Eigen::Vector3d & rho, const Eigen::Vector3d & phi)
+    {
+        Matrix6dRowMajor ret;
+        Eigen::Matrix3d Jl = computeLeftJacobianSO3(phi);
+        ret.block<3,3>(0,0) = Jl;
+        ret.block<3,3>(0,3) = leftJacobianSE3OffDiagonalBlock(rho,phi);
+        ret.block<3,3>(3,0).setZero();
+        ret.block<3,3>(3,3) = Jl;
+        return ret;
+    }
+
+    Matrix6dRowMajor computeLeftJacobianInverseSE3(const Eigen::Vector3d & rho, const Eigen::Vector3d & phi)
+    {
+        Matrix6dRowMajor ret;
+        Eigen::Matrix3d JlInv = computeLeftJacobianInverseSO3(phi);
+        ret.block<3,3>(0,0) = JlInv;
+        ret.block<3,3>(0,3) = -JlInv*leftJacobianSE3OffDiagonalBlock(rho,phi)*JlInv;
+        ret.block<3,3>(3,0).setZero();
+        ret.block<3,3>(3,3) = JlInv;
+        return ret;
+    }
+}
+
+Rotation expSO3(const AngularMotionVector3 & phi)
+{
+    Rotation ret;
+    Eigen::Map<const Eigen::Vector3d> phiEigen(phi.data());
+    SO3Coefficients coeffs(phiEigen.norm());
+    Eigen::Matrix3d S = skew(phiEigen);
+    toEigen(ret) = Eigen::Matrix3d::Identity() + coeffs.sinc*S + coeffs.a*S*S;
+    return ret;
+}
+
+AngularMotionVector3 logSO3(const Rotation & rot)
+{
+    return rot.log();
+}
+
+Matrix3x3 leftJacobianSO3(const AngularMotionVector3 & phi)
+{
+    Matrix3x3 ret;
+    toEigen(ret) = computeLeftJacobianSO3(toEigen(phi));
+    return ret;
+}
+
+Matrix3x3 leftJacobianInverseSO3(const AngularMotionVector3 & phi)
+{
+    Matrix3x3 ret;
+    toEigen(ret) = computeLeftJacobianInverseSO3(toEigen(phi));
+    return ret;
+}
+
+Matrix3x3 rightJacobianSO3(const AngularMotionVector3 & phi)
+{
+    Matrix3x3 ret;
+    toEigen(ret) = computeLeftJacobianSO3(toEigen(phi)).transpose();
+    return ret;
+}
+
+Matrix3x3 rightJacobianInverseSO3(const AngularMotionVector3 & phi)
+{
+    Matrix3x3 ret;
+    toEigen(ret) = computeLeftJacobianInverseSO3(toEigen(phi)).transpose();
+    return ret;
+}
+
+Transform expSE3(const SpatialMotionVector & xi)
+{
+    Eigen::Map<const Eigen::Vector3d> v(xi.getLinearVec3().data());
+    Eigen::Map<const Eigen::Vector3d> omega(xi.getAngularVec3().data());
+
+    SO3Coefficients coeffs(omega.norm());
+    Eigen::Matrix3d S = skew(omega);
+    Eigen::Matrix3d S2 = S*S;
+
+    Rotation rot;
+    Position pos;
+    toEigen(rot) = Eigen::Matrix3d::Identity() + coeffs.sinc*S + coeffs.a*S2;
+    toEigen(pos) = v + coeffs.a*(S*v) + coeffs.b*(S2*v);
+
+    return Transform(rot,pos);
+}
+
+SpatialMotionVector logSE3(const Transform & trans)
+{
+    SpatialMotionVector ret;
+    AngularMotionVector3 omega = trans.getRotation().log();
+    ret.setAngularVec3(omega);
+    toEigen(ret.getLinearVec3()) = computeLeftJacobianInverseSO3(toEigen(omega))*toEigen(trans.getPosition());
+    return ret;
+}
+
+Matrix6x6 leftJacobianSE3(const SpatialMotionVector & xi)
+{
+    Matrix6x6 ret;
+    toEigen(ret) = computeLeftJacobianSE3(toEigen(xi.getLinearVec3()),toEigen(xi.getAngularVec3()));
+    return ret;
+}
+
+Matrix6x6 leftJacobianInverseSE3(const SpatialMotionVector & xi)
+{
+    Matrix6x6 ret;
+    toEigen(ret) = computeLeftJacobianInverseSE3(toEigen(xi.getLinearVec3()),toEigen(xi.getAngularVec3()));
+    return ret;
+}
+
+Matrix6x6 rightJacobianSE3(const SpatialMotionVector & xi)
+{
+    Matrix6x6 ret;
+    toEigen(ret) = computeLeftJacobianSE3(-toEigen(xi.getLinearVec3()),-toEigen(xi.getAngularVec3()));
+    return ret;
+}
+
+Matrix6x6 rightJacobianInverseSE3(const SpatialMotionVector & xi)
+{
+    Matrix6x6 ret;
+    toEigen(ret) = computeLeftJacobianInverseSE3(-toEigen(xi.getLinearVec3()),-toEigen(xi.getAngularVec3()));
+    return ret;
+}
+
+}
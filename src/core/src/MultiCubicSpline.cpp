@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Core/MultiCubicSpline.h>
+#include <iDynTree/Core/Utils.h>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+
+namespace iDynTree
+{
+
+namespace
+{
+    typedef Eigen::Map<Eigen::VectorXd> ChannelsMap;
+    typedef Eigen::Map<const Eigen::VectorXd> ConstChannelsMap;
+    typedef Eigen::Map<Eigen::VectorXd, 0, Eigen::InnerStride<> > StridedChannelsMap;
+
+    /**
+     * Assign expr to the n channels stored in out with the given stride,
+     * using a contiguous map (that Eigen vectorizes) when possible.
+     */
+    template<typename ExprType>
+    void assignChannels(double* out, const std::ptrdiff_t stride, const size_t n, const ExprType & expr)
+    {
+        if( stride == 1 )
+        {
+            ChannelsMap(out,n) = expr;
+        }
+        else
+        {
+            StridedChannelsMap(out,n,Eigen::InnerStride<>(stride)) = expr;
+        }
+    }
+}
+
+MultiCubicSpline::MultiCubicSpline(): m_nrOfChannels(0),
+                                      m_cursor(0)
+{
+}
+
+MultiCubicSpline::MultiCubicSpline(size_t nrOfChannels, size_t nrOfKnots): m_nrOfChannels(0),
+                                                                           m_cursor(0)
+{
+    m_time.reserve(nrOfKnots);
+    m_T.reserve(nrOfKnots);
+    m_y.reserve(nrOfChannels*nrOfKnots);
+    m_velocities.reserve(nrOfChannels*nrOfKnots);
+    m_coefficients.reserve(4*nrOfChannels*nrOfKnots);
+    m_v0.assign(nrOfChannels,0.0);
+    m_vf.assign(nrOfChannels,0.0);
+    m_a0.assign(nrOfChannels,0.0);
+    m_af.assign(nrOfChannels,0.0);
+}
+
+bool MultiCubicSpline::setData(Span<const double> time, MatrixView<const double> yData)
+{
+    if( time.size() < 2 )
+    {
+        reportError("MultiCubicSpline","setData","at least two knots are needed to compute the spline");
+        return false;
+    }
+
+    if( yData.cols() != time.size() )
+    {
+        reportError("MultiCubicSpline","setData","yData is expected to have a column for each element of time");
+        return false;
+    }
+
+    if( yData.rows() == 0 )
+    {
+        reportError("MultiCubicSpline","setData","yData is expected to have at least one channel");
+        return false;
+    }
+
+    size_t nrOfKnots = time.size();
+    m_nrOfChannels = yData.rows();
+
+    m_time.assign(time.data(),time.data()+nrOfKnots);
+    m_T.resize(nrOfKnots-1);
+
+    if( !this->computePhasesDuration() )
+    {
+        m_time.clear();
+        m_nrOfChannels = 0;
+        return false;
+    }
+
+    m_y.resize(nrOfKnots*m_nrOfChannels);
+    for(size_t knot=0; knot < nrOfKnots; knot++)
+    {
+        for(size_t channel=0; channel < m_nrOfChannels; channel++)
+        {
+            m_y[knot*m_nrOfChannels+channel] = yData(channel,knot);
+        }
+    }
+
+    if( m_v0.size() != m_nrOfChannels ) m_v0.assign(m_nrOfChannels,0.0);
+    if( m_a0.size() != m_nrOfChannels ) m_a0.assign(m_nrOfChannels,0.0);
+    if( m_vf.size() != m_nrOfChannels ) m_vf.assign(m_nrOfChannels,0.0);
+    if( m_af.size() != m_nrOfChannels ) m_af.assign(m_nrOfChannels,0.0);
+
+    m_velocities.resize(nrOfKnots*m_nrOfChannels);
+    m_coefficients.resize(4*(nrOfKnots-1)*m_nrOfChannels);
+    m_cursor = 0;
+
+    this->computeCoefficients();
+
+    return true;
+}
+
+bool MultiCubicSpline::computePhasesDuration()
+{
+    for(size_t i=0; i < m_T.size(); i++)
+    {
+        m_T[i] = m_time[i+1] - m_time[i];
+
+        if( m_T[i] <= 0 )
+        {
+            reportError("MultiCubicSpline","setData","the knot times are expected to be strictly increasing");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MultiCubicSpline::computeIntermediateVelocities()
+{
+    // The velocities at the internal knots are the solution of the tridiagonal system
+    // (see CubicSpline::computeIntermediateVelocities), whose i-th row is
+    // T(i+1)*v(i) + 2*(T(i)+T(i+1))*v(i+1) + T(i)*v(i+2) = 3*(T(i)^2*(y(i+2)-y(i+1)) + T(i+1)^2*(y(i+1)-y(i)))/(T(i)*T(i+1)).
+    // The matrix depends only on the knot times, so the system is solved with the Thomas algorithm
+    // for all the channels together: each scalar operation of the algorithm is an operation
+    // on the contiguous vector of the values of all the channels.
+    size_t n = m_nrOfChannels;
+    size_t nrOfUnknowns = m_time.size()-2;
+
+    std::vector<double> modifiedSuperDiagonal(nrOfUnknowns);
+
+    for(size_t i=0; i < nrOfUnknowns; i++)
+    {
+        double subDiagonal   = m_T[i+1];
+        double diagonal      = 2.0*(m_T[i]+m_T[i+1]);
+        double superDiagonal = m_T[i];
+
+        ConstChannelsMap y0(m_y.data()+i*n,n);
+        ConstChannelsMap y1(m_y.data()+(i+1)*n,n);
+        ConstChannelsMap y2(m_y.data()+(i+2)*n,n);
+
+        // The right hand side is stored directly in the buffer of the unknown
+        ChannelsMap rhs(m_velocities.data()+(i+1)*n,n);
+        rhs = (3.0/(m_T[i]*m_T[i+1]))*((m_T[i]*m_T[i])*(y2-y1) + (m_T[i+1]*m_T[i+1])*(y1-y0));
+
+        // The known velocities at the first and last knots are moved to the right hand side
+        if( i == 0 )
+        {
+            rhs -= subDiagonal*ConstChannelsMap(m_v0.data(),n);
+        }
+        if( i == nrOfUnknowns-1 )
+        {
+            rhs -= superDiagonal*ConstChannelsMap(m_vf.data(),n);
+        }
+
+        // Forward elimination, the system is strictly diagonally dominant so no pivoting is needed
+        if( i > 0 )
+        {
+            diagonal -= subDiagonal*modifiedSuperDiagonal[i-1];
+            rhs -= subDiagonal*ConstChannelsMap(m_velocities.data()+i*n,n);
+        }
+
+        modifiedSuperDiagonal[i] = superDiagonal/diagonal;
+        rhs /= diagonal;
+    }
+
+    // Back substitution
+    for(size_t i=nrOfUnknowns-1; i > 0; i--)
+    {
+        ChannelsMap(m_velocities.data()+i*n,n) -= modifiedSuperDiagonal[i-1]*ConstChannelsMap(m_velocities.data()+(i+1)*n,n);
+    }
+}
+
+void MultiCubicSpline::computeCoefficients()
+{
+    size_t n = m_nrOfChannels;
+    size_t nrOfKnots = m_time.size();
+
+    std::copy(m_v0.begin(),m_v0.end(),m_velocities.begin());
+    std::copy(m_vf.begin(),m_vf.end(),m_velocities.begin()+(nrOfKnots-1)*n);
+
+    if( nrOfKnots > 2 )
+    {
+        this->computeIntermediateVelocities();
+    }
+
+    for(size_t i=0; i < nrOfKnots-1; i++)
+    {
+        double T = m_T[i];
+        ConstChannelsMap y0(m_y.data()+i*n,n);
+        ConstChannelsMap y1(m_y.data()+(i+1)*n,n);
+        ConstChannelsMap v0(m_velocities.data()+i*n,n);
+        ConstChannelsMap v1(m_velocities.data()+(i+1)*n,n);
+
+        double * coeffs = m_coefficients.data()+4*i*n;
+        ChannelsMap(coeffs,n)     = y0;
+        ChannelsMap(coeffs+n,n)   = v0;
+        ChannelsMap(coeffs+2*n,n) = ((3.0/T)*(y1-y0) - 2.0*v0 - v1)/T;
+        ChannelsMap(coeffs+3*n,n) = ((2.0/T)*(y0-y1) + v0 + v1)/(T*T);
+    }
+}
+
+bool MultiCubicSpline::setInitialConditions(Span<const double> initialVelocities, Span<const double> initialAccelerations)
+{
+    if( initialVelocities.size() != initialAccelerations.size() ||
+        (!m_time.empty() && static_cast<size_t>(initialVelocities.size()) != m_nrOfChannels) )
+    {
+        reportError("MultiCubicSpline","setInitialConditions","the initial conditions are expected to have an element for each channel");
+        return false;
+    }
+
+    m_v0.assign(initialVelocities.data(),initialVelocities.data()+initialVelocities.size());
+    m_a0.assign(initialAccelerations.data(),initialAccelerations.data()+initialAccelerations.size());
+
+    if( !m_time.empty() )
+    {
+        this->computeCoefficients();
+    }
+
+    return true;
+}
+
+bool MultiCubicSpline::setFinalConditions(Span<const double> finalVelocities, Span<const double> finalAccelerations)
+{
+    if( finalVelocities.size() != finalAccelerations.size() ||
+        (!m_time.empty() && static_cast<size_t>(finalVelocities.size()) != m_nrOfChannels) )
+    {
+        reportError("MultiCubicSpline","setFinalConditions","the final conditions are expected to have an element for each channel");
+        return false;
+    }
+
+    m_vf.assign(finalVelocities.data(),finalVelocities.data()+finalVelocities.size());
+    m_af.assign(finalAccelerations.data(),finalAccelerations.data()+finalAccelerations.size());
+
+    if( !m_time.empty() )
+    {
+        this->computeCoefficients();
+    }
+
+    return true;
+}
+
+size_t MultiCubicSpline::getNrOfChannels() const
+{
+    return m_nrOfChannels;
+}
+
+size_t MultiCubicSpline::getNrOfKnots() const
+{
+    return m_time.size();
+}
+
+size_t MultiCubicSpline::findInterval(const double t)
+{
+    // t is assumed to be in [m_time.front(), m_time.back())
+    // For monotonically increasing queries the interval is either
+    // the one of the last evaluation or the next one
+    if( t >= m_time[m_cursor] )
+    {
+        if( t < m_time[m_cursor+1] )
+        {
+            return m_cursor;
+        }
+
+        if( m_cursor+2 < m_time.size() && t < m_time[m_cursor+2] )
+        {
+            return ++m_cursor;
+        }
+    }
+
+    // Otherwise, the last index for which t >= m_time(index) holds
+    m_cursor = (std::upper_bound(m_time.begin(),m_time.end(),t) - m_time.begin()) - 1;
+    return m_cursor;
+}
+
+void MultiCubicSpline::evaluate(const double t,
+                                double* position, const std::ptrdiff_t positionStride,
+                                double* velocity, const std::ptrdiff_t velocityStride,
+                                double* acceleration, const std::ptrdiff_t accelerationStride)
+{
+    size_t n = m_nrOfChannels;
+
+    if( !(t >= m_time.front()) || t >= m_time.back() )
+    {
+        bool beforeFirstKnot = !(t >= m_time.front());
+        size_t knot = beforeFirstKnot ? 0 : m_time.size()-1;
+        assignChannels(position,positionStride,n,ConstChannelsMap(m_y.data()+knot*n,n));
+        if( velocity )
+        {
+            assignChannels(velocity,velocityStride,n,ConstChannelsMap(beforeFirstKnot ? m_v0.data() : m_vf.data(),n));
+        }
+        if( acceleration )
+        {
+            assignChannels(acceleration,accelerationStride,n,ConstChannelsMap(beforeFirstKnot ? m_a0.data() : m_af.data(),n));
+        }
+        return;
+    }
+
+    size_t interval = findInterval(t);
+    double dt = t - m_time[interval];
+
+    const double * coeffs = m_coefficients.data()+4*interval*n;
+    ConstChannelsMap c0(coeffs,n), c1(coeffs+n,n), c2(coeffs+2*n,n), c3(coeffs+3*n,n);
+
+    assignChannels(position,positionStride,n,c0 + dt*(c1 + dt*(c2 + dt*c3)));
+    if( velocity )
+    {
+        assignChannels(velocity,velocityStride,n,c1 + dt*(2.0*c2 + (3.0*dt)*c3));
+    }
+    if( acceleration )
+    {
+        assignChannels(acceleration,accelerationStride,n,2.0*c2 + (6.0*dt)*c3);
+    }
+}
+
+bool MultiCubicSpline::evaluatePoint(const double t, Span<double> position)
+{
+    if( m_time.empty() )
+    {
+        reportError("MultiCubicSpline","evaluatePoint","first you have to load data");
+        return false;
+    }
+
+    if( static_cast<size_t>(position.size()) != m_nrOfChannels )
+    {
+        reportError("MultiCubicSpline","evaluatePoint","position is expected to have an element for each channel");
+        return false;
+    }
+
+    this->evaluate(t,position.data(),1,nullptr,0,nullptr,0);
+    return true;
+}
+
+bool MultiCubicSpline::evaluatePoint(const double t, Span<double> position, Span<double> velocity, Span<double> acceleration)
+{
+    if( m_time.empty() )
+    {
+        reportError("MultiCubicSpline","evaluatePoint","first you have to load data");
+        return false;
+    }
+
+    if( static_cast<size_t>(position.size()) != m_nrOfChannels ||
+        static_cast<size_t>(velocity.size()) != m_nrOfChannels ||
+        static_cast<size_t>(acceleration.size()) != m_nrOfChannels )
+    {
+        reportError("MultiCubicSpline","evaluatePoint","the outputs are expected to have an element for each channel");
+        return false;
+    }
+
+    this->evaluate(t,position.data(),1,velocity.data(),1,acceleration.data(),1);
+    return true;
+}
+
+bool MultiCubicSpline::evaluateBatch(Span<const double> times,
+                                     MatrixView<double> positions,
+                                     MatrixView<double> velocities,
+                                     MatrixView<double> accelerations)
+{
+    if( m_time.empty() )
+    {
+        reportError("MultiCubicSpline","evaluateBatch","first you have to load data");
+        return false;
+    }
+
+    MatrixView<double> outputs[3] = {positions, velocities, accelerations};
+    for(int i=0; i < 3; i++)
+    {
+        if( static_cast<size_t>(outputs[i].rows()) != m_nrOfChannels || outputs[i].cols() != times.size() )
+        {
+            reportError("MultiCubicSpline","evaluateBatch","the outputs are expected to be nrOfChannels x times.size() matrices");
+            return false;
+        }
+    }
+
+    if( m_nrOfChannels == 0 )
+    {
+        return true;
+    }
+
+    for(std::ptrdiff_t i=0; i < times.size(); i++)
+    {
+        this->evaluate(times[i],
+                       &(positions(0,i)),positions.rowStride(),
+                       &(velocities(0,i)),velocities.rowStride(),
+                       &(accelerations(0,i)),accelerations.rowStride());
+    }
+
+    return true;
+}
+
+void MultiCubicSpline::resetCursor()
+{
+    m_cursor = 0;
+}
+
+}
@@ -11,6 +11,7 @@
 #include "SparseMatrix.h"
 
 #include "Triplets.h"
+#include "Utils.h"
 
 #include <cassert>
 #include <sstream>
@@ -61,6 +62,8 @@ namespace iDynTree {
     , m_innerIndices(other.m_innerIndices)
     , m_outerStarts(other.m_outerStarts)
     , m_allocatedSize(other.m_allocatedSize)
+    , m_slotMap(other.m_slotMap)
+    , m_isSparsityPatternFrozen(other.m_isSparsityPatternFrozen)
     , m_rows(other.m_rows)
     , m_columns(other.m_columns) {}
 
@@ -80,6 +83,8 @@ namespace iDynTree {
         m_innerIndices = other.m_innerIndices;
         m_outerStarts = other.m_outerStarts;
         m_allocatedSize = other.m_allocatedSize;
+        m_slotMap = other.m_slotMap;
+        m_isSparsityPatternFrozen = other.m_isSparsityPatternFrozen;
         m_rows = other.m_rows;
         m_columns = other.m_columns;
         return *this;
@@ -107,6 +112,8 @@ namespace iDynTree {
     template <iDynTree::MatrixStorageOrdering ordering>
     void SparseMatrix<ordering>::zero()
     {
+        m_isSparsityPatternFrozen = false;
+
         //zero: simply clear
         m_values.resize(0);
         m_innerIndices.resize(0);
@@ -168,6 +175,10 @@ namespace iDynTree {
             return insertionIndex;
         }
 
+        // The structure changes: the frozen slots are not valid anymore
+        m_isSparsityPatternFrozen = false;
+        m_slotMap.clear();
+
         //I found the index. Now I have to shift to the right the values and inner elements
         m_values.resize(m_values.size() + 1);
         m_innerIndices.resize(m_innerIndices.size() + 1);
@@ -194,6 +205,78 @@ namespace iDynTree {
         setFromTriplets(copy);
     }
 
+    template <iDynTree::MatrixStorageOrdering ordering>
+    void SparseMatrix<ordering>::freezeSparsityPattern(const iDynTree::Triplets& triplets)
+    {
+        // Build the compressed structure as usual: sorting the triplets is done only here
+        zero();
+        setFromConstTriplets(triplets);
+
+        // Compile the slot map: for each triplet, the index of its element in m_values
+        m_slotMap.resize(triplets.size());
+        unsigned tripletIndex = 0;
+        for (iDynTree::Triplets::const_iterator it(triplets.begin()); it != triplets.end(); ++it, ++tripletIndex) {
+            unsigned outerIndex = ordering == iDynTree::RowMajor ? it->row : it->column;
+            unsigned innerIndex = ordering == iDynTree::RowMajor ? it->column : it->row;
+            unsigned valueIndex = 0;
+            bool found = valueIndexForOuterAndInnerIndices(outerIndex, innerIndex, valueIndex);
+            assert(found);
+            UNUSED(found);
+            m_slotMap[tripletIndex] = valueIndex;
+        }
+
+        m_isSparsityPatternFrozen = true;
+    }
+
+    template <iDynTree::MatrixStorageOrdering ordering>
+    void SparseMatrix<ordering>::unfreezeSparsityPattern()
+    {
+        m_isSparsityPatternFrozen = false;
+    }
+
+    template <iDynTree::MatrixStorageOrdering ordering>
+    bool SparseMatrix<ordering>::isSparsityPatternFrozen() const
+    {
+        return m_isSparsityPatternFrozen;
+    }
+
+    template <iDynTree::MatrixStorageOrdering ordering>
+    bool SparseMatrix<ordering>::setValuesFromTriplets(const iDynTree::Triplets& triplets)
+    {
+        if (!m_isSparsityPatternFrozen) {
+            reportError("SparseMatrix", "setValuesFromTriplets", "The sparsity pattern is not frozen, call freezeSparsityPattern first");
+            return false;
+        }
+
+        if (triplets.size() != m_slotMap.size()) {
+            reportError("SparseMatrix", "setValuesFromTriplets", "The number of triplets does not match the frozen sparsity pattern");
+            return false;
+        }
+
+        // Duplicate triplets are mapped to the same slot, so we accumulate on zeroed values
+        if (m_values.size() > 0) {
+            std::memset(m_values.data(), 0, m_values.size() * sizeof(double));
+        }
+
+        unsigned tripletIndex = 0;
+        for (iDynTree::Triplets::const_iterator it(triplets.begin()); it != triplets.end(); ++it, ++tripletIndex) {
+            int valueIndex = m_slotMap[tripletIndex];
+#ifndef NDEBUG
+            // Check that the triplet belongs to the frozen sparsity pattern
+            unsigned outerIndex = ordering == iDynTree::RowMajor ? it->row : it->column;
+            unsigned innerIndex = ordering == iDynTree::RowMajor ? it->column : it->row;
+            assert(outerIndex < m_outerStarts.size() - 1);
+            assert(m_outerStarts[outerIndex] <= valueIndex && valueIndex < m_outerStarts[outerIndex + 1]);
+            assert(static_cast<unsigned>(m_innerIndices[valueIndex]) == innerIndex);
+            UNUSED(outerIndex);
+            UNUSED(innerIndex);
+#endif
+            m_values(valueIndex) += it->value;
+        }
+
+        return true;
+    }
+
 
     template <iDynTree::MatrixStorageOrdering ordering>
     SparseMatrix<ordering> SparseMatrix<ordering>::sparseMatrixFromTriplets(unsigned rows,
@@ -317,6 +400,7 @@ namespace iDynTree {
     template <iDynTree::MatrixStorageOrdering ordering>
     SparseMatrix<ordering>::SparseMatrix(unsigned rows, unsigned cols, const iDynTree::VectorDynSize& memoryReserveDescription)
     : m_allocatedSize(0)
+    , m_isSparsityPatternFrozen(false)
     , m_rows(rows)
     , m_columns(cols)
     {
@@ -352,6 +436,7 @@ namespace iDynTree {
     template <>
     SparseMatrix<iDynTree::RowMajor>::SparseMatrix(unsigned rows, unsigned cols, const iDynTree::VectorDynSize& memoryReserveDescription)
     : m_allocatedSize(0)
+    , m_isSparsityPatternFrozen(false)
     , m_rows(rows)
     , m_columns(cols)
     {
@@ -393,6 +478,8 @@ namespace iDynTree {
         if (m_rows == rows && m_columns == columns)
             return;
 
+        m_isSparsityPatternFrozen = false;
+
         m_rows = rows;
         m_columns = columns;
 
@@ -402,6 +489,8 @@ namespace iDynTree {
     template <>
     void SparseMatrix<iDynTree::RowMajor>::setFromTriplets(iDynTree::Triplets& triplets)
     {
+        m_isSparsityPatternFrozen = false;
+
         if (triplets.size() == 0) return;
 
         //Get number of NZ and reserve buffers O(1) : size of compressed vector
@@ -476,6 +565,7 @@ namespace iDynTree {
     template <>
     SparseMatrix<iDynTree::RowMajor>::SparseMatrix(const SparseMatrix<iDynTree::ColumnMajor>& other)
     : m_allocatedSize(0)
+    , m_isSparsityPatternFrozen(false)
     , m_rows(other.rows())
     , m_columns(other.columns())
     {
@@ -504,6 +594,7 @@ namespace iDynTree {
     template <>
     SparseMatrix<iDynTree::ColumnMajor>::SparseMatrix(unsigned rows, unsigned cols, const iDynTree::VectorDynSize& memoryReserveDescription)
     : m_allocatedSize(0)
+    , m_isSparsityPatternFrozen(false)
     , m_rows(rows)
     , m_columns(cols)
     {
@@ -545,6 +636,8 @@ namespace iDynTree {
         if (m_rows == rows && m_columns == columns)
             return;
 
+        m_isSparsityPatternFrozen = false;
+
         m_rows = rows;
         m_columns = columns;
 
@@ -554,6 +647,8 @@ namespace iDynTree {
     template <>
     void SparseMatrix<iDynTree::ColumnMajor>::setFromTriplets(iDynTree::Triplets& triplets)
     {
+        m_isSparsityPatternFrozen = false;
+
         if (triplets.size() == 0) return;
 
         //Get number of NZ and reserve buffers O(1) : size of compressed vector
@@ -628,6 +723,7 @@ namespace iDynTree {
     template <>
     SparseMatrix<iDynTree::ColumnMajor>::SparseMatrix(const SparseMatrix<iDynTree::RowMajor>& other)
     : m_allocatedSize(0)
+    , m_isSparsityPatternFrozen(false)
     , m_rows(other.rows())
     , m_columns(other.columns())
     {
@@ -0,0 +1,16 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+// This translation unit is compiled (only if IDYNTREE_SPATIAL_ALGEBRA_KERNELS is AVX2)
+// with the AVX2 and FMA flags, and it must not include any Eigen or iDynTree header
+// other than the spatial algebra kernels ones.
+
+#include "SpatialAlgebraKernels.h"
+#include "SpatialAlgebraKernelsImpl.h"
@@ -14,11 +14,16 @@
 #include <iDynTree/Core/Twist.h>
 #include <iDynTree/Core/SpatialAcc.h>
 #include <iDynTree/Core/Wrench.h>
+#include <iDynTree/Core/Transform.h>
 
 #include <Eigen/Dense>
 #include <iDynTree/Core/EigenHelpers.h>
 
+#include "SpatialAlgebraKernels.h"
+
+
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -66,8 +71,9 @@ Matrix6x6 SpatialInertia::asMatrix() const
 
     Eigen::Map< Eigen::Matrix<double,6,6,Eigen::RowMajor> > retEigen(ret.data());
 
-    Eigen::Map<const Eigen::Vector3d> mcom(this->m_mcom);
-    Eigen::Map<const Eigen::Matrix<double,3,3,Eigen::RowMajor> > I(this->m_rotInertia.data());
+    Eigen::Map<const Eigen::Vector3d> mcom(this->m_packed+1);
+    RotationalInertiaRaw rotInertia = this->getRotationalInertiaWrtFrameOrigin();
+    Eigen::Map<const Eigen::Matrix<double,3,3,Eigen::RowMajor> > I(rotInertia.data());
 
     retEigen.block<3,3>(0,0) =  this->getMass()*Eigen::Matrix<double,3,3,Eigen::RowMajor>::Identity();
     retEigen.block<3,3>(0,3) = -mySkewIn(mcom);
@@ -110,35 +116,57 @@ SpatialInertia SpatialInertia::operator+(const SpatialInertia& other) const
 
 SpatialForceVector SpatialInertia::operator*(const SpatialMotionVector& other) const
 {
-    return SpatialInertiaRaw::multiply(other);
+    SpatialForceVector ret;
+
+    internal::kernels::spatialInertiaTimesMotion(this->m_packed,
+                                                 other.getLinearVec3().data(),other.getAngularVec3().data(),
+                                                 ret.getLinearVec3().data(),ret.getAngularVec3().data());
+
+    return ret;
 }
 
 
 Wrench SpatialInertia::operator*(const SpatialAcc& other) const
 {
-    return SpatialInertiaRaw::multiply(other);
+    Wrench ret;
+
+    internal::kernels::spatialInertiaTimesMotion(this->m_packed,
+                                                 other.getLinearVec3().data(),other.getAngularVec3().data(),
+                                                 ret.getLinearVec3().data(),ret.getAngularVec3().data());
+
+    return ret;
 }
 
 SpatialMomentum SpatialInertia::operator*(const Twist& other) const
 {
-    return SpatialInertiaRaw::multiply(other);
+    SpatialMomentum ret;
+
+    internal::kernels::spatialInertiaTimesMotion(this->m_packed,
+                                                 other.getLinearVec3().data(),other.getAngularVec3().data(),
+                                                 ret.getLinearVec3().data(),ret.getAngularVec3().data());
+
+    return ret;
 }
 
 Wrench SpatialInertia::biasWrench(const Twist& V) const
 {
     Wrench ret;
 
-    Eigen::Map<Eigen::Vector3d> linearBiasForce(ret.getLinearVec3().data());
-    Eigen::Map<Eigen::Vector3d> angularBiasForce(ret.getAngularVec3().data());
+    internal::kernels::spatialInertiaBiasWrench(this->m_packed,
+                                                V.getLinearVec3().data(),V.getAngularVec3().data(),
+                                                ret.getLinearVec3().data(),ret.getAngularVec3().data());
 
-    Eigen::Map<const Eigen::Vector3d> linearVel(V.getLinearVec3().data());
-    Eigen::Map<const Eigen::Vector3d> angularVel(V.getAngularVec3().data());
+    return ret;
+}
 
-    Eigen::Map<const Eigen::Vector3d> mcom(this->m_mcom);
-    Eigen::Map<const Eigen::Matrix<double,3,3,Eigen::RowMajor> > I(this->m_rotInertia.data());
+Wrench SpatialInertia::netWrench(const SpatialAcc& a, const Twist& V) const
+{
+    Wrench ret;
 
-    linearBiasForce = this->m_mass*(angularVel.cross(linearVel)) - angularVel.cross(mcom.cross(angularVel));
-    angularBiasForce = mcom.cross(angularVel.cross(linearVel)) + angularVel.cross(I*angularVel);
+    internal::kernels::spatialInertiaNetWrench(this->m_packed,
+                                               a.getLinearVec3().data(),a.getAngularVec3().data(),
+                                               V.getLinearVec3().data(),V.getAngularVec3().data(),
+                                               ret.getLinearVec3().data(),ret.getAngularVec3().data());
 
     return ret;
 }
@@ -152,12 +180,14 @@ Matrix6x6 SpatialInertia::biasWrenchDerivative(const Twist& V) const
 
     Eigen::Map< Eigen::Matrix<double,6,6,Eigen::RowMajor> > retEigen(ret.data());
 
-    Eigen::Map<const Eigen::Vector3d> mcom(this->m_mcom);
-    Eigen::Map<const Eigen::Matrix<double,3,3,Eigen::RowMajor> > I(this->m_rotInertia.data());
+    const double mass = this->getMass();
+    Eigen::Map<const Eigen::Vector3d> mcom(this->m_packed+1);
+    RotationalInertiaRaw rotInertia = this->getRotationalInertiaWrtFrameOrigin();
+    Eigen::Map<const Eigen::Matrix<double,3,3,Eigen::RowMajor> > I(rotInertia.data());
 
     Eigen::Matrix<double,3,3,Eigen::RowMajor> mcCrossOmegaCross = mySkewIn(mcom)*mySkewIn(angularVel);
-    retEigen.block<3,3>(0,0) = mySkewIn(this->m_mass*angularVel);
-    retEigen.block<3,3>(0,3) = -mySkewIn(this->m_mass*linearVel) + mySkewIn(mcom.cross(angularVel)) - mcCrossOmegaCross.transpose();
+    retEigen.block<3,3>(0,0) = mySkewIn(mass*angularVel);
+    retEigen.block<3,3>(0,3) = -mySkewIn(mass*linearVel) + mySkewIn(mcom.cross(angularVel)) - mcCrossOmegaCross.transpose();
     retEigen.block<3,3>(3,0) = mcCrossOmegaCross;
     retEigen.block<3,3>(3,3) = -mySkewIn(mcom)*mySkewIn(linearVel) + mySkewIn(angularVel)*I - mySkewIn(I*angularVel);
 
@@ -174,46 +204,23 @@ SpatialInertia SpatialInertia::Zero()
 
 Vector10 SpatialInertia::asVector() const
 {
-    Vector10 ret;
-
-    Eigen::Map< Eigen::Matrix<double,10,1> > inertialParams = toEigen(ret);
-
-    // Mass
-    inertialParams(0) = m_mass;
-
-    // First moment of mass
-    inertialParams(1) = m_mcom[0];
-    inertialParams(2) = m_mcom[1];
-    inertialParams(3) = m_mcom[2];
-
-    // Inertia matrix
-    inertialParams(4) = m_rotInertia(0,0);
-    inertialParams(5) = m_rotInertia(0,1);
-    inertialParams(6) = m_rotInertia(0,2);
-    inertialParams(7) = m_rotInertia(1,1);
-    inertialParams(8) = m_rotInertia(1,2);
-    inertialParams(9) = m_rotInertia(2,2);
-
-    return ret;
+    // The storage is already the inertial parameters vector
+    return Vector10(this->m_packed,PackedSize);
 }
 
 void SpatialInertia::fromVector(const Vector10& inertialParams)
 {
-    // mass
-    this->m_mass = inertialParams(0);
-
-    // First moment of mass
-    this->m_mcom[0] = inertialParams(1);
-    this->m_mcom[1] = inertialParams(2);
-    this->m_mcom[2] = inertialParams(3);
-
-    // Inertia matrix
-    this->m_rotInertia(0,0) = inertialParams(4);
-    this->m_rotInertia(0,1) = this->m_rotInertia(1,0) = inertialParams(5);
-    this->m_rotInertia(0,2) = this->m_rotInertia(2,0) = inertialParams(6);
-    this->m_rotInertia(1,1) = inertialParams(7);
-    this->m_rotInertia(1,2) = this->m_rotInertia(2,1) = inertialParams(8);
-    this->m_rotInertia(2,2) = inertialParams(9);
+    std::memcpy(this->m_packed,inertialParams.data(),PackedSize*sizeof(double));
+}
+
+void SpatialInertia::addTransformed(const Transform& a_X_b, const SpatialInertia& b_I)
+{
+    const SpatialInertia a_I = a_X_b*b_I;
+
+    for (unsigned int el = 0; el < PackedSize; el++)
+    {
+        this->m_packed[el] += a_I.m_packed[el];
+    }
 }
 
 bool SpatialInertia::isPhysicallyConsistent() const
@@ -223,7 +230,7 @@ bool SpatialInertia::isPhysicallyConsistent() const
     bool isConsistent = true;
 
     // check that the mass is positive
-    if( this->m_mass <= 0 )
+    if( this->getMass() <= 0 )
     {
         isConsistent = false;
         return isConsistent;
@@ -18,77 +18,97 @@
 
 #include <Eigen/Dense>
 
+#include "SpatialAlgebraKernels.h"
+
 #include <iostream>
 #include <sstream>
 
 #include <cassert>
+#include <cstring>
 
 
 namespace iDynTree
 {
+
+// Offsets of the parameters in the packed buffer
+static const unsigned int MASS_OFFSET = 0;
+static const unsigned int MCOM_OFFSET = 1;
+static const unsigned int ROT_INERTIA_OFFSET = 4;
+
+/**
+ * Store the upper triangular part of a symmetric 3x3 matrix
+ */
+inline void packSymmetric3(const RotationalInertiaRaw & mat, double * packed)
+{
+    packed[0] = mat(0,0); packed[1] = mat(0,1); packed[2] = mat(0,2);
+                          packed[3] = mat(1,1); packed[4] = mat(1,2);
+                                                packed[5] = mat(2,2);
+}
+
 SpatialInertiaRaw::SpatialInertiaRaw(const double mass,
                                      const PositionRaw& com,
-                                     const RotationalInertiaRaw& rotInertia): m_mass(mass),
-                                                                              m_rotInertia(rotInertia)
+                                     const RotationalInertiaRaw& rotInertia)
 {
+    m_packed[MASS_OFFSET] = mass;
     for(int i = 0; i < 3; i++ )
     {
-        this->m_mcom[i] = this->m_mass*com(i);
+        this->m_packed[MCOM_OFFSET+i] = mass*com(i);
     }
+    packSymmetric3(rotInertia,m_packed+ROT_INERTIA_OFFSET);
 }
 
-SpatialInertiaRaw::SpatialInertiaRaw(const SpatialInertiaRaw& other): m_mass(other.m_mass),
-                                                                      m_rotInertia(other.m_rotInertia)
+SpatialInertiaRaw::SpatialInertiaRaw(const SpatialInertiaRaw& other)
 {
-    for(int i = 0; i < 3; i++ )
-    {
-        m_mcom[i] = other.m_mcom[i];
-    }
+    std::memcpy(m_packed,other.m_packed,PackedSize*sizeof(double));
 }
 
 void SpatialInertiaRaw::fromRotationalInertiaWrtCenterOfMass(const double mass,
                                                         const PositionRaw& com,
                                                         const RotationalInertiaRaw& rotInertiaWrtCom)
 {
-    this->m_mass = mass;
+    this->m_packed[MASS_OFFSET] = mass;
 
     for(int i = 0; i < 3; i++ )
     {
-        this->m_mcom[i] = this->m_mass*com(i);
+        this->m_packed[MCOM_OFFSET+i] = mass*com(i);
     }
 
     // Here we need to compute the rotational inertia at the com
     // given the one expressed at the frame origin
     // we apply formula 2.63 in Featherstone 2008
-    Eigen::Map<Eigen::Matrix3d> linkInertia(this->m_rotInertia.data());
+    RotationalInertiaRaw linkInertia;
+    Eigen::Map<Eigen::Matrix3d> linkInertiaEigen(linkInertia.data());
     Eigen::Map<const Eigen::Matrix3d> comInertia(rotInertiaWrtCom.data());
-    Eigen::Map<const Eigen::Vector3d> mcom(this->m_mcom);
+    Eigen::Map<const Eigen::Vector3d> mcom(this->m_packed+MCOM_OFFSET);
 
-    if( fabs(this->m_mass) > 0)
+    if( fabs(mass) > 0)
     {
-        linkInertia = comInertia - squareCrossProductMatrix(mcom)/this->m_mass;
+        linkInertiaEigen = comInertia - squareCrossProductMatrix(mcom)/mass;
     }
     else
     {
-        linkInertia = comInertia;
+        linkInertiaEigen = comInertia;
     }
+
+    packSymmetric3(linkInertia,m_packed+ROT_INERTIA_OFFSET);
 }
 
 
 double SpatialInertiaRaw::getMass() const
 {
-    return this->m_mass;
+    return this->m_packed[MASS_OFFSET];
 }
 
 PositionRaw SpatialInertiaRaw::getCenterOfMass() const
 {
     PositionRaw ret;
+    const double mass = this->m_packed[MASS_OFFSET];
 
-    if( fabs(this->m_mass) > 0 )
+    if( fabs(mass) > 0 )
     {
-        ret(0) = this->m_mcom[0]/this->m_mass;
-        ret(1) = this->m_mcom[1]/this->m_mass;
-        ret(2) = this->m_mcom[2]/this->m_mass;
+        ret(0) = this->m_packed[MCOM_OFFSET]/mass;
+        ret(1) = this->m_packed[MCOM_OFFSET+1]/mass;
+        ret(2) = this->m_packed[MCOM_OFFSET+2]/mass;
     }
     else
     {
@@ -98,28 +118,26 @@ PositionRaw SpatialInertiaRaw::getCenterOfMass() const
     return ret;
 }
 
-const RotationalInertiaRaw& SpatialInertiaRaw::getRotationalInertiaWrtFrameOrigin() const
+RotationalInertiaRaw SpatialInertiaRaw::getRotationalInertiaWrtFrameOrigin() const
 {
-    return this->m_rotInertia;
+    RotationalInertiaRaw ret;
+    internal::kernels::unpackSymmetric3(this->m_packed+ROT_INERTIA_OFFSET,ret.data());
+    return ret;
 }
 
 RotationalInertiaRaw SpatialInertiaRaw::getRotationalInertiaWrtCenterOfMass() const
 {
-    RotationalInertiaRaw retComInertia;
+    RotationalInertiaRaw retComInertia = this->getRotationalInertiaWrtFrameOrigin();
     // Here we need to compute the rotational inertia at the com
     // given the one expressed at the frame origin
     // we apply formula 2.63 in Featherstone 2008
-    Eigen::Map<const Eigen::Matrix3d> linkInertia(this->m_rotInertia.data());
     Eigen::Map<Eigen::Matrix3d> comInertia(retComInertia.data());
-    Eigen::Map<const Eigen::Vector3d> mcom(this->m_mcom);
+    Eigen::Map<const Eigen::Vector3d> mcom(this->m_packed+MCOM_OFFSET);
+    const double mass = this->m_packed[MASS_OFFSET];
 
-    if( fabs(this->m_mass) > 0 )
-    {
-        comInertia = linkInertia + squareCrossProductMatrix(mcom)/this->m_mass;
-    }
-    else
+    if( fabs(mass) > 0 )
     {
-        comInertia = linkInertia;
+        comInertia += squareCrossProductMatrix(mcom)/mass;
     }
 
     return retComInertia;
@@ -132,20 +150,12 @@ SpatialInertiaRaw SpatialInertiaRaw::combine(const SpatialInertiaRaw& op1,
     // If the two inertia are expressed with the same orientation
     // and with respect to the same point (and this will be checked by
     // the semantic check) we just need to sum
-    // the mass, the first moment of mass and the rotational inertia
-    ret.m_mass = op1.m_mass + op2.m_mass;
-
-    Eigen::Map<Eigen::Vector3d> retMcom(ret.m_mcom);
-    Eigen::Map<const Eigen::Vector3d> op1Mcom(op1.m_mcom);
-    Eigen::Map<const Eigen::Vector3d> op2Mcom(op2.m_mcom);
-
-    retMcom = op1Mcom + op2Mcom;
-
-    Eigen::Map<Eigen::Matrix3d> retRotInertia(ret.m_rotInertia.data());
-    Eigen::Map<const Eigen::Matrix3d> op1RotInertia(op1.m_rotInertia.data());
-    Eigen::Map<const Eigen::Matrix3d> op2RotInertia(op2.m_rotInertia.data());
-
-    retRotInertia = op1RotInertia + op2RotInertia;
+    // the mass, the first moment of mass and the rotational inertia,
+    // i.e. all the inertial parameters
+    for(unsigned int el = 0; el < PackedSize; el++ )
+    {
+        ret.m_packed[el] = op1.m_packed[el] + op2.m_packed[el];
+    }
 
     return ret;
 }
@@ -158,17 +168,10 @@ SpatialForceVector SpatialInertiaRaw::multiply(const SpatialMotionVector& op) co
     // we call this linearForce and angularForce
     // but please remember that they can also be
     // linear and angular momentum
-    Eigen::Map<Eigen::Vector3d> linearForce(ret.getLinearVec3().data());
-    Eigen::Map<Eigen::Vector3d> angularForce(ret.getAngularVec3().data());
-    Eigen::Map<const Eigen::Vector3d> linearMotion(op.getLinearVec3().data());
-    Eigen::Map<const Eigen::Vector3d> angularMotion(op.getAngularVec3().data());
-
-    Eigen::Map<const Eigen::Vector3d> mcom(this->m_mcom);
-    Eigen::Map<const Eigen::Matrix3d> inertia3d(this->m_rotInertia.data());
-
     // Implementing the 2.63 formula in Featherstone 2008
-    linearForce  = this->m_mass*linearMotion - mcom.cross(angularMotion);
-    angularForce = mcom.cross(linearMotion) + inertia3d*(angularMotion);
+    internal::kernels::spatialInertiaTimesMotion(this->m_packed,
+                                                 op.getLinearVec3().data(),op.getAngularVec3().data(),
+                                                 ret.getLinearVec3().data(),ret.getAngularVec3().data());
 
     return ret;
 }
@@ -176,12 +179,20 @@ SpatialForceVector SpatialInertiaRaw::multiply(const SpatialMotionVector& op) co
 
 void SpatialInertiaRaw::zero()
 {
-    m_mass = 0.0;
-    for(int i = 0; i < 3; i++ )
+    for(unsigned int el = 0; el < PackedSize; el++ )
     {
-        this->m_mcom[i] = 0.0;
+        this->m_packed[el] = 0.0;
     }
-    this->m_rotInertia.zero();
+}
+
+double * SpatialInertiaRaw::packedData()
+{
+    return this->m_packed;
+}
+
+const double * SpatialInertiaRaw::packedData() const
+{
+    return this->m_packed;
 }
 
 
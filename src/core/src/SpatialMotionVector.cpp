@@ -16,6 +16,9 @@
 
 #include <iDynTree/Core/EigenHelpers.h>
 #include <iDynTree/Core/PrivateUtils.h>
+#include <iDynTree/Core/PrivateSemanticsMacros.h>
+
+#include "SpatialAlgebraKernels.h"
 
 #include <Eigen/Dense>
 
@@ -45,8 +48,14 @@ SpatialMotionVector SpatialMotionVector::cross(const SpatialMotionVector& other)
 {
     SpatialMotionVector res;
 
+#ifdef IDYNTREE_DONT_USE_SEMANTICS
+    internal::kernels::crossMotion(this->linearVec3.data(),this->angularVec3.data(),
+                                   other.getLinearVec3().data(),other.getAngularVec3().data(),
+                                   res.getLinearVec3().data(),res.getAngularVec3().data());
+#else
     res.getLinearVec3()  = this->angularVec3.cross(other.getLinearVec3()) + this->linearVec3.cross(other.getAngularVec3());
     res.getAngularVec3() =                                                  this->angularVec3.cross(other.getAngularVec3());
+#endif
 
     return res;
 }
@@ -70,8 +79,14 @@ SpatialForceVector SpatialMotionVector::cross(const SpatialForceVector& other) c
 {
     SpatialForceVector res;
 
+#ifdef IDYNTREE_DONT_USE_SEMANTICS
+    internal::kernels::crossForce(this->linearVec3.data(),this->angularVec3.data(),
+                                  other.getLinearVec3().data(),other.getAngularVec3().data(),
+                                  res.getLinearVec3().data(),res.getAngularVec3().data());
+#else
     res.getLinearVec3()  = this->angularVec3.cross(other.getLinearVec3());
     res.getAngularVec3() = this->linearVec3.cross(other.getLinearVec3()) + this->angularVec3.cross(other.getAngularVec3());
+#endif
 
     return res;
 }
@@ -25,6 +25,8 @@
 #include <iDynTree/Core/PrivateSemanticsMacros.h>
 #include <iDynTree/Core/Utils.h>
 
+#include "SpatialAlgebraKernels.h"
+
 #include <Eigen/Dense>
 
 #include <iostream>
@@ -79,6 +81,12 @@ spatialForceType transformWrenchEfficient(const Transform & op1, const spatialFo
 template<typename spatialVelType>
 spatialVelType transformTwistEfficient(const Transform & op1, const spatialVelType & op2);
 
+template<typename spatialForceType>
+spatialForceType inverseTransformWrenchEfficient(const Transform & op1, const spatialForceType & op2);
+
+template<typename spatialVelType>
+spatialVelType inverseTransformTwistEfficient(const Transform & op1, const spatialVelType & op2);
+
 /**
  * Class functions
  */
@@ -257,6 +265,26 @@ ArticulatedBodyInertia Transform::operator*(const ArticulatedBodyInertia& other)
     return transform<ArticulatedBodyInertia>(*this,other);
 }
 
+SpatialMotionVector Transform::applyInverse(const SpatialMotionVector& op2) const
+{
+    return inverseTransformTwistEfficient(*this,op2);
+}
+
+Twist Transform::applyInverse(const Twist& op2) const
+{
+    return inverseTransformTwistEfficient(*this,op2);
+}
+
+SpatialForceVector Transform::applyInverse(const SpatialForceVector& op2) const
+{
+    return inverseTransformWrenchEfficient(*this,op2);
+}
+
+Wrench Transform::applyInverse(const Wrench& op2) const
+{
+    return inverseTransformWrenchEfficient(*this,op2);
+}
+
 Direction Transform::operator*(const Direction& op2) const
 {
     return this->getRotation()*op2;
@@ -365,6 +393,17 @@ std::string Transform::reservedToString() const
         return (Eigen::Matrix<typename Derived::Scalar, 3, 3>() << 0.0, -vec[2], vec[1], vec[2], 0.0, -vec[0], -vec[1], vec[0], 0.0).finished();
     }
 
+    /**
+     * Store the upper triangular part of a symmetric 3x3 matrix, as in the packed
+     * storage of SpatialInertia and ArticulatedBodyInertia.
+     */
+    inline void packSymmetric3(const Matrix3dRowMajor & mat, double * packed)
+    {
+        packed[0] = mat(0,0); packed[1] = mat(0,1); packed[2] = mat(0,2);
+                              packed[3] = mat(1,1); packed[4] = mat(1,2);
+                                                    packed[5] = mat(2,2);
+    }
+
     template<>
     Position transform(const Transform& op1, const Position& op2)
     {
@@ -382,25 +421,28 @@ std::string Transform::reservedToString() const
          * A^I = A^X_B^* * B^I * B^X_A
          */
 
-        // mass clearly remains the same
-        double newMass = op2.getMass();
-
-        // the com is transformed as any position
-        Position newCenterOfMass = transform<Position>(op1,Position(op2.getCenterOfMass()));
-
-        // the rotational inertial is rotated and then
-        // the parallel axis theorem applies
-        RotationalInertiaRaw newRotInertia;
-        Eigen::Map<Eigen::Matrix3d> newI(newRotInertia.data());
-        RotationalInertiaRaw oldRotInertiaWrtCom = op2.getRotationalInertiaWrtCenterOfMass();
-        Eigen::Map<const Eigen::Matrix3d> oldIWrtCom(oldRotInertiaWrtCom.data());
-
+        // The inertial parameters are transformed without computing
+        // the center of mass, i.e. without dividing by the mass
         Eigen::Map<const Matrix3dRowMajor> R(op1.getRotation().data());
-        Eigen::Map<const Eigen::Vector3d> newCOM(newCenterOfMass.data());
-
-        newI =  R*oldIWrtCom*R.transpose() - newMass*squareCrossProductMatrix(newCOM);
+        Eigen::Map<const Eigen::Vector3d> p(op1.getPosition().data());
 
-        return SpatialInertia(newMass,newCenterOfMass,newRotInertia);
+        const double * oldPacked = op2.packedData();
+        const double mass = oldPacked[0];
+        Eigen::Map<const Eigen::Vector3d> oldMcom(oldPacked+1);
+        Matrix3dRowMajor oldI;
+        internal::kernels::unpackSymmetric3(oldPacked+4,oldI.data());
+
+        // I_A = R I_B R^T - S(p)S(h) - S(h)S(p) - m S(p)^2 , with h = R c_B m
+        const Eigen::Vector3d h = R*oldMcom;
+        Matrix3dRowMajor newI = R*oldI*R.transpose() - (mass*p+h)*p.transpose() - p*h.transpose();
+        newI.diagonal().array() += 2.0*h.dot(p) + mass*p.squaredNorm();
+
+        SpatialInertia ret;
+        double * newPacked = ret.packedData();
+        newPacked[0] = mass;
+        Eigen::Map<Eigen::Vector3d>(newPacked+1) = h + mass*p;
+        packSymmetric3(newI,newPacked+4);
+        return ret;
     }
 
     template<>
@@ -413,33 +455,32 @@ std::string Transform::reservedToString() const
         Eigen::Map<const Matrix3dRowMajor> R(op1.getRotation().data());
         Eigen::Map<const Eigen::Vector3d> p(op1.getPosition().data());
 
-        /*
-         *
-         * TODO: document this simplifcation
-         */
-        Eigen::Map<const Matrix3dRowMajor> oldLinearLinear(op2.getLinearLinearSubmatrix().data());
-        Eigen::Map<const Matrix3dRowMajor> oldLinearAngular(op2.getLinearAngularSubmatrix().data());
-        Eigen::Map<const Matrix3dRowMajor> oldAngularAngular(op2.getAngularAngularSubmatrix().data());
-
-        ArticulatedBodyInertia newABI;
-
-        Eigen::Map<Matrix3dRowMajor> newLinearLinear(newABI.getLinearLinearSubmatrix().data());
-        Eigen::Map<Matrix3dRowMajor> newLinearAngular(newABI.getLinearAngularSubmatrix().data());
-        Eigen::Map<Matrix3dRowMajor> newAngularAngular(newABI.getAngularAngularSubmatrix().data());
+        const double * oldPacked = op2.packedData();
+        Matrix3dRowMajor oldLinearLinear, oldAngularAngular;
+        internal::kernels::unpackSymmetric3(oldPacked,oldLinearLinear.data());
+        Eigen::Map<const Matrix3dRowMajor> oldLinearAngular(oldPacked+6);
+        internal::kernels::unpackSymmetric3(oldPacked+15,oldAngularAngular.data());
 
-        newLinearLinear = R*oldLinearLinear*R.transpose();
+        Matrix3dRowMajor newLinearLinear = R*oldLinearLinear*R.transpose();
 
         Matrix3dRowMajor skewP = mySkew(p);
         Matrix3dRowMajor rotatedLinearAngular = R*oldLinearAngular*R.transpose();
 
+        ArticulatedBodyInertia newABI;
+        double * newPacked = newABI.packedData();
+
+        Eigen::Map<Matrix3dRowMajor> newLinearAngular(newPacked+6);
         newLinearAngular = rotatedLinearAngular - newLinearLinear*skewP;
 
         Matrix3dRowMajor skewPtimesrotatedLinearAngular = skewP*rotatedLinearAngular;
 
-        newAngularAngular =   R*oldAngularAngular*R.transpose()
-                            + skewPtimesrotatedLinearAngular
-                            + skewPtimesrotatedLinearAngular.transpose()
-                            - skewP*newLinearLinear*skewP;
+        Matrix3dRowMajor newAngularAngular =   R*oldAngularAngular*R.transpose()
+                                             + skewPtimesrotatedLinearAngular
+                                             + skewPtimesrotatedLinearAngular.transpose()
+                                             - skewP*newLinearLinear*skewP;
+
+        packSymmetric3(newLinearLinear,newPacked);
+        packSymmetric3(newAngularAngular,newPacked+15);
 
         return newABI;
     }
@@ -472,6 +513,26 @@ std::string Transform::reservedToString() const
         return ret;
     }
 
+    template<typename spatialVelType>
+    spatialVelType inverseTransformTwistEfficient(const Transform& op1, const spatialVelType& op2)
+    {
+        spatialVelType ret;
+        internal::kernels::inverseTransformMotion(op1.getRotation().data(),op1.getPosition().data(),
+                                                  op2.getLinearVec3().data(),op2.getAngularVec3().data(),
+                                                  ret.getLinearVec3().data(),ret.getAngularVec3().data());
+        return ret;
+    }
+
+    template<typename spatialForceType>
+    spatialForceType inverseTransformWrenchEfficient(const Transform& op1, const spatialForceType& op2)
+    {
+        spatialForceType ret;
+        internal::kernels::inverseTransformForce(op1.getRotation().data(),op1.getPosition().data(),
+                                                 op2.getLinearVec3().data(),op2.getAngularVec3().data(),
+                                                 ret.getLinearVec3().data(),ret.getAngularVec3().data());
+        return ret;
+    }
+
     Matrix4x4 Transform::asHomogeneousTransform() const
     {
         Matrix4x4 ret;
@@ -120,6 +120,35 @@ void checkInversion()
     ASSERT_EQUAL_VECTOR(aTrans.asVector(),aTransCheck.asVector());
 }
 
+void checkFusedOperations(const Transform & trans, const ArticulatedBodyInertia & inertia, const SpatialForceVector & U)
+{
+    double d = getRandomDouble(1.0,2.0);
+
+    // Fused congruence transform
+    ArticulatedBodyInertia accumulated = inertia;
+    accumulated.addTransformed(trans,inertia);
+    ArticulatedBodyInertia accumulatedCheck = inertia + trans*inertia;
+    ASSERT_EQUAL_MATRIX(accumulated.asMatrix(),accumulatedCheck.asMatrix());
+
+    // Fused rank 1 downdate
+    ArticulatedBodyInertia downdated = inertia;
+    downdated.subtractABADyad(U,d);
+    Matrix6x6 downdatedCheck = inertia.asMatrix();
+    Vector6 Uplain = U.asVector();
+    toEigen(downdatedCheck) -= toEigen(Uplain)*toEigen(Uplain).transpose()/d;
+    ASSERT_EQUAL_MATRIX(downdated.asMatrix(),downdatedCheck);
+    ASSERT_EQUAL_MATRIX(downdated.asMatrix(),(inertia-ArticulatedBodyInertia::ABADyadHelper(U,d)).asMatrix());
+
+    // The packed storage and the submatrices are consistent
+    Matrix6x6 fullMatrix = inertia.asMatrix();
+    ArticulatedBodyInertia fromBlocks;
+    fromBlocks.setLinearLinearSubmatrix(inertia.getLinearLinearSubmatrix());
+    fromBlocks.setLinearAngularSubmatrix(inertia.getLinearAngularSubmatrix());
+    fromBlocks.setAngularAngularSubmatrix(inertia.getAngularAngularSubmatrix());
+    ASSERT_EQUAL_MATRIX(fromBlocks.asMatrix(),fullMatrix);
+    ASSERT_EQUAL_MATRIX(ArticulatedBodyInertia(fullMatrix.data(),6,6).asMatrix(),fullMatrix);
+}
+
 int main()
 {
     Transform trans(Rotation::RPY(4.0,5.0,6.0),Position(10,30,-30));
@@ -140,5 +169,13 @@ int main()
     checkInvariance(trans,abi,twist);
     checkInversion();
 
+    for(int i=0; i < 10; i++)
+    {
+        ArticulatedBodyInertia randomAbi = ArticulatedBodyInertia(getRandomInertia());
+        Transform randomTrans = getRandomTransform();
+        checkInertiaTransformation(randomTrans,randomAbi);
+        checkFusedOperations(randomTrans,randomAbi,getRandomWrench());
+    }
+
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Core/CompressedColumnJacobian.h>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/Core/EigenSparseHelpers.h>
+#include <iDynTree/Core/TestUtils.h>
+
+#include <cstdlib>
+
+using namespace iDynTree;
+
+void fillRandomJacobian(CompressedColumnJacobian & jacobian, MatrixDynSize & denseCheck)
+{
+    denseCheck.resize(jacobian.rows(),jacobian.columns());
+    denseCheck.zero();
+
+    for (unsigned k = 0; k < jacobian.getNrOfNonZeroColumns(); k++)
+    {
+        double * column = jacobian.nonZeroColumnBuffer(k);
+        for (unsigned row = 0; row < jacobian.rows(); row++)
+        {
+            column[row] = getRandomDouble();
+            denseCheck(row,jacobian.getNonZeroColumns()[k]) = column[row];
+        }
+    }
+}
+
+void testCompressedColumnJacobian()
+{
+    CompressedColumnJacobian jacobian(6,20);
+    ASSERT_IS_TRUE(jacobian.getNrOfNonZeroColumns() == 0);
+    ASSERT_IS_TRUE(jacobian.numberOfNonZeros() == 0);
+
+    // Not sorted or out of bounds patterns are rejected
+    std::vector<int> wrongPattern;
+    wrongPattern.push_back(3);
+    wrongPattern.push_back(1);
+    ASSERT_IS_FALSE(jacobian.setNonZeroColumns(wrongPattern));
+    wrongPattern.clear();
+    wrongPattern.push_back(20);
+    ASSERT_IS_FALSE(jacobian.setNonZeroColumns(wrongPattern));
+
+    std::vector<int> pattern;
+    for (int col = 0; col < 6; col++)
+    {
+        pattern.push_back(col);
+    }
+    pattern.push_back(8);
+    pattern.push_back(13);
+    pattern.push_back(19);
+    ASSERT_IS_TRUE(jacobian.setNonZeroColumns(pattern));
+    ASSERT_IS_TRUE(jacobian.getNrOfNonZeroColumns() == pattern.size());
+    ASSERT_IS_TRUE(jacobian.numberOfNonZeros() == 6*pattern.size());
+
+    MatrixDynSize denseCheck;
+    fillRandomJacobian(jacobian,denseCheck);
+
+    // Dense conversion
+    MatrixDynSize dense;
+    jacobian.toDense(dense);
+    ASSERT_EQUAL_MATRIX(dense,denseCheck);
+
+    // Eigen conversion
+    MatrixDynSize denseFromEigen(6,20);
+    toEigen(denseFromEigen) = Eigen::MatrixXd(toEigen(jacobian));
+    ASSERT_EQUAL_MATRIX(denseFromEigen,denseCheck);
+
+    // SparseMatrix conversion
+    SparseMatrix<ColumnMajor> sparseColMajor;
+    SparseMatrix<RowMajor> sparseRowMajor;
+    jacobian.toSparseMatrix(sparseColMajor);
+    jacobian.toSparseMatrix(sparseRowMajor);
+    ASSERT_IS_TRUE(sparseColMajor.numberOfNonZeros() == jacobian.numberOfNonZeros());
+    for (unsigned row = 0; row < 6; row++)
+    {
+        for (unsigned col = 0; col < 20; col++)
+        {
+            ASSERT_EQUAL_DOUBLE(sparseColMajor(row,col),denseCheck(row,col));
+            ASSERT_EQUAL_DOUBLE(sparseRowMajor(row,col),denseCheck(row,col));
+        }
+    }
+
+    // Setting the same pattern preserves the values, setting a different one zeroes them
+    ASSERT_IS_TRUE(jacobian.setNonZeroColumns(pattern));
+    jacobian.toDense(dense);
+    ASSERT_EQUAL_MATRIX(dense,denseCheck);
+
+    pattern.pop_back();
+    ASSERT_IS_TRUE(jacobian.setNonZeroColumns(pattern));
+    ASSERT_IS_TRUE(jacobian.numberOfNonZeros() == 6*pattern.size());
+    MatrixDynSize zeroMatrix(6,20);
+    zeroMatrix.zero();
+    jacobian.toDense(dense);
+    ASSERT_EQUAL_MATRIX(dense,zeroMatrix);
+
+    // An empty pattern should give an empty sparse matrix
+    ASSERT_IS_TRUE(jacobian.setNonZeroColumns(std::vector<int>()));
+    jacobian.toSparseMatrix(sparseColMajor);
+    ASSERT_IS_TRUE(sparseColMajor.numberOfNonZeros() == 0);
+}
+
+int main()
+{
+    testCompressedColumnJacobian();
+
+    return EXIT_SUCCESS;
+}
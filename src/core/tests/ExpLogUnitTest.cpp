@@ -9,6 +9,8 @@
  */
 
 #include <iDynTree/Core/Axis.h>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/Core/ExpLog.h>
 #include <iDynTree/Core/Transform.h>
 #include <iDynTree/Core/Utils.h>
 #include <iDynTree/Core/TestUtils.h>
@@ -35,6 +37,127 @@ void validateLogExpConsistency(const iDynTree::SpatialMotionVector & vec)
     ASSERT_EQUAL_VECTOR(vec,vecCheck);
 }
 
+SpatialMotionVector getTestTwist(const double angle, const double linearNorm)
+{
+    // Deterministic twist with an angular part of norm angle
+    SpatialMotionVector xi;
+    Eigen::Vector3d axis(0.3,-0.5,0.8);
+    toEigen(xi.getAngularVec3()) = angle*axis.normalized();
+    toEigen(xi.getLinearVec3()) = linearNorm*Eigen::Vector3d(-0.7,0.1,0.4).normalized();
+    return xi;
+}
+
+void validateSO3(const AngularMotionVector3 & phi)
+{
+    // exp is consistent with the existing so(3) exp
+    ASSERT_EQUAL_MATRIX_TOL(expSO3(phi),phi.exp(),1e-14);
+    ASSERT_EQUAL_VECTOR_TOL(logSO3(expSO3(phi)),phi,1e-12);
+
+    Matrix3x3 Jl = leftJacobianSO3(phi);
+    Matrix3x3 Jr = rightJacobianSO3(phi);
+    Eigen::Matrix3d identity = Eigen::Matrix3d::Identity();
+    ASSERT_IS_TRUE((toEigen(Jl)*toEigen(leftJacobianInverseSO3(phi))).isApprox(identity,1e-12));
+    ASSERT_IS_TRUE((toEigen(Jr)*toEigen(rightJacobianInverseSO3(phi))).isApprox(identity,1e-12));
+
+    // exp(phi + delta) = exp(Jl delta) exp(phi) = exp(phi) exp(Jr delta), checked with central differences
+    const double eps = 1e-6;
+    Rotation expPhi = expSO3(phi);
+    for(int i=0; i < 3; i++)
+    {
+        AngularMotionVector3 phiPlus = phi, phiMinus = phi;
+        phiPlus(i) += eps;
+        phiMinus(i) -= eps;
+        Eigen::Vector3d leftNumerical = (toEigen(logSO3(expSO3(phiPlus)*expPhi.inverse()))
+                                        -toEigen(logSO3(expSO3(phiMinus)*expPhi.inverse())))/(2*eps);
+        Eigen::Vector3d rightNumerical = (toEigen(logSO3(expPhi.inverse()*expSO3(phiPlus)))
+                                         -toEigen(logSO3(expPhi.inverse()*expSO3(phiMinus))))/(2*eps);
+        ASSERT_IS_TRUE((leftNumerical-toEigen(Jl).col(i)).norm() < 1e-8);
+        ASSERT_IS_TRUE((rightNumerical-toEigen(Jr).col(i)).norm() < 1e-8);
+    }
+}
+
+void validateSE3(const SpatialMotionVector & xi)
+{
+    Transform expXi = expSE3(xi);
+    ASSERT_EQUAL_VECTOR_TOL(logSE3(expXi),xi,1e-12);
+    ASSERT_EQUAL_MATRIX_TOL(expXi.getRotation(),expSO3(xi.getAngularVec3()),1e-14);
+
+    // The exponential of a constant twist is the solution of dH/dt = H xi^ , so it has the group property
+    Transform expHalfXi = expSE3(xi*0.5);
+    ASSERT_EQUAL_TRANSFORM_TOL(expHalfXi*expHalfXi,expXi,1e-12);
+
+    Matrix6x6 Jl = leftJacobianSE3(xi);
+    Matrix6x6 Jr = rightJacobianSE3(xi);
+    Eigen::Matrix<double,6,6> identity = Eigen::Matrix<double,6,6>::Identity();
+    ASSERT_IS_TRUE((toEigen(Jl)*toEigen(leftJacobianInverseSE3(xi))).isApprox(identity,1e-12));
+    ASSERT_IS_TRUE((toEigen(Jr)*toEigen(rightJacobianInverseSE3(xi))).isApprox(identity,1e-12));
+
+    // The Jacobians are related by the adjoint of exp(xi)
+    ASSERT_IS_TRUE((toEigen(Jl)).isApprox(toEigen(expXi.asAdjointTransform())*toEigen(Jr),1e-12));
+
+    const double eps = 1e-6;
+    for(int i=0; i < 6; i++)
+    {
+        SpatialMotionVector xiPlus = xi, xiMinus = xi;
+        xiPlus(i) += eps;
+        xiMinus(i) -= eps;
+        Eigen::Matrix<double,6,1> leftNumerical = (toEigen(logSE3(expSE3(xiPlus)*expXi.inverse()))
+                                                  -toEigen(logSE3(expSE3(xiMinus)*expXi.inverse())))/(2*eps);
+        Eigen::Matrix<double,6,1> rightNumerical = (toEigen(logSE3(expXi.inverse()*expSE3(xiPlus)))
+                                                   -toEigen(logSE3(expXi.inverse()*expSE3(xiMinus))))/(2*eps);
+        ASSERT_IS_TRUE((leftNumerical-toEigen(Jl).col(i)).norm() < 1e-8);
+        ASSERT_IS_TRUE((rightNumerical-toEigen(Jr).col(i)).norm() < 1e-8);
+    }
+}
+
+void validateContinuity(const double angle)
+{
+    // The functions switch between closed form and Taylor expansion around some angles,
+    // so check that there are no jumps
+    const double delta = 1e-10;
+    SpatialMotionVector xiBelow = getTestTwist(angle-delta,1.0);
+    SpatialMotionVector xiAbove = getTestTwist(angle+delta,1.0);
+
+    ASSERT_EQUAL_TRANSFORM_TOL(expSE3(xiBelow),expSE3(xiAbove),1e-9);
+    ASSERT_EQUAL_MATRIX_TOL(leftJacobianSE3(xiBelow),leftJacobianSE3(xiAbove),1e-9);
+    ASSERT_EQUAL_MATRIX_TOL(leftJacobianInverseSE3(xiBelow),leftJacobianInverseSE3(xiAbove),1e-9);
+}
+
+void validateLieGroupMaps()
+{
+    double angles[] = {0.0, 1e-12, 1e-6, 1e-3, 0.1, 0.2499, 0.2501, 1.0, 2.0, 3.0, 3.1};
+    for(size_t i=0; i < sizeof(angles)/sizeof(double); i++)
+    {
+        SpatialMotionVector xi = getTestTwist(angles[i],1.5);
+        validateSO3(xi.getAngularVec3());
+        validateSE3(xi);
+    }
+
+    // Pure translation
+    SpatialMotionVector translation = getTestTwist(0.0,2.0);
+    Transform expTranslation = expSE3(translation);
+    ASSERT_EQUAL_VECTOR(expTranslation.getPosition(),translation.getLinearVec3());
+    ASSERT_EQUAL_MATRIX(expTranslation.getRotation(),Rotation::Identity());
+
+    // Screw motion: rotation of pi/2 around z, with a translation along z
+    SpatialMotionVector screw;
+    screw.zero();
+    screw(2) = 0.3;
+    screw(5) = M_PI/2;
+    Transform expScrew = expSE3(screw);
+    ASSERT_EQUAL_MATRIX(expScrew.getRotation(),Rotation::RotZ(M_PI/2));
+    ASSERT_EQUAL_VECTOR(expScrew.getPosition(),Position(0.0,0.0,0.3));
+
+    // Rotation around an axis not passing through the origin
+    screw.zero();
+    screw(1) = -M_PI; // v = -omega x r, with r = (1,0,0)
+    screw(5) = M_PI;
+    expScrew = expSE3(screw);
+    ASSERT_EQUAL_VECTOR(expScrew.getPosition(),Position(2.0,0.0,0.0));
+
+    validateContinuity(0.25);
+}
+
 int main()
 {
     // test setters and getters
@@ -56,5 +179,7 @@ int main()
 
     validateLogExpConsistency(vec);
 
+    validateLieGroupMaps();
+
     return EXIT_SUCCESS;
 }
\ No newline at end of file
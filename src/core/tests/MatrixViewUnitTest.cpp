@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Core/MatrixView.h>
+#include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/MatrixFixSize.h>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/Core/TestUtils.h>
+
+using namespace iDynTree;
+
+template<typename ViewType, typename EigenType>
+void checkViewAgainstEigen(const ViewType & view, const EigenType & mat)
+{
+    ASSERT_EQUAL_DOUBLE(view.rows(), mat.rows());
+    ASSERT_EQUAL_DOUBLE(view.cols(), mat.cols());
+    for (int r = 0; r < mat.rows(); r++)
+    {
+        for (int c = 0; c < mat.cols(); c++)
+        {
+            ASSERT_EQUAL_DOUBLE(view(r,c), mat(r,c));
+        }
+    }
+}
+
+void checkIDynTreeMatrices()
+{
+    MatrixDynSize dynMat(4,7);
+    getRandomMatrix(dynMat);
+
+    MatrixView<double> dynView(dynMat);
+    ASSERT_IS_TRUE(dynView.storageOrder() == RowMajor);
+    checkViewAgainstEigen(dynView, toEigen(dynMat));
+
+    // Writing through the view modifies the underlying matrix
+    dynView(2,5) = 42.0;
+    ASSERT_EQUAL_DOUBLE(dynMat(2,5), 42.0);
+
+    Matrix3x3 fixMat;
+    getRandomMatrix(fixMat);
+    const Matrix3x3 & constFixMat = fixMat;
+    MatrixView<const double> fixView(constFixMat);
+    checkViewAgainstEigen(fixView, toEigen(fixMat));
+
+    // Conversion from non-const to const view
+    MatrixView<const double> constDynView = dynView;
+    checkViewAgainstEigen(constDynView, toEigen(dynMat));
+}
+
+void checkEigenMatrices()
+{
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> rowMajor(5,3);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::ColMajor> colMajor(5,3);
+    rowMajor.setRandom();
+    colMajor.setRandom();
+
+    MatrixView<double> rowView(rowMajor);
+    MatrixView<double> colView(colMajor);
+    ASSERT_IS_TRUE(rowView.storageOrder() == RowMajor);
+    ASSERT_IS_TRUE(colView.storageOrder() == ColumnMajor);
+    checkViewAgainstEigen(rowView, rowMajor);
+    checkViewAgainstEigen(colView, colMajor);
+
+    // Blocks of the views are consistent with the Eigen blocks
+    checkViewAgainstEigen(rowView.block(1,1,3,2), rowMajor.block(1,1,3,2));
+    checkViewAgainstEigen(colView.block(2,0,2,3), colMajor.block(2,0,2,3));
+
+    // Views built from Eigen blocks honor the Eigen strides
+    auto colBlock = colMajor.block(1,1,3,2);
+    checkViewAgainstEigen(make_matrix_view(colBlock), colMajor.block(1,1,3,2));
+
+    // toEigen of a view maps the same memory, for any storage ordering
+    ASSERT_IS_TRUE(toEigen(rowView).isApprox(rowMajor));
+    ASSERT_IS_TRUE(toEigen(colView).isApprox(colMajor));
+    ASSERT_IS_TRUE(toEigen(rowView.block(1,0,4,2)).isApprox(rowMajor.block(1,0,4,2)));
+    toEigen(colView.block(0,1,5,2)) = rowMajor.block(0,0,5,2);
+    ASSERT_IS_TRUE(colMajor.block(0,1,5,2).isApprox(rowMajor.block(0,0,5,2)));
+
+    // Raw buffers
+    double buffer[6] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    MatrixView<const double> rawRowMajor = make_matrix_view(static_cast<const double*>(buffer), 2, 3, RowMajor);
+    MatrixView<const double> rawColMajor = make_matrix_view(static_cast<const double*>(buffer), 2, 3, ColumnMajor);
+    ASSERT_EQUAL_DOUBLE(rawRowMajor(1,0), 4.0);
+    ASSERT_EQUAL_DOUBLE(rawColMajor(1,0), 2.0);
+    ASSERT_EQUAL_DOUBLE(rawColMajor(0,2), 5.0);
+}
+
+int main()
+{
+    checkIDynTreeMatrices();
+    checkEigenMatrices();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Core/MultiCubicSpline.h>
+#include <iDynTree/Core/CubicSpline.h>
+#include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/VectorDynSize.h>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/Core/TestUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace iDynTree;
+
+// Knots with non uniform spacing
+VectorDynSize getKnotTimes(size_t nrOfKnots, double initialTime)
+{
+    VectorDynSize time(nrOfKnots);
+    time(0) = initialTime;
+    for(size_t i=1; i < nrOfKnots; i++)
+    {
+        time(i) = time(i-1) + 0.1 + 0.05*std::sin(static_cast<double>(i));
+    }
+    return time;
+}
+
+void checkConsistencyWithCubicSpline(size_t nrOfChannels, size_t nrOfKnots)
+{
+    VectorDynSize time = getKnotTimes(nrOfKnots,1.0);
+    MatrixDynSize yData(nrOfChannels,nrOfKnots);
+    VectorDynSize v0(nrOfChannels), a0(nrOfChannels), vf(nrOfChannels), af(nrOfChannels);
+    getRandomMatrix(yData);
+    getRandomVector(v0);
+    getRandomVector(a0);
+    getRandomVector(vf);
+    getRandomVector(af);
+
+    MultiCubicSpline multiSpline(nrOfChannels,nrOfKnots);
+    ASSERT_IS_TRUE(multiSpline.setInitialConditions(v0,a0));
+    ASSERT_IS_TRUE(multiSpline.setFinalConditions(vf,af));
+    ASSERT_IS_TRUE(multiSpline.setData(time,yData));
+    ASSERT_EQUAL_DOUBLE(multiSpline.getNrOfChannels(),nrOfChannels);
+    ASSERT_EQUAL_DOUBLE(multiSpline.getNrOfKnots(),nrOfKnots);
+
+    std::vector<CubicSpline> splines(nrOfChannels);
+    for(size_t channel=0; channel < nrOfChannels; channel++)
+    {
+        VectorDynSize channelData(nrOfKnots);
+        toEigen(channelData) = toEigen(yData).row(channel).transpose();
+        splines[channel].setInitialConditions(v0(channel),a0(channel));
+        splines[channel].setFinalConditions(vf(channel),af(channel));
+        ASSERT_IS_TRUE(splines[channel].setData(time,channelData));
+    }
+
+    // Monotonically increasing times, including times out of the knots range
+    // and times falling exactly on the knots
+    std::vector<double> evaluationTimes;
+    for(double t = time(0)-0.1; t < time(nrOfKnots-1)+0.1; t += 0.013)
+    {
+        evaluationTimes.push_back(t);
+    }
+    for(size_t i=0; i < nrOfKnots; i++)
+    {
+        evaluationTimes.push_back(time(i));
+    }
+    std::sort(evaluationTimes.begin(),evaluationTimes.end());
+
+    VectorDynSize pos(nrOfChannels), vel(nrOfChannels), acc(nrOfChannels), posOnly(nrOfChannels);
+    for(size_t i=0; i < evaluationTimes.size(); i++)
+    {
+        double t = evaluationTimes[i];
+        ASSERT_IS_TRUE(multiSpline.evaluatePoint(t,pos,vel,acc));
+        ASSERT_IS_TRUE(multiSpline.evaluatePoint(t,posOnly));
+        ASSERT_EQUAL_VECTOR(pos,posOnly);
+
+        for(size_t channel=0; channel < nrOfChannels; channel++)
+        {
+            double expectedVel, expectedAcc;
+            double expectedPos = splines[channel].evaluatePoint(t,expectedVel,expectedAcc);
+            ASSERT_EQUAL_DOUBLE_TOL(pos(channel),expectedPos,1e-9);
+            ASSERT_EQUAL_DOUBLE_TOL(vel(channel),expectedVel,1e-8);
+            ASSERT_EQUAL_DOUBLE_TOL(acc(channel),expectedAcc,1e-6);
+        }
+    }
+
+    // Batch evaluation, in reverse order (so that the cursor is not useful) and
+    // with outputs of different storage ordering
+    std::vector<double> reversedTimes(evaluationTimes.rbegin(),evaluationTimes.rend());
+    MatrixDynSize batchPos(nrOfChannels,reversedTimes.size());
+    Eigen::MatrixXd batchVel(nrOfChannels,reversedTimes.size()), batchAcc(nrOfChannels,reversedTimes.size());
+    ASSERT_IS_TRUE(multiSpline.evaluateBatch(reversedTimes,batchPos,batchVel,batchAcc));
+
+    for(size_t i=0; i < reversedTimes.size(); i++)
+    {
+        ASSERT_IS_TRUE(multiSpline.evaluatePoint(reversedTimes[i],pos,vel,acc));
+        ASSERT_IS_TRUE(toEigen(pos).isApprox(toEigen(batchPos).col(i)));
+        ASSERT_IS_TRUE(toEigen(vel).isApprox(batchVel.col(i)));
+        ASSERT_IS_TRUE(toEigen(acc).isApprox(batchAcc.col(i)));
+    }
+}
+
+void checkCubicReproduction()
+{
+    // A cubic polynomial is interpolated exactly, if the boundary velocities are the exact ones
+    const size_t nrOfChannels = 5;
+    for(size_t nrOfKnots = 2; nrOfKnots <= 6; nrOfKnots++)
+    {
+        VectorDynSize time = getKnotTimes(nrOfKnots,-0.5);
+        MatrixDynSize parameters(nrOfChannels,4);
+        getRandomMatrix(parameters);
+
+        MatrixDynSize yData(nrOfChannels,nrOfKnots);
+        VectorDynSize v0(nrOfChannels), a0(nrOfChannels), vf(nrOfChannels), af(nrOfChannels);
+        double t0 = time(0);
+        double tf = time(nrOfKnots-1);
+        for(size_t channel=0; channel < nrOfChannels; channel++)
+        {
+            const double p0 = parameters(channel,0), p1 = parameters(channel,1);
+            const double p2 = parameters(channel,2), p3 = parameters(channel,3);
+            for(size_t knot=0; knot < nrOfKnots; knot++)
+            {
+                double t = time(knot);
+                yData(channel,knot) = p0 + p1*t + p2*t*t + p3*t*t*t;
+            }
+            v0(channel) = p1 + 2*p2*t0 + 3*p3*t0*t0;
+            a0(channel) = 2*p2 + 6*p3*t0;
+            vf(channel) = p1 + 2*p2*tf + 3*p3*tf*tf;
+            af(channel) = 2*p2 + 6*p3*tf;
+        }
+
+        MultiCubicSpline multiSpline;
+        ASSERT_IS_TRUE(multiSpline.setData(time,yData));
+        // The conditions can also be set after the data
+        ASSERT_IS_TRUE(multiSpline.setInitialConditions(v0,a0));
+        ASSERT_IS_TRUE(multiSpline.setFinalConditions(vf,af));
+
+        VectorDynSize pos(nrOfChannels), vel(nrOfChannels), acc(nrOfChannels);
+        for(double t = t0; t < tf; t += 0.01)
+        {
+            ASSERT_IS_TRUE(multiSpline.evaluatePoint(t,pos,vel,acc));
+            for(size_t channel=0; channel < nrOfChannels; channel++)
+            {
+                const double p0 = parameters(channel,0), p1 = parameters(channel,1);
+                const double p2 = parameters(channel,2), p3 = parameters(channel,3);
+                ASSERT_EQUAL_DOUBLE_TOL(pos(channel),p0 + p1*t + p2*t*t + p3*t*t*t,1e-9);
+                ASSERT_EQUAL_DOUBLE_TOL(vel(channel),p1 + 2*p2*t + 3*p3*t*t,1e-8);
+                ASSERT_EQUAL_DOUBLE_TOL(acc(channel),2*p2 + 6*p3*t,1e-6);
+            }
+        }
+    }
+}
+
+void checkWrongInputs()
+{
+    MultiCubicSpline multiSpline;
+    VectorDynSize pos(3), vel(3), acc(3);
+    ASSERT_IS_FALSE(multiSpline.evaluatePoint(0.0,pos));
+
+    VectorDynSize time(4);
+    MatrixDynSize yData(3,4);
+    time(0) = 0.0; time(1) = 1.0; time(2) = 1.0; time(3) = 2.0;
+    yData.zero();
+    ASSERT_IS_FALSE(multiSpline.setData(time,yData));
+
+    time(2) = 1.5;
+    ASSERT_IS_TRUE(multiSpline.setData(time,yData));
+    MatrixDynSize wrongYData(3,3);
+    ASSERT_IS_FALSE(multiSpline.setData(time,wrongYData));
+
+    VectorDynSize wrongSize(2);
+    ASSERT_IS_FALSE(multiSpline.evaluatePoint(0.5,wrongSize));
+    ASSERT_IS_FALSE(multiSpline.setInitialConditions(wrongSize,wrongSize));
+}
+
+int main()
+{
+    checkConsistencyWithCubicSpline(1,2);
+    checkConsistencyWithCubicSpline(7,4);
+    checkConsistencyWithCubicSpline(32,25);
+    checkCubicReproduction();
+    checkWrongInputs();
+
+    return EXIT_SUCCESS;
+}
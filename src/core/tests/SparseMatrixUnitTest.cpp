@@ -202,6 +202,83 @@ void testRowColumnMajorConversion(SparseMatrix<iDynTree::RowMajor> matrix)
     std::cout << "------------------------------------" << std::endl;
 }
 
+template <iDynTree::MatrixStorageOrdering ordering>
+void testFrozenSparsityPattern()
+{
+    std::cout << "------------------------------------" << std::endl;
+    std::cout << "testFrozenSparsityPattern" << std::endl;
+    SparseMatrix<ordering> matrix(5, 5);
+    Triplets triplets;
+    triplets.pushTriplet(iDynTree::Triplet(4, 4, 8));
+    triplets.pushTriplet(iDynTree::Triplet(0, 0, -6));
+    triplets.pushTriplet(iDynTree::Triplet(2, 0, 7));
+    triplets.pushTriplet(iDynTree::Triplet(0, 1, 3));
+    triplets.pushTriplet(iDynTree::Triplet(0, 0, 5));
+    triplets.pushTriplet(iDynTree::Triplet(1, 4, 17));
+    triplets.pushTriplet(iDynTree::Triplet(2, 3, 1));
+
+    ASSERT_IS_FALSE(matrix.setValuesFromTriplets(triplets));
+
+    // The non-const accessor inserts the elements outside of the pattern,
+    // so the values are compared through a const reference
+    const SparseMatrix<ordering>& constMatrix = matrix;
+
+    matrix.freezeSparsityPattern(triplets);
+    ASSERT_IS_TRUE(matrix.isSparsityPatternFrozen());
+    ASSERT_EQUAL_DOUBLE(matrix.numberOfNonZeros(), 6);
+    ASSERT_EQUAL_DOUBLE(constMatrix(0, 0), -1);
+    ASSERT_EQUAL_DOUBLE(constMatrix(4, 4), 8);
+
+    // Update only the values, with the same rows and columns
+    const double* valuesBuffer = matrix.valuesBuffer();
+    for (int iter = 0; iter < 3; iter++) {
+        Triplets newTriplets;
+        double offset = 10.0 * (iter + 1);
+        for (Triplets::const_iterator it(triplets.begin()); it != triplets.end(); ++it) {
+            newTriplets.pushTriplet(iDynTree::Triplet(it->row, it->column, it->value + offset));
+        }
+
+        ASSERT_IS_TRUE(matrix.setValuesFromTriplets(newTriplets));
+
+        // The structure is unchanged, and no reallocation happened
+        ASSERT_IS_TRUE(valuesBuffer == matrix.valuesBuffer());
+        ASSERT_EQUAL_DOUBLE(matrix.numberOfNonZeros(), 6);
+
+        // The result is the same of rebuilding the matrix from the triplets
+        SparseMatrix<ordering> check(5, 5);
+        check.setFromConstTriplets(newTriplets);
+        const SparseMatrix<ordering>& constCheck = check;
+        for (unsigned row = 0; row < 5; ++row) {
+            for (unsigned col = 0; col < 5; ++col) {
+                ASSERT_EQUAL_DOUBLE(constMatrix(row, col), constCheck(row, col));
+            }
+        }
+    }
+
+    // A wrong number of triplets is rejected
+    Triplets wrongTriplets(triplets);
+    wrongTriplets.pushTriplet(iDynTree::Triplet(3, 3, 1));
+    ASSERT_IS_FALSE(matrix.setValuesFromTriplets(wrongTriplets));
+
+    // Writing an element of the pattern keeps it frozen
+    matrix(2, 0) = 4;
+    ASSERT_IS_TRUE(matrix.isSparsityPatternFrozen());
+    ASSERT_IS_TRUE(matrix.setValuesFromTriplets(triplets));
+
+    // Writing an element outside of the pattern inserts it, and releases the pattern
+    matrix(3, 2) = 2;
+    ASSERT_IS_FALSE(matrix.isSparsityPatternFrozen());
+    ASSERT_EQUAL_DOUBLE(matrix.numberOfNonZeros(), 7);
+    ASSERT_IS_FALSE(matrix.setValuesFromTriplets(triplets));
+
+    // Changing the structure releases the pattern
+    matrix.freezeSparsityPattern(triplets);
+    ASSERT_IS_TRUE(matrix.isSparsityPatternFrozen());
+    matrix.setFromConstTriplets(wrongTriplets);
+    ASSERT_IS_FALSE(matrix.isSparsityPatternFrozen());
+    ASSERT_IS_FALSE(matrix.setValuesFromTriplets(wrongTriplets));
+}
+
 int main()
 {
     std::cerr << "Testing RowMajor ordering" << std::endl;
@@ -209,6 +286,7 @@ int main()
     testCreateMatrixFromAccessorOperator<iDynTree::RowMajor>();
     testCreateMatrixFromTriplets<iDynTree::RowMajor>();
     testCreateMatrixFromDuplicateTriplets<iDynTree::RowMajor>();
+    testFrozenSparsityPattern<iDynTree::RowMajor>();
 
     SparseMatrix<iDynTree::RowMajor> matrix(5, 5);
     Triplets triplets;
@@ -232,6 +310,7 @@ int main()
     testCreateMatrixFromAccessorOperator<iDynTree::ColumnMajor>();
     testCreateMatrixFromTriplets<iDynTree::ColumnMajor>();
     testCreateMatrixFromDuplicateTriplets<iDynTree::ColumnMajor>();
+    testFrozenSparsityPattern<iDynTree::ColumnMajor>();
 
 
     std::cerr << "Testing RowMajor-ColumnMajor conversions" << std::endl;
@@ -75,6 +75,38 @@ void checkInertiaTransformation(const Transform & trans, const SpatialInertia &
     ASSERT_EQUAL_MATRIX(inertiaTranslatedCheck,inertiaTranslatedRaw);
 }
 
+void checkAddTransformed(const Transform & trans, const SpatialInertia & inertia)
+{
+    SpatialInertia accumulated = inertia;
+    accumulated.addTransformed(trans,inertia);
+    SpatialInertia accumulatedCheck = inertia + trans*inertia;
+    ASSERT_EQUAL_MATRIX(accumulated.asMatrix(),accumulatedCheck.asMatrix());
+
+    // The accumulated and the transformed inertia can be the same object
+    accumulated = inertia;
+    accumulated.addTransformed(trans,accumulated);
+    ASSERT_EQUAL_MATRIX(accumulated.asMatrix(),accumulatedCheck.asMatrix());
+}
+
+void checkPackedStorage(const SpatialInertia & inertia)
+{
+    // The packed storage is the inertial parameters vector
+    Vector10 params = inertia.asVector();
+    for(unsigned int i=0; i < SpatialInertia::PackedSize; i++)
+    {
+        ASSERT_EQUAL_DOUBLE(params(i),inertia.packedData()[i]);
+    }
+
+    SpatialInertia inertiaCheck;
+    inertiaCheck.fromVector(params);
+    ASSERT_EQUAL_MATRIX(inertiaCheck.asMatrix(),inertia.asMatrix());
+
+    Matrix3x3 rotInertiaBlock;
+    toEigen(rotInertiaBlock) = toEigen(inertia.asMatrix()).block<3,3>(3,3);
+    ASSERT_EQUAL_MATRIX(inertia.getRotationalInertiaWrtFrameOrigin(),rotInertiaBlock);
+    ASSERT_EQUAL_DOUBLE(inertia.getMass(),params(0));
+}
+
 void checkInertiaTwistProduct(const SpatialInertia & inertia, const Twist & twist)
 {
     SpatialMomentum momentum = inertia*twist;
@@ -143,6 +175,14 @@ void checkBiasWrench(const SpatialInertia & inertia, const Twist & twist)
     ASSERT_EQUAL_VECTOR(biasWrench.asVector(),biasWrenchCheck.asVector());
 }
 
+void checkNetWrench(const SpatialInertia & inertia, const SpatialAcc & acc, const Twist & twist)
+{
+    Wrench netWrench = inertia.netWrench(acc,twist);
+    Wrench netWrenchCheck = inertia*acc + twist*(inertia*twist);
+
+    ASSERT_EQUAL_VECTOR(netWrench.asVector(),netWrenchCheck.asVector());
+}
+
 void checkRegressors(const SpatialInertia & I,
                      const Twist & v,
                      const SpatialAcc & a,
@@ -457,6 +497,8 @@ int main()
     checkInertiaTransformation(trans,inertia);
     checkInvariance(trans,inertia,twist);
     checkBiasWrench(inertia,twist);
+    checkAddTransformed(trans,inertia);
+    checkPackedStorage(inertia);
 
     inertia = getNonPhysicalConsistentInertia();
 
@@ -474,6 +516,9 @@ int main()
         SpatialAcc a  = getRandomTwist();
 
         checkRegressors(inertia,twist,a,twist2);
+        checkInertiaTransformation(getRandomTransform(),inertia);
+        checkBiasWrench(inertia,twist);
+        checkNetWrench(inertia,a,twist);
 
         checkInertiaNonLinearParametrization();
         checkInertiaNonLinearParametrizationGradient();
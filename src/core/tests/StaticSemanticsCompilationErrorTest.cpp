@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Core/StaticSemantics.h>
+#include <cstdlib>
+
+using namespace iDynTree;
+using namespace iDynTree::StaticSemantics;
+
+struct A;
+struct B;
+struct C;
+
+int main()
+{
+    // A_X_B * C_v does not change the frame of a twist expressed in C,
+    // so this should result in a compilation error
+    FrameTransform<A,B> A_X_B;
+    FrameTwist<C,A,C> C_v;
+    A_X_B*C_v;
+
+    return EXIT_SUCCESS;
+}
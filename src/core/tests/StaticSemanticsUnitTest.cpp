@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Core/StaticSemantics.h>
+#include <iDynTree/Core/TestUtils.h>
+
+#include <cstdlib>
+
+using namespace iDynTree;
+using namespace iDynTree::StaticSemantics;
+
+// Frame tags
+struct World;
+struct Base;
+struct Hand;
+struct Point;
+
+// The wrappers do not add any storage to the wrapped classes
+static_assert(sizeof(FrameTransform<World,Base>) == sizeof(Transform), "FrameTransform has a different size of Transform");
+static_assert(sizeof(FramePosition<World,Point>) == sizeof(Position), "FramePosition has a different size of Position");
+static_assert(sizeof(FrameTwist<Hand,World,Base>) == sizeof(Twist), "FrameTwist has a different size of Twist");
+static_assert(sizeof(FrameWrench<Hand,Base>) == sizeof(Wrench), "FrameWrench has a different size of Wrench");
+
+void checkConsistencyWithRawClasses()
+{
+    Transform world_H_base_raw = getRandomTransform();
+    Transform base_H_hand_raw = getRandomTransform();
+    Position hand_p_raw = getRandomPosition();
+    Twist hand_v_raw = getRandomTwist();
+    Wrench hand_f_raw = getRandomWrench();
+
+    FrameTransform<World,Base> world_H_base(world_H_base_raw);
+    FrameTransform<Base,Hand> base_H_hand(base_H_hand_raw);
+    FramePosition<Hand,Point> hand_p(hand_p_raw);
+    FrameTwist<Hand,World,Hand> hand_v(hand_v_raw);
+    FrameWrench<Hand,Hand> hand_f(hand_f_raw);
+
+    // Composition and inverse
+    FrameTransform<World,Hand> world_H_hand = world_H_base*base_H_hand;
+    ASSERT_EQUAL_TRANSFORM(world_H_hand.raw(), world_H_base_raw*base_H_hand_raw);
+    FrameTransform<Hand,World> hand_H_world = world_H_hand.inverse();
+    ASSERT_EQUAL_TRANSFORM(hand_H_world.raw(), (world_H_base_raw*base_H_hand_raw).inverse());
+    typedef FrameTransform<Hand,Hand> HandTransform;
+    ASSERT_EQUAL_TRANSFORM((hand_H_world*world_H_hand).raw(), HandTransform::Identity().raw());
+
+    // Change of frame of the quantities
+    FramePosition<World,Point> world_p = world_H_hand*hand_p;
+    ASSERT_EQUAL_VECTOR(world_p.raw(), world_H_hand.raw()*hand_p_raw);
+
+    FrameTwist<Hand,World,World> world_v = world_H_hand*hand_v;
+    ASSERT_EQUAL_VECTOR(world_v.raw().asVector(), (world_H_hand.raw()*hand_v_raw).asVector());
+    FrameTwist<Hand,World,Hand> hand_v_check = world_H_hand.applyInverse(world_v);
+    ASSERT_EQUAL_VECTOR(hand_v_check.raw().asVector(), hand_v_raw.asVector());
+
+    FrameWrench<Hand,World> world_f = world_H_hand*hand_f;
+    ASSERT_EQUAL_VECTOR(world_f.raw().asVector(), (world_H_hand.raw()*hand_f_raw).asVector());
+    FrameWrench<Hand,Hand> hand_f_check = world_H_hand.applyInverse(world_f);
+    ASSERT_EQUAL_VECTOR(hand_f_check.raw().asVector(), hand_f_raw.asVector());
+
+    // Sum of quantities
+    FrameTwist<Base,Hand,World> world_v_base_hand(getRandomTwist());
+    FrameTwist<Base,World,World> world_v_base = world_v_base_hand + world_v;
+    ASSERT_EQUAL_VECTOR(world_v_base.raw().asVector(), (world_v_base_hand.raw()+world_v.raw()).asVector());
+    FrameTwist<World,Hand,World> world_v_inv = -world_v;
+    ASSERT_EQUAL_VECTOR(world_v_inv.raw().asVector(), (-world_v.raw()).asVector());
+
+    FrameWrench<Hand,World> world_f_sum = world_f + world_f;
+    ASSERT_EQUAL_VECTOR(world_f_sum.raw().asVector(), (world_f.raw()+world_f.raw()).asVector());
+}
+
+int main()
+{
+    for (int i = 0; i < 10; i++)
+    {
+        checkConsistencyWithRawClasses();
+    }
+
+    return EXIT_SUCCESS;
+}
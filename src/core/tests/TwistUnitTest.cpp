@@ -10,6 +10,7 @@
 
 #include <iDynTree/Core/EigenHelpers.h>
 #include <iDynTree/Core/Twist.h>
+#include <iDynTree/Core/Wrench.h>
 #include <iDynTree/Core/Transform.h>
 #include <iDynTree/Core/TestUtils.h>
 
@@ -32,6 +33,31 @@ void checkTwistTransformation(const Transform & trans, const Twist & twist)
     ASSERT_EQUAL_VECTOR(twistTranslatedCheck,twistTransformed.asVector());
 }
 
+void checkTwistInverseTransformation(const Transform & trans, const Twist & twist)
+{
+    Twist twistInvTransformed = trans.applyInverse(twist);
+    Twist twistInvTransformedCheck = trans.inverse()*twist;
+
+    ASSERT_EQUAL_VECTOR(twistInvTransformedCheck.asVector(),twistInvTransformed.asVector());
+}
+
+void checkCrossProducts(const Twist & twist, const Twist & otherTwist, const Wrench & wrench)
+{
+    Vector6 crossCheck;
+    Matrix6x6 crossMatrix = twist.asCrossProductMatrix();
+    Vector6 otherTwistPlain = otherTwist.asVector();
+    toEigen(crossCheck) = toEigen(crossMatrix)*toEigen(otherTwistPlain);
+
+    ASSERT_EQUAL_VECTOR(crossCheck,twist.cross(otherTwist).asVector());
+
+    Vector6 crossWrenchCheck;
+    Matrix6x6 crossWrenchMatrix = twist.asCrossProductMatrixWrench();
+    Vector6 wrenchPlain = wrench.asVector();
+    toEigen(crossWrenchCheck) = toEigen(crossWrenchMatrix)*toEigen(wrenchPlain);
+
+    ASSERT_EQUAL_VECTOR(crossWrenchCheck,twist.cross(wrench).asVector());
+}
+
 int main()
 {
     Transform trans(Rotation::RPY(5.0,7.0,8.0),Position(10,0,-40));
@@ -40,6 +66,16 @@ int main()
     Twist twist(LinVelocity(twistData,3),AngVelocity(twistData+3,3));
 
     checkTwistTransformation(trans,twist);
+    checkTwistInverseTransformation(trans,twist);
+
+    for(int i=0; i < 10; i++)
+    {
+        Transform randomTrans = getRandomTransform();
+        Twist randomTwist = getRandomTwist();
+        checkTwistTransformation(randomTrans,randomTwist);
+        checkTwistInverseTransformation(randomTrans,randomTwist);
+        checkCrossProducts(randomTwist,getRandomTwist(),getRandomWrench());
+    }
 
     return EXIT_SUCCESS;
 }
@@ -33,6 +33,14 @@ void checkWrenchTransformation(const Transform & trans, const Wrench & w)
     ASSERT_EQUAL_VECTOR(wTranslatedCheck,wTransformed.asVector());
 }
 
+void checkWrenchInverseTransformation(const Transform & trans, const Wrench & w)
+{
+    Wrench wInvTransformed = trans.applyInverse(w);
+    Wrench wInvTransformedCheck = trans.inverse()*w;
+
+    ASSERT_EQUAL_VECTOR(wInvTransformedCheck.asVector(),wInvTransformed.asVector());
+}
+
 void checkDotProductInvariance(const Transform & trans, const Wrench & w, const Twist & twist)
 {
     double power = w.dot(twist);
@@ -58,6 +66,16 @@ int main()
 
     checkWrenchTransformation(trans,wrench);
     checkDotProductInvariance(trans,wrench,twist);
+    checkWrenchInverseTransformation(trans,wrench);
+
+    for(int i=0; i < 10; i++)
+    {
+        Transform randomTrans = getRandomTransform();
+        Wrench randomWrench = getRandomWrench();
+        checkWrenchTransformation(randomTrans,randomWrench);
+        checkWrenchInverseTransformation(randomTrans,randomWrench);
+        checkDotProductInvariance(randomTrans,randomWrench,getRandomTwist());
+    }
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
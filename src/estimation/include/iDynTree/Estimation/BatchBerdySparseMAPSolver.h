@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_BATCH_BERDY_SPARSEMAPSOLVER_H
+#define IDYNTREE_BATCH_BERDY_SPARSEMAPSOLVER_H
+
+#include <iDynTree/Core/VectorFixSize.h>
+#include <iDynTree/Model/Indices.h>
+
+#include <iDynTree/Estimation/BerdyHelper.h>
+
+#include <cstddef>
+
+namespace iDynTree {
+
+    class Model;
+    class SensorsList;
+    class VectorDynSize;
+    class JointPosDoubleArray;
+    class JointDOFsDoubleArray;
+    class BerdySparseMAPSolver;
+
+    /**
+     * \brief Estimation of the dynamics of a batch of independent subjects with BERDY.
+     *
+     * Each subject (for example each human model tracked in a motion capture session)
+     * has its own BerdyHelper and BerdySparseMAPSolver, that can be accessed to
+     * configure the priors of its estimation.
+     * The information of the estimation of each subject is set with
+     * setEstimateInformationFixedBase or setEstimateInformationFloatingBase, and
+     * doEstimates updates the kinematics and computes the estimates of all the subjects,
+     * distributing the subjects on worker threads that are kept alive between the calls.
+     *
+     * The subjects whose MAP problems have the same structure (i.e. the same sparsity patterns
+     * of the berdy matrices and of the priors, as for subjects with the same model, sensors
+     * and options) share the structure of the normal equations of the problem.
+     *
+     * @warning This class is still in active development, and so API interface can change between iDynTree versions.
+     * \ingroup iDynTreeExperimental
+     */
+    class BatchBerdySparseMAPSolver
+    {
+        struct BatchBerdySparseMAPSolverPimpl;
+        BatchBerdySparseMAPSolverPimpl* m_pimpl;
+
+        // copy is disabled for the moment
+        BatchBerdySparseMAPSolver(const BatchBerdySparseMAPSolver& other);
+        BatchBerdySparseMAPSolver& operator=(const BatchBerdySparseMAPSolver& other);
+
+    public:
+        BatchBerdySparseMAPSolver();
+        ~BatchBerdySparseMAPSolver();
+
+        /**
+         * Add a subject, of index getNrOfSubjects()-1.
+         *
+         * @param[in] model The model of the subject.
+         * @param[in] sensors The sensors of the subject.
+         * @param[in] options The options of the BerdyHelper of the subject.
+         * @return true if all went well, false otherwise.
+         */
+        bool addSubject(const Model& model,
+                        const SensorsList& sensors,
+                        const BerdyOptions options=BerdyOptions());
+
+        /**
+         * Get the number of subjects.
+         */
+        size_t getNrOfSubjects() const;
+
+        /**
+         * Access the BerdyHelper of a subject.
+         */
+        BerdyHelper& berdyHelper(const size_t subject);
+        const BerdyHelper& berdyHelper(const size_t subject) const;
+
+        /**
+         * Access the solver of a subject, for example to set its priors.
+         */
+        BerdySparseMAPSolver& solver(const size_t subject);
+        const BerdySparseMAPSolver& solver(const size_t subject) const;
+
+        /**
+         * Set the number of threads used for the estimation.
+         *
+         * If nrOfThreads is 0, the number of concurrent threads supported by the machine is used.
+         * By default, the number of concurrent threads supported by the machine is used.
+         * If the number of threads changes, the worker threads are created again in the next call to doEstimates.
+         */
+        void setNrOfThreads(const unsigned int nrOfThreads);
+
+        /**
+         * Get the number of threads used for the estimation.
+         */
+        unsigned int getNrOfThreads() const;
+
+        /**
+         * Set the information used in the next estimate of a fixed base subject.
+         * See BerdySparseMAPSolver::updateEstimateInformationFixedBase .
+         */
+        bool setEstimateInformationFixedBase(const size_t subject,
+                                             const JointPosDoubleArray& jointsConfiguration,
+                                             const JointDOFsDoubleArray& jointsVelocity,
+                                             const FrameIndex fixedFrame,
+                                             const Vector3& gravityInFixedFrame,
+                                             const VectorDynSize& measurements);
+
+        /**
+         * Set the information used in the next estimate of a floating base subject.
+         * See BerdySparseMAPSolver::updateEstimateInformationFloatingBase .
+         */
+        bool setEstimateInformationFloatingBase(const size_t subject,
+                                                const JointPosDoubleArray& jointsConfiguration,
+                                                const JointDOFsDoubleArray& jointsVelocity,
+                                                const FrameIndex floatingFrame,
+                                                const Vector3& bodyAngularVelocityOfSpecifiedFrame,
+                                                const VectorDynSize& measurements);
+
+        /**
+         * Compute the estimates of all the subjects.
+         *
+         * The subjects for which no information was set after the previous call
+         * are estimated again with their last information.
+         *
+         * @return true if all went well, false otherwise.
+         */
+        bool doEstimates();
+
+        /**
+         * Get the last estimate of a subject.
+         */
+        const VectorDynSize& getLastEstimate(const size_t subject) const;
+
+        /**
+         * Get the number of different structures of the normal equations
+         * used by the subjects in the last call to doEstimates.
+         */
+        size_t getNrOfNormalEquationsStructures() const;
+    };
+}
+
+#endif /* end of include guard: IDYNTREE_BATCH_BERDY_SPARSEMAPSOLVER_H */
@@ -17,6 +17,7 @@
 #include <iDynTree/Core/VectorDynSize.h>
 #include <iDynTree/Core/VectorFixSize.h>
 #include <iDynTree/Core/Utils.h>
+#include <iDynTree/Core/SparseMatrix.h>
 #include <iDynTree/Core/Triplets.h>
 
 #include <iDynTree/Model/Indices.h>
@@ -428,6 +429,20 @@ class BerdyHelper
     bool computeBerdyDynamicsMatricesFixedBase(SparseMatrix<iDynTree::ColumnMajor>& D, VectorDynSize& bD);
     bool computeBerdyDynamicsMatricesFloatingBase(SparseMatrix<iDynTree::ColumnMajor>& D, VectorDynSize& bD);
 
+    /**
+     * Build the sparsity pattern of the D and Y matrices, that only
+     * depends on the model, the sensors and the options. Called in init.
+     */
+    bool initBerdyMatricesSparsityPattern();
+
+    /**
+     * Write the values of triplets in matrix, copying in it the frozen sparsity
+     * pattern of sparsityPattern if the matrix does not have it already.
+     */
+    bool setBerdyMatrixValues(SparseMatrix<iDynTree::ColumnMajor>& matrix,
+                              const SparseMatrix<iDynTree::ColumnMajor>& sparsityPattern,
+                              const Triplets& triplets);
+
     // Helper method
     Matrix6x1 getBiasTermJointAccelerationPropagation(IJointConstPtr joint,
                                                       const LinkIndex parentLinkIdx,
@@ -483,6 +498,14 @@ class BerdyHelper
     Triplets matrixDElements;
     Triplets matrixYElements;
 
+    /**
+     * D and Y matrices with the frozen sparsity pattern built in init.
+     * The matrices passed to getBerdyMatrices get this pattern (once) and then
+     * their values are updated in place.
+     */
+    SparseMatrix<iDynTree::ColumnMajor> m_DSparsityPattern;
+    SparseMatrix<iDynTree::ColumnMajor> m_YSparsityPattern;
+
     /**
      * Transform between the frame in which the external net wrench measurements are expressed
      * and the link frames.
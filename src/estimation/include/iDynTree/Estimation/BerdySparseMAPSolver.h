@@ -15,10 +15,16 @@
 #include <iDynTree/Core/VectorFixSize.h>
 #include <iDynTree/Model/Indices.h>
 
+#include <memory>
+#include <vector>
+
 namespace iDynTree {
 
     class BerdyHelper;
+    class BatchBerdySparseMAPSolver;
+    struct BerdyNormalEquationsStructure;
     class VectorDynSize;
+    class MatrixDynSize;
     class JointPosDoubleArray;
     class JointDOFsDoubleArray;
 
@@ -36,6 +42,15 @@ namespace iDynTree {
         class BerdySparseMAPSolverPimpl;
         BerdySparseMAPSolverPimpl* m_pimpl;
 
+        friend class BatchBerdySparseMAPSolver;
+
+        /**
+         * Make sure that the structure of the normal equations of the MAP problem is valid,
+         * using one of the given structures if it matches the one of this problem.
+         * If none matches, the structure of this problem is appended to sharedStructures.
+         */
+        void shareNormalEquationsStructure(std::vector<std::shared_ptr<const BerdyNormalEquationsStructure> >& sharedStructures);
+
     public:
         BerdySparseMAPSolver(BerdyHelper& berdyHelper);
         ~BerdySparseMAPSolver();
@@ -54,6 +69,35 @@ namespace iDynTree {
         const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& measurementsPriorCovarianceInverse() const; // Sigma_y^-1
         iDynTree::SparseMatrix<iDynTree::ColumnMajor>& measurementsPriorCovarianceInverse(); // Sigma_y^-1
 
+        /**
+         * Enable or disable the recursive estimation.
+         *
+         * When enabled, the prior on the dynamics (set with setDynamicsRegularizationPriorCovariance
+         * and setDynamicsRegularizationPriorExpectedValue) is used only for the first estimate.
+         * The following estimates use as prior the previous a-posteriori, propagated with a random walk
+         * process model with the variances set with setDynamicsProcessNoiseVariances.
+         * To keep the sparsity of the information matrix, the covariance of the propagated
+         * a-posteriori is approximated with a diagonal matrix, computed from the marginal variances
+         * of the previous a-posteriori (see getLastEstimateVariances).
+         *
+         * \note enabling or disabling the recursive estimation resets it.
+         */
+        void setRecursiveEstimation(bool enabled);
+        bool isRecursiveEstimationEnabled() const;
+
+        /**
+         * Restart the recursive estimation: the next estimate uses again
+         * the prior on the dynamics.
+         */
+        void resetRecursiveEstimation();
+
+        /**
+         * Set the variances of the process noise of the recursive estimation,
+         * one for each dynamic variable (by default they are all equal to one).
+         */
+        bool setDynamicsProcessNoiseVariances(const iDynTree::VectorDynSize& variances);
+        const iDynTree::VectorDynSize& dynamicsProcessNoiseVariances() const;
+
         bool isValid();
 
         bool initialize();
@@ -75,6 +119,25 @@ namespace iDynTree {
         void getLastEstimate(iDynTree::VectorDynSize& lastEstimate) const;
         const iDynTree::VectorDynSize& getLastEstimate() const;
 
+        /**
+         * Get the variances of the dynamic variables of the last estimate,
+         * i.e. the diagonal of the a-posteriori covariance.
+         *
+         * The covariance is not computed as the inverse of the whole information matrix:
+         * the sparse factorization used for the estimate is inverted only on its own
+         * sparsity pattern (selected inversion), once for each estimate.
+         */
+        bool getLastEstimateVariances(iDynTree::VectorDynSize& variances) const;
+
+        /**
+         * Get the block of the a-posteriori covariance of the last estimate
+         * relative to the dynamic variables in the specified range, for example
+         * the one returned by BerdyHelper::getRangeJointVariable for a joint wrench.
+         *
+         * The elements that are not available from the selected inversion are
+         * computed by solving the factorized system for the columns of the block that contain them.
+         */
+        bool getLastEstimateCovarianceBlock(const iDynTree::IndexRange& range, iDynTree::MatrixDynSize& covarianceBlock) const;
 
     };
 }
@@ -121,11 +121,9 @@ namespace iDynTree
     std::vector<iDynTree::Traversal*> m_kinematicTraversals;
     
     iDynTree::JointPosDoubleArray m_jointPos;                         ///< joint positions
-    iDynTree::JointDOFsDoubleArray m_jointDofsZero;                   ///< zero DOFArrays for joint velocities and joint accelerations
-    iDynTree::LinkVelArray m_linkVels;                                ///< link velocities
-    iDynTree::LinkAccArray m_linkProperAccs;                          ///< link proper accelerations
-    iDynTree::LinkNetExternalWrenches m_linkNetExternalWrenchesZero;  ///< link external wrenches set to zero
-    iDynTree::LinkInternalWrenches m_linkIntWrenches;                 ///< link internal wrenches
+    iDynTree::LinkPositions m_linkPositions;                          ///< link positions with respect to the floating link
+    iDynTree::Vector3 m_gravity;                                      ///< gravity, expressed in the floating link frame
+    iDynTree::GeneralizedGravityForcesInternalBuffers m_gravityForcesBuffers; ///< buffers of ComputeGeneralizedGravityForces
     iDynTree::FreeFloatingGeneralizedTorques m_generalizedTorques;    ///< generalized torques 
   };
 }
@@ -0,0 +1,376 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Estimation/BatchBerdySparseMAPSolver.h>
+#include <iDynTree/Estimation/BerdySparseMAPSolver.h>
+
+#include <iDynTree/Core/VectorDynSize.h>
+#include <iDynTree/Model/Model.h>
+#include <iDynTree/Model/JointState.h>
+#include <iDynTree/Sensors/Sensors.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iDynTree {
+
+    /**
+     * Estimation problem of a single subject, with the information
+     * used for its next estimate.
+     */
+    struct BatchBerdySubject
+    {
+        std::unique_ptr<BerdyHelper> berdy;
+        std::unique_ptr<BerdySparseMAPSolver> solver;
+
+        // True if the information was set after the last estimate
+        bool hasNewInformation;
+        bool isFloatingBase;
+        JointPosDoubleArray jointsConfiguration;
+        JointDOFsDoubleArray jointsVelocity;
+        FrameIndex frame;
+        // Gravity (fixed base) or angular velocity of the frame (floating base)
+        Vector3 frameVector;
+        VectorDynSize measurements;
+    };
+
+    struct BatchBerdySparseMAPSolver::BatchBerdySparseMAPSolverPimpl
+    {
+        std::vector<BatchBerdySubject> subjects;
+
+        // Number of threads used for the estimation
+        unsigned int nrOfThreads;
+
+        // Structures of the normal equations shared by the solvers of the subjects
+        std::vector<std::shared_ptr<const BerdyNormalEquationsStructure> > normalEquationsStructures;
+
+        // Worker threads, kept alive between the calls to doEstimates.
+        // The calling thread is the worker of index 0, so workers[i] is the worker of index i+1.
+        std::vector<std::thread> workers;
+        std::mutex workersMutex;
+        std::condition_variable estimateRequested;
+        std::condition_variable estimateCompleted;
+        // Incremented to request an estimate of all the subjects to the workers
+        unsigned long estimateRequest;
+        // Number of workers that still have to complete the last requested estimate
+        size_t nrOfPendingWorkers;
+        bool stopRequested;
+
+        std::atomic<size_t> nextSubject;
+        std::vector<char> workerOk;
+
+        BatchBerdySparseMAPSolverPimpl()
+        : nrOfThreads(std::max(std::thread::hardware_concurrency(), 1u))
+        , estimateRequest(0)
+        , nrOfPendingWorkers(0)
+        , stopRequested(false)
+        , nextSubject(0)
+        {
+        }
+
+        ~BatchBerdySparseMAPSolverPimpl()
+        {
+            stopWorkers();
+        }
+
+        bool checkSubject(const size_t subject, const char* method) const
+        {
+            if (subject >= subjects.size()) {
+                reportError("BatchBerdySparseMAPSolver", method, "Subject index out of bounds");
+                return false;
+            }
+            return true;
+        }
+
+        bool estimate(BatchBerdySubject& subject)
+        {
+            if (subject.hasNewInformation) {
+                if (subject.isFloatingBase) {
+                    subject.solver->updateEstimateInformationFloatingBase(subject.jointsConfiguration, subject.jointsVelocity,
+                                                                         subject.frame, subject.frameVector, subject.measurements);
+                } else {
+                    subject.solver->updateEstimateInformationFixedBase(subject.jointsConfiguration, subject.jointsVelocity,
+                                                                      subject.frame, subject.frameVector, subject.measurements);
+                }
+                subject.hasNewInformation = false;
+            }
+            return subject.solver->doEstimate();
+        }
+
+        /**
+         * As the cost of the estimate changes between subjects, each worker
+         * takes the next subject to estimate as soon as it finishes the previous one.
+         */
+        void processSubjects(const size_t worker)
+        {
+            bool ok = true;
+            for (size_t subject = nextSubject++; subject < subjects.size(); subject = nextSubject++) {
+                ok = estimate(subjects[subject]) && ok;
+            }
+            workerOk[worker] = ok;
+        }
+
+        void workerLoop(const size_t worker, unsigned long lastEstimateRequest)
+        {
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(workersMutex);
+                    estimateRequested.wait(lock, [&]() { return stopRequested || estimateRequest != lastEstimateRequest; });
+                    if (stopRequested) {
+                        return;
+                    }
+                    lastEstimateRequest = estimateRequest;
+                }
+
+                processSubjects(worker);
+
+                std::lock_guard<std::mutex> lock(workersMutex);
+                nrOfPendingWorkers--;
+                if (nrOfPendingWorkers == 0) {
+                    estimateCompleted.notify_one();
+                }
+            }
+        }
+
+        void startWorkers(const size_t nrOfWorkers)
+        {
+            for (size_t worker = 1; worker < nrOfWorkers; worker++) {
+                workers.push_back(std::thread(&BatchBerdySparseMAPSolverPimpl::workerLoop, this, worker, estimateRequest));
+            }
+        }
+
+        void stopWorkers()
+        {
+            {
+                std::lock_guard<std::mutex> lock(workersMutex);
+                stopRequested = true;
+            }
+            estimateRequested.notify_all();
+
+            for (size_t worker = 0; worker < workers.size(); worker++) {
+                workers[worker].join();
+            }
+            workers.clear();
+            stopRequested = false;
+        }
+
+        /**
+         * Estimate all the subjects.
+         *
+         * The worker threads are created in the first call, and created again
+         * only if the number of threads or of subjects changed.
+         */
+        bool estimateAllSubjects()
+        {
+            size_t nrOfWorkers = std::min(static_cast<size_t>(nrOfThreads), subjects.size());
+
+            if (nrOfWorkers == 0) {
+                return true;
+            }
+
+            if (workers.size() != nrOfWorkers - 1) {
+                stopWorkers();
+                startWorkers(nrOfWorkers);
+            }
+
+            nextSubject = 0;
+            workerOk.assign(nrOfWorkers, 1);
+
+            {
+                std::lock_guard<std::mutex> lock(workersMutex);
+                nrOfPendingWorkers = workers.size();
+                estimateRequest++;
+            }
+            estimateRequested.notify_all();
+
+            processSubjects(0);
+
+            {
+                std::unique_lock<std::mutex> lock(workersMutex);
+                estimateCompleted.wait(lock, [&]() { return nrOfPendingWorkers == 0; });
+            }
+
+            return std::find(workerOk.begin(), workerOk.end(), 0) == workerOk.end();
+        }
+    };
+
+    BatchBerdySparseMAPSolver::BatchBerdySparseMAPSolver()
+    : m_pimpl(new BatchBerdySparseMAPSolverPimpl())
+    {
+        assert(m_pimpl);
+    }
+
+    BatchBerdySparseMAPSolver::~BatchBerdySparseMAPSolver()
+    {
+        assert(m_pimpl);
+        delete m_pimpl;
+    }
+
+    bool BatchBerdySparseMAPSolver::addSubject(const Model& model,
+                                               const SensorsList& sensors,
+                                               const BerdyOptions options)
+    {
+        assert(m_pimpl);
+
+        BatchBerdySubject subject;
+        subject.berdy.reset(new BerdyHelper());
+        if (!subject.berdy->init(model, sensors, options)) {
+            reportError("BatchBerdySparseMAPSolver", "addSubject", "Error in the initialization of the BerdyHelper of the subject");
+            return false;
+        }
+
+        subject.solver.reset(new BerdySparseMAPSolver(*subject.berdy));
+        if (!subject.solver->isValid()) {
+            reportError("BatchBerdySparseMAPSolver", "addSubject", "Error in the initialization of the solver of the subject");
+            return false;
+        }
+
+        subject.hasNewInformation = false;
+        subject.isFloatingBase = false;
+        subject.jointsConfiguration.resize(subject.berdy->model());
+        subject.jointsVelocity.resize(subject.berdy->model());
+        subject.frame = FRAME_INVALID_INDEX;
+        subject.frameVector.zero();
+        subject.measurements.resize(subject.berdy->getNrOfSensorsMeasurements());
+
+        m_pimpl->subjects.push_back(std::move(subject));
+        return true;
+    }
+
+    size_t BatchBerdySparseMAPSolver::getNrOfSubjects() const
+    {
+        assert(m_pimpl);
+        return m_pimpl->subjects.size();
+    }
+
+    BerdyHelper& BatchBerdySparseMAPSolver::berdyHelper(const size_t subject)
+    {
+        assert(m_pimpl);
+        assert(subject < m_pimpl->subjects.size());
+        return *(m_pimpl->subjects[subject].berdy);
+    }
+
+    const BerdyHelper& BatchBerdySparseMAPSolver::berdyHelper(const size_t subject) const
+    {
+        assert(m_pimpl);
+        assert(subject < m_pimpl->subjects.size());
+        return *(m_pimpl->subjects[subject].berdy);
+    }
+
+    BerdySparseMAPSolver& BatchBerdySparseMAPSolver::solver(const size_t subject)
+    {
+        assert(m_pimpl);
+        assert(subject < m_pimpl->subjects.size());
+        return *(m_pimpl->subjects[subject].solver);
+    }
+
+    const BerdySparseMAPSolver& BatchBerdySparseMAPSolver::solver(const size_t subject) const
+    {
+        assert(m_pimpl);
+        assert(subject < m_pimpl->subjects.size());
+        return *(m_pimpl->subjects[subject].solver);
+    }
+
+    void BatchBerdySparseMAPSolver::setNrOfThreads(const unsigned int nrOfThreads)
+    {
+        assert(m_pimpl);
+        if (nrOfThreads == 0) {
+            m_pimpl->nrOfThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        } else {
+            m_pimpl->nrOfThreads = nrOfThreads;
+        }
+    }
+
+    unsigned int BatchBerdySparseMAPSolver::getNrOfThreads() const
+    {
+        assert(m_pimpl);
+        return m_pimpl->nrOfThreads;
+    }
+
+    bool BatchBerdySparseMAPSolver::setEstimateInformationFixedBase(const size_t subject,
+                                                                    const JointPosDoubleArray& jointsConfiguration,
+                                                                    const JointDOFsDoubleArray& jointsVelocity,
+                                                                    const FrameIndex fixedFrame,
+                                                                    const Vector3& gravityInFixedFrame,
+                                                                    const VectorDynSize& measurements)
+    {
+        assert(m_pimpl);
+        if (!m_pimpl->checkSubject(subject, "setEstimateInformationFixedBase")) return false;
+
+        BatchBerdySubject& subjectData = m_pimpl->subjects[subject];
+        subjectData.hasNewInformation = true;
+        subjectData.isFloatingBase = false;
+        subjectData.jointsConfiguration = jointsConfiguration;
+        subjectData.jointsVelocity = jointsVelocity;
+        subjectData.frame = fixedFrame;
+        subjectData.frameVector = gravityInFixedFrame;
+        subjectData.measurements = measurements;
+        return true;
+    }
+
+    bool BatchBerdySparseMAPSolver::setEstimateInformationFloatingBase(const size_t subject,
+                                                                       const JointPosDoubleArray& jointsConfiguration,
+                                                                       const JointDOFsDoubleArray& jointsVelocity,
+                                                                       const FrameIndex floatingFrame,
+                                                                       const Vector3& bodyAngularVelocityOfSpecifiedFrame,
+                                                                       const VectorDynSize& measurements)
+    {
+        assert(m_pimpl);
+        if (!m_pimpl->checkSubject(subject, "setEstimateInformationFloatingBase")) return false;
+
+        BatchBerdySubject& subjectData = m_pimpl->subjects[subject];
+        subjectData.hasNewInformation = true;
+        subjectData.isFloatingBase = true;
+        subjectData.jointsConfiguration = jointsConfiguration;
+        subjectData.jointsVelocity = jointsVelocity;
+        subjectData.frame = floatingFrame;
+        subjectData.frameVector = bodyAngularVelocityOfSpecifiedFrame;
+        subjectData.measurements = measurements;
+        return true;
+    }
+
+    bool BatchBerdySparseMAPSolver::doEstimates()
+    {
+        assert(m_pimpl);
+
+        // Share the structures of the normal equations between the subjects
+        // (in this thread, as it may need to build new structures).
+        // The structures not used anymore by any subject are released.
+        std::vector<std::shared_ptr<const BerdyNormalEquationsStructure> >& structures = m_pimpl->normalEquationsStructures;
+        for (size_t subject = 0; subject < m_pimpl->subjects.size(); subject++) {
+            m_pimpl->subjects[subject].solver->shareNormalEquationsStructure(structures);
+        }
+        structures.erase(std::remove_if(structures.begin(), structures.end(),
+                                        [](const std::shared_ptr<const BerdyNormalEquationsStructure>& structure)
+                                        { return structure.use_count() == 1; }),
+                         structures.end());
+
+        return m_pimpl->estimateAllSubjects();
+    }
+
+    const VectorDynSize& BatchBerdySparseMAPSolver::getLastEstimate(const size_t subject) const
+    {
+        assert(m_pimpl);
+        assert(subject < m_pimpl->subjects.size());
+        return m_pimpl->subjects[subject].solver->getLastEstimate();
+    }
+
+    size_t BatchBerdySparseMAPSolver::getNrOfNormalEquationsStructures() const
+    {
+        assert(m_pimpl);
+        return m_pimpl->normalEquationsStructures.size();
+    }
+}
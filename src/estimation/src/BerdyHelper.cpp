@@ -204,6 +204,8 @@ bool BerdyHelper::init(const Model& model,
             res = false;
     }
 
+    res = res && initBerdyMatricesSparsityPattern();
+
     if( res )
     {
         m_areModelAndSensorsValid = true;
@@ -722,9 +724,8 @@ IndexRange BerdyHelper::getRangeNewtonEulerEquationsFloatingBase(const LinkIndex
 
 bool BerdyHelper::computeBerdyDynamicsMatricesFixedBase(SparseMatrix<iDynTree::ColumnMajor>& D, VectorDynSize& bD)
 {
-    D.resize(m_nrOfDynamicEquations,m_nrOfDynamicalVariables);
     bD.resize(m_nrOfDynamicEquations);
-    //TODO: \todo check if this is a bottleneck
+    // The capacity of the triplets buffer is preserved by clear, so after the first call no memory is allocated
     matrixDElements.clear();
     bD.zero();
 
@@ -920,8 +921,7 @@ bool BerdyHelper::computeBerdyDynamicsMatricesFixedBase(SparseMatrix<iDynTree::C
         }
     }
 
-    D.setFromTriplets(matrixDElements);
-    return true;
+    return setBerdyMatrixValues(D, m_DSparsityPattern, matrixDElements);
 }
 
 Matrix6x1 BerdyHelper::getBiasTermJointAccelerationPropagation(IJointConstPtr joint,
@@ -965,9 +965,8 @@ Matrix6x1 BerdyHelper::getBiasTermJointAccelerationPropagation(IJointConstPtr jo
 
 bool BerdyHelper::computeBerdyDynamicsMatricesFloatingBase(SparseMatrix<iDynTree::ColumnMajor>& D, VectorDynSize& bD)
 {
-    D.resize(m_nrOfDynamicEquations,m_nrOfDynamicalVariables);
     bD.resize(m_nrOfDynamicEquations);
-    //TODO: \todo check if this is a bottleneck
+    // The capacity of the triplets buffer is preserved by clear, so after the first call no memory is allocated
     matrixDElements.clear();
     bD.zero();
 
@@ -1063,16 +1062,13 @@ bool BerdyHelper::computeBerdyDynamicsMatricesFloatingBase(SparseMatrix<iDynTree
 
     }
 
-    D.setFromTriplets(matrixDElements);
-    return true;
+    return setBerdyMatrixValues(D, m_DSparsityPattern, matrixDElements);
 }
 
 bool BerdyHelper::computeBerdySensorMatrices(SparseMatrix<iDynTree::ColumnMajor>& Y, VectorDynSize& bY)
 {
-    Y.resize(m_nrOfSensorsMeasurements,m_nrOfDynamicalVariables);
     bY.resize(m_nrOfSensorsMeasurements);
-    // \todo TODO check if this is a bottleneck
-//    Y.zero();
+    // The capacity of the triplets buffer is preserved by clear, so after the first call no memory is allocated
     matrixYElements.clear();
     bY.zero();
 
@@ -1366,10 +1362,70 @@ bool BerdyHelper::computeBerdySensorMatrices(SparseMatrix<iDynTree::ColumnMajor>
         // bY for the joint wrenches is zero
     }
 
-    Y.setFromTriplets(matrixYElements);
-    return true;
+    return setBerdyMatrixValues(Y, m_YSparsityPattern, matrixYElements);
+}
+
+
+bool BerdyHelper::initBerdyMatricesSparsityPattern()
+{
+    // The structure of D and Y does not depend on the robot state (all the blocks are
+    // added even if some of their elements are zero), so we build it with a zero state
+    m_jointPos.zero();
+    m_jointVel.zero();
+    for (LinkIndex lnkIdx = 0; lnkIdx < static_cast<LinkIndex>(m_model.getNrOfLinks()); lnkIdx++)
+    {
+        m_linkVels(lnkIdx).zero();
+    }
+    m_gravity.zero();
+    m_gravity6D.zero();
+
+    m_DSparsityPattern.resize(m_nrOfDynamicEquations,m_nrOfDynamicalVariables);
+    m_YSparsityPattern.resize(m_nrOfSensorsMeasurements,m_nrOfDynamicalVariables);
+
+    VectorDynSize bD, bY;
+    bool res = true;
+    if (m_options.berdyVariant == ORIGINAL_BERDY_FIXED_BASE)
+    {
+        res = res && computeBerdyDynamicsMatricesFixedBase(m_DSparsityPattern, bD);
+    }
+    else
+    {
+        assert(m_options.berdyVariant == BERDY_FLOATING_BASE);
+        res = res && computeBerdyDynamicsMatricesFloatingBase(m_DSparsityPattern, bD);
+    }
+    res = res && computeBerdySensorMatrices(m_YSparsityPattern, bY);
+
+    return res;
 }
 
+bool BerdyHelper::setBerdyMatrixValues(SparseMatrix<iDynTree::ColumnMajor>& matrix,
+                                       const SparseMatrix<iDynTree::ColumnMajor>& sparsityPattern,
+                                       const Triplets& triplets)
+{
+    // While building the pattern in initBerdyMatricesSparsityPattern, matrix is the pattern itself
+    if (&matrix == &sparsityPattern && !matrix.isSparsityPatternFrozen())
+    {
+        matrix.freezeSparsityPattern(triplets);
+        return true;
+    }
+
+    // The pattern is copied only the first time a matrix is passed (or if the caller changed its structure)
+    if (!matrix.isSparsityPatternFrozen() ||
+        matrix.rows() != sparsityPattern.rows() ||
+        matrix.columns() != sparsityPattern.columns() ||
+        matrix.numberOfNonZeros() != sparsityPattern.numberOfNonZeros())
+    {
+        matrix = sparsityPattern;
+    }
+
+    if (!matrix.setValuesFromTriplets(triplets))
+    {
+        reportError("BerdyHelpers","setBerdyMatrixValues","The structure of the matrix is not consistent with its sparsity pattern.");
+        return false;
+    }
+
+    return true;
+}
 
 bool BerdyHelper::initBerdyFloatingBase()
 {
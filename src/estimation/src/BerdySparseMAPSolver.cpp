@@ -11,6 +11,7 @@
 #include "iDynTree/Estimation/BerdyHelper.h"
 
 #include <iDynTree/Core/VectorDynSize.h>
+#include <iDynTree/Core/MatrixDynSize.h>
 #include <iDynTree/Core/VectorFixSize.h>
 #include <iDynTree/Core/SparseMatrix.h>
 #include <iDynTree/Core/EigenHelpers.h>
@@ -19,10 +20,233 @@
 #include <Eigen/SparseCore>
 #include <Eigen/SparseCholesky>
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
+#include <vector>
 
 namespace iDynTree {
 
+    namespace {
+        /**
+         * Term of the product J^T W J: the element of index destination in the values
+         * of the result is incremented by W[weightValue]*J[leftValue]*J[rightValue],
+         * where the indices refer to the values buffers of J and W.
+         */
+        struct NormalEquationsTerm
+        {
+            int destination;
+            int leftValue;
+            int rightValue;
+            int weightValue;
+        };
+
+        /**
+         * Sparsity pattern of a column major sparse matrix.
+         */
+        struct SparsityPattern
+        {
+            unsigned rows;
+            unsigned columns;
+            std::vector<int> outerIndices;
+            std::vector<int> innerIndices;
+
+            void set(const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& matrix)
+            {
+                rows = matrix.rows();
+                columns = matrix.columns();
+                outerIndices.assign(matrix.outerIndicesBuffer(), matrix.outerIndicesBuffer() + matrix.columns() + 1);
+                innerIndices.assign(matrix.innerIndicesBuffer(), matrix.innerIndicesBuffer() + matrix.numberOfNonZeros());
+            }
+
+            bool matches(const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& matrix) const
+            {
+                return rows == matrix.rows() && columns == matrix.columns()
+                    && innerIndices.size() == matrix.numberOfNonZeros()
+                    && std::equal(outerIndices.begin(), outerIndices.end(), matrix.outerIndicesBuffer())
+                    && std::equal(innerIndices.begin(), innerIndices.end(), matrix.innerIndicesBuffer());
+            }
+        };
+
+        /**
+         * Expand J^T W J (with W symmetric) in terms: the rows and columns of the result are stored
+         * in the destination field of each term (as row*cols + col) until resolveTermsDestinations is called.
+         * As the result is symmetric and it is only read by SimplicialLDLT (that uses its lower triangular part),
+         * only the terms of the lower triangular part (row >= col) are expanded.
+         */
+        void expandWeightedProduct(const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& J,
+                                   const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& W,
+                                   std::vector<NormalEquationsTerm>& terms,
+                                   std::vector<Eigen::Triplet<double> >& resultPattern)
+        {
+            const int * JOuter = J.outerIndicesBuffer();
+            const int * JInner = J.innerIndicesBuffer();
+            const int * WOuter = W.outerIndicesBuffer();
+            const int * WInner = W.innerIndicesBuffer();
+
+            // Row-wise access to the elements of J: (column, index in the values buffer)
+            std::vector<std::vector<std::pair<int, int> > > JRows(J.rows());
+            for (unsigned col = 0; col < J.columns(); col++) {
+                for (int k = JOuter[col]; k < JOuter[col + 1]; k++) {
+                    JRows[JInner[k]].push_back(std::make_pair(static_cast<int>(col), k));
+                }
+            }
+
+            terms.clear();
+            // (J^T W J)(i,j) = sum_{k,h} J(k,i) W(k,h) J(h,j)
+            for (unsigned i = 0; i < J.columns(); i++) {
+                for (int left = JOuter[i]; left < JOuter[i + 1]; left++) {
+                    int k = JInner[left];
+                    for (int w = WOuter[k]; w < WOuter[k + 1]; w++) {
+                        int h = WInner[w];
+                        for (size_t el = 0; el < JRows[h].size(); el++) {
+                            if (JRows[h][el].first > static_cast<int>(i)) {
+                                // The elements of JRows[h] are sorted by column
+                                break;
+                            }
+                            NormalEquationsTerm term;
+                            term.destination = static_cast<int>(i*J.columns()) + JRows[h][el].first;
+                            term.leftValue = left;
+                            term.rightValue = JRows[h][el].second;
+                            term.weightValue = w;
+                            terms.push_back(term);
+                            resultPattern.push_back(Eigen::Triplet<double>(i, JRows[h][el].first, 0.0));
+                        }
+                    }
+                }
+            }
+        }
+
+        // Index of the element (row, col) in the values of matrix, -1 if it is not in the sparsity pattern
+        int searchValueIndex(const Eigen::SparseMatrix<double, Eigen::ColMajor>& matrix, int row, int col)
+        {
+            const int * begin = matrix.innerIndexPtr() + matrix.outerIndexPtr()[col];
+            const int * end = matrix.innerIndexPtr() + matrix.outerIndexPtr()[col + 1];
+            const int * found = std::lower_bound(begin, end, row);
+            if (found == end || *found != row) return -1;
+            return static_cast<int>(found - matrix.innerIndexPtr());
+        }
+
+        int findValueIndex(const Eigen::SparseMatrix<double, Eigen::ColMajor>& matrix, int row, int col)
+        {
+            int index = searchValueIndex(matrix, row, col);
+            assert(index >= 0);
+            return index;
+        }
+
+        void resolveTermsDestinations(const Eigen::SparseMatrix<double, Eigen::ColMajor>& result,
+                                      std::vector<NormalEquationsTerm>& terms)
+        {
+            const int cols = static_cast<int>(result.cols());
+            for (size_t t = 0; t < terms.size(); t++) {
+                terms[t].destination = findValueIndex(result, terms[t].destination / cols, terms[t].destination % cols);
+            }
+        }
+
+        void accumulateTerms(const std::vector<NormalEquationsTerm>& terms,
+                             const double * JValues,
+                             const double * WValues,
+                             double * resultValues)
+        {
+            for (size_t t = 0; t < terms.size(); t++) {
+                const NormalEquationsTerm& term = terms[t];
+                resultValues[term.destination] += WValues[term.weightValue] * JValues[term.leftValue] * JValues[term.rightValue];
+            }
+        }
+
+        /**
+         * Selected inversion (Takahashi et al., 1973) of a matrix factorized as L D L^T, where L is
+         * unit lower triangular and stored without its diagonal (as in Eigen::SimplicialLDLT).
+         * Only the elements of the inverse Z in the sparsity pattern of L (aligned with the values of L)
+         * and its diagonal are computed, from the last column to the first one:
+         * Z(i,j) = delta_ij/D(j) - sum_{k > j} L(k,j) Z(i,k), for i >= j.
+         * All the elements of Z needed by the recursion belong to the pattern of L.
+         */
+        void computeSelectedInversion(const Eigen::SparseMatrix<double, Eigen::ColMajor>& L,
+                                      const Eigen::VectorXd& D,
+                                      Eigen::VectorXd& inverseValues,
+                                      Eigen::VectorXd& inverseDiagonal)
+        {
+            assert(L.isCompressed());
+            const int * outer = L.outerIndexPtr();
+            const int * inner = L.innerIndexPtr();
+            const double * values = L.valuePtr();
+
+            for (int j = static_cast<int>(L.cols()) - 1; j >= 0; j--) {
+                for (int p = outer[j]; p < outer[j + 1]; p++) {
+                    const int i = inner[p];
+                    double element = 0.0;
+                    for (int q = outer[j]; q < outer[j + 1]; q++) {
+                        const int k = inner[q];
+                        // Z(i,k), stored in the column min(i,k)
+                        const double inverseElement = (i == k) ? inverseDiagonal(i)
+                                                               : inverseValues(findValueIndex(L, std::max(i, k), std::min(i, k)));
+                        element -= values[q] * inverseElement;
+                    }
+                    inverseValues(p) = element;
+                }
+
+                double diagonalElement = 1.0 / D(j);
+                for (int p = outer[j]; p < outer[j + 1]; p++) {
+                    diagonalElement -= values[p] * inverseValues(p);
+                }
+                inverseDiagonal(j) = diagonalElement;
+            }
+        }
+    }
+
+    /**
+     * Structure of the normal equations of the MAP problem.
+     * As the sparsity patterns of the berdy matrices and of the priors do not change
+     * between two estimates, the products D^T Sigma_D^-1 D and Y^T Sigma_y^-1 Y are expanded
+     * once in a list of terms, each one summing the product of two elements of D (or Y)
+     * and of one element of the prior in a given element of the result.
+     * The structure depends only on the sparsity patterns (and not on the values) of the
+     * berdy matrices and of the priors, so it can be shared by the solvers of problems with the same structure.
+     */
+    struct BerdyNormalEquationsStructure
+    {
+        // Patterns of D, Y, Sigma_D^-1, Sigma_d^-1 and Sigma_y^-1 used to build the structure
+        SparsityPattern dynamicsConstraintsMatrixPattern;
+        SparsityPattern measurementsMatrixPattern;
+        SparsityPattern dynamicsConstraintsPriorPattern;
+        SparsityPattern dynamicsRegularizationPriorPattern;
+        SparsityPattern measurementsPriorPattern;
+
+        std::vector<NormalEquationsTerm> dynamicsConstraintsTerms;
+        std::vector<NormalEquationsTerm> measurementsTerms;
+        // Sparsity patterns (with zero values) of the lower triangular part of the inverse of the variance
+        // of the prior and of the a-posteriori on the dynamics
+        Eigen::SparseMatrix<double, Eigen::ColMajor> covarianceDynamicsPriorInversePattern;
+        Eigen::SparseMatrix<double, Eigen::ColMajor> covarianceDynamicsAPosterioriInversePattern;
+        // Index in the values of covarianceDynamicsPriorInverse of each element of Sigma_d^-1 (-1 for the upper triangular part)
+        std::vector<int> regularizationToPriorValues;
+        // Index in the values of covarianceDynamicsAPosterioriInverse of each element of covarianceDynamicsPriorInverse
+        std::vector<int> priorToAPosterioriValues;
+        // Index of the diagonal elements in the values of covarianceDynamicsPriorInverse
+        std::vector<int> priorDiagonalValues;
+
+        bool matches(const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& dynamicsConstraintsMatrix,
+                     const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& measurementsMatrix,
+                     const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& dynamicsConstraintsPrior,
+                     const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& dynamicsRegularizationPrior,
+                     const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& measurementsPrior) const
+        {
+            return dynamicsConstraintsMatrixPattern.matches(dynamicsConstraintsMatrix)
+                && measurementsMatrixPattern.matches(measurementsMatrix)
+                && priorsMatch(dynamicsConstraintsPrior, dynamicsRegularizationPrior, measurementsPrior);
+        }
+
+        bool priorsMatch(const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& dynamicsConstraintsPrior,
+                         const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& dynamicsRegularizationPrior,
+                         const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& measurementsPrior) const
+        {
+            return dynamicsConstraintsPriorPattern.matches(dynamicsConstraintsPrior)
+                && dynamicsRegularizationPriorPattern.matches(dynamicsRegularizationPrior)
+                && measurementsPriorPattern.matches(measurementsPrior);
+        }
+    };
+
     class BerdySparseMAPSolver::BerdySparseMAPSolverPimpl
     {
     public:
@@ -50,30 +274,74 @@ namespace iDynTree {
         iDynTree::JointDOFsDoubleArray jointsVelocity;
         iDynTree::VectorDynSize measurements;
 
-        // Expected value and variance of the prior on the dynamics
-        iDynTree::VectorDynSize expectedDynamicsPrior;
+        // Structure of the normal equations, possibly shared with other solvers.
+        // The structure is rebuilt (and the permutation recomputed) only if the priors
+        // or the structure of the berdy matrices change.
+        bool normalEquationsStructureValid;
+        std::shared_ptr<const BerdyNormalEquationsStructure> normalEquationsStructure;
+        // False if the permutation of the decomposition has to be recomputed
+        bool symbolicFactorizationValid;
+
+        // Recursive estimation.
+        // The prior on the dynamics is the a-posteriori of the previous estimate, propagated
+        // with a random walk process model d_k = d_{k-1} + w, w ~ N(0, Q), Q diagonal.
+        // To preserve the sparsity of the information matrix, the propagated covariance
+        // is approximated with a diagonal matrix, whose elements are Sigma_ii + Q_ii, where the marginal
+        // variances Sigma_ii of the previous a-posteriori are obtained with the selected inversion.
+        bool recursiveEstimationEnabled;
+        bool recursivePriorAvailable;
+        iDynTree::VectorDynSize dynamicsProcessNoiseVariances; // diagonal of Q
+        iDynTree::VectorDynSize recursivePriorInformation; // diagonal of the inverse of the propagated covariance
+
+        // Inverse of the variance of the prior on the dynamics (only its lower triangular part is stored)
         Eigen::SparseMatrix<double, Eigen::ColMajor> covarianceDynamicsPriorInverse;
-
+        // Expected value of the prior on the dynamics, multiplied by the inverse of its variance
         iDynTree::VectorDynSize expectedDynamicsPriorRHS;
 
-        // Expected value and variance of the a-posteriori on the dynamics
+        // Expected value and variance of the a-posteriori on the dynamics (only the lower triangular part
+        // of the inverse of the variance is stored, as it is the only one read by the decomposition)
         iDynTree::VectorDynSize expectedDynamicsAPosteriori;
         Eigen::SparseMatrix<double, Eigen::ColMajor> covarianceDynamicsAPosterioriInverse;
         iDynTree::VectorDynSize expectedDynamicsAPosterioriRHS;
 
+        // Buffers for the weighted residuals of the constraints and of the measurements
+        iDynTree::VectorDynSize weightedDynamicsConstraintsBias;
+        iDynTree::VectorDynSize measurementsResidual;
+        iDynTree::VectorDynSize weightedMeasurementsResidual;
+
         // Decomposition buffers
-        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double, Eigen::ColMajor> > covarianceDynamicsPriorInverseDecomposition;
         Eigen::SimplicialLDLT<Eigen::SparseMatrix<double, Eigen::ColMajor> > covarianceDynamicsAPosterioriInverseDecomposition;
 
+        // Elements of the a-posteriori covariance, computed on request (once for each estimate)
+        // by the selected inversion of covarianceDynamicsAPosterioriInverseDecomposition.
+        // They refer to the permuted information matrix P Sigma^-1 P^T: the values are aligned with the ones of L.
+        bool selectedInverseValid;
+        Eigen::VectorXd selectedInverseValues;
+        Eigen::VectorXd selectedInverseDiagonal;
+        // Buffers for the columns of the covariance that are not available from the selected inversion
+        Eigen::VectorXd covarianceColumnBuffer;
+        Eigen::VectorXd unitVectorBuffer;
+
         BerdySparseMAPSolverPimpl(BerdyHelper& berdyHelper)
         : berdy(berdyHelper)
         , valid(false)
+        , normalEquationsStructureValid(false)
+        , symbolicFactorizationValid(false)
+        , recursiveEstimationEnabled(false)
+        , recursivePriorAvailable(false)
+        , selectedInverseValid(false)
         {
             initialize();
         }
 
         bool initialize();
+        std::shared_ptr<const BerdyNormalEquationsStructure> buildNormalEquationsStructure() const;
+        bool normalEquationsStructureMatches(const BerdyNormalEquationsStructure& structure) const;
+        bool isNormalEquationsStructureCurrent() const;
+        void setNormalEquationsStructure(const std::shared_ptr<const BerdyNormalEquationsStructure>& structure);
         void computeMAP(bool computePermutation);
+        bool computeSelectedInverse();
+        bool selectedCovarianceElement(int row, int col, double& element) const;
         static bool invertSparseMatrix(const iDynTree::SparseMatrix<iDynTree::ColumnMajor>&in, iDynTree::SparseMatrix<iDynTree::ColumnMajor>& inverted);
     };
 
@@ -95,6 +363,7 @@ namespace iDynTree {
         assert(covariance.rows() == m_pimpl->priorDynamicsConstraintsCovarianceInverse.rows()
                && covariance.columns() == m_pimpl->priorDynamicsConstraintsCovarianceInverse.columns());
         BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::invertSparseMatrix(covariance, m_pimpl->priorDynamicsConstraintsCovarianceInverse);
+        m_pimpl->normalEquationsStructureValid = false;
     }
 
     void BerdySparseMAPSolver::setDynamicsRegularizationPriorCovariance(const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& covariance)
@@ -103,6 +372,7 @@ namespace iDynTree {
         assert(covariance.rows() == m_pimpl->priorDynamicsRegularizationCovarianceInverse.rows()
                && covariance.columns() == m_pimpl->priorDynamicsRegularizationCovarianceInverse.columns());
         BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::invertSparseMatrix(covariance, m_pimpl->priorDynamicsRegularizationCovarianceInverse);
+        m_pimpl->normalEquationsStructureValid = false;
     }
 
     void BerdySparseMAPSolver::setDynamicsRegularizationPriorExpectedValue(const iDynTree::VectorDynSize& expectedValue)
@@ -118,6 +388,7 @@ namespace iDynTree {
         assert(covariance.rows() == m_pimpl->priorMeasurementsCovarianceInverse.rows()
                && covariance.columns() == m_pimpl->priorMeasurementsCovarianceInverse.columns());
         BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::invertSparseMatrix(covariance, m_pimpl->priorMeasurementsCovarianceInverse);
+        m_pimpl->normalEquationsStructureValid = false;
     }
 
     const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& BerdySparseMAPSolver::dynamicsConstraintsPriorCovarianceInverse() const
@@ -129,6 +400,8 @@ namespace iDynTree {
     iDynTree::SparseMatrix<iDynTree::ColumnMajor>& BerdySparseMAPSolver::dynamicsConstraintsPriorCovarianceInverse()
     {
         assert(m_pimpl);
+        // If the pattern of the prior is modified through the returned reference,
+        // the normal equations structure is rebuilt in the next estimate
         return m_pimpl->priorDynamicsConstraintsCovarianceInverse;
     }
 
@@ -141,6 +414,8 @@ namespace iDynTree {
     iDynTree::SparseMatrix<iDynTree::ColumnMajor>& BerdySparseMAPSolver::dynamicsRegularizationPriorCovarianceInverse()
     {
         assert(m_pimpl);
+        // If the pattern of the prior is modified through the returned reference,
+        // the normal equations structure is rebuilt in the next estimate
         return m_pimpl->priorDynamicsRegularizationCovarianceInverse;
     }
 
@@ -165,9 +440,47 @@ namespace iDynTree {
     iDynTree::SparseMatrix<iDynTree::ColumnMajor>& BerdySparseMAPSolver::measurementsPriorCovarianceInverse()
     {
         assert(m_pimpl);
+        // If the pattern of the prior is modified through the returned reference,
+        // the normal equations structure is rebuilt in the next estimate
         return m_pimpl->priorMeasurementsCovarianceInverse;
     }
 
+    void BerdySparseMAPSolver::setRecursiveEstimation(bool enabled)
+    {
+        assert(m_pimpl);
+        m_pimpl->recursiveEstimationEnabled = enabled;
+        m_pimpl->recursivePriorAvailable = false;
+    }
+
+    bool BerdySparseMAPSolver::isRecursiveEstimationEnabled() const
+    {
+        assert(m_pimpl);
+        return m_pimpl->recursiveEstimationEnabled;
+    }
+
+    void BerdySparseMAPSolver::resetRecursiveEstimation()
+    {
+        assert(m_pimpl);
+        m_pimpl->recursivePriorAvailable = false;
+    }
+
+    bool BerdySparseMAPSolver::setDynamicsProcessNoiseVariances(const iDynTree::VectorDynSize& variances)
+    {
+        assert(m_pimpl);
+        if (variances.size() != m_pimpl->dynamicsProcessNoiseVariances.size()) {
+            reportError("BerdySparseMAPSolver", "setDynamicsProcessNoiseVariances", "Wrong size of the process noise variances");
+            return false;
+        }
+        m_pimpl->dynamicsProcessNoiseVariances = variances;
+        return true;
+    }
+
+    const iDynTree::VectorDynSize& BerdySparseMAPSolver::dynamicsProcessNoiseVariances() const
+    {
+        assert(m_pimpl);
+        return m_pimpl->dynamicsProcessNoiseVariances;
+    }
+
     bool BerdySparseMAPSolver::isValid()
     {
         assert(m_pimpl);
@@ -240,6 +553,183 @@ namespace iDynTree {
         return m_pimpl->expectedDynamicsAPosteriori;
     }
 
+    void BerdySparseMAPSolver::shareNormalEquationsStructure(std::vector<std::shared_ptr<const BerdyNormalEquationsStructure> >& sharedStructures)
+    {
+        assert(m_pimpl);
+        if (!m_pimpl->valid) return;
+
+        const std::shared_ptr<const BerdyNormalEquationsStructure>& current = m_pimpl->normalEquationsStructure;
+        const bool isCurrent = m_pimpl->isNormalEquationsStructureCurrent();
+        if (isCurrent
+            && std::find(sharedStructures.begin(), sharedStructures.end(), current) != sharedStructures.end()) {
+            return;
+        }
+
+        for (size_t i = 0; i < sharedStructures.size(); i++) {
+            if (m_pimpl->normalEquationsStructureMatches(*sharedStructures[i])) {
+                m_pimpl->setNormalEquationsStructure(sharedStructures[i]);
+                return;
+            }
+        }
+
+        if (!isCurrent) {
+            m_pimpl->setNormalEquationsStructure(m_pimpl->buildNormalEquationsStructure());
+        }
+        sharedStructures.push_back(m_pimpl->normalEquationsStructure);
+    }
+
+    bool BerdySparseMAPSolver::getLastEstimateVariances(iDynTree::VectorDynSize& variances) const
+    {
+        assert(m_pimpl);
+        if (!m_pimpl->valid || !m_pimpl->computeSelectedInverse()) {
+            reportError("BerdySparseMAPSolver", "getLastEstimateVariances", "No valid estimate available");
+            return false;
+        }
+
+        variances.resize(m_pimpl->expectedDynamicsAPosteriori.size());
+        for (int i = 0; i < static_cast<int>(variances.size()); i++) {
+            m_pimpl->selectedCovarianceElement(i, i, variances(i));
+        }
+        return true;
+    }
+
+    bool BerdySparseMAPSolver::getLastEstimateCovarianceBlock(const iDynTree::IndexRange& range, iDynTree::MatrixDynSize& covarianceBlock) const
+    {
+        assert(m_pimpl);
+        if (!m_pimpl->valid || !m_pimpl->computeSelectedInverse()) {
+            reportError("BerdySparseMAPSolver", "getLastEstimateCovarianceBlock", "No valid estimate available");
+            return false;
+        }
+
+        const std::ptrdiff_t numberOfDynVariables = static_cast<std::ptrdiff_t>(m_pimpl->expectedDynamicsAPosteriori.size());
+        if (!range.isValid() || range.offset + range.size > numberOfDynVariables) {
+            reportError("BerdySparseMAPSolver", "getLastEstimateCovarianceBlock", "Range out of the dynamic variables");
+            return false;
+        }
+
+        const int offset = static_cast<int>(range.offset);
+        const int size = static_cast<int>(range.size);
+        covarianceBlock.resize(size, size);
+        for (int col = 0; col < size; col++) {
+            bool columnAvailable = true;
+            for (int row = 0; row < size && columnAvailable; row++) {
+                columnAvailable = m_pimpl->selectedCovarianceElement(offset + row, offset + col, covarianceBlock(row, col));
+            }
+
+            if (!columnAvailable) {
+                // Column of the covariance, solving Sigma^-1 x = e_col
+                m_pimpl->unitVectorBuffer.setZero(numberOfDynVariables);
+                m_pimpl->unitVectorBuffer(offset + col) = 1.0;
+                m_pimpl->covarianceColumnBuffer = m_pimpl->covarianceDynamicsAPosterioriInverseDecomposition.solve(m_pimpl->unitVectorBuffer);
+                for (int row = 0; row < size; row++) {
+                    covarianceBlock(row, col) = m_pimpl->covarianceColumnBuffer(offset + row);
+                }
+            }
+        }
+        return true;
+    }
+
+    std::shared_ptr<const BerdyNormalEquationsStructure> BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::buildNormalEquationsStructure() const
+    {
+        std::shared_ptr<BerdyNormalEquationsStructure> structure = std::make_shared<BerdyNormalEquationsStructure>();
+        structure->dynamicsConstraintsMatrixPattern.set(dynamicsConstraintsMatrix);
+        structure->measurementsMatrixPattern.set(measurementsMatrix);
+        structure->dynamicsConstraintsPriorPattern.set(priorDynamicsConstraintsCovarianceInverse);
+        structure->dynamicsRegularizationPriorPattern.set(priorDynamicsRegularizationCovarianceInverse);
+        structure->measurementsPriorPattern.set(priorMeasurementsCovarianceInverse);
+
+        const int numberOfDynVariables = static_cast<int>(berdy.getNrOfDynamicVariables());
+        std::vector<Eigen::Triplet<double> > pattern;
+
+        // Inverse of the variance of the prior on the dynamics: Sigma_d^-1 + D^T Sigma_D^-1 D (lower triangular part)
+        const iDynTree::SparseMatrix<iDynTree::ColumnMajor>& regularizationPrior = priorDynamicsRegularizationCovarianceInverse;
+        Eigen::Map<const Eigen::SparseMatrix<double, Eigen::ColMajor> > regularization = toEigen(regularizationPrior);
+        for (int col = 0; col < regularization.outerSize(); col++) {
+            for (Eigen::Map<const Eigen::SparseMatrix<double, Eigen::ColMajor> >::InnerIterator it(regularization, col); it; ++it) {
+                if (it.row() >= it.col()) {
+                    pattern.push_back(Eigen::Triplet<double>(it.row(), it.col(), 0.0));
+                }
+            }
+        }
+        // The diagonal is always part of the structure, as the prior used in the recursive estimation is diagonal
+        for (int i = 0; i < numberOfDynVariables; i++) {
+            pattern.push_back(Eigen::Triplet<double>(i, i, 0.0));
+        }
+        expandWeightedProduct(dynamicsConstraintsMatrix, priorDynamicsConstraintsCovarianceInverse, structure->dynamicsConstraintsTerms, pattern);
+        Eigen::SparseMatrix<double, Eigen::ColMajor>& priorPattern = structure->covarianceDynamicsPriorInversePattern;
+        priorPattern.resize(numberOfDynVariables, numberOfDynVariables);
+        priorPattern.setFromTriplets(pattern.begin(), pattern.end());
+        resolveTermsDestinations(priorPattern, structure->dynamicsConstraintsTerms);
+
+        // The elements of the upper triangular part of Sigma_d^-1 are not stored (-1)
+        structure->regularizationToPriorValues.resize(regularization.nonZeros());
+        for (int col = 0; col < regularization.outerSize(); col++) {
+            for (int k = regularization.outerIndexPtr()[col]; k < regularization.outerIndexPtr()[col + 1]; k++) {
+                const int row = regularization.innerIndexPtr()[k];
+                structure->regularizationToPriorValues[k] = row >= col ? findValueIndex(priorPattern, row, col) : -1;
+            }
+        }
+
+        // Inverse of the variance of the a-posteriori on the dynamics: (prior) + Y^T Sigma_y^-1 Y
+        pattern.clear();
+        for (int col = 0; col < priorPattern.outerSize(); col++) {
+            for (Eigen::SparseMatrix<double, Eigen::ColMajor>::InnerIterator it(priorPattern, col); it; ++it) {
+                pattern.push_back(Eigen::Triplet<double>(it.row(), it.col(), 0.0));
+            }
+        }
+        expandWeightedProduct(measurementsMatrix, priorMeasurementsCovarianceInverse, structure->measurementsTerms, pattern);
+        Eigen::SparseMatrix<double, Eigen::ColMajor>& aPosterioriPattern = structure->covarianceDynamicsAPosterioriInversePattern;
+        aPosterioriPattern.resize(numberOfDynVariables, numberOfDynVariables);
+        aPosterioriPattern.setFromTriplets(pattern.begin(), pattern.end());
+        resolveTermsDestinations(aPosterioriPattern, structure->measurementsTerms);
+
+        structure->priorToAPosterioriValues.resize(priorPattern.nonZeros());
+        for (int col = 0; col < priorPattern.outerSize(); col++) {
+            for (int k = priorPattern.outerIndexPtr()[col]; k < priorPattern.outerIndexPtr()[col + 1]; k++) {
+                structure->priorToAPosterioriValues[k] = findValueIndex(aPosterioriPattern, priorPattern.innerIndexPtr()[k], col);
+            }
+        }
+
+        structure->priorDiagonalValues.resize(numberOfDynVariables);
+        for (int i = 0; i < numberOfDynVariables; i++) {
+            structure->priorDiagonalValues[i] = findValueIndex(priorPattern, i, i);
+        }
+
+        return structure;
+    }
+
+    bool BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::normalEquationsStructureMatches(const BerdyNormalEquationsStructure& structure) const
+    {
+        return structure.matches(dynamicsConstraintsMatrix,
+                                 measurementsMatrix,
+                                 priorDynamicsConstraintsCovarianceInverse,
+                                 priorDynamicsRegularizationCovarianceInverse,
+                                 priorMeasurementsCovarianceInverse);
+    }
+
+    bool BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::isNormalEquationsStructureCurrent() const
+    {
+        // The berdy matrices are only checked by size, as their pattern depends just on the
+        // BerdyHelper options. The priors are checked entirely, as their pattern may change
+        // through the references returned by the non-const accessors.
+        return normalEquationsStructureValid
+            && dynamicsConstraintsMatrix.numberOfNonZeros() == normalEquationsStructure->dynamicsConstraintsMatrixPattern.innerIndices.size()
+            && measurementsMatrix.numberOfNonZeros() == normalEquationsStructure->measurementsMatrixPattern.innerIndices.size()
+            && normalEquationsStructure->priorsMatch(priorDynamicsConstraintsCovarianceInverse,
+                                                     priorDynamicsRegularizationCovarianceInverse,
+                                                     priorMeasurementsCovarianceInverse);
+    }
+
+    void BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::setNormalEquationsStructure(const std::shared_ptr<const BerdyNormalEquationsStructure>& structure)
+    {
+        normalEquationsStructure = structure;
+        // The values are overwritten in computeMAP
+        covarianceDynamicsPriorInverse = structure->covarianceDynamicsPriorInversePattern;
+        covarianceDynamicsAPosterioriInverse = structure->covarianceDynamicsAPosterioriInversePattern;
+        normalEquationsStructureValid = true;
+        symbolicFactorizationValid = false;
+    }
+
     void BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::computeMAP(bool computePermutation)
     {
         /*
@@ -250,6 +740,10 @@ namespace iDynTree {
                                measurementsMatrix,
                                measurementsBias);
 
+        if (!isNormalEquationsStructureCurrent()) {
+            setNormalEquationsStructure(buildNormalEquationsStructure());
+        }
+        const BerdyNormalEquationsStructure& structure = *normalEquationsStructure;
 
         // Compute the maximum a posteriori probability
         // See Latella et al., "Whole-Body Human Inverse Dynamics with
@@ -257,45 +751,105 @@ namespace iDynTree {
 
         // Intermediate quantities
 
-        // Covariance matrix of the prior of the dynamics: var[p(d)], Eq. 10a
-        //TODO: find a way to map to iDynTree::SparseMatrix
-        covarianceDynamicsPriorInverse
-        //    toEigen(m_intermediateQuantities.covarianceDynamicsPriorInverse)
-        //Better to assign the "sum" before, and adding the product part later
-        = toEigen(priorDynamicsRegularizationCovarianceInverse);
-
-        covarianceDynamicsPriorInverse += toEigen(dynamicsConstraintsMatrix).transpose() * toEigen(priorDynamicsConstraintsCovarianceInverse) * toEigen(dynamicsConstraintsMatrix);
-
-        // decompose m_covarianceDynamicsPriorInverse
-        if (computePermutation) {
-            covarianceDynamicsPriorInverseDecomposition.analyzePattern(covarianceDynamicsPriorInverse);
+        // Inverse of the covariance matrix of the prior of the dynamics: var[p(d)]^-1, Eq. 10a
+        // Only the values are updated, the structure is the one computed in buildNormalEquationsStructure
+        double * priorValues = covarianceDynamicsPriorInverse.valuePtr();
+        const bool useRecursivePrior = recursiveEstimationEnabled && recursivePriorAvailable;
+        std::fill(priorValues, priorValues + covarianceDynamicsPriorInverse.nonZeros(), 0.0);
+        if (useRecursivePrior) {
+            // The regularization is replaced by the propagated a-posteriori of the previous estimate
+            for (size_t i = 0; i < structure.priorDiagonalValues.size(); i++) {
+                priorValues[structure.priorDiagonalValues[i]] = recursivePriorInformation(i);
+            }
+        } else {
+            const double * regularizationValues = priorDynamicsRegularizationCovarianceInverse.valuesBuffer();
+            for (size_t k = 0; k < structure.regularizationToPriorValues.size(); k++) {
+                if (structure.regularizationToPriorValues[k] >= 0) {
+                    priorValues[structure.regularizationToPriorValues[k]] += regularizationValues[k];
+                }
+            }
         }
-        //    m_intermediateQuantities.covarianceDynamicsPriorInverseDecomposition.factorize(toEigen(m_intermediateQuantities.covarianceDynamicsPriorInverse));
-        covarianceDynamicsPriorInverseDecomposition.factorize(covarianceDynamicsPriorInverse);
-
-        // Expected value of the prior of the dynamics: E[p(d)], Eq. 10b
-        toEigen(expectedDynamicsPriorRHS) = toEigen(priorDynamicsRegularizationCovarianceInverse) * toEigen(priorDynamicsRegularizationExpectedValue) - toEigen(dynamicsConstraintsMatrix).transpose() * toEigen(priorDynamicsConstraintsCovarianceInverse) * toEigen(dynamicsConstraintsBias);
-
-        toEigen(expectedDynamicsPrior) =
-        covarianceDynamicsPriorInverseDecomposition.solve(toEigen(expectedDynamicsPriorRHS));
+        accumulateTerms(structure.dynamicsConstraintsTerms, dynamicsConstraintsMatrix.valuesBuffer(),
+                        priorDynamicsConstraintsCovarianceInverse.valuesBuffer(), priorValues);
+
+        // Expected value of the prior of the dynamics, multiplied by var[p(d)]^-1: var[p(d)]^-1 E[p(d)], Eq. 10b
+        toEigen(weightedDynamicsConstraintsBias).noalias() = toEigen(priorDynamicsConstraintsCovarianceInverse) * toEigen(dynamicsConstraintsBias);
+        if (useRecursivePrior) {
+            // expectedDynamicsAPosteriori still contains the previous estimate
+            toEigen(expectedDynamicsPriorRHS) = toEigen(recursivePriorInformation).cwiseProduct(toEigen(expectedDynamicsAPosteriori));
+        } else {
+            toEigen(expectedDynamicsPriorRHS).noalias() = toEigen(priorDynamicsRegularizationCovarianceInverse) * toEigen(priorDynamicsRegularizationExpectedValue);
+        }
+        toEigen(expectedDynamicsPriorRHS).noalias() -= toEigen(dynamicsConstraintsMatrix).transpose() * toEigen(weightedDynamicsConstraintsBias);
 
-        // Final result: covariance matrix of the whole-body dynamics, Eq. 11a
-        //TODO: find a way to map to iDynTree::SparseMatrix
-        covarianceDynamicsAPosterioriInverse = covarianceDynamicsPriorInverse;
-        covarianceDynamicsAPosterioriInverse += toEigen(measurementsMatrix).transpose() * toEigen(priorMeasurementsCovarianceInverse) * toEigen(measurementsMatrix);
+        // Final result: inverse of the covariance matrix of the whole-body dynamics, Eq. 11a
+        double * aPosterioriValues = covarianceDynamicsAPosterioriInverse.valuePtr();
+        std::fill(aPosterioriValues, aPosterioriValues + covarianceDynamicsAPosterioriInverse.nonZeros(), 0.0);
+        for (size_t k = 0; k < structure.priorToAPosterioriValues.size(); k++) {
+            aPosterioriValues[structure.priorToAPosterioriValues[k]] = priorValues[k];
+        }
+        accumulateTerms(structure.measurementsTerms, measurementsMatrix.valuesBuffer(),
+                        priorMeasurementsCovarianceInverse.valuesBuffer(), aPosterioriValues);
 
         // decompose m_covarianceDynamicsAPosterioriInverse
-        if (computePermutation) {
-            //        m_intermediateQuantities.covarianceDynamicsAPosterioriInverseDecomposition.analyzePattern(toEigen(m_covarianceDynamicsAPosterioriInverse));
+        if (computePermutation || !symbolicFactorizationValid) {
             covarianceDynamicsAPosterioriInverseDecomposition.analyzePattern(covarianceDynamicsAPosterioriInverse);
+            symbolicFactorizationValid = true;
         }
-        //    m_intermediateQuantities.covarianceDynamicsAPosterioriInverseDecomposition.factorize(toEigen(m_covarianceDynamicsAPosterioriInverse));
         covarianceDynamicsAPosterioriInverseDecomposition.factorize(covarianceDynamicsAPosterioriInverse);
+        selectedInverseValid = false;
 
         // Final result: expected value of the whole-body dynamics, Eq. 11b
-        toEigen(expectedDynamicsAPosterioriRHS) = (toEigen(measurementsMatrix).transpose() * toEigen(priorMeasurementsCovarianceInverse) * (toEigen(measurements) - toEigen(measurementsBias)) + covarianceDynamicsPriorInverse * toEigen(expectedDynamicsPrior));
+        // As var[p(d)]^-1 E[p(d)] is already available, there is no need to factorize var[p(d)]^-1
+        toEigen(measurementsResidual) = toEigen(measurements) - toEigen(measurementsBias);
+        toEigen(weightedMeasurementsResidual).noalias() = toEigen(priorMeasurementsCovarianceInverse) * toEigen(measurementsResidual);
+        toEigen(expectedDynamicsAPosterioriRHS) = toEigen(expectedDynamicsPriorRHS);
+        toEigen(expectedDynamicsAPosterioriRHS).noalias() += toEigen(measurementsMatrix).transpose() * toEigen(weightedMeasurementsResidual);
         toEigen(expectedDynamicsAPosteriori) =
         covarianceDynamicsAPosterioriInverseDecomposition.solve(toEigen(expectedDynamicsAPosterioriRHS));
+
+        // Propagate the a-posteriori to obtain the prior of the next estimate
+        if (recursiveEstimationEnabled && computeSelectedInverse()) {
+            for (int i = 0; i < static_cast<int>(recursivePriorInformation.size()); i++) {
+                double variance = 0.0;
+                selectedCovarianceElement(i, i, variance);
+                recursivePriorInformation(i) = 1.0 / (variance + dynamicsProcessNoiseVariances(i));
+            }
+            recursivePriorAvailable = true;
+        }
+    }
+
+    bool BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::computeSelectedInverse()
+    {
+        if (covarianceDynamicsAPosterioriInverseDecomposition.info() != Eigen::Success) return false;
+        if (selectedInverseValid) return true;
+
+        const Eigen::SparseMatrix<double, Eigen::ColMajor>& L = covarianceDynamicsAPosterioriInverseDecomposition.matrixL().nestedExpression();
+        selectedInverseValues.resize(L.nonZeros());
+        selectedInverseDiagonal.resize(L.cols());
+        computeSelectedInversion(L, covarianceDynamicsAPosterioriInverseDecomposition.vectorD(),
+                                 selectedInverseValues, selectedInverseDiagonal);
+        selectedInverseValid = true;
+        return true;
+    }
+
+    bool BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::selectedCovarianceElement(int row, int col, double& element) const
+    {
+        // The factorization is P Sigma^-1 P^T = L D L^T, so Sigma(row, col) = Z(P(row), P(col))
+        const Eigen::VectorXi& permutation = covarianceDynamicsAPosterioriInverseDecomposition.permutationP().indices();
+        const int permutedRow = permutation.size() > 0 ? permutation(row) : row;
+        const int permutedCol = permutation.size() > 0 ? permutation(col) : col;
+
+        if (permutedRow == permutedCol) {
+            element = selectedInverseDiagonal(permutedRow);
+            return true;
+        }
+
+        const Eigen::SparseMatrix<double, Eigen::ColMajor>& L = covarianceDynamicsAPosterioriInverseDecomposition.matrixL().nestedExpression();
+        int index = searchValueIndex(L, std::max(permutedRow, permutedCol), std::min(permutedRow, permutedCol));
+        if (index < 0) return false;
+        element = selectedInverseValues(index);
+        return true;
     }
 
     bool BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::initialize()
@@ -317,13 +871,20 @@ namespace iDynTree {
 
         expectedDynamicsAPosteriori.resize(numberOfDynVariables);
         expectedDynamicsAPosteriori.zero();
-        covarianceDynamicsAPosterioriInverse.resize(numberOfDynVariables, numberOfDynVariables);
 
-        covarianceDynamicsPriorInverse.resize(numberOfDynVariables, numberOfDynVariables);
-        expectedDynamicsPrior.resize(numberOfDynVariables);
         expectedDynamicsPriorRHS.resize(numberOfDynVariables);
         expectedDynamicsAPosterioriRHS.resize(numberOfDynVariables);
         expectedDynamicsAPosterioriRHS.zero();
+        weightedDynamicsConstraintsBias.resize(numberOfDynEquations);
+        measurementsResidual.resize(numberOfMeasurements);
+        weightedMeasurementsResidual.resize(numberOfMeasurements);
+        normalEquationsStructureValid = false;
+
+        recursivePriorInformation.resize(numberOfDynVariables);
+        if (dynamicsProcessNoiseVariances.size() != numberOfDynVariables) {
+            dynamicsProcessNoiseVariances.resize(numberOfDynVariables);
+            toEigen(dynamicsProcessNoiseVariances).setOnes();
+        }
 
         // Resize priors and set them to identity.
         // If a prior is specified in config file they will be cleared after
@@ -354,6 +915,8 @@ namespace iDynTree {
 
         berdy.updateKinematicsFromFixedBase(jointsConfiguration, jointsVelocity, berdy.dynamicTraversal().getBaseLink()->getIndex(), initialGravity);
         computeMAP(true);
+        // The estimate computed during initialization is not a meaningful prior
+        recursivePriorAvailable = false;
 
         valid = true;
         return true;
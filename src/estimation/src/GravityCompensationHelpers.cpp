@@ -10,6 +10,8 @@
 
 #include "iDynTree/Estimation/GravityCompensationHelpers.h"
 
+#include <iDynTree/Model/ForwardKinematics.h>
+
 namespace iDynTree 
 {
 
@@ -19,10 +21,9 @@ namespace iDynTree
                                                            m_dynamicTraversal(),
                                                            m_kinematicTraversals(),
                                                            m_jointPos(),
-                                                           m_linkVels(),
-                                                           m_linkProperAccs(),
-                                                           m_linkNetExternalWrenchesZero(),
-                                                           m_linkIntWrenches(),
+                                                           m_linkPositions(),
+                                                           m_gravity(),
+                                                           m_gravityForcesBuffers(),
                                                            m_generalizedTorques()
   {
 
@@ -69,13 +70,8 @@ namespace iDynTree
     allocKinematicTraversals(m_model.getNrOfLinks());
     
     m_jointPos.resize(m_model);
-    m_jointDofsZero.resize(m_model);
-    m_jointDofsZero.zero();
-    m_linkVels.resize(m_model);
-    m_linkProperAccs.resize(m_model);
-    m_linkIntWrenches.resize(m_model);
-    m_linkNetExternalWrenchesZero.resize(m_model);
-    m_linkNetExternalWrenchesZero.zero();
+    m_linkPositions.resize(m_model);
+    m_gravityForcesBuffers.resize(m_model);
     m_generalizedTorques.resize(m_model);
 
     // set the model valid
@@ -122,34 +118,16 @@ namespace iDynTree
       m_model.computeFullTreeTraversal(*m_kinematicTraversals[floatingLinkIndex], floatingLinkIndex);
     }
     
-    // To initialize the kinmatic propagation, we should first convert the kinematics
-    // information from the frame in which they are specified to the main frame of the link
+    // The gravity compensation torques only depend on the position of the links
+    // and on the gravity, so we use the floating link as the world frame and we
+    // express in it the gravity, i.e. the opposite of the proper acceleration
+    // (the floating frame has zero velocity, so its proper classical and spatial accelerations coincide)
     iDynTree::Transform link_H_frame = m_model.getFrameTransform(floatingFrame);
-    
-    iDynTree::Twist base_vel_frame, base_vel_link;
-    iDynTree::SpatialAcc base_acc_frame, base_acc_link;
-    iDynTree::ClassicalAcc base_classical_acc_link;
-    
-    iDynTree::Vector3 zero3;
-    zero3.zero();
-    
-    base_vel_frame.setLinearVec3(zero3);
-    base_vel_frame.setAngularVec3(zero3);
-    base_vel_link = link_H_frame*base_vel_frame;
-    
-    base_acc_frame.setLinearVec3(properClassicalLinearAcceleration);
-    base_acc_frame.setAngularVec3(zero3);
-    base_acc_link = link_H_frame*base_acc_frame;
-    
-    base_classical_acc_link.fromSpatial(base_acc_link, base_vel_link);
-    
-    // Propagate the kinematics information
-    bool ok = iDynTree::dynamicsEstimationForwardVelAccKinematics(m_model, *(m_kinematicTraversals[floatingLinkIndex]),
-                                                                  base_classical_acc_link.getLinearVec3(),
-                                                                  base_vel_link.getAngularVec3(),
-                                                                  base_classical_acc_link.getAngularVec3(),
-                                                                  jointPos, m_jointDofsZero, m_jointDofsZero,
-                                                                  m_linkVels, m_linkProperAccs);
+    toEigen(m_gravity) = -toEigen(link_H_frame.getRotation())*toEigen(properClassicalLinearAcceleration);
+
+    bool ok = iDynTree::ForwardPositionKinematics(m_model, *(m_kinematicTraversals[floatingLinkIndex]),
+                                                  iDynTree::Transform::Identity(),
+                                                  jointPos, m_linkPositions);
     // store joint positions
     m_jointPos = jointPos;
     
@@ -179,11 +157,11 @@ namespace iDynTree
     }
     
     // Compute joint torques
-    bool ok = iDynTree::RNEADynamicPhase(m_model, m_dynamicTraversal, m_jointPos, m_linkVels, m_linkProperAccs,
-                                         m_linkNetExternalWrenchesZero, m_linkIntWrenches, m_generalizedTorques);
+    bool ok = iDynTree::ComputeGeneralizedGravityForces(m_model, m_dynamicTraversal, m_jointPos, m_linkPositions,
+                                                        m_gravity, m_gravityForcesBuffers, m_generalizedTorques);
     if (!ok)
     {
-      iDynTree::reportError("GravityCompensationHelper", "getGravityCompensationTorques", "Error in computing RNEADynamicPhase");
+      iDynTree::reportError("GravityCompensationHelper", "getGravityCompensationTorques", "Error in computing ComputeGeneralizedGravityForces");
       return false;
     }
     
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Estimation/BatchBerdySparseMAPSolver.h>
+#include <iDynTree/Estimation/BerdySparseMAPSolver.h>
+#include <iDynTree/Estimation/BerdyHelper.h>
+#include "testModels.h"
+#include "BerdyTestUtils.h"
+
+#include <iDynTree/ModelIO/ModelLoader.h>
+#include <iDynTree/Core/TestUtils.h>
+#include <iDynTree/Core/SparseMatrix.h>
+#include <iDynTree/Core/Triplets.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace iDynTree;
+
+// Priors of a subject, different for each subject
+void setPriors(BerdySparseMAPSolver& solver, BerdyHelper& berdy, size_t subject)
+{
+    solver.setDynamicsConstraintsPriorCovariance(diagonalCovariance(berdy.getNrOfDynamicEquations(), 1e-4*(subject+1)));
+    solver.setDynamicsRegularizationPriorCovariance(diagonalCovariance(berdy.getNrOfDynamicVariables(), 1.0 + 0.5*subject));
+    solver.setMeasurementsPriorCovariance(diagonalCovariance(berdy.getNrOfSensorsMeasurements(), 0.1*(subject+1)));
+}
+
+struct SubjectInformation
+{
+    JointPosDoubleArray jointPos;
+    JointDOFsDoubleArray jointVel;
+    VectorDynSize measurements;
+    Vector3 baseAngVel;
+    FrameIndex baseFrame;
+};
+
+SubjectInformation getSubjectInformation(const BerdyHelper& berdy, size_t subject, int step)
+{
+    SubjectInformation info;
+    info.jointPos.resize(berdy.model());
+    info.jointVel.resize(berdy.model());
+    info.measurements.resize(berdy.getNrOfSensorsMeasurements());
+    for (size_t i = 0; i < info.jointPos.size(); i++)
+    {
+        info.jointPos(i) = 0.1*(step+1) - 0.03*i + 0.05*subject;
+        info.jointVel(i) = 0.02*i - 0.1*step;
+    }
+    for (size_t i = 0; i < info.measurements.size(); i++)
+    {
+        info.measurements(i) = 0.3*step - 0.01*i + 0.1*subject;
+    }
+    info.baseAngVel(0) = 0.1*subject;
+    info.baseAngVel(1) = 0.2*step;
+    info.baseAngVel(2) = -0.1;
+    info.baseFrame = berdy.dynamicTraversal().getBaseLink()->getIndex();
+    return info;
+}
+
+void testBatchEstimates(const std::vector<std::string>& fileNames, const unsigned int nrOfThreads)
+{
+    BerdyOptions options;
+    options.berdyVariant = iDynTree::BERDY_FLOATING_BASE;
+    options.includeAllNetExternalWrenchesAsDynamicVariables = true;
+    options.includeAllNetExternalWrenchesAsSensors = true;
+
+    BatchBerdySparseMAPSolver batch;
+    batch.setNrOfThreads(nrOfThreads);
+    ASSERT_EQUAL_DOUBLE(batch.getNrOfThreads(), nrOfThreads);
+
+    // Each subject is compared with a solver used sequentially
+    std::vector<BerdyHelper> berdys(fileNames.size());
+    std::vector<BerdySparseMAPSolver*> solvers;
+    for (size_t subject = 0; subject < fileNames.size(); subject++)
+    {
+        ModelLoader loader;
+        ASSERT_IS_TRUE(loader.loadModelFromFile(fileNames[subject]));
+
+        ASSERT_IS_TRUE(batch.addSubject(loader.model(), loader.sensors(), options));
+        ASSERT_IS_TRUE(berdys[subject].init(loader.model(), loader.sensors(), options));
+        solvers.push_back(new BerdySparseMAPSolver(berdys[subject]));
+
+        setPriors(batch.solver(subject), batch.berdyHelper(subject), subject);
+        setPriors(*solvers[subject], berdys[subject], subject);
+    }
+    ASSERT_EQUAL_DOUBLE(batch.getNrOfSubjects(), fileNames.size());
+
+    for (int step = 0; step < 2; step++)
+    {
+        for (size_t subject = 0; subject < fileNames.size(); subject++)
+        {
+            SubjectInformation info = getSubjectInformation(berdys[subject], subject, step);
+            ASSERT_IS_TRUE(batch.setEstimateInformationFloatingBase(subject, info.jointPos, info.jointVel,
+                                                                    info.baseFrame, info.baseAngVel, info.measurements));
+            solvers[subject]->updateEstimateInformationFloatingBase(info.jointPos, info.jointVel,
+                                                                    info.baseFrame, info.baseAngVel, info.measurements);
+            ASSERT_IS_TRUE(solvers[subject]->doEstimate());
+        }
+
+        ASSERT_IS_TRUE(batch.doEstimates());
+
+        for (size_t subject = 0; subject < fileNames.size(); subject++)
+        {
+            ASSERT_EQUAL_VECTOR_TOL(batch.getLastEstimate(subject), solvers[subject]->getLastEstimate(), 1e-8);
+        }
+    }
+
+    // Subjects with the same model share the structure of the normal equations
+    ASSERT_EQUAL_DOUBLE(batch.getNrOfNormalEquationsStructures(), 2);
+
+    // The worker threads are created again when the number of threads changes
+    batch.setNrOfThreads(nrOfThreads + 1);
+    ASSERT_IS_TRUE(batch.doEstimates());
+    for (size_t subject = 0; subject < fileNames.size(); subject++)
+    {
+        ASSERT_EQUAL_VECTOR_TOL(batch.getLastEstimate(subject), solvers[subject]->getLastEstimate(), 1e-8);
+    }
+
+    SubjectInformation info = getSubjectInformation(berdys[0], 0, 0);
+    ASSERT_IS_FALSE(batch.setEstimateInformationFloatingBase(fileNames.size(), info.jointPos, info.jointVel,
+                                                             info.baseFrame, info.baseAngVel, info.measurements));
+
+    for (size_t subject = 0; subject < solvers.size(); subject++)
+    {
+        delete solvers[subject];
+    }
+}
+
+int main()
+{
+    std::vector<std::string> fileNames;
+    fileNames.push_back(getAbsModelPath("twoLinks.urdf"));
+    fileNames.push_back(getAbsModelPath("icub_skin_frames.urdf"));
+    fileNames.push_back(getAbsModelPath("twoLinks.urdf"));
+    fileNames.push_back(getAbsModelPath("icub_skin_frames.urdf"));
+    fileNames.push_back(getAbsModelPath("twoLinks.urdf"));
+
+    for (unsigned int nrOfThreads = 1; nrOfThreads <= 3; nrOfThreads += 2)
+    {
+        testBatchEstimates(fileNames, nrOfThreads);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -150,6 +150,56 @@ void testBerdySensorMatrices(BerdyHelper & berdy, std::string filename)
     }
 }
 
+/*
+ * After the first call, getBerdyMatrices should only update the values
+ * of the matrices passed to it, giving the same result of new matrices.
+ */
+void testBerdyMatricesInPlaceUpdate(BerdyHelper & berdy)
+{
+    JointPosDoubleArray jointPos(berdy.model());
+    JointDOFsDoubleArray jointVel(berdy.model());
+    LinkIndex baseIdx = berdy.dynamicTraversal().getBaseLink()->getIndex();
+    Vector3 baseAngVel;
+
+    SparseMatrix<iDynTree::ColumnMajor> D, Y;
+    VectorDynSize bD, bY;
+
+    for(int trial = 0; trial < 3; trial++)
+    {
+        for(size_t i = 0; i < jointPos.size(); i++)
+        {
+            jointPos(i) = 0.1*(trial+1)*i;
+            jointVel(i) = -0.2*(trial+1) + 0.05*i;
+        }
+        baseAngVel(0) = 0.3*trial;
+        baseAngVel(1) = -0.1;
+        baseAngVel(2) = 0.2*trial;
+
+        ASSERT_IS_TRUE(berdy.updateKinematicsFromFloatingBase(jointPos,jointVel,baseIdx,baseAngVel));
+        ASSERT_IS_TRUE(berdy.getBerdyMatrices(D,bD,Y,bY));
+        ASSERT_IS_TRUE(D.isSparsityPatternFrozen());
+        ASSERT_IS_TRUE(Y.isSparsityPatternFrozen());
+
+        SparseMatrix<iDynTree::ColumnMajor> DCheck, YCheck;
+        VectorDynSize bDCheck, bYCheck;
+        ASSERT_IS_TRUE(berdy.getBerdyMatrices(DCheck,bDCheck,YCheck,bYCheck));
+
+        ASSERT_EQUAL_DOUBLE(D.numberOfNonZeros(), DCheck.numberOfNonZeros());
+        ASSERT_EQUAL_DOUBLE(Y.numberOfNonZeros(), YCheck.numberOfNonZeros());
+        MatrixDynSize denseD(D.rows(),D.columns()), denseDCheck(D.rows(),D.columns());
+        toEigen(denseD) = toEigen(D);
+        toEigen(denseDCheck) = toEigen(DCheck);
+        ASSERT_EQUAL_MATRIX(denseD, denseDCheck);
+
+        MatrixDynSize denseY(Y.rows(),Y.columns()), denseYCheck(Y.rows(),Y.columns());
+        toEigen(denseY) = toEigen(Y);
+        toEigen(denseYCheck) = toEigen(YCheck);
+        ASSERT_EQUAL_MATRIX(denseY, denseYCheck);
+        ASSERT_EQUAL_VECTOR(bD, bDCheck);
+        ASSERT_EQUAL_VECTOR(bY, bYCheck);
+    }
+}
+
 /*
  * In the ORIGINAL_BERDY_FIXED_BASE, the serialization of the
  * dynamic variables returned by getDynamicVariablesOrdering
@@ -361,6 +411,7 @@ void testBerdyHelpers(std::string fileName)
     ok = berdyHelper.init(estimator.model(), estimator.sensors(), options);
     ASSERT_IS_TRUE(ok);
     testBerdySensorMatrices(berdyHelper, fileName);
+    testBerdyMatricesInPlaceUpdate(berdyHelper);
 
 }
 
@@ -11,10 +11,18 @@
 #include <iDynTree/Estimation/BerdySparseMAPSolver.h>
 
 #include <iDynTree/Estimation/BerdyHelper.h>
+#include <iDynTree/Estimation/ExtWrenchesAndJointTorquesEstimator.h>
+#include "testModels.h"
+#include "BerdyTestUtils.h"
 
 #include <iDynTree/Core/EigenHelpers.h>
 #include <iDynTree/Core/EigenSparseHelpers.h>
+#include <iDynTree/Core/MatrixDynSize.h>
 #include <iDynTree/Core/TestUtils.h>
+#include <iDynTree/Core/SparseMatrix.h>
+#include <iDynTree/Core/Triplets.h>
+
+#include <Eigen/Dense>
 
 #include <cstdio>
 #include <cstdlib>
@@ -29,9 +37,280 @@ void testEmptyHelper()
     ASSERT_IS_FALSE(solver.isValid());
 }
 
+/*
+ * Dense solution of the MAP problem with the given prior on the dynamics
+ */
+void computeDenseEstimate(BerdyHelper& berdy,
+                          const BerdySparseMAPSolver& solver,
+                          const Eigen::MatrixXd& dynamicsPriorInformation,
+                          const Eigen::VectorXd& dynamicsPriorExpectedValue,
+                          const VectorDynSize& measurements,
+                          VectorDynSize& estimate,
+                          Eigen::MatrixXd& estimateInformation)
+{
+    SparseMatrix<iDynTree::ColumnMajor> D, Y;
+    VectorDynSize bD, bY;
+    ASSERT_IS_TRUE(berdy.getBerdyMatrices(D, bD, Y, bY));
+
+    Eigen::MatrixXd denseD = toEigen(D);
+    Eigen::MatrixXd denseY = toEigen(Y);
+    Eigen::MatrixXd SigmaDInv = toEigen(solver.dynamicsConstraintsPriorCovarianceInverse());
+    Eigen::MatrixXd SigmayInv = toEigen(solver.measurementsPriorCovarianceInverse());
+
+    estimateInformation = dynamicsPriorInformation + denseD.transpose()*SigmaDInv*denseD + denseY.transpose()*SigmayInv*denseY;
+    Eigen::VectorXd rhs = dynamicsPriorInformation*dynamicsPriorExpectedValue
+                          - denseD.transpose()*SigmaDInv*toEigen(bD)
+                          + denseY.transpose()*SigmayInv*(toEigen(measurements) - toEigen(bY));
+
+    estimate.resize(berdy.getNrOfDynamicVariables());
+    toEigen(estimate) = estimateInformation.ldlt().solve(rhs);
+}
+
+/*
+ * Check the estimate of the solver against the dense solution of the MAP problem
+ */
+void checkEstimateAgainstDenseSolution(BerdyHelper& berdy,
+                                       const BerdySparseMAPSolver& solver,
+                                       const VectorDynSize& measurements)
+{
+    VectorDynSize expected;
+    Eigen::MatrixXd information;
+    computeDenseEstimate(berdy, solver,
+                         toEigen(solver.dynamicsRegularizationPriorCovarianceInverse()),
+                         toEigen(solver.dynamicsRegularizationPriorExpectedValue()),
+                         measurements, expected, information);
+
+    ASSERT_EQUAL_VECTOR_TOL(solver.getLastEstimate(), expected, 1e-6);
+}
+
+void testEstimate(std::string fileName)
+{
+    ExtWrenchesAndJointTorquesEstimator estimator;
+    ASSERT_IS_TRUE(estimator.loadModelAndSensorsFromFile(fileName));
+
+    BerdyOptions options;
+    options.berdyVariant = iDynTree::BERDY_FLOATING_BASE;
+    options.includeAllNetExternalWrenchesAsDynamicVariables = true;
+    options.includeAllNetExternalWrenchesAsSensors = true;
+    options.includeAllJointAccelerationsAsSensors = true;
+
+    BerdyHelper berdy;
+    ASSERT_IS_TRUE(berdy.init(estimator.model(), estimator.sensors(), options));
+
+    BerdySparseMAPSolver solver(berdy);
+    ASSERT_IS_TRUE(solver.isValid());
+
+    solver.setDynamicsConstraintsPriorCovariance(diagonalCovariance(berdy.getNrOfDynamicEquations(), 1e-4));
+    solver.setDynamicsRegularizationPriorCovariance(diagonalCovariance(berdy.getNrOfDynamicVariables(), 1.0));
+
+    JointPosDoubleArray jointPos(berdy.model());
+    JointDOFsDoubleArray jointVel(berdy.model());
+    VectorDynSize measurements(berdy.getNrOfSensorsMeasurements());
+    Vector3 baseAngVel;
+    FrameIndex baseFrame = berdy.dynamicTraversal().getBaseLink()->getIndex();
+
+    // Reference kept across the estimates
+    SparseMatrix<iDynTree::ColumnMajor>& measurementsPrior = solver.measurementsPriorCovarianceInverse();
+
+    for (int trial = 0; trial < 3; trial++)
+    {
+        // The measurements prior changes after the first estimate
+        if (trial == 1)
+        {
+            solver.setMeasurementsPriorCovariance(diagonalCovariance(berdy.getNrOfSensorsMeasurements(), 0.1));
+        }
+
+        // The pattern of the measurements prior changes through the kept reference
+        if (trial == 2)
+        {
+            Triplets triplets;
+            for (size_t i = 0; i < measurements.size(); i++)
+            {
+                triplets.pushTriplet(Triplet(i, i, 10.0));
+            }
+            triplets.pushTriplet(Triplet(0, 1, 0.5));
+            triplets.pushTriplet(Triplet(1, 0, 0.5));
+            measurementsPrior.setFromTriplets(triplets);
+        }
+
+        for (size_t i = 0; i < jointPos.size(); i++)
+        {
+            jointPos(i) = 0.2*(trial+1) - 0.03*i;
+            jointVel(i) = 0.1*trial + 0.02*i;
+        }
+        for (size_t i = 0; i < measurements.size(); i++)
+        {
+            measurements(i) = 0.5*trial - 0.01*i;
+        }
+        baseAngVel(0) = 0.1*trial;
+        baseAngVel(1) = 0.2;
+        baseAngVel(2) = -0.1;
+
+        solver.updateEstimateInformationFloatingBase(jointPos, jointVel, baseFrame, baseAngVel, measurements);
+        ASSERT_IS_TRUE(solver.doEstimate());
+        checkEstimateAgainstDenseSolution(berdy, solver, measurements);
+    }
+}
+
+void testRecursiveEstimate(std::string fileName)
+{
+    ExtWrenchesAndJointTorquesEstimator estimator;
+    ASSERT_IS_TRUE(estimator.loadModelAndSensorsFromFile(fileName));
+
+    BerdyOptions options;
+    options.berdyVariant = iDynTree::BERDY_FLOATING_BASE;
+    options.includeAllNetExternalWrenchesAsDynamicVariables = true;
+    options.includeAllNetExternalWrenchesAsSensors = true;
+
+    BerdyHelper berdy;
+    ASSERT_IS_TRUE(berdy.init(estimator.model(), estimator.sensors(), options));
+
+    BerdySparseMAPSolver solver(berdy);
+    ASSERT_IS_TRUE(solver.isValid());
+    solver.setDynamicsConstraintsPriorCovariance(diagonalCovariance(berdy.getNrOfDynamicEquations(), 1e-4));
+    solver.setRecursiveEstimation(true);
+    ASSERT_IS_TRUE(solver.isRecursiveEstimationEnabled());
+
+    VectorDynSize processNoise(berdy.getNrOfDynamicVariables());
+    for (size_t i = 0; i < processNoise.size(); i++)
+    {
+        processNoise(i) = 0.5 + 0.1*(i%3);
+    }
+    ASSERT_IS_TRUE(solver.setDynamicsProcessNoiseVariances(processNoise));
+
+    JointPosDoubleArray jointPos(berdy.model());
+    JointDOFsDoubleArray jointVel(berdy.model());
+    VectorDynSize measurements(berdy.getNrOfSensorsMeasurements());
+    Vector3 baseAngVel;
+    baseAngVel.zero();
+    FrameIndex baseFrame = berdy.dynamicTraversal().getBaseLink()->getIndex();
+
+    // The first estimate uses the prior on the dynamics
+    Eigen::MatrixXd priorInformation = toEigen(solver.dynamicsRegularizationPriorCovarianceInverse());
+    Eigen::VectorXd priorExpectedValue = toEigen(solver.dynamicsRegularizationPriorExpectedValue());
+
+    for (int step = 0; step < 3; step++)
+    {
+        for (size_t i = 0; i < jointPos.size(); i++)
+        {
+            jointPos(i) = 0.1*step + 0.05*i;
+            jointVel(i) = 0.1 - 0.01*i;
+        }
+        for (size_t i = 0; i < measurements.size(); i++)
+        {
+            measurements(i) = 1.0 + 0.2*step - 0.02*i;
+        }
+
+        solver.updateEstimateInformationFloatingBase(jointPos, jointVel, baseFrame, baseAngVel, measurements);
+        ASSERT_IS_TRUE(solver.doEstimate());
+
+        VectorDynSize expected;
+        Eigen::MatrixXd information;
+        computeDenseEstimate(berdy, solver, priorInformation, priorExpectedValue, measurements, expected, information);
+        ASSERT_EQUAL_VECTOR_TOL(solver.getLastEstimate(), expected, 1e-6);
+
+        // Prior of the next step: previous a-posteriori, with diagonal covariance and process noise
+        Eigen::MatrixXd covariance = information.inverse();
+        priorInformation.setZero();
+        for (int i = 0; i < priorInformation.rows(); i++)
+        {
+            priorInformation(i, i) = 1.0/(covariance(i, i) + processNoise(i));
+        }
+        priorExpectedValue = toEigen(expected);
+    }
+
+    // After a reset, the prior on the dynamics is used again
+    solver.resetRecursiveEstimation();
+    ASSERT_IS_TRUE(solver.doEstimate());
+    checkEstimateAgainstDenseSolution(berdy, solver, measurements);
+}
+
+void testCovariance(std::string fileName)
+{
+    ExtWrenchesAndJointTorquesEstimator estimator;
+    ASSERT_IS_TRUE(estimator.loadModelAndSensorsFromFile(fileName));
+
+    BerdyOptions options;
+    options.berdyVariant = iDynTree::BERDY_FLOATING_BASE;
+    options.includeAllNetExternalWrenchesAsDynamicVariables = true;
+    options.includeAllNetExternalWrenchesAsSensors = true;
+    options.includeAllJointAccelerationsAsSensors = true;
+
+    BerdyHelper berdy;
+    ASSERT_IS_TRUE(berdy.init(estimator.model(), estimator.sensors(), options));
+
+    BerdySparseMAPSolver solver(berdy);
+    ASSERT_IS_TRUE(solver.isValid());
+    solver.setDynamicsConstraintsPriorCovariance(diagonalCovariance(berdy.getNrOfDynamicEquations(), 1e-4));
+    solver.setMeasurementsPriorCovariance(diagonalCovariance(berdy.getNrOfSensorsMeasurements(), 0.1));
+
+    JointPosDoubleArray jointPos(berdy.model());
+    JointDOFsDoubleArray jointVel(berdy.model());
+    VectorDynSize measurements(berdy.getNrOfSensorsMeasurements());
+    Vector3 baseAngVel;
+    baseAngVel.zero();
+    FrameIndex baseFrame = berdy.dynamicTraversal().getBaseLink()->getIndex();
+
+    for (size_t i = 0; i < jointPos.size(); i++)
+    {
+        jointPos(i) = 0.3 - 0.02*i;
+        jointVel(i) = 0.05*i;
+    }
+    for (size_t i = 0; i < measurements.size(); i++)
+    {
+        measurements(i) = 0.1*(i%5);
+    }
+
+    solver.updateEstimateInformationFloatingBase(jointPos, jointVel, baseFrame, baseAngVel, measurements);
+    ASSERT_IS_TRUE(solver.doEstimate());
+
+    VectorDynSize expected;
+    Eigen::MatrixXd information;
+    computeDenseEstimate(berdy, solver,
+                         toEigen(solver.dynamicsRegularizationPriorCovarianceInverse()),
+                         toEigen(solver.dynamicsRegularizationPriorExpectedValue()),
+                         measurements, expected, information);
+    Eigen::MatrixXd covariance = information.inverse();
+
+    VectorDynSize variances;
+    ASSERT_IS_TRUE(solver.getLastEstimateVariances(variances));
+    VectorDynSize expectedVariances(covariance.rows());
+    toEigen(expectedVariances) = covariance.diagonal();
+    ASSERT_EQUAL_VECTOR_TOL(variances, expectedVariances, 1e-6);
+
+    // Blocks of the joint wrenches
+    MatrixDynSize block, expectedBlock;
+    for (JointIndex jnt = 0; jnt < static_cast<JointIndex>(berdy.model().getNrOfJoints()); jnt++)
+    {
+        IndexRange range = berdy.getRangeJointVariable(JOINT_WRENCH, jnt);
+        ASSERT_IS_TRUE(solver.getLastEstimateCovarianceBlock(range, block));
+        expectedBlock.resize(range.size, range.size);
+        toEigen(expectedBlock) = covariance.block(range.offset, range.offset, range.size, range.size);
+        ASSERT_EQUAL_MATRIX_TOL(block, expectedBlock, 1e-6);
+    }
+
+    // A block including elements outside of the sparsity pattern of the factorization
+    IndexRange wholeRange;
+    wholeRange.offset = 0;
+    wholeRange.size = covariance.rows();
+    ASSERT_IS_TRUE(solver.getLastEstimateCovarianceBlock(wholeRange, block));
+    expectedBlock.resize(covariance.rows(), covariance.cols());
+    toEigen(expectedBlock) = covariance;
+    ASSERT_EQUAL_MATRIX_TOL(block, expectedBlock, 1e-6);
+
+    wholeRange.size = covariance.rows() + 1;
+    ASSERT_IS_FALSE(solver.getLastEstimateCovarianceBlock(wholeRange, block));
+}
+
 int main()
 {
     testEmptyHelper();
+    testEstimate(getAbsModelPath("twoLinks.urdf"));
+    testEstimate(getAbsModelPath("icub_skin_frames.urdf"));
+    testRecursiveEstimate(getAbsModelPath("twoLinks.urdf"));
+    testRecursiveEstimate(getAbsModelPath("icub_skin_frames.urdf"));
+    testCovariance(getAbsModelPath("twoLinks.urdf"));
+    testCovariance(getAbsModelPath("icub_skin_frames.urdf"));
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_BERDY_TEST_UTILS_H
+#define IDYNTREE_BERDY_TEST_UTILS_H
+
+#include <iDynTree/Core/SparseMatrix.h>
+#include <iDynTree/Core/Triplets.h>
+
+#include <cstddef>
+
+/*
+ * Diagonal covariance of the given size, with elements slightly different from offset
+ */
+inline iDynTree::SparseMatrix<iDynTree::ColumnMajor> diagonalCovariance(size_t size, double offset)
+{
+    iDynTree::Triplets triplets;
+    for (size_t i = 0; i < size; i++)
+    {
+        triplets.pushTriplet(iDynTree::Triplet(i, i, offset + 0.01*(i%7)));
+    }
+    iDynTree::SparseMatrix<iDynTree::ColumnMajor> covariance(size, size);
+    covariance.setFromTriplets(triplets);
+    return covariance;
+}
+
+#endif /* end of include guard: IDYNTREE_BERDY_TEST_UTILS_H */
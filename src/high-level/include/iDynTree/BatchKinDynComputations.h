@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_BATCH_KINDYNCOMPUTATIONS_H
+#define IDYNTREE_BATCH_KINDYNCOMPUTATIONS_H
+
+#include <string>
+#include <vector>
+
+#include <iDynTree/Core/VectorFixSize.h>
+#include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/Transform.h>
+#include <iDynTree/Core/Twist.h>
+#include <iDynTree/Core/Utils.h>
+
+#include <iDynTree/Model/Indices.h>
+#include <iDynTree/Model/FreeFloatingMatrices.h>
+
+namespace iDynTree
+{
+
+class Model;
+
+/**
+ * \ingroup iDynTreeHighLevel
+ *
+ * \brief High level class to evaluate kinematics and dynamics quantities on a batch of robot states.
+ *
+ * While KinDynComputations stores a single robot state, this class stores N states
+ * (base pose, joint positions, base velocity and joint velocities) and computes the
+ * quantities of all the states in a single call, returning them stacked in a single output
+ * matrix. Each quantity is stored internally in a separate array indexed by the state,
+ * and the states are split in contiguous chunks that are processed by different threads.
+ *
+ * The frame velocity representation has the same meaning of the one of KinDynComputations,
+ * and it is used both for the input base velocities and for the outputs.
+ *
+ * Internally, all the computations are performed on a CompiledModel, that is
+ * shared by the different threads.
+ *
+ * \note Only models with fixed, revolute and prismatic joints are supported.
+ */
+class BatchKinDynComputations {
+private:
+    struct BatchKinDynComputationsPrivateAttributes;
+    BatchKinDynComputationsPrivateAttributes * pimpl;
+
+    // copy is disabled for the moment
+    BatchKinDynComputations(const BatchKinDynComputations & other);
+    BatchKinDynComputations& operator=(const BatchKinDynComputations& other);
+
+    // Make sure that (if necessary) forward kinematics of all the states is updated
+    bool computeFwdKinematics();
+
+    // Make sure that (if necessary) the raw mass matrices of all the states are updated
+    bool computeRawMassMatrices();
+
+    // Set to invalid all the cached quantities
+    void invalidateCache();
+
+public:
+    /**
+     * Constructor.
+     */
+    BatchKinDynComputations();
+
+    /**
+     * Destructor.
+     */
+    virtual ~BatchKinDynComputations();
+
+    /**
+     * @name Model loading and basic model information
+     */
+    //@{
+
+    /**
+     * Set the model used for the computations.
+     *
+     * @return true if all went well, false otherwise (for example if the model contains unsupported joints).
+     */
+    bool loadRobotModel(const iDynTree::Model & model);
+
+    /**
+     * Return true if the model was correctly loaded.
+     */
+    bool isValid() const;
+
+    /**
+     * Get the model used for the computations.
+     */
+    const Model & model() const;
+
+    /**
+     * Set the used FrameVelocityRepresentation.
+     */
+    bool setFrameVelocityRepresentation(const FrameVelocityRepresentation frameVelRepr);
+
+    /**
+     * Get the used FrameVelocityRepresentation.
+     */
+    FrameVelocityRepresentation getFrameVelocityRepresentation() const;
+
+    /**
+     * Set the link that is used as the floating base.
+     *
+     * @return true if all went well, false otherwise (for example if the link name is not found).
+     */
+    bool setFloatingBase(const std::string & floatingBaseName);
+
+    /**
+     * Get the name of the link used as the floating base.
+     */
+    std::string getFloatingBase() const;
+
+    /**
+     * Set the number of threads used for the computations.
+     *
+     * If nrOfThreads is 0, the number of concurrent threads supported by the machine is used.
+     * By default, the number of concurrent threads supported by the machine is used.
+     */
+    void setNrOfThreads(const unsigned int nrOfThreads);
+
+    /**
+     * Get the number of threads used for the computations.
+     */
+    unsigned int getNrOfThreads() const;
+
+    /**
+     * Get the number of internal degrees of freedom of the robot model.
+     */
+    unsigned int getNrOfDegreesOfFreedom() const;
+
+    /**
+     * Get the index of a frame, or FRAME_INVALID_INDEX if the frame is not found.
+     */
+    FrameIndex getFrameIndex(const std::string & frameName) const;
+
+    //@}
+
+    /**
+     * @name Batch of robot states
+     */
+    //@{
+
+    /**
+     * Set the batch of robot states.
+     *
+     * @param[in] world_T_base  vector of N world_T_base transforms,
+     * @param[in] s             N x getNrOfDegreesOfFreedom() matrix, the i-th row contains the joint positions of the i-th state,
+     * @param[in] base_velocity vector of N base velocities, expressed in the used FrameVelocityRepresentation,
+     * @param[in] s_dot         N x getNrOfDegreesOfFreedom() matrix, the i-th row contains the joint velocities of the i-th state,
+     * @param[in] world_gravity the gravity acceleration, expressed in the world frame, common to all the states.
+     * @return true if all went well, false otherwise.
+     */
+    bool setRobotStates(const std::vector<Transform> & world_T_base,
+                        const MatrixDynSize & s,
+                        const std::vector<Twist> & base_velocity,
+                        const MatrixDynSize & s_dot,
+                        const Vector3 & world_gravity);
+
+    /**
+     * Get the number of states in the batch.
+     */
+    size_t getNrOfStates() const;
+
+    //@}
+
+    /**
+     * @name Batch kinematics
+     */
+    //@{
+
+    /**
+     * Get the world_H_frame transform of a frame, for all the states.
+     *
+     * @param[in]  frameIndex the index of the frame,
+     * @param[out] world_H_frame vector of N transforms, resized if necessary.
+     * @return true if all went well, false otherwise.
+     */
+    bool getWorldTransforms(const FrameIndex frameIndex,
+                            std::vector<Transform> & world_H_frame);
+
+    /**
+     * Get the free floating jacobian of a frame, for all the states.
+     *
+     * @param[in]  frameIndex the index of the frame,
+     * @param[out] stackedJacobians 6N x (6+getNrOfDegreesOfFreedom()) matrix, rows [6i,6i+6) contain
+     *                              the jacobian of the i-th state. Resized if necessary.
+     * @return true if all went well, false otherwise.
+     */
+    bool getFrameFreeFloatingJacobians(const FrameIndex frameIndex,
+                                       MatrixDynSize & stackedJacobians);
+
+    /**
+     * Get the position of the center of mass, expressed in the world frame, for all the states.
+     *
+     * @param[out] comPositions N x 3 matrix, the i-th row contains the center of mass of the i-th state.
+     * @return true if all went well, false otherwise.
+     */
+    bool getCenterOfMassPositions(MatrixDynSize & comPositions);
+
+    //@}
+
+    /**
+     * @name Batch dynamics
+     */
+    //@{
+
+    /**
+     * Get the free floating mass matrix, for all the states.
+     *
+     * @param[out] stackedMassMatrices N(6+n) x (6+n) matrix, rows [(6+n)i,(6+n)(i+1)) contain
+     *                                 the mass matrix of the i-th state. Resized if necessary.
+     * @return true if all went well, false otherwise.
+     */
+    bool getFreeFloatingMassMatrices(MatrixDynSize & stackedMassMatrices);
+
+    /**
+     * Compute the inverse dynamics (without external wrenches) for all the states.
+     *
+     * @param[in]  baseAcc N x 6 matrix, the i-th row contains the base acceleration of the i-th state,
+     *                     expressed in the used FrameVelocityRepresentation,
+     * @param[in]  s_ddot  N x n matrix, the i-th row contains the joint accelerations of the i-th state,
+     * @param[out] generalizedTorques N x (6+n) matrix, the i-th row contains the base wrench and the joint torques
+     *                                of the i-th state. Resized if necessary.
+     * @return true if all went well, false otherwise.
+     */
+    bool inverseDynamics(const MatrixDynSize & baseAcc,
+                         const MatrixDynSize & s_ddot,
+                               MatrixDynSize & generalizedTorques);
+
+    /**
+     * Compute the generalized bias forces (coriolis, centrifugal and gravity terms) for all the states.
+     *
+     * @param[out] generalizedBiasForces N x (6+n) matrix, the i-th row contains the base wrench and the joint torques
+     *                                   of the i-th state. Resized if necessary.
+     * @return true if all went well, false otherwise.
+     */
+    bool generalizedBiasForces(MatrixDynSize & generalizedBiasForces);
+
+    //@}
+};
+
+}
+
+#endif
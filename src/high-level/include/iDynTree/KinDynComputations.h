@@ -12,9 +12,13 @@
 #define IDYNTREE_KINDYNCOMPUTATIONS_H
 
 #include <string>
+#include <vector>
 
 #include <iDynTree/Core/VectorFixSize.h>
 #include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/MatrixView.h>
+#include <iDynTree/Core/Span.h>
+#include <iDynTree/Core/CompressedColumnJacobian.h>
 #include <iDynTree/Core/Utils.h>
 
 
@@ -79,7 +83,7 @@ private:
     // exits without further computations
     void computeBiasAccFwdKinematics();
 
-    // Invalidate the cache of intermediated results (called by setRobotState)
+    // Invalidate the whole cache of intermediated results (called when the model or the floating base change)
     void invalidateCache();
 
     // Resize internal data structures after a model has been successfully loaded
@@ -341,6 +345,38 @@ public:
                        const iDynTree::VectorDynSize &s_dot,
                        const iDynTree::Vector3& world_gravity);
 
+    /**
+     * Set the state for the robot (floating base), reading it directly from the memory of the caller.
+     *
+     * Same as the setRobotState taking iDynTree classes, but the inputs can be any contiguous buffer
+     * (for example Eigen vectors or std::vector) and the homogeneous transform can be any 4x4 matrix,
+     * with any storage ordering.
+     *
+     * @param world_T_base  the 4x4 homogeneous transformation world_T_base.
+     * @param s a vector of getNrOfPosCoords() joint positions.
+     * @param base_velocity the 6d base twist (linear velocity first, then angular velocity),
+     *                      expressed with the convention specified by the used FrameVelocityConvention.
+     * @param s_dot a vector of getNrOfDegreesOfFreedom() joint velocities.
+     * @param world_gravity a 3d vector of the gravity acceleration vector, expressed in the world/inertial frame.
+     * @return true if all went well, false otherwise.
+     */
+    bool setRobotState(iDynTree::MatrixView<const double> world_T_base,
+                       iDynTree::Span<const double> s,
+                       iDynTree::Span<const double> base_velocity,
+                       iDynTree::Span<const double> s_dot,
+                       iDynTree::Span<const double> world_gravity);
+
+    /**
+     * Set the state for the robot (fixed base), reading it directly from the memory of the caller.
+     *
+     * Same as setRobotState, but with:
+     *  world_T_base      = iDynTree::Transform::Identity()
+     *  base_velocity     = iDynTree::Twist::Zero();
+     */
+    bool setRobotState(iDynTree::Span<const double> s,
+                       iDynTree::Span<const double> s_dot,
+                       iDynTree::Span<const double> world_gravity);
+
     void getRobotState(iDynTree::Transform &world_T_base,
                        iDynTree::VectorDynSize& s,
                        iDynTree::Twist& base_velocity,
@@ -392,6 +428,8 @@ public:
      * specified by frameIndex, and the reference frame is the world one
      * (world_H_frame).
      *
+     * @note Only the position of the links in the path between the base
+     *       and the frame is computed (if not already available).
      */
     iDynTree::Transform getWorldTransform(const iDynTree::FrameIndex frameIndex);
 
@@ -409,6 +447,8 @@ public:
      * specified by frameIndex, and the reference frame is the one specified
      * by refFrameIndex (refFrame_H_frame).
      *
+     * @note If the world transforms of the two frames are not already available,
+     *       only the joints in the path between the two frames are used.
      */
     iDynTree::Transform getRelativeTransform(const iDynTree::FrameIndex refFrameIndex,
                                              const iDynTree::FrameIndex frameIndex);
@@ -481,6 +521,58 @@ public:
     bool getFrameFreeFloatingJacobian(const FrameIndex frameIndex,
                                       iDynTree::MatrixDynSize & outJacobian);
 
+    /**
+     * Compute the free floating jacobian of a frame, writing it directly in the memory of the caller.
+     *
+     * @param[in]  frameIndex the index of the frame.
+     * @param[out] outJacobian view of a 6 x (6+getNrOfDegreesOfFreedom()) matrix, with any storage ordering.
+     *                         It is not resized: if it has the wrong size an error is reported.
+     * @return true if all went well, false otherwise.
+     */
+    bool getFrameFreeFloatingJacobian(const FrameIndex frameIndex,
+                                      iDynTree::MatrixView<double> outJacobian);
+
+    bool getFrameFreeFloatingJacobian(const std::string & frameName,
+                                      iDynTree::MatrixView<double> outJacobian);
+
+    /**
+     * Compute the free floating jacobian of a frame, storing only its nonzero columns.
+     *
+     * The nonzero columns are the ones of getFrameFreeFloatingJacobianSparsityPattern, i.e. the
+     * 6 columns of the base and the columns of the joints in the path between the frame and the base.
+     * Only these columns are computed and written, and if the frame is the same of the previous call
+     * no memory allocation is performed. The jacobian can be mapped to an Eigen sparse matrix with toEigen
+     * (see iDynTree/Core/EigenSparseHelpers.h) or converted with CompressedColumnJacobian::toSparseMatrix.
+     *
+     * @param[in]  frameIndex the index of the frame.
+     * @param[out] outJacobian the 6 x (6+getNrOfDegreesOfFreedom()) jacobian, resized if necessary.
+     * @return true if all went well, false otherwise.
+     */
+    bool getFrameFreeFloatingJacobian(const FrameIndex frameIndex,
+                                      iDynTree::CompressedColumnJacobian & outJacobian);
+
+    bool getFrameFreeFloatingJacobian(const std::string & frameName,
+                                      iDynTree::CompressedColumnJacobian & outJacobian);
+
+    /**
+     * Return the free floating jacobians of several frames, stacked in a single matrix.
+     *
+     * The result is the same of calling getFrameFreeFloatingJacobian for each frame, but
+     * the columns relative to the joints shared by the frames (for example the torso joints)
+     * are computed only once, and the representation-dependent quantities of the base are
+     * computed once for all the frames.
+     *
+     * @param[in]  frameIndices the indices of the k frames.
+     * @param[out] outStackedJacobians 6k x (6+getNrOfDegreesOfFreedom()) matrix, rows [6i,6i+6)
+     *                                 contain the jacobian of the i-th frame. It is resized if necessary.
+     * @return true if all went well, false otherwise.
+     */
+    bool getFrameFreeFloatingJacobians(const std::vector<FrameIndex> & frameIndices,
+                                       iDynTree::MatrixDynSize & outStackedJacobians);
+
+    bool getFrameFreeFloatingJacobians(const std::vector<std::string> & frameNames,
+                                       iDynTree::MatrixDynSize & outStackedJacobians);
+
 
 
 
@@ -572,6 +664,11 @@ public:
      */
     bool getCenterOfMassJacobian(MatrixDynSize & comJacobian);
 
+    /**
+     * Return the center of mass jacobian, writing it in the 3 \times (n+6) matrix viewed by comJacobian.
+     */
+    bool getCenterOfMassJacobian(MatrixView<double> comJacobian);
+
     /**
      * Return the center of mass bias acceleration.
      */
@@ -617,6 +714,12 @@ public:
      */
     bool getCentroidalAverageVelocityJacobian(MatrixDynSize & centroidalAvgVelocityJacobian);
 
+    /**
+     * Get the jacobian of the centroidal average velocity of the robot,
+     * writing it in the 6 \times (n+6) matrix viewed by centroidalAvgVelocityJacobian.
+     */
+    bool getCentroidalAverageVelocityJacobian(MatrixView<double> centroidalAvgVelocityJacobian);
+
     /**
      * Get the linear and angular momentum of the robot.
      * The quantity is expressed in (B[A]), (A) or (B) depending on the FrameVelocityConvention used.
@@ -666,6 +769,15 @@ public:
      */
     bool getFreeFloatingMassMatrix(MatrixDynSize & freeFloatingMassMatrix);
 
+    /**
+     * Get the free floating mass matrix of the system, writing it directly in the memory of the caller.
+     *
+     * @param[out] freeFloatingMassMatrix view of the (6+getNrOfDOFs()) times (6+getNrOfDOFs()) output mass matrix,
+     *                                    with any storage ordering. It is not resized.
+     * @return true if all went well, false otherwise.
+     */
+    bool getFreeFloatingMassMatrix(MatrixView<double> freeFloatingMassMatrix);
+
     //@}
 
     /**
@@ -692,6 +804,84 @@ public:
                          const LinkNetExternalWrenches & linkExtForces,
                                FreeFloatingGeneralizedTorques & baseForceAndJointTorques);
 
+    /**
+     * Compute the free floating inverse dynamics, reading the accelerations from the memory of the caller.
+     *
+     * @param[in] baseAcc the 6d acceleration of the base link
+     * @param[in] s_ddot the getNrOfDOFs() accelerations of the joints
+     * @param[in] linkExtForces the external wrenches excerted by the environment on the model
+     * @param[out] baseForceAndJointTorques the output generalized torques
+     * @return true if all went well, false otherwise
+     */
+    bool inverseDynamics(Span<const double> baseAcc,
+                         Span<const double> s_ddot,
+                         const LinkNetExternalWrenches & linkExtForces,
+                               FreeFloatingGeneralizedTorques & baseForceAndJointTorques);
+
+    /**
+     * Compute the free floating inverse dynamics, reading and writing directly the memory of the caller.
+     *
+     * @param[in] baseAcc the 6d acceleration of the base link
+     * @param[in] s_ddot the getNrOfDOFs() accelerations of the joints
+     * @param[in] linkExtForces the external wrenches excerted by the environment on the model
+     * @param[out] baseForceAndJointTorques vector of 6+getNrOfDOFs() elements, containing the base wrench
+     *                                      (force first, then torque) followed by the joint torques.
+     * @return true if all went well, false otherwise
+     */
+    bool inverseDynamics(Span<const double> baseAcc,
+                         Span<const double> s_ddot,
+                         const LinkNetExternalWrenches & linkExtForces,
+                               Span<double> baseForceAndJointTorques);
+
+    /**
+     * Compute the free floating forward dynamics, using the Articulated Body Algorithm.
+     *
+     * The semantics of baseAcc and of the elements of linkExtForces
+     * depend of the chosen FrameVelocityRepresentation .
+     *
+     * The state is the one given set by the setRobotState method.
+     *
+     * @param[in] jointTorques the torques of the joints
+     * @param[in] linkExtForces the external wrenches excerted by the environment on the model
+     * @param[out] baseAcc the output acceleration of the base link
+     * @param[out] s_ddot the output accelerations of the joints
+     * @return true if all went well, false otherwise
+     */
+    bool forwardDynamics(const VectorDynSize& jointTorques,
+                         const LinkNetExternalWrenches & linkExtForces,
+                               Vector6& baseAcc,
+                               VectorDynSize& s_ddot);
+
+    /**
+     * Compute the derivatives of the free floating inverse dynamics with respect to
+     * the robot position, velocity and acceleration.
+     *
+     * The semantics of baseAcc, of the base part of the generalized torques
+     * and of the elements of linkExtForces depend of the chosen FrameVelocityRepresentation .
+     * Coherently, the base columns of the derivatives with respect to the robot position
+     * are the derivatives along the variations of the base position obtained by moving the base with a
+     * unit base velocity expressed in the chosen FrameVelocityRepresentation, and the baseAcc and
+     * linkExtForces are kept constant in the chosen FrameVelocityRepresentation.
+     *
+     * The derivatives are computed analytically in \f$ O(n^2) \f$, see the InverseDynamicsDerivatives function.
+     *
+     * The state is the one given set by the setRobotState method.
+     *
+     * @param[in] baseAcc the acceleration of the base link
+     * @param[in] s_ddot the accelerations of the joints
+     * @param[in] linkExtForces the external wrenches excerted by the environment on the model
+     * @param[out] dTau_dq (6+getNrOfDOFs())x(6+getNrOfDOFs()) derivative of the generalized torques with respect to the robot position
+     * @param[out] dTau_dnu (6+getNrOfDOFs())x(6+getNrOfDOFs()) derivative of the generalized torques with respect to the robot velocity
+     * @param[out] dTau_dnudot (6+getNrOfDOFs())x(6+getNrOfDOFs()) derivative of the generalized torques with respect to the robot acceleration
+     * @return true if all went well, false otherwise
+     */
+    bool inverseDynamicsDerivatives(const Vector6& baseAcc,
+                                    const VectorDynSize& s_ddot,
+                                    const LinkNetExternalWrenches & linkExtForces,
+                                          MatrixDynSize & dTau_dq,
+                                          MatrixDynSize & dTau_dnu,
+                                          MatrixDynSize & dTau_dnudot);
+
     /**
      * Compute the getNrOfDOFS()+6 vector of generalized bias (gravity+coriolis) forces.
      *
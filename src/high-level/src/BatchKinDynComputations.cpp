@@ -0,0 +1,906 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/BatchKinDynComputations.h>
+
+#include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/VectorDynSize.h>
+#include <iDynTree/Core/Twist.h>
+#include <iDynTree/Core/Transform.h>
+#include <iDynTree/Core/Rotation.h>
+#include <iDynTree/Core/Utils.h>
+#include <iDynTree/Core/SpatialAcc.h>
+#include <iDynTree/Core/SpatialInertia.h>
+#include <iDynTree/Core/Wrench.h>
+
+#include <iDynTree/Core/EigenHelpers.h>
+
+#include <iDynTree/Model/Model.h>
+#include <iDynTree/Model/Traversal.h>
+#include <iDynTree/Model/CompiledModel.h>
+#include <iDynTree/Model/FreeFloatingState.h>
+#include <iDynTree/Model/FreeFloatingMatrices.h>
+#include <iDynTree/Model/LinkState.h>
+
+#include "KinDynComputationsHelpers.h"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace iDynTree
+{
+
+/**
+ * Buffers used by a single thread to process its chunk of states.
+ */
+struct BatchKinDynWorkerBuffers
+{
+    /** Generalized **proper** (real-gravity) acceleration, base part in body-fixed representation */
+    FreeFloatingAcc m_generalizedProperAccs;
+
+    /** Link velocities, in body-fixed representation */
+    LinkVelArray m_linkVel;
+
+    /** **Proper** (real-gravity) acceleration of each link, in body-fixed representation */
+    LinkProperAccArray m_linkProperAccs;
+
+    /** External wrenches, always zero */
+    LinkNetExternalWrenches m_zeroNetExtWrenches;
+
+    /** Internal wrenches, in body-fixed representation */
+    LinkInternalWrenches m_internalWrenches;
+
+    /** Output of the inverse dynamics */
+    FreeFloatingGeneralizedTorques m_generalizedTorques;
+
+    /** Buffer for the jacobian of a single state */
+    MatrixDynSize m_jacobian;
+
+    /** Buffer for the mass matrix of a single state */
+    MatrixDynSize m_massMatrix;
+
+    void resize(const Model & model)
+    {
+        m_generalizedProperAccs.resize(model);
+        m_linkVel.resize(model);
+        m_linkProperAccs.resize(model);
+        m_zeroNetExtWrenches.resize(model);
+        m_zeroNetExtWrenches.zero();
+        m_internalWrenches.resize(model);
+        m_generalizedTorques.resize(model);
+        m_jacobian.resize(6,6+model.getNrOfDOFs());
+        m_massMatrix.resize(6+model.getNrOfDOFs(),6+model.getNrOfDOFs());
+    }
+};
+
+struct BatchKinDynComputations::BatchKinDynComputationsPrivateAttributes
+{
+private:
+    // Disable copy constructor and copy operator
+    BatchKinDynComputationsPrivateAttributes(const BatchKinDynComputationsPrivateAttributes&other)
+    {
+        assert(false);
+    }
+
+    BatchKinDynComputationsPrivateAttributes& operator=(const BatchKinDynComputationsPrivateAttributes& other)
+    {
+        assert(false);
+
+        return *this;
+    }
+
+public:
+    // True if the the model is valid, false otherwise.
+    bool m_isModelValid;
+
+    // Frame velocity representation used by the class
+    FrameVelocityRepresentation m_frameVelRepr;
+
+    // Number of threads used for the computations
+    unsigned int m_nrOfThreads;
+
+    // Model used for the computations
+    Model m_robot_model;
+
+    // Traversal used for the computations, it defines the floating base
+    Traversal m_traversal;
+
+    // Compiled representation of m_robot_model and m_traversal, shared by all the threads
+    CompiledModel m_compiledModel;
+
+    // 3d gravity vector, expressed with the orientation of the inertial (world) frame
+    Vector3 m_gravityAcc;
+
+    // All the following vectors have one element for each state of the batch
+
+    // Position of the states
+    std::vector<FreeFloatingPos> m_pos;
+
+    // Velocity of the states (the base velocity is always stored in BODY_FIXED_REPRESENTATION,
+    // and converted on set/get, as in KinDynComputations)
+    std::vector<FreeFloatingVel> m_vel;
+
+    // Forward kinematics data structures
+    bool m_isFwdKinematicsUpdated;
+    std::vector<LinkPositions> m_parent_X_links;
+    std::vector<LinkPositions> m_linkPos;
+    std::vector<LinkVelArray> m_linkVel;
+
+    // Mass matrix data structures
+    bool m_isRawMassMatrixUpdated;
+    std::vector<LinkCompositeRigidBodyInertias> m_linkCRBIs;
+    std::vector<FreeFloatingMassMatrix> m_rawMassMatrix;
+
+    // Buffers, one for each thread
+    std::vector<BatchKinDynWorkerBuffers> m_workerBuffers;
+
+    // Worker threads, kept alive between the calls to runOnAllStates.
+    // The calling thread is the worker of index 0, so m_workers[i] is the worker of index i+1.
+    std::vector<std::thread> m_workers;
+    std::mutex m_workersMutex;
+    std::condition_variable m_runRequested;
+    std::condition_variable m_runCompleted;
+    // Incremented to request a run of m_stateKernel on all the states to the workers
+    unsigned long m_runRequest;
+    // Number of workers that still have to complete the last requested run
+    size_t m_nrOfPendingWorkers;
+    bool m_stopRequested;
+
+    // Kernel of the current run, and result of each worker
+    std::function<bool(const size_t, BatchKinDynWorkerBuffers &)> m_stateKernel;
+    std::vector<char> m_workerOk;
+
+    BatchKinDynComputationsPrivateAttributes()
+    {
+        m_isModelValid = false;
+        m_frameVelRepr = MIXED_REPRESENTATION;
+        m_nrOfThreads = std::max(std::thread::hardware_concurrency(),1u);
+        m_gravityAcc.zero();
+        m_isFwdKinematicsUpdated = false;
+        m_isRawMassMatrixUpdated = false;
+        m_runRequest = 0;
+        m_nrOfPendingWorkers = 0;
+        m_stopRequested = false;
+    }
+
+    ~BatchKinDynComputationsPrivateAttributes()
+    {
+        stopWorkers();
+    }
+
+    void resizeWorkerBuffers()
+    {
+        m_workerBuffers.resize(m_nrOfThreads);
+        for(size_t worker=0; worker < m_workerBuffers.size(); worker++)
+        {
+            m_workerBuffers[worker].resize(m_robot_model);
+        }
+    }
+
+    void resizeStates(const size_t nrOfStates)
+    {
+        m_pos.resize(nrOfStates);
+        m_vel.resize(nrOfStates);
+        m_parent_X_links.resize(nrOfStates);
+        m_linkPos.resize(nrOfStates);
+        m_linkVel.resize(nrOfStates);
+        m_linkCRBIs.resize(nrOfStates);
+        m_rawMassMatrix.resize(nrOfStates);
+
+        for(size_t state=0; state < nrOfStates; state++)
+        {
+            m_pos[state].resize(m_robot_model);
+            m_vel[state].resize(m_robot_model);
+            m_parent_X_links[state].resize(m_robot_model);
+            m_linkPos[state].resize(m_robot_model);
+            m_linkVel[state].resize(m_robot_model);
+            m_linkCRBIs[state].resize(m_robot_model);
+            m_rawMassMatrix[state].resize(m_robot_model);
+            m_rawMassMatrix[state].zero();
+        }
+    }
+
+    LinkIndex getBaseLinkIndex() const
+    {
+        return m_compiledModel.getLinkIndex(0);
+    }
+
+    /**
+     * Run m_stateKernel on the chunk of states of the worker.
+     *
+     * The states are split in contiguous chunks, one for each worker.
+     */
+    void processChunk(const size_t worker)
+    {
+        size_t nrOfStates  = m_pos.size();
+        size_t nrOfWorkers = m_workerOk.size();
+        size_t firstState = (worker*nrOfStates)/nrOfWorkers;
+        size_t lastState  = ((worker+1)*nrOfStates)/nrOfWorkers;
+
+        bool ok = true;
+        for(size_t state=firstState; state < lastState; state++)
+        {
+            ok = m_stateKernel(state,m_workerBuffers[worker]) && ok;
+        }
+        m_workerOk[worker] = ok;
+    }
+
+    void workerLoop(const size_t worker, unsigned long lastRunRequest)
+    {
+        while( true )
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_workersMutex);
+                m_runRequested.wait(lock,[&]() { return m_stopRequested || m_runRequest != lastRunRequest; });
+                if( m_stopRequested )
+                {
+                    return;
+                }
+                lastRunRequest = m_runRequest;
+            }
+
+            processChunk(worker);
+
+            std::lock_guard<std::mutex> lock(m_workersMutex);
+            m_nrOfPendingWorkers--;
+            if( m_nrOfPendingWorkers == 0 )
+            {
+                m_runCompleted.notify_one();
+            }
+        }
+    }
+
+    void startWorkers(const size_t nrOfWorkers)
+    {
+        for(size_t worker=1; worker < nrOfWorkers; worker++)
+        {
+            m_workers.push_back(std::thread(&BatchKinDynComputationsPrivateAttributes::workerLoop,this,worker,m_runRequest));
+        }
+    }
+
+    void stopWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_workersMutex);
+            m_stopRequested = true;
+        }
+        m_runRequested.notify_all();
+
+        for(size_t worker=0; worker < m_workers.size(); worker++)
+        {
+            m_workers[worker].join();
+        }
+        m_workers.clear();
+        m_stopRequested = false;
+    }
+
+    /**
+     * Run kernel(state,workerBuffers) for all the states of the batch.
+     *
+     * The states are split in contiguous chunks, one for each thread.
+     * The first chunk is processed by the calling thread.
+     * The worker threads are created in the first call, and created again
+     * only if the number of threads or of states changed.
+     *
+     * @return true if the kernel returned true for all the states, false otherwise.
+     */
+    template<typename StateKernel>
+    bool runOnAllStates(StateKernel kernel)
+    {
+        size_t nrOfWorkers = std::min(static_cast<size_t>(m_nrOfThreads),m_pos.size());
+
+        if( nrOfWorkers == 0 )
+        {
+            return true;
+        }
+
+        if( m_workers.size() != nrOfWorkers-1 )
+        {
+            stopWorkers();
+            startWorkers(nrOfWorkers);
+        }
+
+        m_stateKernel = kernel;
+        m_workerOk.assign(nrOfWorkers,1);
+
+        {
+            std::lock_guard<std::mutex> lock(m_workersMutex);
+            m_nrOfPendingWorkers = m_workers.size();
+            m_runRequest++;
+        }
+        m_runRequested.notify_all();
+
+        processChunk(0);
+
+        {
+            std::unique_lock<std::mutex> lock(m_workersMutex);
+            m_runCompleted.wait(lock,[&]() { return m_nrOfPendingWorkers == 0; });
+        }
+
+        // Release the references captured by the kernel
+        m_stateKernel = nullptr;
+
+        return std::find(m_workerOk.begin(),m_workerOk.end(),0) == m_workerOk.end();
+    }
+
+    // Convert a base acceleration in the used representation to the body fixed one
+    SpatialAcc toBodyFixedBaseAcc(const Vector6 & baseAcc, const size_t state) const
+    {
+        if( m_frameVelRepr == BODY_FIXED_REPRESENTATION )
+        {
+            SpatialAcc bodyFixedAcc;
+            fromEigen(bodyFixedAcc,toEigen(baseAcc));
+            return bodyFixedAcc;
+        }
+        else if( m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION )
+        {
+            return convertInertialAccelerationToBodyFixedAcceleration(baseAcc,m_pos[state].worldBasePos());
+        }
+        else
+        {
+            assert(m_frameVelRepr == MIXED_REPRESENTATION);
+            return convertMixedAccelerationToBodyFixedAcceleration(baseAcc,
+                                                                   m_vel[state].baseVel(),
+                                                                   m_pos[state].worldBasePos().getRotation());
+        }
+    }
+
+    // Run the inverse dynamics for a given state, without external wrenches
+    bool inverseDynamics(const size_t state,
+                         const Vector6 & baseAcc,
+                         const double * jointAcc,
+                               BatchKinDynWorkerBuffers & bufs,
+                               double * generalizedTorques) const
+    {
+        size_t nrOfDOFs = m_robot_model.getNrOfDOFs();
+
+        // Prepare the vector of generalized proper accs
+        const Rotation & world_R_base = m_pos[state].worldBasePos().getRotation();
+        SpatialAcc baseAccBodyFixed = toBodyFixedBaseAcc(baseAcc,state);
+        bufs.m_generalizedProperAccs.baseAcc() = baseAccBodyFixed;
+        toEigen(bufs.m_generalizedProperAccs.baseAcc().getLinearVec3()) =
+            toEigen(baseAccBodyFixed.getLinearVec3()) - toEigen(world_R_base).transpose()*toEigen(m_gravityAcc);
+        for(size_t dof=0; dof < nrOfDOFs; dof++)
+        {
+            bufs.m_generalizedProperAccs.jointAcc()(dof) = jointAcc ? jointAcc[dof] : 0.0;
+        }
+
+        bool ok = ForwardVelAccKinematics(m_compiledModel,
+                                          m_parent_X_links[state],
+                                          m_vel[state],
+                                          bufs.m_generalizedProperAccs,
+                                          bufs.m_linkVel,
+                                          bufs.m_linkProperAccs);
+
+        ok = ok && RNEADynamicPhase(m_compiledModel,
+                                    m_parent_X_links[state],
+                                    bufs.m_linkVel,
+                                    bufs.m_linkProperAccs,
+                                    bufs.m_zeroNetExtWrenches,
+                                    bufs.m_internalWrenches,
+                                    bufs.m_generalizedTorques);
+
+        // Convert output base force
+        Wrench baseWrench = bufs.m_generalizedTorques.baseWrench();
+        if( m_frameVelRepr == MIXED_REPRESENTATION )
+        {
+            baseWrench = world_R_base*bufs.m_generalizedTorques.baseWrench();
+        }
+        else if( m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION )
+        {
+            baseWrench = m_pos[state].worldBasePos()*bufs.m_generalizedTorques.baseWrench();
+        }
+
+        Eigen::Map< Eigen::Matrix<double,Eigen::Dynamic,1> > out(generalizedTorques,6+nrOfDOFs);
+        out.segment<6>(0) = toEigen(baseWrench);
+        out.segment(6,nrOfDOFs) = toEigen(bufs.m_generalizedTorques.jointTorques());
+
+        return ok;
+    }
+};
+
+BatchKinDynComputations::BatchKinDynComputations():
+pimpl(new BatchKinDynComputationsPrivateAttributes)
+{
+}
+
+BatchKinDynComputations::BatchKinDynComputations(const BatchKinDynComputations & other)
+{
+    // copyng the class is disabled
+    assert(false);
+}
+
+BatchKinDynComputations& BatchKinDynComputations::operator=(const BatchKinDynComputations& other)
+{
+    // copyng the class is disabled
+    assert(false);
+
+    return *this;
+}
+
+BatchKinDynComputations::~BatchKinDynComputations()
+{
+    delete this->pimpl;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+////// Private Methods
+//////////////////////////////////////////////////////////////////////////////
+
+void BatchKinDynComputations::invalidateCache()
+{
+    pimpl->m_isFwdKinematicsUpdated = false;
+    pimpl->m_isRawMassMatrixUpdated = false;
+}
+
+bool BatchKinDynComputations::computeFwdKinematics()
+{
+    if( pimpl->m_isFwdKinematicsUpdated )
+    {
+        return true;
+    }
+
+    BatchKinDynComputationsPrivateAttributes * p = pimpl;
+    bool ok = pimpl->runOnAllStates([p](const size_t state, BatchKinDynWorkerBuffers &)
+    {
+        bool ok = ComputeJointTransforms(p->m_compiledModel,
+                                         p->m_pos[state].jointPos(),
+                                         p->m_parent_X_links[state]);
+        return ok && ForwardPosVelKinematics(p->m_compiledModel,
+                                             p->m_parent_X_links[state],
+                                             p->m_pos[state],
+                                             p->m_vel[state],
+                                             p->m_linkPos[state],
+                                             p->m_linkVel[state]);
+    });
+
+    reportErrorIf(!ok,"BatchKinDynComputations::computeFwdKinematics","Error in computing the forward kinematics.");
+
+    pimpl->m_isFwdKinematicsUpdated = ok;
+    return ok;
+}
+
+bool BatchKinDynComputations::computeRawMassMatrices()
+{
+    if( pimpl->m_isRawMassMatrixUpdated )
+    {
+        return true;
+    }
+
+    // The CRBA uses the parent_X_link transforms computed by the forward kinematics
+    if( !this->computeFwdKinematics() )
+    {
+        return false;
+    }
+
+    BatchKinDynComputationsPrivateAttributes * p = pimpl;
+    bool ok = pimpl->runOnAllStates([p](const size_t state, BatchKinDynWorkerBuffers &)
+    {
+        return CompositeRigidBodyAlgorithm(p->m_compiledModel,
+                                           p->m_parent_X_links[state],
+                                           p->m_linkCRBIs[state],
+                                           p->m_rawMassMatrix[state]);
+    });
+
+    reportErrorIf(!ok,"BatchKinDynComputations::computeRawMassMatrices","Error in computing the mass matrices.");
+
+    pimpl->m_isRawMassMatrixUpdated = ok;
+    return ok;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+////// Public Methods
+//////////////////////////////////////////////////////////////////////////////
+
+bool BatchKinDynComputations::loadRobotModel(const Model& model)
+{
+    pimpl->m_isModelValid = false;
+    pimpl->m_robot_model = model;
+    pimpl->m_robot_model.computeFullTreeTraversal(pimpl->m_traversal);
+
+    if( !pimpl->m_compiledModel.compile(pimpl->m_robot_model,pimpl->m_traversal) )
+    {
+        reportError("BatchKinDynComputations","loadRobotModel","Error in compiling the model.");
+        return false;
+    }
+
+    pimpl->m_isModelValid = true;
+    pimpl->resizeWorkerBuffers();
+    pimpl->resizeStates(0);
+    this->invalidateCache();
+    return true;
+}
+
+bool BatchKinDynComputations::isValid() const
+{
+    return pimpl->m_isModelValid;
+}
+
+const Model& BatchKinDynComputations::model() const
+{
+    return pimpl->m_robot_model;
+}
+
+bool BatchKinDynComputations::setFrameVelocityRepresentation(const FrameVelocityRepresentation frameVelRepr)
+{
+    if( frameVelRepr != INERTIAL_FIXED_REPRESENTATION &&
+        frameVelRepr != BODY_FIXED_REPRESENTATION &&
+        frameVelRepr != MIXED_REPRESENTATION )
+    {
+        reportError("BatchKinDynComputations","setFrameVelocityRepresentation","unknown frame velocity representation");
+        return false;
+    }
+
+    // All the caches are stored in BODY_FIXED, so there is no need to invalidate them
+    pimpl->m_frameVelRepr = frameVelRepr;
+    return true;
+}
+
+FrameVelocityRepresentation BatchKinDynComputations::getFrameVelocityRepresentation() const
+{
+    return pimpl->m_frameVelRepr;
+}
+
+bool BatchKinDynComputations::setFloatingBase(const std::string& floatingBaseName)
+{
+    LinkIndex newFloatingBaseLinkIndex = pimpl->m_robot_model.getLinkIndex(floatingBaseName);
+
+    if( newFloatingBaseLinkIndex == LINK_INVALID_INDEX )
+    {
+        reportError("BatchKinDynComputations","setFloatingBase","link not found in the model");
+        return false;
+    }
+
+    bool ok = pimpl->m_robot_model.computeFullTreeTraversal(pimpl->m_traversal,newFloatingBaseLinkIndex);
+    ok = ok && pimpl->m_compiledModel.compile(pimpl->m_robot_model,pimpl->m_traversal);
+
+    // The sparsity pattern of the mass matrix depends on the traversal, so the
+    // elements that are not written by the CRBA need to be zeroed again
+    for(size_t state=0; state < pimpl->m_rawMassMatrix.size(); state++)
+    {
+        pimpl->m_rawMassMatrix[state].zero();
+    }
+
+    this->invalidateCache();
+    return ok;
+}
+
+std::string BatchKinDynComputations::getFloatingBase() const
+{
+    return pimpl->m_robot_model.getLinkName(pimpl->m_traversal.getBaseLink()->getIndex());
+}
+
+void BatchKinDynComputations::setNrOfThreads(const unsigned int nrOfThreads)
+{
+    if( nrOfThreads == 0 )
+    {
+        pimpl->m_nrOfThreads = std::max(std::thread::hardware_concurrency(),1u);
+    }
+    else
+    {
+        pimpl->m_nrOfThreads = nrOfThreads;
+    }
+
+    if( pimpl->m_isModelValid )
+    {
+        pimpl->resizeWorkerBuffers();
+    }
+}
+
+unsigned int BatchKinDynComputations::getNrOfThreads() const
+{
+    return pimpl->m_nrOfThreads;
+}
+
+unsigned int BatchKinDynComputations::getNrOfDegreesOfFreedom() const
+{
+    return static_cast<unsigned int>(pimpl->m_robot_model.getNrOfDOFs());
+}
+
+FrameIndex BatchKinDynComputations::getFrameIndex(const std::string& frameName) const
+{
+    FrameIndex index = pimpl->m_robot_model.getFrameIndex(frameName);
+    reportErrorIf(index < 0, "BatchKinDynComputations::getFrameIndex", "requested frameName not found in model");
+    return index;
+}
+
+bool BatchKinDynComputations::setRobotStates(const std::vector<Transform>& world_T_base,
+                                             const MatrixDynSize& s,
+                                             const std::vector<Twist>& base_velocity,
+                                             const MatrixDynSize& s_dot,
+                                             const Vector3& world_gravity)
+{
+    if( !pimpl->m_isModelValid )
+    {
+        reportError("BatchKinDynComputations","setRobotStates","Model not loaded.");
+        return false;
+    }
+
+    size_t nrOfStates = world_T_base.size();
+    size_t nrOfDOFs = pimpl->m_robot_model.getNrOfDOFs();
+
+    if( base_velocity.size() != nrOfStates ||
+        s.rows() != nrOfStates || s_dot.rows() != nrOfStates )
+    {
+        reportError("BatchKinDynComputations","setRobotStates","Inconsistent number of states in the inputs");
+        return false;
+    }
+
+    if( s.cols() != pimpl->m_robot_model.getNrOfPosCoords() )
+    {
+        reportError("BatchKinDynComputations","setRobotStates","Wrong size in input joint positions");
+        return false;
+    }
+
+    if( s_dot.cols() != nrOfDOFs )
+    {
+        reportError("BatchKinDynComputations","setRobotStates","Wrong size in input joint velocities");
+        return false;
+    }
+
+    this->invalidateCache();
+
+    if( pimpl->m_pos.size() != nrOfStates )
+    {
+        pimpl->resizeStates(nrOfStates);
+    }
+
+    pimpl->m_gravityAcc = world_gravity;
+
+    for(size_t state=0; state < nrOfStates; state++)
+    {
+        FreeFloatingPos & pos = pimpl->m_pos[state];
+        FreeFloatingVel & vel = pimpl->m_vel[state];
+
+        pos.worldBasePos() = world_T_base[state];
+        toEigen(pos.jointPos()) = toEigen(s).row(state).transpose();
+        toEigen(vel.jointVel()) = toEigen(s_dot).row(state).transpose();
+
+        // Account for the different possible representations
+        if( pimpl->m_frameVelRepr == MIXED_REPRESENTATION )
+        {
+            vel.baseVel() = pos.worldBasePos().getRotation().inverse()*base_velocity[state];
+        }
+        else if( pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION )
+        {
+            vel.baseVel() = base_velocity[state];
+        }
+        else
+        {
+            assert(pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION);
+            vel.baseVel() = pos.worldBasePos().inverse()*base_velocity[state];
+        }
+    }
+
+    return true;
+}
+
+size_t BatchKinDynComputations::getNrOfStates() const
+{
+    return pimpl->m_pos.size();
+}
+
+bool BatchKinDynComputations::getWorldTransforms(const FrameIndex frameIndex,
+                                                 std::vector<Transform>& world_H_frame)
+{
+    if( !pimpl->m_robot_model.isValidFrameIndex(frameIndex) )
+    {
+        reportError("BatchKinDynComputations","getWorldTransforms","Frame index out of bounds");
+        return false;
+    }
+
+    if( !this->computeFwdKinematics() )
+    {
+        return false;
+    }
+
+    LinkIndex frameLink = pimpl->m_robot_model.getFrameLink(frameIndex);
+    const Transform & link_H_frame = pimpl->m_robot_model.getFrameTransform(frameIndex);
+
+    world_H_frame.resize(pimpl->m_pos.size());
+
+    BatchKinDynComputationsPrivateAttributes * p = pimpl;
+    return pimpl->runOnAllStates([&,p](const size_t state, BatchKinDynWorkerBuffers &)
+    {
+        world_H_frame[state] = p->m_linkPos[state](frameLink)*link_H_frame;
+        return true;
+    });
+}
+
+bool BatchKinDynComputations::getFrameFreeFloatingJacobians(const FrameIndex frameIndex,
+                                                            MatrixDynSize& stackedJacobians)
+{
+    if( !pimpl->m_robot_model.isValidFrameIndex(frameIndex) )
+    {
+        reportError("BatchKinDynComputations","getFrameFreeFloatingJacobians","Frame index out of bounds");
+        return false;
+    }
+
+    if( !this->computeFwdKinematics() )
+    {
+        return false;
+    }
+
+    size_t nrOfStates = pimpl->m_pos.size();
+    size_t nrOfDOFs = pimpl->m_robot_model.getNrOfDOFs();
+    stackedJacobians.resize(6*nrOfStates,6+nrOfDOFs);
+
+    LinkIndex jacobLink = pimpl->m_robot_model.getFrameLink(frameIndex);
+    const Transform & jacobLink_H_frame = pimpl->m_robot_model.getFrameTransform(frameIndex);
+
+    BatchKinDynComputationsPrivateAttributes * p = pimpl;
+    return pimpl->runOnAllStates([&,p](const size_t state, BatchKinDynWorkerBuffers & bufs)
+    {
+        const LinkPositions & linkPos = p->m_linkPos[state];
+        const Transform & world_H_base = linkPos(p->getBaseLinkIndex());
+
+        // See KinDynComputations::getFrameFreeFloatingJacobian for the details
+        Transform jacobFrame_X_world;
+        Transform baseFrame_X_jacobBaseFrame;
+        if( p->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION )
+        {
+            jacobFrame_X_world = Transform::Identity();
+            baseFrame_X_jacobBaseFrame = world_H_base.inverse();
+        }
+        else if( p->m_frameVelRepr == MIXED_REPRESENTATION )
+        {
+            Transform world_X_frame = linkPos(jacobLink)*jacobLink_H_frame;
+            jacobFrame_X_world = Transform(Rotation::Identity(),-world_X_frame.getPosition());
+            baseFrame_X_jacobBaseFrame = Transform(world_H_base.getRotation().inverse(),Position::Zero());
+        }
+        else
+        {
+            assert(p->m_frameVelRepr == BODY_FIXED_REPRESENTATION);
+            jacobFrame_X_world = (linkPos(jacobLink)*jacobLink_H_frame).inverse();
+            baseFrame_X_jacobBaseFrame = Transform::Identity();
+        }
+
+        bool ok = FreeFloatingJacobianUsingLinkPos(p->m_compiledModel,linkPos,jacobLink,
+                                                   jacobFrame_X_world,baseFrame_X_jacobBaseFrame,
+                                                   bufs.m_jacobian);
+
+        toEigen(stackedJacobians).block(6*state,0,6,6+nrOfDOFs) = toEigen(bufs.m_jacobian);
+
+        return ok;
+    });
+}
+
+bool BatchKinDynComputations::getCenterOfMassPositions(MatrixDynSize& comPositions)
+{
+    if( !this->computeRawMassMatrices() )
+    {
+        return false;
+    }
+
+    comPositions.resize(pimpl->m_pos.size(),3);
+
+    BatchKinDynComputationsPrivateAttributes * p = pimpl;
+    return pimpl->runOnAllStates([&,p](const size_t state, BatchKinDynWorkerBuffers &)
+    {
+        // Extract the {}^B com from the composite rigid body inertia of the base
+        Position base_com = p->m_linkCRBIs[state](p->getBaseLinkIndex()).getCenterOfMass();
+        Position world_com = p->m_pos[state].worldBasePos()*base_com;
+        toEigen(comPositions).row(state) = toEigen(world_com).transpose();
+        return true;
+    });
+}
+
+bool BatchKinDynComputations::getFreeFloatingMassMatrices(MatrixDynSize& stackedMassMatrices)
+{
+    if( !this->computeRawMassMatrices() )
+    {
+        return false;
+    }
+
+    size_t nrOfStates = pimpl->m_pos.size();
+    size_t nrOfDOFs = pimpl->m_robot_model.getNrOfDOFs();
+    stackedMassMatrices.resize((6+nrOfDOFs)*nrOfStates,6+nrOfDOFs);
+
+    BatchKinDynComputationsPrivateAttributes * p = pimpl;
+    return pimpl->runOnAllStates([&,p](const size_t state, BatchKinDynWorkerBuffers & bufs)
+    {
+        toEigen(bufs.m_massMatrix) = toEigen(p->m_rawMassMatrix[state]);
+
+        // Handle the different representations, see KinDynComputations::getFreeFloatingMassMatrix
+        if( p->m_frameVelRepr != BODY_FIXED_REPRESENTATION )
+        {
+            const Transform & world_H_base = p->m_pos[state].worldBasePos();
+            Transform newOutputFrame_X_oldOutputFrame;
+            if( p->m_frameVelRepr == MIXED_REPRESENTATION )
+            {
+                newOutputFrame_X_oldOutputFrame = Transform(world_H_base.getRotation(),Position::Zero());
+            }
+            else
+            {
+                assert(p->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION);
+                newOutputFrame_X_oldOutputFrame = world_H_base;
+            }
+
+            Matrix6x6 baseFrame_X_newJacobBaseFrame = newOutputFrame_X_oldOutputFrame.inverse().asAdjointTransform();
+            Matrix6x6 newOutputFrame_X_oldOutputFrame_ = newOutputFrame_X_oldOutputFrame.asAdjointTransformWrench();
+
+            int rows = bufs.m_massMatrix.rows();
+            int cols = bufs.m_massMatrix.cols();
+            toEigen(bufs.m_massMatrix).block(0,0,rows,6) = toEigen(bufs.m_massMatrix).block(0,0,rows,6)*toEigen(baseFrame_X_newJacobBaseFrame);
+            toEigen(bufs.m_massMatrix).block(0,0,6,cols) = toEigen(newOutputFrame_X_oldOutputFrame_)*toEigen(bufs.m_massMatrix).block(0,0,6,cols);
+        }
+
+        toEigen(stackedMassMatrices).block((6+nrOfDOFs)*state,0,6+nrOfDOFs,6+nrOfDOFs) = toEigen(bufs.m_massMatrix);
+        return true;
+    });
+}
+
+bool BatchKinDynComputations::inverseDynamics(const MatrixDynSize& baseAcc,
+                                              const MatrixDynSize& s_ddot,
+                                                    MatrixDynSize& generalizedTorques)
+{
+    size_t nrOfStates = pimpl->m_pos.size();
+    size_t nrOfDOFs = pimpl->m_robot_model.getNrOfDOFs();
+
+    if( baseAcc.rows() != nrOfStates || baseAcc.cols() != 6 )
+    {
+        reportError("BatchKinDynComputations","inverseDynamics","Wrong size in input base accelerations");
+        return false;
+    }
+
+    if( s_ddot.rows() != nrOfStates || s_ddot.cols() != nrOfDOFs )
+    {
+        reportError("BatchKinDynComputations","inverseDynamics","Wrong size in input joint accelerations");
+        return false;
+    }
+
+    // The dynamics uses the parent_X_link transforms computed by the forward kinematics
+    if( !this->computeFwdKinematics() )
+    {
+        return false;
+    }
+
+    generalizedTorques.resize(nrOfStates,6+nrOfDOFs);
+
+    BatchKinDynComputationsPrivateAttributes * p = pimpl;
+    return pimpl->runOnAllStates([&,p](const size_t state, BatchKinDynWorkerBuffers & bufs)
+    {
+        Vector6 stateBaseAcc;
+        toEigen(stateBaseAcc) = toEigen(baseAcc).row(state).transpose();
+        return p->inverseDynamics(state,stateBaseAcc,s_ddot.data()+nrOfDOFs*state,
+                                  bufs,generalizedTorques.data()+(6+nrOfDOFs)*state);
+    });
+}
+
+bool BatchKinDynComputations::generalizedBiasForces(MatrixDynSize& generalizedBiasForces)
+{
+    size_t nrOfStates = pimpl->m_pos.size();
+    size_t nrOfDOFs = pimpl->m_robot_model.getNrOfDOFs();
+
+    if( !this->computeFwdKinematics() )
+    {
+        return false;
+    }
+
+    generalizedBiasForces.resize(nrOfStates,6+nrOfDOFs);
+
+    // The base acceleration is "zero" in the chosen representation,
+    // the conversion to body-fixed is handled in inverseDynamics
+    Vector6 zeroBaseAcc;
+    zeroBaseAcc.zero();
+
+    BatchKinDynComputationsPrivateAttributes * p = pimpl;
+    return pimpl->runOnAllStates([&,p](const size_t state, BatchKinDynWorkerBuffers & bufs)
+    {
+        return p->inverseDynamics(state,zeroBaseAcc,0,
+                                  bufs,generalizedBiasForces.data()+(6+nrOfDOFs)*state);
+    });
+}
+
+}
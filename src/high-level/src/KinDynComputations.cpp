@@ -30,13 +30,18 @@
 #include <iDynTree/Model/LinkTraversalsCache.h>
 #include <iDynTree/Model/ForwardKinematics.h>
 #include <iDynTree/Model/Dynamics.h>
+#include <iDynTree/Model/DynamicsLinearization.h>
 #include <iDynTree/Model/Jacobians.h>
 
 #include <iDynTree/ModelIO/ModelLoader.h>
 
+#include "KinDynComputationsHelpers.h"
+
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 namespace iDynTree
 {
@@ -116,14 +121,76 @@ public:
     // storage of the CRBs, used to extract
     LinkCompositeRigidBodyInertias m_linkCRBIs;
 
+    // Change tracking data structures, used to update only the part of the cached
+    // quantities that is affected by a change in the state.
+    // The vectors are indexed by JointIndex, and an element is true if the position (or velocity)
+    // of the joint changed since the last update of the forward kinematics (or of the CRBA)
+    std::vector<bool> m_fwdKinJointPosChanged;
+    std::vector<bool> m_fwdKinJointVelChanged;
+    std::vector<bool> m_crbaJointPosChanged;
+    bool m_fwdKinBasePosChanged;
+    bool m_fwdKinBaseVelChanged;
+
+    // true if some of the above forward kinematics changes were not yet propagated to m_isLinkPosUpdated/m_isLinkVelUpdated
+    bool m_areFwdKinChangesPending;
+
+    // true if the whole raw mass matrix needs to be computed (for example after a model change)
+    bool m_isCRBAFullUpdateNeeded;
+
+    // Forward kinematics is computed on demand: these vectors are indexed by LinkIndex, and an element
+    // is true if the element of m_linkPos (or m_linkVel) is consistent with the current state.
+    // If a link is updated, its parent (in m_traversal) is updated too.
+    std::vector<bool> m_isLinkPosUpdated;
+    std::vector<bool> m_isLinkVelUpdated;
+
+    // Buffers used to propagate the changes along the traversal, indexed by LinkIndex
+    std::vector<bool> m_isLinkPathChanged;
+    std::vector<bool> m_isLinkSubtreeChanged;
+
+    // Buffer of links, used to store the links in a path of the traversal
+    std::vector<LinkIndex> m_linkPathBuffer;
+
+    // Mark as not updated the elements of m_linkPos and m_linkVel affected by the changes in the state
+    void propagateFwdKinChanges();
+
+    // Make sure that the position (or the body-fixed velocity) of a link is updated,
+    // computing only the links in the path to the base that are not updated
+    void computeLinkPos(const LinkIndex linkIndex);
+    void computeLinkVel(const LinkIndex linkIndex);
+
+    // Compute the refLink_H_link transform, either from the forward kinematics results if available,
+    // or using only the joints in the path between the two links
+    Transform getRelativeLinkTransform(const LinkIndex refLinkIndex, const LinkIndex linkIndex);
+
+    // Save the new joint positions (or velocities) in m_pos (or m_vel), marking the joints that changed.
+    // Return true if at least one joint changed
+    bool updateJointPos(Span<const double> s);
+    bool updateJointVel(Span<const double> s_dot);
+
+    // Save the state of the robot, see KinDynComputations::setRobotState
+    bool setRobotState(const Transform & world_T_base,
+                       Span<const double> s,
+                       const Twist & base_velocity,
+                       Span<const double> s_dot,
+                       const Vector3 & world_gravity);
+
+    // Compute the column (and the corresponding row) of the raw mass matrix relative to
+    // the joint connecting the visited link to its parent, given the CRBI of the visited link
+    void computeRawMassMatrixColumn(const LinkIndex visitedLinkIndex);
+
     // Helper function to get the lockedInertia of the robot from the m_linkCRBIs
     const SpatialInertia & getRobotLockedInertia();
 
     // Process a jacobian that expects a body fixed base velocity depending on the selected FrameVelocityRepresentation
-    void processOnRightSideMatrixExpectingBodyFixedModelVelocity(MatrixDynSize &mat);
-    void processOnLeftSideBodyFixedBaseMomentumJacobian(MatrixDynSize & jac);
-    void processOnLeftSideBodyFixedAvgVelocityJacobian(MatrixDynSize &jac);
-    void processOnLeftSideBodyFixedCentroidalAvgVelocityJacobian(MatrixDynSize &jac, const FrameVelocityRepresentation & leftSideRepresentation);
+    void processOnRightSideMatrixExpectingBodyFixedModelVelocity(MatrixView<double> mat);
+
+    // Transforms used to express a free floating jacobian in the used representation
+    // (see FreeFloatingJacobianUsingLinkPos)
+    Transform getJacobFrame_X_world(const FrameIndex frameIndex);
+    Transform getBaseFrame_X_jacobBaseFrame();
+    void processOnLeftSideBodyFixedBaseMomentumJacobian(MatrixView<double> jac);
+    void processOnLeftSideBodyFixedAvgVelocityJacobian(MatrixView<double> jac);
+    void processOnLeftSideBodyFixedCentroidalAvgVelocityJacobian(MatrixView<double> jac, const FrameVelocityRepresentation & leftSideRepresentation);
 
     // Transform a wrench from and to body fixed and the used representation
     Wrench fromBodyFixedToUsedRepresentation(const Wrench & wrenchInBodyFixed, const Transform & inertial_X_link);
@@ -165,6 +232,9 @@ public:
     /** Generalized **proper** (real-gravity) acceleration, base part in body-fixed representation */
     FreeFloatingAcc m_invDynGeneralizedProperAccs;
 
+    // Output of the inverse dynamics, used by the Span version of inverseDynamics
+    FreeFloatingGeneralizedTorques m_invDynGeneralizedTorques;
+
     /** **Proper** (real-gravity) acceleration of each link, in body-fixed representation */
     LinkProperAccArray m_invDynLinkProperAccs;
 
@@ -174,11 +244,36 @@ public:
     /** Internal wrenches, in body-fixed representation */
     LinkInternalWrenches m_invDynInternalWrenches;
 
-    /** Buffer of robot velocity, always set to zero for gravity computations */
-    FreeFloatingVel m_invDynZeroVel;
+    /** Internal buffers of ComputeGeneralizedGravityForces */
+    GeneralizedGravityForcesInternalBuffers m_gravityForcesBuffers;
+
+    // Forward dynamics buffers
+
+    /** Joint torques, used as input of the ArticulatedBodyAlgorithm */
+    JointDOFsDoubleArray m_fwdDynJointTorques;
+
+    /** External wrenches, in body-fixed representation */
+    LinkNetExternalWrenches m_fwdDynNetExtWrenches;
+
+    /** Internal buffers of the ArticulatedBodyAlgorithm */
+    ArticulatedBodyAlgorithmInternalBuffers m_fwdDynBuffers;
+
+    /** Generalized **proper** (real-gravity) acceleration, base part in body-fixed representation */
+    FreeFloatingAcc m_fwdDynGeneralizedProperAccs;
+
+    // Inverse dynamics derivatives buffers
 
-    /** Buffer of link velocities, always set to zero for gravity computations */
-    LinkVelArray m_invDynZeroLinkVel;
+    /** Generalized acceleration (without gravity), base part in body-fixed representation */
+    FreeFloatingAcc m_invDynDerivGeneralizedAccs;
+
+    /** Internal buffers of InverseDynamicsDerivatives */
+    InverseDynamicsDerivativesInternalBuffers m_invDynDerivBuffers;
+
+    // Stacked and compressed jacobians buffers
+    std::vector<FrameIndex> m_stackedJacobiansFrames;
+    std::vector<LinkIndex> m_stackedJacobiansLinks;
+    std::vector<Transform> m_stackedJacobiansFrames_X_world;
+    FreeFloatingJacobiansInternalBuffers m_stackedJacobiansBuffers;
 
     KinDynComputationsPrivateAttributes()
     {
@@ -187,6 +282,10 @@ public:
         m_isFwdKinematicsUpdated = false;
         m_isRawMassMatrixUpdated = false;
         m_areBiasAccelerationsUpdated = false;
+        m_fwdKinBasePosChanged = true;
+        m_fwdKinBaseVelChanged = true;
+        m_areFwdKinChangesPending = true;
+        m_isCRBAFullUpdateNeeded = true;
     }
 };
 
@@ -317,6 +416,15 @@ void KinDynComputations::invalidateCache()
     this->pimpl->m_isFwdKinematicsUpdated = false;
     this->pimpl->m_isRawMassMatrixUpdated = false;
     this->pimpl->m_areBiasAccelerationsUpdated = false;
+
+    // Mark all the state as changed, so that the next update is performed on the whole tree
+    std::fill(pimpl->m_fwdKinJointPosChanged.begin(),pimpl->m_fwdKinJointPosChanged.end(),true);
+    std::fill(pimpl->m_fwdKinJointVelChanged.begin(),pimpl->m_fwdKinJointVelChanged.end(),true);
+    std::fill(pimpl->m_crbaJointPosChanged.begin(),pimpl->m_crbaJointPosChanged.end(),true);
+    this->pimpl->m_fwdKinBasePosChanged = true;
+    this->pimpl->m_fwdKinBaseVelChanged = true;
+    this->pimpl->m_areFwdKinChangesPending = true;
+    this->pimpl->m_isCRBAFullUpdateNeeded = true;
 }
 
 void KinDynComputations::resizeInternalDataStructures()
@@ -339,19 +447,27 @@ void KinDynComputations::resizeInternalDataStructures()
     this->pimpl->m_linkAccs.resize(this->pimpl->m_robot_model);
     this->pimpl->m_invDynBaseAcc.zero();
     this->pimpl->m_invDynGeneralizedProperAccs.resize(this->pimpl->m_robot_model);
+    this->pimpl->m_invDynGeneralizedTorques.resize(this->pimpl->m_robot_model);
     this->pimpl->m_invDynNetExtWrenches.resize(this->pimpl->m_robot_model);
     this->pimpl->m_invDynInternalWrenches.resize(this->pimpl->m_robot_model);
     this->pimpl->m_invDynLinkProperAccs.resize(this->pimpl->m_robot_model);
-    this->pimpl->m_invDynZeroVel.resize(this->pimpl->m_robot_model);
-    this->pimpl->m_invDynZeroVel.baseVel().zero();
-    this->pimpl->m_invDynZeroVel.jointVel().zero();
-    this->pimpl->m_invDynZeroLinkVel.resize(this->pimpl->m_robot_model);
+    this->pimpl->m_gravityForcesBuffers.resize(this->pimpl->m_robot_model);
+    this->pimpl->m_fwdDynJointTorques.resize(this->pimpl->m_robot_model);
+    this->pimpl->m_fwdDynNetExtWrenches.resize(this->pimpl->m_robot_model);
+    this->pimpl->m_fwdDynBuffers.resize(this->pimpl->m_robot_model);
+    this->pimpl->m_fwdDynGeneralizedProperAccs.resize(this->pimpl->m_robot_model);
+    this->pimpl->m_invDynDerivGeneralizedAccs.resize(this->pimpl->m_robot_model);
+    this->pimpl->m_invDynDerivBuffers.resize(this->pimpl->m_robot_model);
+    this->pimpl->m_stackedJacobiansBuffers.resize(this->pimpl->m_robot_model);
     this->pimpl->m_traversalCache.resize(this->pimpl->m_robot_model);
-
-    for(LinkIndex lnkIdx = 0; lnkIdx < static_cast<LinkIndex>(pimpl->m_robot_model.getNrOfLinks()); lnkIdx++)
-    {
-        pimpl->m_invDynZeroLinkVel(lnkIdx).zero();
-    }
+    this->pimpl->m_fwdKinJointPosChanged.resize(this->pimpl->m_robot_model.getNrOfJoints());
+    this->pimpl->m_fwdKinJointVelChanged.resize(this->pimpl->m_robot_model.getNrOfJoints());
+    this->pimpl->m_crbaJointPosChanged.resize(this->pimpl->m_robot_model.getNrOfJoints());
+    this->pimpl->m_isLinkPosUpdated.resize(this->pimpl->m_robot_model.getNrOfLinks());
+    this->pimpl->m_isLinkVelUpdated.resize(this->pimpl->m_robot_model.getNrOfLinks());
+    this->pimpl->m_linkPathBuffer.reserve(this->pimpl->m_robot_model.getNrOfLinks());
+    this->pimpl->m_isLinkPathChanged.resize(this->pimpl->m_robot_model.getNrOfLinks());
+    this->pimpl->m_isLinkSubtreeChanged.resize(this->pimpl->m_robot_model.getNrOfLinks());
 }
 
 int KinDynComputations::getFrameIndex(const std::string& frameName) const
@@ -373,15 +489,19 @@ void KinDynComputations::computeFwdKinematics()
         return;
     }
 
-    // Compute position and velocity kinematics
-    bool ok = ForwardPosVelKinematics(this->pimpl->m_robot_model,
-                                      this->pimpl->m_traversal,
-                                      this->pimpl->m_pos,
-                                      this->pimpl->m_vel,
-                                      this->pimpl->m_linkPos,
-                                      this->pimpl->m_linkVel);
+    // Compute position and velocity kinematics, only for the links
+    // affected by the changes in the state since the last update
+    pimpl->propagateFwdKinChanges();
+
+    const Traversal & traversal = pimpl->m_traversal;
+    for(TraversalIndex traversalEl=0; traversalEl < static_cast<TraversalIndex>(traversal.getNrOfVisitedLinks()); traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+        pimpl->computeLinkPos(visitedLinkIndex);
+        pimpl->computeLinkVel(visitedLinkIndex);
+    }
 
-    this->pimpl->m_isFwdKinematicsUpdated = ok;
+    this->pimpl->m_isFwdKinematicsUpdated = true;
 }
 
 void KinDynComputations::computeRawMassMatrixAndTotalMomentum()
@@ -391,14 +511,87 @@ void KinDynComputations::computeRawMassMatrixAndTotalMomentum()
         return;
     }
 
-    // Compute raw mass matrix
-    bool ok = CompositeRigidBodyAlgorithm(pimpl->m_robot_model,
-                                          pimpl->m_traversal,
-                                          pimpl->m_pos.jointPos(),
-                                          pimpl->m_linkCRBIs,
-                                          pimpl->m_rawMassMatrix);
+    // Compute raw mass matrix, as in CompositeRigidBodyAlgorithm but only for the
+    // part affected by the joints whose position changed since the last update.
+    // The raw mass matrix does not depend on the base position, and:
+    //  * the CRBI of a link needs to be updated if a joint in the subtree of the link changed,
+    //  * the column of the mass matrix relative to the joint connecting a link to its parent
+    //    needs to be updated if the CRBI of the link needs to be updated or if a joint
+    //    in the path between the link and the base changed.
+    const Traversal & traversal = pimpl->m_traversal;
+    std::vector<bool> & isPathChanged = pimpl->m_isLinkPathChanged;
+    std::vector<bool> & isSubtreeChanged = pimpl->m_isLinkSubtreeChanged;
+
+    for(TraversalIndex traversalEl=0; traversalEl < static_cast<TraversalIndex>(traversal.getNrOfVisitedLinks()); traversalEl++)
+    {
+        LinkConstPtr visitedLink = traversal.getLink(traversalEl);
+        LinkConstPtr parentLink  = traversal.getParentLink(traversalEl);
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+        isSubtreeChanged[visitedLink->getIndex()] = pimpl->m_isCRBAFullUpdateNeeded;
+        isPathChanged[visitedLink->getIndex()] = parentLink &&
+            (isPathChanged[parentLink->getIndex()] || pimpl->m_crbaJointPosChanged[toParentJoint->getIndex()]);
+    }
 
-    reportErrorIf(!ok,"KinDynComputations::computeRawMassMatrix","Error in computing mass matrix.");
+    for(TraversalIndex traversalEl=traversal.getNrOfVisitedLinks()-1; traversalEl > 0; traversalEl--)
+    {
+        LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+        if( isSubtreeChanged[visitedLinkIndex] || pimpl->m_crbaJointPosChanged[traversal.getParentJoint(traversalEl)->getIndex()] )
+        {
+            isSubtreeChanged[traversal.getParentLink(traversalEl)->getIndex()] = true;
+        }
+    }
+
+    // If the traversal changed, the entries relative to joints that are not anymore
+    // in an ancestor/descendant relation need to be zeroed
+    if( pimpl->m_isCRBAFullUpdateNeeded )
+    {
+        pimpl->m_rawMassMatrix.zero();
+    }
+
+    // Reset the CRBIs to update to the inertia of the link
+    for(TraversalIndex traversalEl=0; traversalEl < static_cast<TraversalIndex>(traversal.getNrOfVisitedLinks()); traversalEl++)
+    {
+        LinkConstPtr visitedLink = traversal.getLink(traversalEl);
+        if( isSubtreeChanged[visitedLink->getIndex()] )
+        {
+            pimpl->m_linkCRBIs(visitedLink->getIndex()) = visitedLink->getInertia();
+        }
+    }
+
+    // Backward pass: accumulate the CRBIs and update the columns of the mass matrix
+    for(TraversalIndex traversalEl=traversal.getNrOfVisitedLinks()-1; traversalEl > 0; traversalEl--)
+    {
+        LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+        LinkIndex parentLinkIndex = traversal.getParentLink(traversalEl)->getIndex();
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+        if( isSubtreeChanged[parentLinkIndex] )
+        {
+            pimpl->m_linkCRBIs(parentLinkIndex) = pimpl->m_linkCRBIs(parentLinkIndex) +
+                (toParentJoint->getTransform(pimpl->m_pos.jointPos(),parentLinkIndex,visitedLinkIndex))*pimpl->m_linkCRBIs(visitedLinkIndex);
+        }
+
+        // For now we just implement the CRBA for 0 or 1 dofs joints.
+        assert( toParentJoint->getNrOfDOFs() <= 1 );
+
+        if( toParentJoint->getNrOfDOFs() == 1 &&
+            (isSubtreeChanged[visitedLinkIndex] || isPathChanged[visitedLinkIndex]) )
+        {
+            pimpl->computeRawMassMatrixColumn(visitedLinkIndex);
+        }
+    }
+
+    // The top left 6x6 matrix is just the composite rigid body inertia of all the body
+    LinkIndex baseLinkIndex = traversal.getLink(0)->getIndex();
+    if( isSubtreeChanged[baseLinkIndex] )
+    {
+        Matrix6x6 lockedInertia = pimpl->m_linkCRBIs(baseLinkIndex).asMatrix();
+        toEigen(pimpl->m_rawMassMatrix).block<6,6>(0,0) = toEigen(lockedInertia);
+    }
+
+    std::fill(pimpl->m_crbaJointPosChanged.begin(),pimpl->m_crbaJointPosChanged.end(),false);
+    this->pimpl->m_isCRBAFullUpdateNeeded = false;
 
 
     // m_linkPos and m_linkVel are used in the computation of the total momentum
@@ -411,7 +604,7 @@ void KinDynComputations::computeRawMassMatrixAndTotalMomentum()
                                     pimpl->m_linkVel,
                                     pimpl->m_totalMomentum);
 
-    this->pimpl->m_isRawMassMatrixUpdated = ok;
+    this->pimpl->m_isRawMassMatrixUpdated = true;
 }
 
 void KinDynComputations::computeBiasAccFwdKinematics()
@@ -454,6 +647,252 @@ void KinDynComputations::computeBiasAccFwdKinematics()
     this->pimpl->m_areBiasAccelerationsUpdated = ok;
 }
 
+void KinDynComputations::KinDynComputationsPrivateAttributes::propagateFwdKinChanges()
+{
+    if( !m_areFwdKinChangesPending )
+    {
+        return;
+    }
+
+    // The position of a link is not updated anymore if the base position or the position of any joint
+    // in the path between the link and the base changed, while the (body-fixed) velocity of a link is not
+    // updated anymore if the base velocity or the position/velocity of any joint in the path changed.
+    for(TraversalIndex traversalEl=0; traversalEl < static_cast<TraversalIndex>(m_traversal.getNrOfVisitedLinks()); traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = m_traversal.getLink(traversalEl)->getIndex();
+        LinkConstPtr parentLink = m_traversal.getParentLink(traversalEl);
+
+        if( parentLink == 0 )
+        {
+            m_isLinkPosUpdated[visitedLinkIndex] = m_isLinkPosUpdated[visitedLinkIndex] && !m_fwdKinBasePosChanged;
+            m_isLinkVelUpdated[visitedLinkIndex] = m_isLinkVelUpdated[visitedLinkIndex] && !m_fwdKinBaseVelChanged;
+        }
+        else
+        {
+            LinkIndex parentLinkIndex = parentLink->getIndex();
+            JointIndex toParentJointIndex = m_traversal.getParentJoint(traversalEl)->getIndex();
+            bool isJointPosChanged = m_fwdKinJointPosChanged[toParentJointIndex];
+
+            m_isLinkPosUpdated[visitedLinkIndex] = m_isLinkPosUpdated[visitedLinkIndex] &&
+                                                   m_isLinkPosUpdated[parentLinkIndex] && !isJointPosChanged;
+            m_isLinkVelUpdated[visitedLinkIndex] = m_isLinkVelUpdated[visitedLinkIndex] &&
+                                                   m_isLinkVelUpdated[parentLinkIndex] && !isJointPosChanged &&
+                                                   !m_fwdKinJointVelChanged[toParentJointIndex];
+        }
+    }
+
+    std::fill(m_fwdKinJointPosChanged.begin(),m_fwdKinJointPosChanged.end(),false);
+    std::fill(m_fwdKinJointVelChanged.begin(),m_fwdKinJointVelChanged.end(),false);
+    m_fwdKinBasePosChanged = false;
+    m_fwdKinBaseVelChanged = false;
+    m_areFwdKinChangesPending = false;
+}
+
+void KinDynComputations::KinDynComputationsPrivateAttributes::computeLinkPos(const LinkIndex linkIndex)
+{
+    propagateFwdKinChanges();
+
+    // Collect the links that are not updated, going from the link towards the base
+    m_linkPathBuffer.clear();
+    LinkIndex visitedLinkIndex = linkIndex;
+    while( !m_isLinkPosUpdated[visitedLinkIndex] )
+    {
+        m_linkPathBuffer.push_back(visitedLinkIndex);
+        LinkConstPtr parentLink = m_traversal.getParentLinkFromLinkIndex(visitedLinkIndex);
+        if( parentLink == 0 )
+        {
+            break;
+        }
+        visitedLinkIndex = parentLink->getIndex();
+    }
+
+    // Compute the positions going from the base towards the link,
+    // as in ForwardPositionKinematics
+    for(int i=static_cast<int>(m_linkPathBuffer.size())-1; i >= 0; i--)
+    {
+        visitedLinkIndex = m_linkPathBuffer[i];
+        LinkConstPtr parentLink = m_traversal.getParentLinkFromLinkIndex(visitedLinkIndex);
+
+        if( parentLink == 0 )
+        {
+            m_linkPos(visitedLinkIndex) = m_pos.worldBasePos();
+        }
+        else
+        {
+            IJointConstPtr toParentJoint = m_traversal.getParentJointFromLinkIndex(visitedLinkIndex);
+            m_linkPos(visitedLinkIndex) =
+                m_linkPos(parentLink->getIndex())*toParentJoint->getTransform(m_pos.jointPos(),parentLink->getIndex(),visitedLinkIndex);
+        }
+
+        m_isLinkPosUpdated[visitedLinkIndex] = true;
+    }
+}
+
+void KinDynComputations::KinDynComputationsPrivateAttributes::computeLinkVel(const LinkIndex linkIndex)
+{
+    propagateFwdKinChanges();
+
+    // Collect the links that are not updated, going from the link towards the base
+    m_linkPathBuffer.clear();
+    LinkIndex visitedLinkIndex = linkIndex;
+    while( !m_isLinkVelUpdated[visitedLinkIndex] )
+    {
+        m_linkPathBuffer.push_back(visitedLinkIndex);
+        LinkConstPtr parentLink = m_traversal.getParentLinkFromLinkIndex(visitedLinkIndex);
+        if( parentLink == 0 )
+        {
+            break;
+        }
+        visitedLinkIndex = parentLink->getIndex();
+    }
+
+    // Compute the velocities going from the base towards the link,
+    // as in ForwardVelAccKinematics
+    for(int i=static_cast<int>(m_linkPathBuffer.size())-1; i >= 0; i--)
+    {
+        visitedLinkIndex = m_linkPathBuffer[i];
+        LinkConstPtr parentLink = m_traversal.getParentLinkFromLinkIndex(visitedLinkIndex);
+
+        if( parentLink == 0 )
+        {
+            m_linkVel(visitedLinkIndex) = m_vel.baseVel();
+        }
+        else
+        {
+            IJointConstPtr toParentJoint = m_traversal.getParentJointFromLinkIndex(visitedLinkIndex);
+            toParentJoint->computeChildVel(m_pos.jointPos(),m_vel.jointVel(),m_linkVel,
+                                           visitedLinkIndex,parentLink->getIndex());
+        }
+
+        m_isLinkVelUpdated[visitedLinkIndex] = true;
+    }
+}
+
+Transform KinDynComputations::KinDynComputationsPrivateAttributes::getRelativeLinkTransform(const LinkIndex refLinkIndex,
+                                                                                          const LinkIndex linkIndex)
+{
+    propagateFwdKinChanges();
+
+    if( m_isLinkPosUpdated[refLinkIndex] && m_isLinkPosUpdated[linkIndex] )
+    {
+        return m_linkPos(refLinkIndex).inverse()*m_linkPos(linkIndex);
+    }
+
+    // Go from the link towards refLink in the traversal that has refLink as base
+    Traversal & relativeTraversal = m_traversalCache.getTraversalWithLinkAsBase(m_robot_model,refLinkIndex);
+
+    Transform visited_H_link = Transform::Identity();
+    LinkIndex visitedLinkIndex = linkIndex;
+    while( visitedLinkIndex != refLinkIndex )
+    {
+        LinkIndex parentLinkIndex = relativeTraversal.getParentLinkFromLinkIndex(visitedLinkIndex)->getIndex();
+        IJointConstPtr toParentJoint = relativeTraversal.getParentJointFromLinkIndex(visitedLinkIndex);
+        visited_H_link = toParentJoint->getTransform(m_pos.jointPos(),parentLinkIndex,visitedLinkIndex)*visited_H_link;
+        visitedLinkIndex = parentLinkIndex;
+    }
+
+    return visited_H_link;
+}
+
+bool KinDynComputations::KinDynComputationsPrivateAttributes::updateJointPos(Span<const double> s)
+{
+    bool isChanged = false;
+
+    for(JointIndex jntIdx=0; jntIdx < static_cast<JointIndex>(m_robot_model.getNrOfJoints()); jntIdx++)
+    {
+        IJointConstPtr joint = m_robot_model.getJoint(jntIdx);
+        size_t offset = joint->getPosCoordsOffset();
+        for(size_t i=0; i < joint->getNrOfPosCoords(); i++)
+        {
+            if( m_pos.jointPos()(offset+i) != s[offset+i] )
+            {
+                m_pos.jointPos()(offset+i) = s[offset+i];
+                m_fwdKinJointPosChanged[jntIdx] = true;
+                m_crbaJointPosChanged[jntIdx] = true;
+                m_areFwdKinChangesPending = true;
+                isChanged = true;
+            }
+        }
+    }
+
+    return isChanged;
+}
+
+bool KinDynComputations::KinDynComputationsPrivateAttributes::updateJointVel(Span<const double> s_dot)
+{
+    bool isChanged = false;
+
+    for(JointIndex jntIdx=0; jntIdx < static_cast<JointIndex>(m_robot_model.getNrOfJoints()); jntIdx++)
+    {
+        IJointConstPtr joint = m_robot_model.getJoint(jntIdx);
+        size_t offset = joint->getDOFsOffset();
+        for(size_t i=0; i < joint->getNrOfDOFs(); i++)
+        {
+            if( m_vel.jointVel()(offset+i) != s_dot[offset+i] )
+            {
+                m_vel.jointVel()(offset+i) = s_dot[offset+i];
+                m_fwdKinJointVelChanged[jntIdx] = true;
+                m_areFwdKinChangesPending = true;
+                isChanged = true;
+            }
+        }
+    }
+
+    return isChanged;
+}
+
+void KinDynComputations::KinDynComputationsPrivateAttributes::computeRawMassMatrixColumn(const LinkIndex visitedLinkIndex)
+{
+    // See CompositeRigidBodyAlgorithm (Featherstone 2008, Table 6.2)
+    IJointConstPtr toParentJoint = m_traversal.getParentJointFromLinkIndex(visitedLinkIndex);
+    LinkIndex parentLinkIndex = m_traversal.getParentLinkFromLinkIndex(visitedLinkIndex)->getIndex();
+
+    SpatialMotionVector S_visitedDof = toParentJoint->getMotionSubspaceVector(0,visitedLinkIndex,parentLinkIndex);
+    SpatialForceVector  F = m_linkCRBIs(visitedLinkIndex)*S_visitedDof;
+
+    // H_ii = S_i^\top F
+    size_t dofIndex = toParentJoint->getDOFsOffset();
+    m_rawMassMatrix(6+dofIndex,6+dofIndex) = S_visitedDof.dot(F);
+
+    // Off-diagonal terms relative to the ancestors of the visited link
+    LinkIndex ancestorIndex = visitedLinkIndex;
+    LinkConstPtr ancestorParent = m_traversal.getParentLinkFromLinkIndex(ancestorIndex);
+    while( ancestorParent )
+    {
+        // F = X_{\lambda(j)}^j F , j = \lambda(j)
+        IJointConstPtr ancestorToParentJoint = m_traversal.getParentJointFromLinkIndex(ancestorIndex);
+        F = ancestorToParentJoint->getTransform(m_pos.jointPos(),ancestorParent->getIndex(),ancestorIndex)*F;
+        ancestorIndex = ancestorParent->getIndex();
+        ancestorParent = m_traversal.getParentLinkFromLinkIndex(ancestorIndex);
+
+        if( ancestorParent )
+        {
+            ancestorToParentJoint = m_traversal.getParentJointFromLinkIndex(ancestorIndex);
+
+            // For now we just implement the CRBA for 0 or 1 dofs joints.
+            assert( ancestorToParentJoint->getNrOfDOFs() <= 1 );
+
+            if( ancestorToParentJoint->getNrOfDOFs() == 1 )
+            {
+                SpatialMotionVector S_ancestorDof =
+                    ancestorToParentJoint->getMotionSubspaceVector(0,ancestorIndex,ancestorParent->getIndex());
+                size_t ancestorDofIndex = ancestorToParentJoint->getDOFsOffset();
+
+                // H_ij = F^\top S_j
+                // H_ji = H_ij^\top
+                m_rawMassMatrix(6+dofIndex,6+ancestorDofIndex) = S_ancestorDof.dot(F);
+                m_rawMassMatrix(6+ancestorDofIndex,6+dofIndex) = m_rawMassMatrix(6+dofIndex,6+ancestorDofIndex);
+            }
+        }
+    }
+
+    // F is now expressed in the base link frame: fill the 6 \times nDof right top submatrix
+    // of the mass matrix (i.e. the jacobian of the momentum) and its transpose
+    Eigen::Matrix<double,6,1> FEigen = toEigen(F);
+    toEigen(m_rawMassMatrix).block<6,1>(0,6+dofIndex) = FEigen;
+    toEigen(m_rawMassMatrix).block<1,6>(6+dofIndex,0) = FEigen.transpose();
+}
+
 bool KinDynComputations::loadRobotModelFromFile(const std::string& filename,
                                                   const std::string& filetype)
 {
@@ -528,7 +967,12 @@ std::string KinDynComputations::getFloatingBase() const
 bool KinDynComputations::setFloatingBase(const std::string& floatingBaseName)
 {
     LinkIndex newFloatingBaseLinkIndex = this->pimpl->m_robot_model.getLinkIndex(floatingBaseName);
-    return this->pimpl->m_robot_model.computeFullTreeTraversal(this->pimpl->m_traversal,newFloatingBaseLinkIndex);
+    bool ok = this->pimpl->m_robot_model.computeFullTreeTraversal(this->pimpl->m_traversal,newFloatingBaseLinkIndex);
+
+    // All the cached quantities depend on the traversal
+    this->invalidateCache();
+
+    return ok;
 }
 
 unsigned int KinDynComputations::getNrOfLinks() const
@@ -717,61 +1161,138 @@ bool KinDynComputations::setRobotState(const VectorDynSize& s,
                          world_gravity);
 }
 
-bool KinDynComputations::setRobotState(const Transform& world_T_base,
-                                       const VectorDynSize& s,
-                                       const Twist& base_velocity,
-                                       const VectorDynSize& s_dot,
-                                       const Vector3& world_gravity)
+bool KinDynComputations::KinDynComputationsPrivateAttributes::setRobotState(const Transform& world_T_base,
+                                                                         Span<const double> s,
+                                                                         const Twist& base_velocity,
+                                                                         Span<const double> s_dot,
+                                                                         const Vector3& world_gravity)
 {
-
-    bool ok = s.size() == pimpl->m_robot_model.getNrOfPosCoords();
+    bool ok = s.size() == static_cast<Span<const double>::index_type>(m_robot_model.getNrOfPosCoords());
     if( !ok )
     {
         reportError("KinDynComputations","setRobotState","Wrong size in input joint positions");
         return false;
     }
 
-    ok = s_dot.size() == pimpl->m_robot_model.getNrOfDOFs();
+    ok = s_dot.size() == static_cast<Span<const double>::index_type>(m_robot_model.getNrOfDOFs());
     if( !ok )
     {
         reportError("KinDynComputations","setRobotState","Wrong size in input joint velocities");
         return false;
     }
 
-    this->invalidateCache();
-
-    // Save pos
-    this->pimpl->m_pos.worldBasePos() = world_T_base;
-    toEigen(this->pimpl->m_pos.jointPos()) = toEigen(s);
+    // Save pos, keeping track of the changes to update only
+    // the affected part of the cached quantities
+    bool isBasePosChanged = !(toEigen(world_T_base.getRotation()) == toEigen(m_pos.worldBasePos().getRotation()) &&
+                              toEigen(world_T_base.getPosition()) == toEigen(m_pos.worldBasePos().getPosition()));
+    m_pos.worldBasePos() = world_T_base;
+    bool isJointPosChanged = this->updateJointPos(s);
 
     // Save gravity
-    this->pimpl->m_gravityAcc = world_gravity;
-    Rotation base_R_inertial = this->pimpl->m_pos.worldBasePos().getRotation().inverse();
-    toEigen(pimpl->m_gravityAccInBaseLinkFrame) = toEigen(base_R_inertial)*toEigen(this->pimpl->m_gravityAcc);
+    m_gravityAcc = world_gravity;
+    Rotation base_R_inertial = m_pos.worldBasePos().getRotation().inverse();
+    toEigen(m_gravityAccInBaseLinkFrame) = toEigen(base_R_inertial)*toEigen(m_gravityAcc);
 
     // Save vel
-    toEigen(pimpl->m_vel.jointVel()) = toEigen(s_dot);
+    bool isJointVelChanged = this->updateJointVel(s_dot);
 
     // Account for the different possible representations
-    if (pimpl->m_frameVelRepr == MIXED_REPRESENTATION)
+    Twist baseVelInBodyFixed;
+    if (m_frameVelRepr == MIXED_REPRESENTATION)
     {
-        pimpl->m_vel.baseVel() = pimpl->m_pos.worldBasePos().getRotation().inverse()*base_velocity;
+        baseVelInBodyFixed = m_pos.worldBasePos().getRotation().inverse()*base_velocity;
     }
-    else if (pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION)
+    else if (m_frameVelRepr == BODY_FIXED_REPRESENTATION)
     {
         // Data is stored in body fixed
-        pimpl->m_vel.baseVel() = base_velocity;
+        baseVelInBodyFixed = base_velocity;
     }
     else
     {
-        assert(pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION);
+        assert(m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION);
         // base_X_inertial \ls^inertial v_base
-        pimpl->m_vel.baseVel() = pimpl->m_pos.worldBasePos().inverse()*base_velocity;
+        baseVelInBodyFixed = m_pos.worldBasePos().inverse()*base_velocity;
+    }
+
+    bool isBaseVelChanged = !(toEigen(baseVelInBodyFixed) == toEigen(m_vel.baseVel()));
+    m_vel.baseVel() = baseVelInBodyFixed;
+
+    m_fwdKinBasePosChanged = m_fwdKinBasePosChanged || isBasePosChanged;
+    m_fwdKinBaseVelChanged = m_fwdKinBaseVelChanged || isBaseVelChanged;
+    m_areFwdKinChangesPending = m_areFwdKinChangesPending || isBasePosChanged || isBaseVelChanged;
+
+    if( isBasePosChanged || isJointPosChanged || isBaseVelChanged || isJointVelChanged )
+    {
+        m_isFwdKinematicsUpdated = false;
+        m_isRawMassMatrixUpdated = false;
+        m_areBiasAccelerationsUpdated = false;
     }
 
     return true;
 }
 
+bool KinDynComputations::setRobotState(const Transform& world_T_base,
+                                       const VectorDynSize& s,
+                                       const Twist& base_velocity,
+                                       const VectorDynSize& s_dot,
+                                       const Vector3& world_gravity)
+{
+    return pimpl->setRobotState(world_T_base,s,base_velocity,s_dot,world_gravity);
+}
+
+bool KinDynComputations::setRobotState(MatrixView<const double> world_T_base,
+                                       Span<const double> s,
+                                       Span<const double> base_velocity,
+                                       Span<const double> s_dot,
+                                       Span<const double> world_gravity)
+{
+    if( world_T_base.rows() != 4 || world_T_base.cols() != 4 )
+    {
+        reportError("KinDynComputations","setRobotState","Wrong size in input world_T_base, expected a 4x4 matrix");
+        return false;
+    }
+
+    if( base_velocity.size() != 6 )
+    {
+        reportError("KinDynComputations","setRobotState","Wrong size in input base_velocity");
+        return false;
+    }
+
+    if( world_gravity.size() != 3 )
+    {
+        reportError("KinDynComputations","setRobotState","Wrong size in input world_gravity");
+        return false;
+    }
+
+    Transform world_T_base_transform;
+    fromEigen(world_T_base_transform,toEigen(world_T_base));
+
+    Twist base_velocity_twist;
+    toEigen(base_velocity_twist.getLinearVec3()) = toEigen(base_velocity).head<3>();
+    toEigen(base_velocity_twist.getAngularVec3()) = toEigen(base_velocity).tail<3>();
+
+    Vector3 world_gravity_vec;
+    toEigen(world_gravity_vec) = toEigen(world_gravity);
+
+    return pimpl->setRobotState(world_T_base_transform,s,base_velocity_twist,s_dot,world_gravity_vec);
+}
+
+bool KinDynComputations::setRobotState(Span<const double> s,
+                                       Span<const double> s_dot,
+                                       Span<const double> world_gravity)
+{
+    if( world_gravity.size() != 3 )
+    {
+        reportError("KinDynComputations","setRobotState","Wrong size in input world_gravity");
+        return false;
+    }
+
+    Vector3 world_gravity_vec;
+    toEigen(world_gravity_vec) = toEigen(world_gravity);
+
+    return pimpl->setRobotState(Transform::Identity(),s,Twist::Zero(),s_dot,world_gravity_vec);
+}
+
 void KinDynComputations::getRobotState(Transform& world_T_base,
                                        VectorDynSize& s,
                                        Twist& base_velocity,
@@ -819,10 +1340,13 @@ bool KinDynComputations::setJointPos(const VectorDynSize& s)
         return false;
     }
 
-    toEigen(this->pimpl->m_pos.jointPos()) = toEigen(s);
-
-    // Invalidate cache
-    this->invalidateCache();
+    // Invalidate the cache, if necessary
+    if( this->pimpl->updateJointPos(s) )
+    {
+        this->pimpl->m_isFwdKinematicsUpdated = false;
+        this->pimpl->m_isRawMassMatrixUpdated = false;
+        this->pimpl->m_areBiasAccelerationsUpdated = false;
+    }
 
     return true;
 }
@@ -916,13 +1440,12 @@ Transform KinDynComputations::getRelativeTransform(const iDynTree::FrameIndex re
         return iDynTree::Transform::Identity();
     }
 
-    // compute fwd kinematics (if necessary)
-    this->computeFwdKinematics();
-
-    Transform world_H_frame = getWorldTransform(frameIndex);
-    Transform world_H_refFrame = getWorldTransform(refFrameIndex);
-
-    Transform refFrame_H_frame = world_H_refFrame.inverse()*world_H_frame;
+    // Compute the relative transform between the links at which the frames are attached,
+    // using only the joints in the path between the two links (if necessary)
+    Transform refFrame_H_frame =
+        pimpl->m_robot_model.getFrameTransform(refFrameIndex).inverse()*
+        pimpl->getRelativeLinkTransform(pimpl->m_robot_model.getFrameLink(refFrameIndex),pimpl->m_robot_model.getFrameLink(frameIndex))*
+        pimpl->m_robot_model.getFrameTransform(frameIndex);
 
     // Set semantics
     // Setting position semantics
@@ -973,19 +1496,11 @@ Transform KinDynComputations::getRelativeTransformExplicit(const iDynTree::Frame
         return iDynTree::Transform::Identity();
     }
 
-    // compute fwd kinematics (if necessary)
-    this->computeFwdKinematics();
-
-
     // This part can be probably made more efficient, but unless a need for performance
     // arise I prefer it to be readable for now
 
-    Transform world_H_refFrameOrientation = getWorldTransform(refFrameOrientationIndex);
-    Transform world_H_framOrientation = getWorldTransform(frameOrientationIndex);
-
     // Orientation part
-    // refFrameOrientation_R_frameOrientation = world_R_refFrameOrientation^{-1} * world_R_frameOrientation
-    Rotation refFrameOrientation_R_frameOrientation = world_H_refFrameOrientation.getRotation().inverse()*world_H_framOrientation.getRotation();
+    Rotation refFrameOrientation_R_frameOrientation = getRelativeTransform(refFrameOrientationIndex,frameOrientationIndex).getRotation();
 
     // Position part
     // refFrameOrientation_p_refFrameOrigin_frameOrigin =
@@ -1019,15 +1534,8 @@ Transform KinDynComputations::getWorldTransform(const FrameIndex frameIndex)
         return iDynTree::Transform::Identity();
     }
 
-    // compute fwd kinematics (if necessary)
-    this->computeFwdKinematics();
-
-    if( !this->pimpl->m_isFwdKinematicsUpdated )
-    {
-        reportError("KinDynComputations","getWorldTransform","error in computing fwd kinematics");
-        return iDynTree::Transform::Identity();
-    }
-
+    // compute fwd kinematics of the link at which the frame is attached (if necessary)
+    this->pimpl->computeLinkPos(this->pimpl->m_robot_model.getFrameLink(frameIndex));
 
     iDynTree::Transform world_H_frame;
 
@@ -1087,8 +1595,8 @@ Twist KinDynComputations::getFrameVel(const FrameIndex frameIdx)
         return Twist::Zero();
     }
 
-    // compute fwd kinematics (if necessary)
-    this->computeFwdKinematics();
+    // compute velocity kinematics of the link at which the frame is attached (if necessary)
+    this->pimpl->computeLinkVel(pimpl->m_robot_model.getFrameLink(frameIdx));
 
     // Compute frame body-fixed velocity
     Transform frame_X_link = pimpl->m_robot_model.getFrameTransform(frameIdx).inverse();
@@ -1210,6 +1718,19 @@ bool KinDynComputations::getFrameFreeFloatingJacobian(const std::string& frameNa
 
 bool KinDynComputations::getFrameFreeFloatingJacobian(const FrameIndex frameIndex,
                                                       MatrixDynSize& outJacobian)
+{
+    outJacobian.resize(6,6+pimpl->m_robot_model.getNrOfDOFs());
+    return getFrameFreeFloatingJacobian(frameIndex,MatrixView<double>(outJacobian));
+}
+
+bool KinDynComputations::getFrameFreeFloatingJacobian(const std::string & frameName,
+                                                      MatrixView<double> outJacobian)
+{
+    return getFrameFreeFloatingJacobian(getFrameIndex(frameName),outJacobian);
+}
+
+bool KinDynComputations::getFrameFreeFloatingJacobian(const FrameIndex frameIndex,
+                                                      MatrixView<double> outJacobian)
 {
     if (!pimpl->m_robot_model.isValidFrameIndex(frameIndex))
     {
@@ -1217,58 +1738,146 @@ bool KinDynComputations::getFrameFreeFloatingJacobian(const FrameIndex frameInde
         return false;
     }
 
+    if( outJacobian.rows() != 6 ||
+        outJacobian.cols() != static_cast<MatrixView<double>::index_type>(6+pimpl->m_robot_model.getNrOfDOFs()) )
+    {
+        reportError("KinDynComputations","getFrameFreeFloatingJacobian","Wrong size in output jacobian");
+        return false;
+    }
+
     // compute fwd kinematics (if necessary)
     this->computeFwdKinematics();
 
     // Get the link to which the frame is attached
     LinkIndex jacobLink = pimpl->m_robot_model.getFrameLink(frameIndex);
-    const Transform & jacobLink_H_frame = pimpl->m_robot_model.getFrameTransform(frameIndex);
+
+    return FreeFloatingJacobianUsingLinkPos(pimpl->m_robot_model,pimpl->m_traversal,
+                                            pimpl->m_pos.jointPos(),pimpl->m_linkPos,
+                                            jacobLink,
+                                            pimpl->getJacobFrame_X_world(frameIndex),
+                                            pimpl->getBaseFrame_X_jacobBaseFrame(),
+                                            outJacobian);
+}
+
+bool KinDynComputations::getFrameFreeFloatingJacobian(const std::string & frameName,
+                                                      CompressedColumnJacobian & outJacobian)
+{
+    return getFrameFreeFloatingJacobian(getFrameIndex(frameName),outJacobian);
+}
+
+bool KinDynComputations::getFrameFreeFloatingJacobian(const FrameIndex frameIndex,
+                                                      CompressedColumnJacobian & outJacobian)
+{
+    if (!pimpl->m_robot_model.isValidFrameIndex(frameIndex))
+    {
+        reportError("KinDynComputations","getFrameFreeFloatingJacobian","Frame index out of bounds");
+        return false;
+    }
+
+    // compute fwd kinematics (if necessary)
+    this->computeFwdKinematics();
+
+    // Get the link to which the frame is attached
+    LinkIndex jacobLink = pimpl->m_robot_model.getFrameLink(frameIndex);
+
+    return FreeFloatingJacobianUsingLinkPos(pimpl->m_robot_model,pimpl->m_traversal,
+                                            pimpl->m_pos.jointPos(),pimpl->m_linkPos,
+                                            jacobLink,
+                                            pimpl->getJacobFrame_X_world(frameIndex),
+                                            pimpl->getBaseFrame_X_jacobBaseFrame(),
+                                            pimpl->m_stackedJacobiansBuffers,
+                                            outJacobian);
+}
+
+bool KinDynComputations::getFrameFreeFloatingJacobians(const std::vector<std::string> & frameNames,
+                                                       MatrixDynSize & outStackedJacobians)
+{
+    pimpl->m_stackedJacobiansFrames.resize(frameNames.size());
+    for(size_t i=0; i < frameNames.size(); i++)
+    {
+        pimpl->m_stackedJacobiansFrames[i] = getFrameIndex(frameNames[i]);
+    }
+
+    return getFrameFreeFloatingJacobians(pimpl->m_stackedJacobiansFrames,outStackedJacobians);
+}
+
+bool KinDynComputations::getFrameFreeFloatingJacobians(const std::vector<FrameIndex> & frameIndices,
+                                                       MatrixDynSize & outStackedJacobians)
+{
+    for(size_t i=0; i < frameIndices.size(); i++)
+    {
+        if (!pimpl->m_robot_model.isValidFrameIndex(frameIndices[i]))
+        {
+            reportError("KinDynComputations","getFrameFreeFloatingJacobians","Frame index out of bounds");
+            return false;
+        }
+    }
+
+    // compute fwd kinematics (if necessary)
+    this->computeFwdKinematics();
+
+    pimpl->m_stackedJacobiansLinks.resize(frameIndices.size());
+    pimpl->m_stackedJacobiansFrames_X_world.resize(frameIndices.size());
+    for(size_t i=0; i < frameIndices.size(); i++)
+    {
+        pimpl->m_stackedJacobiansLinks[i] = pimpl->m_robot_model.getFrameLink(frameIndices[i]);
+        pimpl->m_stackedJacobiansFrames_X_world[i] = pimpl->getJacobFrame_X_world(frameIndices[i]);
+    }
+
+    return FreeFloatingJacobiansUsingLinkPos(pimpl->m_robot_model,pimpl->m_traversal,
+                                             pimpl->m_pos.jointPos(),pimpl->m_linkPos,
+                                             pimpl->m_stackedJacobiansLinks,
+                                             pimpl->m_stackedJacobiansFrames_X_world,
+                                             pimpl->getBaseFrame_X_jacobBaseFrame(),
+                                             pimpl->m_stackedJacobiansBuffers,
+                                             outStackedJacobians);
+}
+
+Transform KinDynComputations::KinDynComputationsPrivateAttributes::getJacobFrame_X_world(const FrameIndex frameIndex)
+{
+    LinkIndex jacobLink = m_robot_model.getFrameLink(frameIndex);
+    const Transform & jacobLink_H_frame = m_robot_model.getFrameTransform(frameIndex);
 
     // The frame on which the jacobian is expressed is (frame,frame)
     // in the case of BODY_FIXED_REPRESENTATION, (frame,world) for MIXED_REPRESENTATION
     // and (world,world) for INERTIAL_FIXED_REPRESENTATION .
-    Transform jacobFrame_X_world;
-
-    if (pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION)
+    if (m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION)
     {
-        jacobFrame_X_world = Transform::Identity();
+        return Transform::Identity();
     }
-    else if (pimpl->m_frameVelRepr == MIXED_REPRESENTATION)
+    else if (m_frameVelRepr == MIXED_REPRESENTATION)
     {
         // This is tricky.. needs to be properly documented
-        Transform world_X_frame = (pimpl->m_linkPos(jacobLink)*jacobLink_H_frame);
-        jacobFrame_X_world = Transform(Rotation::Identity(),-world_X_frame.getPosition());
+        Transform world_X_frame = (m_linkPos(jacobLink)*jacobLink_H_frame);
+        return Transform(Rotation::Identity(),-world_X_frame.getPosition());
     }
     else
     {
-        assert(pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION);
-        Transform world_X_frame = (pimpl->m_linkPos(jacobLink)*jacobLink_H_frame);
-        jacobFrame_X_world = world_X_frame.inverse();
+        assert(m_frameVelRepr == BODY_FIXED_REPRESENTATION);
+        Transform world_X_frame = (m_linkPos(jacobLink)*jacobLink_H_frame);
+        return world_X_frame.inverse();
     }
+}
 
+Transform KinDynComputations::KinDynComputationsPrivateAttributes::getBaseFrame_X_jacobBaseFrame()
+{
     // To address for different representation of the base velocity, we construct the
     // baseFrame_X_jacobBaseFrame matrix
-    Transform baseFrame_X_jacobBaseFrame;
-    if (pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION)
+    if (m_frameVelRepr == BODY_FIXED_REPRESENTATION)
     {
-        baseFrame_X_jacobBaseFrame = Transform::Identity();
+        return Transform::Identity();
     }
-    else if (pimpl->m_frameVelRepr == MIXED_REPRESENTATION)
+    else if (m_frameVelRepr == MIXED_REPRESENTATION)
     {
-        Transform base_X_world = (pimpl->m_linkPos(pimpl->m_traversal.getBaseLink()->getIndex())).inverse();
-        baseFrame_X_jacobBaseFrame = Transform(base_X_world.getRotation(),Position::Zero());
+        Transform base_X_world = (m_linkPos(m_traversal.getBaseLink()->getIndex())).inverse();
+        return Transform(base_X_world.getRotation(),Position::Zero());
     }
     else
     {
-        assert(pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION);
-        Transform world_X_base = (pimpl->m_linkPos(pimpl->m_traversal.getBaseLink()->getIndex()));
-        baseFrame_X_jacobBaseFrame = world_X_base.inverse();
+        assert(m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION);
+        Transform world_X_base = (m_linkPos(m_traversal.getBaseLink()->getIndex()));
+        return world_X_base.inverse();
     }
-
-    return FreeFloatingJacobianUsingLinkPos(pimpl->m_robot_model,pimpl->m_traversal,
-                                            pimpl->m_pos.jointPos(),pimpl->m_linkPos,
-                                            jacobLink,jacobFrame_X_world,baseFrame_X_jacobBaseFrame,
-                                            outJacobian);
 }
 
 
@@ -1342,9 +1951,6 @@ bool KinDynComputations::getRelativeJacobianExplicit(const iDynTree::FrameIndex
     // \pi^{DOF}_L (D) degrees of freedom in the path connecting the Link D to the link L (as if it were the base).
 
 
-    // compute fwd kinematics (if necessary)
-    this->computeFwdKinematics();
-
     // Get the links to which the frames are attached
     LinkIndex jacobianLinkIndex = pimpl->m_robot_model.getFrameLink(frameIndex);
     LinkIndex refJacobianLink = pimpl->m_robot_model.getFrameLink(refFrameIndex);
@@ -1355,22 +1961,45 @@ bool KinDynComputations::getRelativeJacobianExplicit(const iDynTree::FrameIndex
 
     iDynTree::Traversal& relativeTraversal = pimpl->m_traversalCache.getTraversalWithLinkAsBase(pimpl->m_robot_model, refJacobianLink);
 
-    // Compute joint part
-    // We iterate from the link up in the traveral until we reach the base
-    LinkIndex visitedLinkIdx = jacobianLinkIndex;
+    // Only the joints in the path between the two links are needed: we collect the
+    // links in the path going from the link up in the traversal until we reach the base,
+    // and then we compute their transform w.r.t. the base going back in the path.
+    pimpl->m_linkPathBuffer.clear();
+    for (LinkIndex visitedLinkIdx = jacobianLinkIndex;
+         visitedLinkIdx != relativeTraversal.getBaseLink()->getIndex();
+         visitedLinkIdx = relativeTraversal.getParentLinkFromLinkIndex(visitedLinkIdx)->getIndex())
+    {
+        pimpl->m_linkPathBuffer.push_back(visitedLinkIdx);
+    }
+
+    // {}^L H_O and {}^L H_R, where O and R are the frames in which the origin and the orientation
+    // of the jacobian are expressed
+    Transform refLink_H_expressedOrigin = pimpl->getRelativeLinkTransform(refJacobianLink,pimpl->m_robot_model.getFrameLink(expressedOriginFrameIndex))*
+                                          pimpl->m_robot_model.getFrameTransform(expressedOriginFrameIndex);
+    Transform refLink_H_expressedOrientation = pimpl->getRelativeLinkTransform(refJacobianLink,pimpl->m_robot_model.getFrameLink(expressedOrientationFrameIndex))*
+                                               pimpl->m_robot_model.getFrameTransform(expressedOrientationFrameIndex);
+    Rotation expressedOrientation_R_refLink = refLink_H_expressedOrientation.getRotation().inverse();
 
-    while (visitedLinkIdx != relativeTraversal.getBaseLink()->getIndex())
+    // Compute joint part
+    Transform refLink_H_visited = Transform::Identity();
+    for (int pathEl = static_cast<int>(pimpl->m_linkPathBuffer.size())-1; pathEl >= 0; pathEl--)
     {
         //get the pair of links in the traversal
         //In the thesis this corresponds to links E and F, where
         // - F current visited link
         // - E parent of F wrt base L
         // i.e. E = \lambda_L(F)
+        LinkIndex visitedLinkIdx = pimpl->m_linkPathBuffer[pathEl];
         LinkIndex parentLinkIdx = relativeTraversal.getParentLinkFromLinkIndex(visitedLinkIdx)->getIndex();
         IJointConstPtr joint = relativeTraversal.getParentJointFromLinkIndex(visitedLinkIdx);
 
-        //get {}^D X_F
-        Matrix6x6 Expressed_X_visited = getRelativeTransformExplicit(expressedOriginFrameIndex, expressedOrientationFrameIndex, visitedLinkIdx, visitedLinkIdx).asAdjointTransform();
+        refLink_H_visited = refLink_H_visited*joint->getTransform(pimpl->m_pos.jointPos(),parentLinkIdx,visitedLinkIdx);
+
+        //get {}^D X_F, see getRelativeTransformExplicit
+        Position refLink_p_expressedOrigin_visited = refLink_H_visited.getPosition() - refLink_H_expressedOrigin.getPosition();
+        Transform Expressed_H_visited(expressedOrientation_R_refLink*refLink_H_visited.getRotation(),
+                                      expressedOrientation_R_refLink*refLink_p_expressedOrigin_visited);
+        Matrix6x6 Expressed_X_visited = Expressed_H_visited.asAdjointTransform();
 
         //Now for each Dof get the motion subspace
         //{}^F s_{E,F}, i.e. the velocity of F wrt E written in F.
@@ -1379,8 +2008,6 @@ bool KinDynComputations::getRelativeJacobianExplicit(const iDynTree::FrameIndex
         {
             toEigen(outJacobian).col(dofOffset + i) = toEigen(Expressed_X_visited) * toEigen(joint->getMotionSubspaceVector(i, visitedLinkIdx, parentLinkIdx));
         }
-
-        visitedLinkIdx = parentLinkIdx;
     }
 
     return true;
@@ -1471,9 +2098,20 @@ Vector3 KinDynComputations::getCenterOfMassVelocity()
 
 bool KinDynComputations::getCenterOfMassJacobian(MatrixDynSize& comJacobian)
 {
-    this->computeRawMassMatrixAndTotalMomentum();
-
     comJacobian.resize(3,pimpl->m_robot_model.getNrOfDOFs()+6);
+    return getCenterOfMassJacobian(MatrixView<double>(comJacobian));
+}
+
+bool KinDynComputations::getCenterOfMassJacobian(MatrixView<double> comJacobian)
+{
+    if( comJacobian.rows() != 3 ||
+        comJacobian.cols() != static_cast<MatrixView<double>::index_type>(pimpl->m_robot_model.getNrOfDOFs()+6) )
+    {
+        reportError("KinDynComputations","getCenterOfMassJacobian","Wrong size in output jacobian");
+        return false;
+    }
+
+    this->computeRawMassMatrixAndTotalMomentum();
 
     const SpatialInertia & lockedInertia = pimpl->getRobotLockedInertia();
     Matrix6x6 invLockedInertia = lockedInertia.getInverse();
@@ -1538,9 +2176,9 @@ const SpatialInertia& KinDynComputations::KinDynComputationsPrivateAttributes::g
 }
 
 void KinDynComputations::KinDynComputationsPrivateAttributes::processOnRightSideMatrixExpectingBodyFixedModelVelocity(
-        MatrixDynSize &mat)
+        MatrixView<double> mat)
 {
-    assert(mat.cols() == m_robot_model.getNrOfDOFs()+6);
+    assert(mat.cols() == static_cast<MatrixView<double>::index_type>(m_robot_model.getNrOfDOFs()+6));
 
     Transform baseFrame_X_newJacobBaseFrame;
     if (m_frameVelRepr == BODY_FIXED_REPRESENTATION)
@@ -1568,7 +2206,7 @@ void KinDynComputations::KinDynComputationsPrivateAttributes::processOnRightSide
 }
 
 void KinDynComputations::KinDynComputationsPrivateAttributes::processOnLeftSideBodyFixedAvgVelocityJacobian(
-        MatrixDynSize &jac)
+        MatrixView<double> jac)
 {
     assert(jac.rows() == 6);
 
@@ -1593,7 +2231,7 @@ void KinDynComputations::KinDynComputationsPrivateAttributes::processOnLeftSideB
     toEigen(jac) = toEigen(newOutputFrame_X_oldOutputFrame_)*toEigen(jac);
 }
 
-void KinDynComputations::KinDynComputationsPrivateAttributes::processOnLeftSideBodyFixedBaseMomentumJacobian(MatrixDynSize& jac)
+void KinDynComputations::KinDynComputationsPrivateAttributes::processOnLeftSideBodyFixedBaseMomentumJacobian(MatrixView<double> jac)
 {
     Transform newOutputFrame_X_oldOutputFrame;
     if (m_frameVelRepr == BODY_FIXED_REPRESENTATION)
@@ -1662,9 +2300,9 @@ bool KinDynComputations::getAverageVelocityJacobian(MatrixDynSize& avgVelocityJa
 }
 
 void KinDynComputations::KinDynComputationsPrivateAttributes::processOnLeftSideBodyFixedCentroidalAvgVelocityJacobian(
-        MatrixDynSize &jac, const FrameVelocityRepresentation & leftSideRepresentation)
+        MatrixView<double> jac, const FrameVelocityRepresentation & leftSideRepresentation)
 {
-    assert(jac.cols() == m_robot_model.getNrOfDOFs()+6);
+    assert(jac.cols() == static_cast<MatrixView<double>::index_type>(m_robot_model.getNrOfDOFs()+6));
 
     // Get the center of mass in the base frame
     Position vectorFromComToBaseWithRotationOfBase = PositionRaw::inverse(this->getRobotLockedInertia().getCenterOfMass());
@@ -1727,9 +2365,21 @@ Twist KinDynComputations::getCentroidalAverageVelocity()
 
 bool KinDynComputations::getCentroidalAverageVelocityJacobian(MatrixDynSize& centroidalAvgVelocityJacobian)
 {
+    centroidalAvgVelocityJacobian.resize(6,pimpl->m_robot_model.getNrOfDOFs()+6);
+    return getCentroidalAverageVelocityJacobian(MatrixView<double>(centroidalAvgVelocityJacobian));
+}
+
+bool KinDynComputations::getCentroidalAverageVelocityJacobian(MatrixView<double> centroidalAvgVelocityJacobian)
+{
+    if( centroidalAvgVelocityJacobian.rows() != 6 ||
+        centroidalAvgVelocityJacobian.cols() != static_cast<MatrixView<double>::index_type>(pimpl->m_robot_model.getNrOfDOFs()+6) )
+    {
+        reportError("KinDynComputations","getCentroidalAverageVelocityJacobian","Wrong size in output jacobian");
+        return false;
+    }
+
     this->computeRawMassMatrixAndTotalMomentum();
 
-    centroidalAvgVelocityJacobian.resize(6,pimpl->m_robot_model.getNrOfDOFs()+6);
     const SpatialInertia & lockedInertia = pimpl->getRobotLockedInertia();
     Matrix6x6 invLockedInertia = lockedInertia.getInverse();
     // The first six rows of the mass matrix are the base-base average velocity jacobian
@@ -1811,12 +2461,25 @@ SpatialMomentum KinDynComputations::getCentroidalTotalMomentum()
 
 bool KinDynComputations::getFreeFloatingMassMatrix(MatrixDynSize& freeFloatingMassMatrix)
 {
-    // Compute the body-fixed-body-fixed mass matrix, if necessary 
-    this->computeRawMassMatrixAndTotalMomentum();
-    
-    // If the matrix has the right size, this should be inexpensive 
+    // If the matrix has the right size, this should be inexpensive
     freeFloatingMassMatrix.resize(pimpl->m_robot_model.getNrOfDOFs()+6,pimpl->m_robot_model.getNrOfDOFs()+6);
 
+    return getFreeFloatingMassMatrix(MatrixView<double>(freeFloatingMassMatrix));
+}
+
+bool KinDynComputations::getFreeFloatingMassMatrix(MatrixView<double> freeFloatingMassMatrix)
+{
+    MatrixView<double>::index_type nrOfDOFs = pimpl->m_robot_model.getNrOfDOFs();
+    if( freeFloatingMassMatrix.rows() != nrOfDOFs+6 ||
+        freeFloatingMassMatrix.cols() != nrOfDOFs+6 )
+    {
+        reportError("KinDynComputations","getFreeFloatingMassMatrix","Wrong size in output mass matrix");
+        return false;
+    }
+
+    // Compute the body-fixed-body-fixed mass matrix, if necessary
+    this->computeRawMassMatrixAndTotalMomentum();
+
     toEigen(freeFloatingMassMatrix) = toEigen(pimpl->m_rawMassMatrix);
     
     // Handle the different representations
@@ -1874,6 +2537,53 @@ bool KinDynComputations::inverseDynamics(const Vector6& baseAcc,
                                          const LinkNetExternalWrenches & linkExtForces,
                                                FreeFloatingGeneralizedTorques & baseForceAndJointTorques)
 {
+    return inverseDynamics(make_span(baseAcc),make_span(s_ddot),linkExtForces,baseForceAndJointTorques);
+}
+
+bool KinDynComputations::inverseDynamics(Span<const double> baseAccSpan,
+                                         Span<const double> s_ddot,
+                                         const LinkNetExternalWrenches & linkExtForces,
+                                               Span<double> baseForceAndJointTorques)
+{
+    if( baseForceAndJointTorques.size() != static_cast<Span<double>::index_type>(6+pimpl->m_robot_model.getNrOfDOFs()) )
+    {
+        reportError("KinDynComputations","inverseDynamics","Wrong size in output baseForceAndJointTorques");
+        return false;
+    }
+
+    if( !inverseDynamics(baseAccSpan,s_ddot,linkExtForces,pimpl->m_invDynGeneralizedTorques) )
+    {
+        return false;
+    }
+
+    const Wrench & baseWrench = pimpl->m_invDynGeneralizedTorques.baseWrench();
+    toEigen(baseForceAndJointTorques).head<3>() = toEigen(baseWrench.getLinearVec3());
+    toEigen(baseForceAndJointTorques).segment<3>(3) = toEigen(baseWrench.getAngularVec3());
+    toEigen(baseForceAndJointTorques).tail(pimpl->m_robot_model.getNrOfDOFs()) = toEigen(pimpl->m_invDynGeneralizedTorques.jointTorques());
+
+    return true;
+}
+
+bool KinDynComputations::inverseDynamics(Span<const double> baseAccSpan,
+                                         Span<const double> s_ddot,
+                                         const LinkNetExternalWrenches & linkExtForces,
+                                               FreeFloatingGeneralizedTorques & baseForceAndJointTorques)
+{
+    if( baseAccSpan.size() != 6 )
+    {
+        reportError("KinDynComputations","inverseDynamics","Wrong size in input baseAcc");
+        return false;
+    }
+
+    if( s_ddot.size() != static_cast<Span<const double>::index_type>(pimpl->m_robot_model.getNrOfDOFs()) )
+    {
+        reportError("KinDynComputations","inverseDynamics","Wrong size in input s_ddot");
+        return false;
+    }
+
+    Vector6 baseAcc;
+    toEigen(baseAcc) = toEigen(baseAccSpan);
+
     // Needed for using pimpl->m_linkVel
     this->computeFwdKinematics();
 
@@ -1945,6 +2655,224 @@ bool KinDynComputations::inverseDynamics(const Vector6& baseAcc,
     return true;
 }
 
+bool KinDynComputations::forwardDynamics(const VectorDynSize& jointTorques,
+                                         const LinkNetExternalWrenches & linkExtForces,
+                                               Vector6& baseAcc,
+                                               VectorDynSize& s_ddot)
+{
+    if( jointTorques.size() != pimpl->m_robot_model.getNrOfDOFs() )
+    {
+        reportError("KinDynComputations","forwardDynamics","Wrong size in input joint torques");
+        return false;
+    }
+
+    if( !linkExtForces.isConsistent(pimpl->m_robot_model) )
+    {
+        reportError("KinDynComputations","forwardDynamics","Input external wrenches are not consistent with the model");
+        return false;
+    }
+
+    // Needed for using pimpl->m_linkPos
+    this->computeFwdKinematics();
+
+    // Convert input external forces
+    if( pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION ||
+        pimpl->m_frameVelRepr == MIXED_REPRESENTATION )
+    {
+        for(LinkIndex lnkIdx = 0; lnkIdx < static_cast<LinkIndex>(pimpl->m_robot_model.getNrOfLinks()); lnkIdx++)
+        {
+            const Transform & inertialFrame_X_link = pimpl->m_linkPos(lnkIdx);
+            pimpl->m_fwdDynNetExtWrenches(lnkIdx) = pimpl->fromUsedRepresentationToBodyFixed(linkExtForces(lnkIdx),inertialFrame_X_link);
+        }
+    }
+    else
+    {
+        for(LinkIndex lnkIdx = 0; lnkIdx < static_cast<LinkIndex>(pimpl->m_robot_model.getNrOfLinks()); lnkIdx++)
+        {
+            pimpl->m_fwdDynNetExtWrenches(lnkIdx) = linkExtForces(lnkIdx);
+        }
+    }
+
+    toEigen(pimpl->m_fwdDynJointTorques) = toEigen(jointTorques);
+
+    // Run forward dynamics: as the ArticulatedBodyAlgorithm does not account for gravity,
+    // its output base acceleration is the proper (real-gravity) acceleration of the base.
+    // The link positions already computed by computeFwdKinematics are used in place of the joint transforms.
+    bool ok = ArticulatedBodyAlgorithm(pimpl->m_robot_model,
+                                       pimpl->m_traversal,
+                                       pimpl->m_linkPos,
+                                       pimpl->m_vel,
+                                       pimpl->m_fwdDynNetExtWrenches,
+                                       pimpl->m_fwdDynJointTorques,
+                                       pimpl->m_fwdDynBuffers,
+                                       pimpl->m_fwdDynGeneralizedProperAccs);
+
+    if( !ok )
+    {
+        reportError("KinDynComputations","forwardDynamics","Error in computing the forward dynamics");
+        return false;
+    }
+
+    // Convert the base proper acceleration to the base acceleration
+    SpatialAcc baseAccInBodyFixed = pimpl->m_fwdDynGeneralizedProperAccs.baseAcc();
+    toEigen(baseAccInBodyFixed.getLinearVec3()) =
+        toEigen(pimpl->m_fwdDynGeneralizedProperAccs.baseAcc().getLinearVec3()) + toEigen(pimpl->m_gravityAccInBaseLinkFrame);
+
+    // Convert output base acceleration
+    if( pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION )
+    {
+        baseAcc = baseAccInBodyFixed.asVector();
+    }
+    else if( pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION )
+    {
+        baseAcc = (pimpl->m_pos.worldBasePos()*baseAccInBodyFixed).asVector();
+    }
+    else
+    {
+        assert(pimpl->m_frameVelRepr == MIXED_REPRESENTATION);
+        baseAcc = convertBodyFixedAccelerationToMixedAcceleration(baseAccInBodyFixed,
+                                                                  pimpl->m_vel.baseVel(),
+                                                                  pimpl->m_pos.worldBasePos().getRotation());
+    }
+
+    s_ddot.resize(pimpl->m_robot_model.getNrOfDOFs());
+    toEigen(s_ddot) = toEigen(pimpl->m_fwdDynGeneralizedProperAccs.jointAcc());
+
+    return true;
+}
+
+bool KinDynComputations::inverseDynamicsDerivatives(const Vector6& baseAcc,
+                                                    const VectorDynSize& s_ddot,
+                                                    const LinkNetExternalWrenches & linkExtForces,
+                                                          MatrixDynSize & dTau_dq,
+                                                          MatrixDynSize & dTau_dnu,
+                                                          MatrixDynSize & dTau_dnudot)
+{
+    if( s_ddot.size() != pimpl->m_robot_model.getNrOfDOFs() )
+    {
+        reportError("KinDynComputations","inverseDynamicsDerivatives","Wrong size in input joint accelerations");
+        return false;
+    }
+
+    if( !linkExtForces.isConsistent(pimpl->m_robot_model) )
+    {
+        reportError("KinDynComputations","inverseDynamicsDerivatives","Input external wrenches are not consistent with the model");
+        return false;
+    }
+
+    // Needed for using pimpl->m_linkPos
+    this->computeFwdKinematics();
+
+    // Convert input base acceleration
+    if( pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION )
+    {
+        fromEigen(pimpl->m_invDynBaseAcc,toEigen(baseAcc));
+    }
+    else if( pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION )
+    {
+        pimpl->m_invDynBaseAcc = convertInertialAccelerationToBodyFixedAcceleration(baseAcc,pimpl->m_pos.worldBasePos());
+    }
+    else
+    {
+        assert(pimpl->m_frameVelRepr == MIXED_REPRESENTATION);
+        pimpl->m_invDynBaseAcc = convertMixedAccelerationToBodyFixedAcceleration(baseAcc,
+                                                                                 pimpl->m_vel.baseVel(),
+                                                                                 pimpl->m_pos.worldBasePos().getRotation());
+    }
+
+    // Convert input external forces
+    for(LinkIndex lnkIdx = 0; lnkIdx < static_cast<LinkIndex>(pimpl->m_robot_model.getNrOfLinks()); lnkIdx++)
+    {
+        const Transform & inertialFrame_X_link = pimpl->m_linkPos(lnkIdx);
+        pimpl->m_invDynNetExtWrenches(lnkIdx) = pimpl->fromUsedRepresentationToBodyFixed(linkExtForces(lnkIdx),inertialFrame_X_link);
+    }
+
+    pimpl->m_invDynDerivGeneralizedAccs.baseAcc() = pimpl->m_invDynBaseAcc;
+    toEigen(pimpl->m_invDynDerivGeneralizedAccs.jointAcc()) = toEigen(s_ddot);
+
+    // Compute the derivatives in body-fixed representation, with the external
+    // wrenches kept constant in the used representation
+    bool ok = InverseDynamicsDerivatives(pimpl->m_robot_model,
+                                         pimpl->m_traversal,
+                                         pimpl->m_pos,
+                                         pimpl->m_vel,
+                                         pimpl->m_invDynDerivGeneralizedAccs,
+                                         pimpl->m_gravityAcc,
+                                         pimpl->m_invDynNetExtWrenches,
+                                         pimpl->m_frameVelRepr,
+                                         pimpl->m_invDynDerivBuffers,
+                                         dTau_dq,
+                                         dTau_dnu,
+                                         dTau_dnudot);
+
+    if( !ok )
+    {
+        reportError("KinDynComputations","inverseDynamicsDerivatives","Error in computing the inverse dynamics derivatives");
+        return false;
+    }
+
+    if( pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION )
+    {
+        return true;
+    }
+
+    // In the inertial and mixed representations the body-fixed base velocity, the body-fixed base acceleration
+    // and the base wrench in the used representation depend on the base position, given the quantities in the
+    // used representation. We add these terms to the derivatives with respect to a body-fixed variation \delta of the base
+    // position, and for the mixed representation we add the dependency of the body-fixed base acceleration on the base velocity.
+    size_t size = 6+pimpl->m_robot_model.getNrOfDOFs();
+    Eigen::Matrix<double,6,1> vB = toEigen(pimpl->m_vel.baseVel());
+    Eigen::Matrix<double,6,1> aB = toEigen(pimpl->m_invDynBaseAcc);
+    Eigen::Matrix<double,6,1> fB = toEigen(pimpl->m_invDynDerivBuffers.generalizedTorques.baseWrench());
+
+    Eigen::Matrix<double,6,6> dVb_dDelta, dAb_dDelta, dFb_dDelta;
+    dVb_dDelta.setZero();
+    dAb_dDelta.setZero();
+    dFb_dDelta.setZero();
+
+    // Mixed: only the base orientation matters, v_B = base_R_world v_M so dv_B = v_B \times \delta\theta (for both the linear and angular part),
+    // the same holds for a_B (the terms due to the dependency of a_B on v_B cancel out), while the base wrench is world_R_base f_B
+    // Inertial: v_B = base_X_world v_I so dv_B = v_B \times \delta, the same holds for a_B, while the base wrench is world_X_base^* f_B
+    dVb_dDelta.block<3,3>(0,3) = skew(vB.segment<3>(0));
+    dVb_dDelta.block<3,3>(3,3) = skew(vB.segment<3>(3));
+    dAb_dDelta.block<3,3>(0,3) = skew(aB.segment<3>(0));
+    dAb_dDelta.block<3,3>(3,3) = skew(aB.segment<3>(3));
+    dFb_dDelta.block<3,3>(0,3) = -skew(fB.segment<3>(0));
+    dFb_dDelta.block<3,3>(3,3) = -skew(fB.segment<3>(3));
+
+    if( pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION )
+    {
+        dVb_dDelta.block<3,3>(0,0) = skew(vB.segment<3>(3));
+        dAb_dDelta.block<3,3>(0,0) = skew(aB.segment<3>(3));
+        dFb_dDelta.block<3,3>(3,0) = -skew(fB.segment<3>(0));
+    }
+
+    toEigen(dTau_dq).block(0,0,size,6) += toEigen(dTau_dnu).block(0,0,size,6)*dVb_dDelta
+                                          + toEigen(dTau_dnudot).block(0,0,size,6)*dAb_dDelta;
+    toEigen(dTau_dq).block<6,6>(0,0) += dFb_dDelta;
+
+    if( pimpl->m_frameVelRepr == MIXED_REPRESENTATION )
+    {
+        // a_B = base_R_world a_M - \omega_B \times v_B , so (keeping a_M constant) the linear part
+        // of a_B changes with the body-fixed base velocity as -\omega_B \times dv_B + v_B \times d\omega_B
+        Eigen::Matrix<double,3,6> dAbLin_dVb;
+        dAbLin_dVb.block<3,3>(0,0) = -skew(vB.segment<3>(3));
+        dAbLin_dVb.block<3,3>(0,3) = skew(vB.segment<3>(0));
+        toEigen(dTau_dnu).block(0,0,size,6) += toEigen(dTau_dnudot).block(0,0,size,3)*dAbLin_dVb;
+    }
+
+    // Convert the base columns (the variation of the position, velocity and acceleration of the base)
+    // and the base rows (the base wrench) to the used representation
+    pimpl->processOnRightSideMatrixExpectingBodyFixedModelVelocity(dTau_dq);
+    pimpl->processOnRightSideMatrixExpectingBodyFixedModelVelocity(dTau_dnu);
+    pimpl->processOnRightSideMatrixExpectingBodyFixedModelVelocity(dTau_dnudot);
+    pimpl->processOnLeftSideBodyFixedBaseMomentumJacobian(dTau_dq);
+    pimpl->processOnLeftSideBodyFixedBaseMomentumJacobian(dTau_dnu);
+    pimpl->processOnLeftSideBodyFixedBaseMomentumJacobian(dTau_dnudot);
+
+    return true;
+}
+
 bool KinDynComputations::generalizedBiasForces(FreeFloatingGeneralizedTorques & generalizedBiasForces)
 {
     // Needed for using pimpl->m_linkVel
@@ -2005,34 +2933,17 @@ bool KinDynComputations::generalizedBiasForces(FreeFloatingGeneralizedTorques &
 
 bool KinDynComputations::generalizedGravityForces(FreeFloatingGeneralizedTorques & generalizedGravityForces)
 {
-    // Clear input buffers that need to be cleared
-    for(LinkIndex lnkIdx = 0; lnkIdx < static_cast<LinkIndex>(pimpl->m_robot_model.getNrOfLinks()); lnkIdx++)
-    {
-        pimpl->m_invDynNetExtWrenches(lnkIdx).zero();
-    }
-    pimpl->m_invDynGeneralizedProperAccs.baseAcc().zero();
-    toEigen(pimpl->m_invDynGeneralizedProperAccs.baseAcc().getLinearVec3()) =
-            - toEigen(pimpl->m_gravityAccInBaseLinkFrame);
-    pimpl->m_invDynGeneralizedProperAccs.jointAcc().zero();
-
-    // Run inverse dynamics
-    ForwardAccKinematics(pimpl->m_robot_model,
-                         pimpl->m_traversal,
-                         pimpl->m_pos,
-                         pimpl->m_invDynZeroVel,
-                         pimpl->m_invDynGeneralizedProperAccs,
-                         pimpl->m_invDynZeroLinkVel,
-                         pimpl->m_invDynLinkProperAccs);
-
-    RNEADynamicPhase(pimpl->m_robot_model,
-                     pimpl->m_traversal,
-                     pimpl->m_pos.jointPos(),
-                     pimpl->m_invDynZeroLinkVel,
-                     pimpl->m_invDynLinkProperAccs,
-                     pimpl->m_invDynNetExtWrenches,
-                     pimpl->m_invDynInternalWrenches,
-                     generalizedGravityForces);
+    // Needed for using pimpl->m_linkPos
+    this->computeFwdKinematics();
 
+    // Compute the gravity forces from the subtree masses and first moments
+    ComputeGeneralizedGravityForces(pimpl->m_robot_model,
+                                    pimpl->m_traversal,
+                                    pimpl->m_pos.jointPos(),
+                                    pimpl->m_linkPos,
+                                    pimpl->m_gravityAcc,
+                                    pimpl->m_gravityForcesBuffers,
+                                    generalizedGravityForces);
 
     // Convert output base force
     generalizedGravityForces.baseWrench() = pimpl->fromBodyFixedToUsedRepresentation(generalizedGravityForces.baseWrench(),
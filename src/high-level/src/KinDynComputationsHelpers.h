@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_KINDYNCOMPUTATIONS_HELPERS_H
+#define IDYNTREE_KINDYNCOMPUTATIONS_HELPERS_H
+
+#include <iDynTree/Core/VectorFixSize.h>
+#include <iDynTree/Core/Rotation.h>
+#include <iDynTree/Core/Transform.h>
+#include <iDynTree/Core/Twist.h>
+#include <iDynTree/Core/SpatialAcc.h>
+
+// Private helpers shared by the classes of the high-level component,
+// they are defined in KinDynComputations.cpp
+
+namespace iDynTree
+{
+
+Vector6 convertBodyFixedAccelerationToMixedAcceleration(const SpatialAcc & bodyFixedAcc,
+                                                        const Twist & bodyFixedVel,
+                                                        const Rotation & inertial_R_body);
+
+SpatialAcc convertMixedAccelerationToBodyFixedAcceleration(const Vector6 & mixedAcc,
+                                                           const Twist & bodyFixedVel,
+                                                           const Rotation & inertial_R_body);
+
+SpatialAcc convertInertialAccelerationToBodyFixedAcceleration(const Vector6 & inertialAcc,
+                                                              const Transform & inertial_H_body);
+
+}
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include "testModels.h"
+#include <iDynTree/Core/TestUtils.h>
+
+#include <iDynTree/Core/Transform.h>
+#include <iDynTree/Core/Twist.h>
+#include <iDynTree/Core/VectorDynSize.h>
+#include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/EigenHelpers.h>
+
+#include <iDynTree/KinDynComputations.h>
+#include <iDynTree/BatchKinDynComputations.h>
+#include <iDynTree/Model/Model.h>
+#include <iDynTree/Model/FreeFloatingState.h>
+#include <iDynTree/ModelIO/ModelLoader.h>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace iDynTree;
+
+void testBatchConsistency(const Model & model, const FrameVelocityRepresentation frameVelRepr, const unsigned int nrOfThreads)
+{
+    const size_t nrOfStates = 7;
+    size_t dofs = model.getNrOfDOFs();
+
+    KinDynComputations dynComp;
+    BatchKinDynComputations batchDynComp;
+
+    ASSERT_IS_TRUE(dynComp.loadRobotModel(model));
+    ASSERT_IS_TRUE(batchDynComp.loadRobotModel(model));
+    ASSERT_IS_TRUE(dynComp.setFrameVelocityRepresentation(frameVelRepr));
+    ASSERT_IS_TRUE(batchDynComp.setFrameVelocityRepresentation(frameVelRepr));
+    batchDynComp.setNrOfThreads(nrOfThreads);
+
+    std::vector<Transform> world_T_base(nrOfStates);
+    std::vector<Twist> baseVel(nrOfStates);
+    MatrixDynSize s(nrOfStates,dofs), s_dot(nrOfStates,dofs), s_ddot(nrOfStates,dofs), baseAcc(nrOfStates,6);
+    Vector3 gravity;
+    gravity(0) = 0.0;
+    gravity(1) = 0.0;
+    gravity(2) = -9.81;
+
+    for(size_t state=0; state < nrOfStates; state++)
+    {
+        world_T_base[state] = getRandomTransform();
+        baseVel[state] = getRandomTwist();
+        for(size_t dof=0; dof < dofs; dof++)
+        {
+            s(state,dof) = getRandomDouble();
+            s_dot(state,dof) = getRandomDouble();
+            s_ddot(state,dof) = getRandomDouble();
+        }
+        for(size_t i=0; i < 6; i++)
+        {
+            baseAcc(state,i) = getRandomDouble();
+        }
+    }
+
+    ASSERT_IS_TRUE(batchDynComp.setRobotStates(world_T_base,s,baseVel,s_dot,gravity));
+    ASSERT_EQUAL_DOUBLE(batchDynComp.getNrOfStates(),nrOfStates);
+
+    FrameIndex frameIndex = model.getNrOfFrames()-1;
+    std::vector<Transform> world_H_frames;
+    MatrixDynSize jacobians, comPositions, massMatrices, invDynTorques, biasForces;
+    ASSERT_IS_TRUE(batchDynComp.getWorldTransforms(frameIndex,world_H_frames));
+    ASSERT_IS_TRUE(batchDynComp.getFrameFreeFloatingJacobians(frameIndex,jacobians));
+    ASSERT_IS_TRUE(batchDynComp.getCenterOfMassPositions(comPositions));
+    ASSERT_IS_TRUE(batchDynComp.getFreeFloatingMassMatrices(massMatrices));
+    ASSERT_IS_TRUE(batchDynComp.inverseDynamics(baseAcc,s_ddot,invDynTorques));
+    ASSERT_IS_TRUE(batchDynComp.generalizedBiasForces(biasForces));
+
+    for(size_t state=0; state < nrOfStates; state++)
+    {
+        VectorDynSize qj(dofs), dqj(dofs), ddqj(dofs);
+        toEigen(qj) = toEigen(s).row(state).transpose();
+        toEigen(dqj) = toEigen(s_dot).row(state).transpose();
+        toEigen(ddqj) = toEigen(s_ddot).row(state).transpose();
+        ASSERT_IS_TRUE(dynComp.setRobotState(world_T_base[state],qj,baseVel[state],dqj,gravity));
+
+        ASSERT_EQUAL_TRANSFORM(dynComp.getWorldTransform(frameIndex),world_H_frames[state]);
+
+        MatrixDynSize jacobian(6,6+dofs);
+        ASSERT_IS_TRUE(dynComp.getFrameFreeFloatingJacobian(frameIndex,jacobian));
+        MatrixDynSize jacobianBatch(6,6+dofs);
+        toEigen(jacobianBatch) = toEigen(jacobians).block(6*state,0,6,6+dofs);
+        ASSERT_EQUAL_MATRIX(jacobian,jacobianBatch);
+
+        Position com = dynComp.getCenterOfMassPosition();
+        Vector3 comBatch;
+        toEigen(comBatch) = toEigen(comPositions).row(state).transpose();
+        ASSERT_EQUAL_VECTOR(com,comBatch);
+
+        MatrixDynSize massMatrix(6+dofs,6+dofs), massMatrixBatch(6+dofs,6+dofs);
+        ASSERT_IS_TRUE(dynComp.getFreeFloatingMassMatrix(massMatrix));
+        toEigen(massMatrixBatch) = toEigen(massMatrices).block((6+dofs)*state,0,6+dofs,6+dofs);
+        ASSERT_EQUAL_MATRIX(massMatrix,massMatrixBatch);
+
+        Vector6 stateBaseAcc;
+        toEigen(stateBaseAcc) = toEigen(baseAcc).row(state).transpose();
+        LinkNetExternalWrenches zeroExtWrenches(model);
+        zeroExtWrenches.zero();
+        FreeFloatingGeneralizedTorques invDyn(model), bias(model);
+        ASSERT_IS_TRUE(dynComp.inverseDynamics(stateBaseAcc,ddqj,zeroExtWrenches,invDyn));
+        ASSERT_IS_TRUE(dynComp.generalizedBiasForces(bias));
+
+        VectorDynSize invDynVec(6+dofs), invDynBatch(6+dofs), biasVec(6+dofs), biasBatch(6+dofs);
+        toEigen(invDynVec).segment<6>(0) = toEigen(invDyn.baseWrench());
+        toEigen(invDynVec).segment(6,dofs) = toEigen(invDyn.jointTorques());
+        toEigen(biasVec).segment<6>(0) = toEigen(bias.baseWrench());
+        toEigen(biasVec).segment(6,dofs) = toEigen(bias.jointTorques());
+        toEigen(invDynBatch) = toEigen(invDynTorques).row(state).transpose();
+        toEigen(biasBatch) = toEigen(biasForces).row(state).transpose();
+        ASSERT_EQUAL_VECTOR(invDynVec,invDynBatch);
+        ASSERT_EQUAL_VECTOR(biasVec,biasBatch);
+    }
+}
+
+void testBatchConsistencyAllRepresentations(std::string modelName)
+{
+    std::string urdfFileName = getAbsModelPath(modelName);
+    std::cout << "Testing file " << urdfFileName <<  std::endl;
+
+    ModelLoader loader;
+    ASSERT_IS_TRUE(loader.loadModelFromFile(urdfFileName));
+
+    for(unsigned int nrOfThreads=1; nrOfThreads <= 3; nrOfThreads += 2)
+    {
+        testBatchConsistency(loader.model(),iDynTree::MIXED_REPRESENTATION,nrOfThreads);
+        testBatchConsistency(loader.model(),iDynTree::BODY_FIXED_REPRESENTATION,nrOfThreads);
+        testBatchConsistency(loader.model(),iDynTree::INERTIAL_FIXED_REPRESENTATION,nrOfThreads);
+    }
+}
+
+int main()
+{
+    testBatchConsistencyAllRepresentations("oneLink.urdf");
+    testBatchConsistencyAllRepresentations("twoLinks.urdf");
+    testBatchConsistencyAllRepresentations("threeLinks.urdf");
+    testBatchConsistencyAllRepresentations("bigman.urdf");
+    testBatchConsistencyAllRepresentations("icub_skin_frames.urdf");
+
+    return EXIT_SUCCESS;
+}
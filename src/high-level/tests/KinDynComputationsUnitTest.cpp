@@ -24,6 +24,8 @@
 #include <iDynTree/Model/Model.h>
 #include <iDynTree/Model/JointState.h>
 #include <iDynTree/Model/FreeFloatingState.h>
+#include <algorithm>
+#include <vector>
 
 using namespace iDynTree;
 
@@ -225,6 +227,225 @@ void testInverseDynamics(KinDynComputations & dynComp)
     }
 }
 
+void testGeneralizedGravityForces(KinDynComputations & dynComp)
+{
+    size_t dofs = dynComp.getNrOfDegreesOfFreedom();
+    Transform world_T_base;
+    Twist baseVel;
+    Vector3 gravity;
+    VectorDynSize qj(dofs), dqj(dofs);
+    dynComp.getRobotState(world_T_base,qj,baseVel,dqj,gravity);
+
+    FreeFloatingGeneralizedTorques gravityForces(dynComp.model());
+    bool ok = dynComp.generalizedGravityForces(gravityForces);
+    ASSERT_IS_TRUE(ok);
+
+    // With zero velocities, the bias forces (computed with the RNEA) are the gravity forces
+    Twist zeroBaseVel;
+    zeroBaseVel.zero();
+    VectorDynSize zeroDqj(dofs);
+    zeroDqj.zero();
+    ASSERT_IS_TRUE(dynComp.setRobotState(world_T_base,qj,zeroBaseVel,zeroDqj,gravity));
+
+    FreeFloatingGeneralizedTorques rneaGravityForces(dynComp.model());
+    ok = dynComp.generalizedBiasForces(rneaGravityForces);
+    ASSERT_IS_TRUE(ok);
+
+    ASSERT_EQUAL_SPATIAL_FORCE(gravityForces.baseWrench(),rneaGravityForces.baseWrench());
+    ASSERT_EQUAL_VECTOR(gravityForces.jointTorques(),rneaGravityForces.jointTorques());
+
+    ASSERT_IS_TRUE(dynComp.setRobotState(world_T_base,qj,baseVel,dqj,gravity));
+}
+
+void testForwardDynamics(KinDynComputations & dynComp)
+{
+    int dofs = dynComp.getNrOfDegreesOfFreedom();
+    iDynTree::VectorDynSize jointTorques(dofs), shapeAccs(dofs);
+    iDynTree::Vector6 baseAcc;
+
+    iDynTree::LinkNetExternalWrenches netExternalWrenches(dynComp.model());
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(dynComp.getNrOfLinks()); lnk++)
+    {
+        netExternalWrenches(lnk) = getRandomWrench();
+    }
+
+    for(int i=0; i < dofs; i++)
+    {
+        jointTorques(i) = random_double();
+    }
+
+    bool ok = dynComp.forwardDynamics(jointTorques,netExternalWrenches,baseAcc,shapeAccs);
+    ASSERT_IS_TRUE(ok);
+
+    // The inverse dynamics of the forward dynamics output should give back
+    // the input joint torques and a zero base wrench
+    FreeFloatingGeneralizedTorques invDynForces(dynComp.model());
+    ok = dynComp.inverseDynamics(baseAcc,shapeAccs,netExternalWrenches,invDynForces);
+    ASSERT_IS_TRUE(ok);
+
+    // The round trip error grows with the magnitude of the forces acting on the model,
+    // so the tolerance is relative to the input forces and to the bias forces
+    FreeFloatingGeneralizedTorques biasForces(dynComp.model());
+    ok = dynComp.generalizedBiasForces(biasForces);
+    ASSERT_IS_TRUE(ok);
+    double forcesMagnitude = toEigen(jointTorques).norm()
+                             + toEigen(biasForces.baseWrench()).norm()
+                             + toEigen(biasForces.jointTorques()).norm();
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(dynComp.getNrOfLinks()); lnk++)
+    {
+        forcesMagnitude += toEigen(netExternalWrenches(lnk)).norm();
+    }
+    double tol = 1e-8*std::max(1.0,forcesMagnitude);
+
+    Vector6 zeroWrench;
+    zeroWrench.zero();
+    ASSERT_EQUAL_VECTOR_TOL(invDynForces.baseWrench().asVector(),zeroWrench,tol);
+    ASSERT_EQUAL_VECTOR_TOL(invDynForces.jointTorques(),jointTorques,tol);
+}
+
+void getInverseDynamicsAsVector(KinDynComputations & dynComp,
+                                const Vector6 & baseAcc,
+                                const VectorDynSize & shapeAccs,
+                                const LinkNetExternalWrenches & netExternalWrenches,
+                                      VectorDynSize & generalizedTorques)
+{
+    int dofs = dynComp.getNrOfDegreesOfFreedom();
+    FreeFloatingGeneralizedTorques invDynForces(dynComp.model());
+    bool ok = dynComp.inverseDynamics(baseAcc,shapeAccs,netExternalWrenches,invDynForces);
+    ASSERT_IS_TRUE(ok);
+
+    generalizedTorques.resize(6+dofs);
+    toEigen(generalizedTorques).segment<6>(0) = toEigen(invDynForces.baseWrench());
+    toEigen(generalizedTorques).segment(6,dofs) = toEigen(invDynForces.jointTorques());
+}
+
+void testInverseDynamicsDerivatives(KinDynComputations & dynComp)
+{
+    int dofs = dynComp.getNrOfDegreesOfFreedom();
+    FrameVelocityRepresentation repr = dynComp.getFrameVelocityRepresentation();
+
+    Vector6 baseAcc;
+    VectorDynSize shapeAccs(dofs);
+    LinkNetExternalWrenches netExternalWrenches(dynComp.model());
+    for(int i=0; i < 6; i++)
+    {
+        baseAcc(i) = random_double();
+    }
+    for(int i=0; i < dofs; i++)
+    {
+        shapeAccs(i) = random_double();
+    }
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(dynComp.getNrOfLinks()); lnk++)
+    {
+        netExternalWrenches(lnk) = getRandomWrench();
+    }
+
+    MatrixDynSize dTau_dq, dTau_dnu, dTau_dnudot;
+    bool ok = dynComp.inverseDynamicsDerivatives(baseAcc,shapeAccs,netExternalWrenches,dTau_dq,dTau_dnu,dTau_dnudot);
+    ASSERT_IS_TRUE(ok);
+
+    // Compare with the central finite differences of inverseDynamics
+    Transform world_T_base;
+    Twist baseVel;
+    Vector3 gravity;
+    VectorDynSize qj(dofs), dqj(dofs);
+    dynComp.getRobotState(world_T_base,qj,baseVel,dqj,gravity);
+
+    const double h = 1e-6;
+    MatrixDynSize dTau_dqNum(6+dofs,6+dofs), dTau_dnuNum(6+dofs,6+dofs), dTau_dnudotNum(6+dofs,6+dofs);
+    VectorDynSize tau[2];
+
+    for(int col=0; col < 6+dofs; col++)
+    {
+        // Derivative with respect to the robot position
+        for(int i=0; i < 2; i++)
+        {
+            double delta = (i == 0) ? h : -h;
+            Transform world_T_basePert = world_T_base;
+            VectorDynSize qjPert = qj;
+
+            if( col < 6 )
+            {
+                Vector6 deltaVec;
+                deltaVec.zero();
+                deltaVec(col) = delta;
+                Twist deltaTwist;
+                fromEigen(deltaTwist,toEigen(deltaVec));
+
+                if( repr == BODY_FIXED_REPRESENTATION )
+                {
+                    world_T_basePert = world_T_base*deltaTwist.exp();
+                }
+                else if( repr == INERTIAL_FIXED_REPRESENTATION )
+                {
+                    world_T_basePert = deltaTwist.exp()*world_T_base;
+                }
+                else
+                {
+                    world_T_basePert = Transform(deltaTwist.exp().getRotation()*world_T_base.getRotation(),
+                                                 world_T_base.getPosition()+deltaTwist.exp().getPosition());
+                }
+            }
+            else
+            {
+                qjPert(col-6) += delta;
+            }
+
+            ASSERT_IS_TRUE(dynComp.setRobotState(world_T_basePert,qjPert,baseVel,dqj,gravity));
+            getInverseDynamicsAsVector(dynComp,baseAcc,shapeAccs,netExternalWrenches,tau[i]);
+        }
+        toEigen(dTau_dqNum).col(col) = (toEigen(tau[0])-toEigen(tau[1]))/(2*h);
+
+        // Derivative with respect to the robot velocity
+        for(int i=0; i < 2; i++)
+        {
+            double delta = (i == 0) ? h : -h;
+            Twist baseVelPert = baseVel;
+            VectorDynSize dqjPert = dqj;
+
+            if( col < 6 )
+            {
+                Vector6 baseVelVec = baseVel.asVector();
+                baseVelVec(col) += delta;
+                fromEigen(baseVelPert,toEigen(baseVelVec));
+            }
+            else
+            {
+                dqjPert(col-6) += delta;
+            }
+
+            ASSERT_IS_TRUE(dynComp.setRobotState(world_T_base,qj,baseVelPert,dqjPert,gravity));
+            getInverseDynamicsAsVector(dynComp,baseAcc,shapeAccs,netExternalWrenches,tau[i]);
+        }
+        toEigen(dTau_dnuNum).col(col) = (toEigen(tau[0])-toEigen(tau[1]))/(2*h);
+
+        // Derivative with respect to the robot acceleration
+        ASSERT_IS_TRUE(dynComp.setRobotState(world_T_base,qj,baseVel,dqj,gravity));
+        for(int i=0; i < 2; i++)
+        {
+            double delta = (i == 0) ? h : -h;
+            Vector6 baseAccPert = baseAcc;
+            VectorDynSize shapeAccsPert = shapeAccs;
+
+            if( col < 6 )
+            {
+                baseAccPert(col) += delta;
+            }
+            else
+            {
+                shapeAccsPert(col-6) += delta;
+            }
+
+            getInverseDynamicsAsVector(dynComp,baseAccPert,shapeAccsPert,netExternalWrenches,tau[i]);
+        }
+        toEigen(dTau_dnudotNum).col(col) = (toEigen(tau[0])-toEigen(tau[1]))/(2*h);
+    }
+
+    ASSERT_EQUAL_MATRIX_TOL(dTau_dq,dTau_dqNum,1e-4);
+    ASSERT_EQUAL_MATRIX_TOL(dTau_dnu,dTau_dnuNum,1e-4);
+    ASSERT_EQUAL_MATRIX_TOL(dTau_dnudot,dTau_dnudotNum,1e-4);
+}
+
 void testRelativeJacobians(KinDynComputations & dynComp)
 {
     if (dynComp.getNrOfLinks() < 2) return;
@@ -355,6 +576,147 @@ void testAbsoluteJacobiansAndFrameBiasAcc(KinDynComputations & dynComp)
     ASSERT_EQUAL_VECTOR(frameAcc, frameAccJac);
 }
 
+void testStackedJacobians(KinDynComputations & dynComp)
+{
+    size_t dofs = dynComp.getNrOfDegreesOfFreedom();
+
+    // Random frames, with at least a repeated frame
+    std::vector<FrameIndex> frames;
+    for(int i=0; i < 5; i++)
+    {
+        frames.push_back(real_random_int(0, dynComp.getNrOfFrames()));
+    }
+    frames.push_back(frames[0]);
+
+    MatrixDynSize stackedJacobians;
+    ASSERT_IS_TRUE(dynComp.getFrameFreeFloatingJacobians(frames,stackedJacobians));
+    ASSERT_EQUAL_DOUBLE(stackedJacobians.rows(),6*frames.size());
+    ASSERT_EQUAL_DOUBLE(stackedJacobians.cols(),6+dofs);
+
+    MatrixDynSize jac(6,6+dofs), stackedJac(6,6+dofs);
+    for(size_t i=0; i < frames.size(); i++)
+    {
+        ASSERT_IS_TRUE(dynComp.getFrameFreeFloatingJacobian(frames[i],jac));
+        toEigen(stackedJac) = toEigen(stackedJacobians).block(6*i,0,6,6+dofs);
+        ASSERT_EQUAL_MATRIX(jac,stackedJac);
+    }
+
+    // Check the version that takes the frame names
+    std::vector<std::string> frameNames;
+    for(size_t i=0; i < frames.size(); i++)
+    {
+        frameNames.push_back(dynComp.getFrameName(frames[i]));
+    }
+
+    MatrixDynSize stackedJacobiansFromNames;
+    ASSERT_IS_TRUE(dynComp.getFrameFreeFloatingJacobians(frameNames,stackedJacobiansFromNames));
+    ASSERT_EQUAL_MATRIX(stackedJacobians,stackedJacobiansFromNames);
+}
+
+void testCompressedColumnJacobian(KinDynComputations & dynComp)
+{
+    FrameIndex frame = real_random_int(0, dynComp.getNrOfFrames());
+
+    FrameFreeFloatingJacobian jac(dynComp.model());
+    MatrixDynSize compressedJacDense, pattern;
+    CompressedColumnJacobian compressedJac;
+    ASSERT_IS_TRUE(dynComp.getFrameFreeFloatingJacobian(frame,jac));
+    ASSERT_IS_TRUE(dynComp.getFrameFreeFloatingJacobian(frame,compressedJac));
+    compressedJac.toDense(compressedJacDense);
+    ASSERT_EQUAL_MATRIX(jac,compressedJacDense);
+
+    // The nonzero columns are the ones of the sparsity pattern
+    ASSERT_IS_TRUE(dynComp.getFrameFreeFloatingJacobianSparsityPattern(frame,pattern));
+    for (size_t col = 0; col < pattern.cols(); col++)
+    {
+        bool isNonZeroColumn = std::binary_search(compressedJac.getNonZeroColumns().begin(),
+                                                  compressedJac.getNonZeroColumns().end(),
+                                                  static_cast<int>(col));
+        ASSERT_IS_TRUE(isNonZeroColumn == !toEigen(pattern).col(col).isZero());
+    }
+}
+
+void testMatrixViewAndSpanOverloads(KinDynComputations & dynComp)
+{
+    typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> RowMajorMatrix;
+    typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::ColMajor> ColMajorMatrix;
+
+    int dofs = dynComp.getNrOfDegreesOfFreedom();
+    FrameIndex frame = real_random_int(0, dynComp.getNrOfFrames());
+
+    // Jacobian
+    MatrixDynSize jac(6,6+dofs);
+    RowMajorMatrix jacRowMajor(6,6+dofs);
+    ColMajorMatrix jacColMajor(6,6+dofs);
+    ASSERT_IS_TRUE(dynComp.getFrameFreeFloatingJacobian(frame,jac));
+    ASSERT_IS_TRUE(dynComp.getFrameFreeFloatingJacobian(frame,MatrixView<double>(jacRowMajor)));
+    ASSERT_IS_TRUE(dynComp.getFrameFreeFloatingJacobian(frame,MatrixView<double>(jacColMajor)));
+    ASSERT_IS_TRUE(toEigen(jac).isApprox(jacRowMajor));
+    ASSERT_IS_TRUE(toEigen(jac).isApprox(jacColMajor));
+
+    // A view of the wrong size is rejected
+    ColMajorMatrix wrongSize(6,5+dofs);
+    ASSERT_IS_FALSE(dynComp.getFrameFreeFloatingJacobian(frame,MatrixView<double>(wrongSize)));
+
+    // Mass matrix
+    MatrixDynSize massMatrix(6+dofs,6+dofs);
+    ColMajorMatrix massMatrixColMajor(6+dofs,6+dofs);
+    ASSERT_IS_TRUE(dynComp.getFreeFloatingMassMatrix(massMatrix));
+    ASSERT_IS_TRUE(dynComp.getFreeFloatingMassMatrix(MatrixView<double>(massMatrixColMajor)));
+    ASSERT_IS_TRUE(toEigen(massMatrix).isApprox(massMatrixColMajor));
+
+    // Center of mass and centroidal average velocity jacobians
+    MatrixDynSize comJac(3,6+dofs), centroidalJac(6,6+dofs);
+    ColMajorMatrix comJacColMajor(3,6+dofs), centroidalJacColMajor(6,6+dofs);
+    ASSERT_IS_TRUE(dynComp.getCenterOfMassJacobian(comJac));
+    ASSERT_IS_TRUE(dynComp.getCenterOfMassJacobian(MatrixView<double>(comJacColMajor)));
+    ASSERT_IS_TRUE(toEigen(comJac).isApprox(comJacColMajor));
+    ASSERT_IS_TRUE(dynComp.getCentroidalAverageVelocityJacobian(centroidalJac));
+    ASSERT_IS_TRUE(dynComp.getCentroidalAverageVelocityJacobian(MatrixView<double>(centroidalJacColMajor)));
+    ASSERT_IS_TRUE(toEigen(centroidalJac).isApprox(centroidalJacColMajor));
+
+    // Inverse dynamics
+    Vector6 baseAcc;
+    VectorDynSize shapeAccs(dofs);
+    getRandomVector(baseAcc);
+    getRandomVector(shapeAccs);
+    LinkNetExternalWrenches netExternalWrenches(dynComp.model());
+    netExternalWrenches.zero();
+    FreeFloatingGeneralizedTorques invDynForces(dynComp.model());
+    ASSERT_IS_TRUE(dynComp.inverseDynamics(baseAcc,shapeAccs,netExternalWrenches,invDynForces));
+
+    std::vector<double> baseAccStd(baseAcc.data(),baseAcc.data()+6);
+    Eigen::VectorXd shapeAccsEigen = toEigen(shapeAccs);
+    Eigen::VectorXd invDynForcesEigen(6+dofs);
+    ASSERT_IS_TRUE(dynComp.inverseDynamics(make_span(baseAccStd),make_span(shapeAccsEigen.data(),dofs),
+                                           netExternalWrenches,make_span(invDynForcesEigen.data(),6+dofs)));
+    ASSERT_IS_TRUE(toEigen(invDynForces.baseWrench().getLinearVec3()).isApprox(invDynForcesEigen.segment<3>(0)));
+    ASSERT_IS_TRUE(toEigen(invDynForces.baseWrench().getAngularVec3()).isApprox(invDynForcesEigen.segment<3>(3)));
+    if( dofs > 0 )
+    {
+        ASSERT_IS_TRUE(toEigen(invDynForces.jointTorques()).isApprox(invDynForcesEigen.tail(dofs)));
+    }
+
+    // Setting the state from buffers gives the same state
+    Transform world_T_base;
+    Twist baseVel;
+    Vector3 gravity;
+    VectorDynSize qj(dofs), dqj(dofs);
+    dynComp.getRobotState(world_T_base,qj,baseVel,dqj,gravity);
+
+    KinDynComputations dynCompCheck;
+    ASSERT_IS_TRUE(dynCompCheck.loadRobotModel(dynComp.model()));
+    ASSERT_IS_TRUE(dynCompCheck.setFrameVelocityRepresentation(dynComp.getFrameVelocityRepresentation()));
+    ColMajorMatrix world_T_baseColMajor = toEigen(world_T_base.asHomogeneousTransform());
+    Eigen::Matrix<double,6,1> baseVelEigen = toEigen(baseVel);
+    ASSERT_IS_TRUE(dynCompCheck.setRobotState(MatrixView<const double>(world_T_baseColMajor),make_span(qj),
+                                              make_span(baseVelEigen.data(),6),make_span(dqj),make_span(gravity)));
+    ASSERT_IS_TRUE(dynCompCheck.getFreeFloatingMassMatrix(MatrixView<double>(massMatrixColMajor)));
+    ASSERT_IS_TRUE(toEigen(massMatrix).isApprox(massMatrixColMajor));
+    ASSERT_EQUAL_VECTOR(dynComp.getBaseTwist().asVector(),dynCompCheck.getBaseTwist().asVector());
+    ASSERT_EQUAL_TRANSFORM(dynComp.getWorldBaseTransform(),dynCompCheck.getWorldBaseTransform());
+}
+
 void testModelConsistency(std::string modelFilePath, const FrameVelocityRepresentation frameVelRepr)
 {
     iDynTree::KinDynComputations dynComp;
@@ -371,8 +733,14 @@ void testModelConsistency(std::string modelFilePath, const FrameVelocityRepresen
         testRelativeTransform(dynComp);
         testAverageVelocityAndTotalMomentumJacobian(dynComp);
         testInverseDynamics(dynComp);
+        testGeneralizedGravityForces(dynComp);
+        testForwardDynamics(dynComp);
+        testInverseDynamicsDerivatives(dynComp);
         testRelativeJacobians(dynComp);
         testAbsoluteJacobiansAndFrameBiasAcc(dynComp);
+        testStackedJacobians(dynComp);
+        testCompressedColumnJacobian(dynComp);
+        testMatrixViewAndSpanOverloads(dynComp);
     }
 
 }
@@ -389,6 +757,156 @@ void testModelConsistencyAllRepresentations(std::string modelName)
     testModelConsistency(urdfFileName,iDynTree::INERTIAL_FIXED_REPRESENTATION);
 }
 
+void checkSameCachedQuantities(KinDynComputations & dynComp, KinDynComputations & dynCompCheck)
+{
+    size_t dofs = dynComp.getNrOfDegreesOfFreedom();
+
+    for(FrameIndex frame=0; frame < static_cast<FrameIndex>(dynComp.getNrOfFrames()); frame++)
+    {
+        ASSERT_EQUAL_TRANSFORM(dynComp.getWorldTransform(frame),dynCompCheck.getWorldTransform(frame));
+        ASSERT_EQUAL_VECTOR(dynComp.getFrameVel(frame).asVector(),dynCompCheck.getFrameVel(frame).asVector());
+        ASSERT_EQUAL_VECTOR(dynComp.getFrameBiasAcc(frame),dynCompCheck.getFrameBiasAcc(frame));
+    }
+
+    MatrixDynSize massMatrix(6+dofs,6+dofs), massMatrixCheck(6+dofs,6+dofs);
+    ASSERT_IS_TRUE(dynComp.getFreeFloatingMassMatrix(massMatrix));
+    ASSERT_IS_TRUE(dynCompCheck.getFreeFloatingMassMatrix(massMatrixCheck));
+    ASSERT_EQUAL_MATRIX(massMatrix,massMatrixCheck);
+
+    ASSERT_EQUAL_VECTOR(dynComp.getLinearAngularMomentum().asVector(),dynCompCheck.getLinearAngularMomentum().asVector());
+    ASSERT_EQUAL_VECTOR(dynComp.getCenterOfMassPosition(),dynCompCheck.getCenterOfMassPosition());
+}
+
+void setSameState(KinDynComputations & dynComp, KinDynComputations & dynCompCheck)
+{
+    size_t dofs = dynComp.getNrOfDegreesOfFreedom();
+    Transform world_T_base;
+    Twist baseVel;
+    Vector3 gravity;
+    VectorDynSize qj(dofs), dqj(dofs);
+
+    dynComp.getRobotState(world_T_base,qj,baseVel,dqj,gravity);
+    ASSERT_IS_TRUE(dynCompCheck.setRobotState(world_T_base,qj,baseVel,dqj,gravity));
+}
+
+void testIncrementalUpdate(std::string modelFilePath, const FrameVelocityRepresentation frameVelRepr)
+{
+    KinDynComputations dynComp;
+    ASSERT_IS_TRUE(dynComp.loadRobotModelFromFile(modelFilePath));
+    ASSERT_IS_TRUE(dynComp.setFrameVelocityRepresentation(frameVelRepr));
+
+    size_t dofs = dynComp.getNrOfDegreesOfFreedom();
+    setRandomState(dynComp);
+
+    for(int i=0; i < 10; i++)
+    {
+        // Change a part of the state of dynComp, and compare the (incrementally updated)
+        // cached quantities with the one of a freshly loaded KinDynComputations object
+        Transform world_T_base;
+        Twist baseVel;
+        Vector3 gravity;
+        VectorDynSize qj(dofs), dqj(dofs);
+        dynComp.getRobotState(world_T_base,qj,baseVel,dqj,gravity);
+
+        int change = real_random_int(0,4);
+        if( change == 0 && dofs > 0 )
+        {
+            qj(real_random_int(0,dofs)) = random_double();
+        }
+        else if( change == 1 )
+        {
+            world_T_base = getRandomTransform();
+        }
+        else if( change == 2 && dofs > 0 )
+        {
+            dqj(real_random_int(0,dofs)) = random_double();
+        }
+        else
+        {
+            baseVel = getRandomTwist();
+        }
+
+        ASSERT_IS_TRUE(dynComp.setRobotState(world_T_base,qj,baseVel,dqj,gravity));
+
+        // Only update part of the quantities, to check that the changes
+        // accumulate correctly between subsequent updates
+        if( i % 2 == 0 )
+        {
+            dynComp.getWorldTransform(dynComp.getNrOfFrames()-1);
+            continue;
+        }
+
+        KinDynComputations dynCompCheck;
+        ASSERT_IS_TRUE(dynCompCheck.loadRobotModel(dynComp.model()));
+        ASSERT_IS_TRUE(dynCompCheck.setFrameVelocityRepresentation(frameVelRepr));
+        setSameState(dynComp,dynCompCheck);
+        checkSameCachedQuantities(dynComp,dynCompCheck);
+    }
+
+    // Changing the floating base changes all the cached quantities
+    std::string newFloatingBase = dynComp.model().getLinkName(real_random_int(0,dynComp.getNrOfLinks()));
+    ASSERT_IS_TRUE(dynComp.setFloatingBase(newFloatingBase));
+    KinDynComputations dynCompCheck;
+    ASSERT_IS_TRUE(dynCompCheck.loadRobotModel(dynComp.model()));
+    ASSERT_IS_TRUE(dynCompCheck.setFrameVelocityRepresentation(frameVelRepr));
+    ASSERT_IS_TRUE(dynCompCheck.setFloatingBase(newFloatingBase));
+    setSameState(dynComp,dynCompCheck);
+    checkSameCachedQuantities(dynComp,dynCompCheck);
+}
+
+void testLazyForwardKinematics(std::string modelFilePath, const FrameVelocityRepresentation frameVelRepr)
+{
+    // dynComp only computes the quantities related to the queried frames,
+    // while in dynCompCheck the whole forward kinematics is computed before each query
+    KinDynComputations dynComp, dynCompCheck;
+    ASSERT_IS_TRUE(dynComp.loadRobotModelFromFile(modelFilePath));
+    ASSERT_IS_TRUE(dynComp.setFrameVelocityRepresentation(frameVelRepr));
+    ASSERT_IS_TRUE(dynCompCheck.loadRobotModel(dynComp.model()));
+    ASSERT_IS_TRUE(dynCompCheck.setFrameVelocityRepresentation(frameVelRepr));
+
+    size_t frames = dynComp.getNrOfFrames();
+    size_t dofs = dynComp.getNrOfDegreesOfFreedom();
+
+    for(int i=0; i < 5; i++)
+    {
+        setRandomState(dynComp);
+        setSameState(dynComp,dynCompCheck);
+
+        FrameIndex refFrame = real_random_int(0,frames);
+        FrameIndex frame = real_random_int(0,frames);
+
+        MatrixDynSize relJac(6,dofs), relJacCheck(6,dofs);
+        ASSERT_IS_TRUE(dynComp.getRelativeJacobian(refFrame,frame,relJac));
+        Transform refFrame_H_frame = dynComp.getRelativeTransform(refFrame,frame);
+        Transform world_H_frame = dynComp.getWorldTransform(frame);
+        Twist frameVel = dynComp.getFrameVel(frame);
+
+        MatrixDynSize massMatrix(6+dofs,6+dofs);
+        ASSERT_IS_TRUE(dynCompCheck.getFreeFloatingMassMatrix(massMatrix));
+        ASSERT_IS_TRUE(dynCompCheck.getRelativeJacobian(refFrame,frame,relJacCheck));
+
+        ASSERT_EQUAL_MATRIX(relJac,relJacCheck);
+        ASSERT_EQUAL_TRANSFORM(refFrame_H_frame,dynCompCheck.getRelativeTransform(refFrame,frame));
+        ASSERT_EQUAL_TRANSFORM(world_H_frame,dynCompCheck.getWorldTransform(frame));
+        ASSERT_EQUAL_VECTOR(frameVel.asVector(),dynCompCheck.getFrameVel(frame).asVector());
+    }
+
+    // The forward kinematics results computed on demand are consistent with the rest of the cached quantities
+    checkSameCachedQuantities(dynComp,dynCompCheck);
+}
+
+void testIncrementalUpdateAllRepresentations(std::string modelName)
+{
+    std::string urdfFileName = getAbsModelPath(modelName);
+    std::cout << "Testing incremental and on demand updates for file " << urdfFileName <<  std::endl;
+    testIncrementalUpdate(urdfFileName,iDynTree::MIXED_REPRESENTATION);
+    testIncrementalUpdate(urdfFileName,iDynTree::BODY_FIXED_REPRESENTATION);
+    testIncrementalUpdate(urdfFileName,iDynTree::INERTIAL_FIXED_REPRESENTATION);
+    testLazyForwardKinematics(urdfFileName,iDynTree::MIXED_REPRESENTATION);
+    testLazyForwardKinematics(urdfFileName,iDynTree::BODY_FIXED_REPRESENTATION);
+    testLazyForwardKinematics(urdfFileName,iDynTree::INERTIAL_FIXED_REPRESENTATION);
+}
+
 void testRelativeJacobianSparsity(KinDynComputations & dynComp)
 {
     // take two frames
@@ -510,6 +1028,12 @@ int main()
     testSparsityPatternAllRepresentations("bigman.urdf");
     testSparsityPatternAllRepresentations("icub_skin_frames.urdf");
 
+    testIncrementalUpdateAllRepresentations("oneLink.urdf");
+    testIncrementalUpdateAllRepresentations("twoLinks.urdf");
+    testIncrementalUpdateAllRepresentations("threeLinks.urdf");
+    testIncrementalUpdateAllRepresentations("bigman.urdf");
+    testIncrementalUpdateAllRepresentations("icub_skin_frames.urdf");
+
 
 
     return EXIT_SUCCESS;
@@ -0,0 +1,341 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_COMPILED_MODEL_H
+#define IDYNTREE_COMPILED_MODEL_H
+
+#include <iDynTree/Core/Transform.h>
+#include <iDynTree/Core/SpatialMotionVector.h>
+#include <iDynTree/Core/SpatialInertia.h>
+#include <iDynTree/Core/Axis.h>
+
+#include <iDynTree/Model/Indices.h>
+#include <iDynTree/Model/LinkState.h>
+#include <iDynTree/Model/JointState.h>
+
+#include <vector>
+
+namespace iDynTree
+{
+    class Model;
+    class Traversal;
+    class VectorDynSize;
+    class MatrixDynSize;
+    class FreeFloatingPos;
+    class FreeFloatingVel;
+    class FreeFloatingAcc;
+    class FreeFloatingGeneralizedTorques;
+    class FreeFloatingMassMatrix;
+    struct ArticulatedBodyAlgorithmInternalBuffers;
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Flat ("compiled") representation of a Model visited with a given Traversal.
+     *
+     * The Model and Traversal classes represent the kinematic tree as a graph
+     * of Link and IJoint objects, and the algorithms defined in ForwardKinematics.h and
+     * Dynamics.h query it through pointers and virtual methods. This class instead
+     * stores all the information required by the recursive algorithms in contiguous
+     * arrays indexed by the traversal index: the traversal index of the parent of each link,
+     * a tag describing the type of the joint connecting each link to its parent,
+     * the rest transform and the axis of the joint, the motion subspace vector and
+     * the inertia of each link and the list of children of each link.
+     *
+     * The algorithms that take a CompiledModel as their first argument dispatch on the
+     * joint type tag, without any virtual call.
+     *
+     * The compiled representation is a snapshot of the Model and of the Traversal at the
+     * time compile was called: if the model is modified (for example because its inertial
+     * parameters are updated) or a different traversal is needed, compile needs to be called again.
+     *
+     * \note Only fixed, revolute and prismatic joints are supported. compile will return false
+     *       for models that contain other types of joints.
+     */
+    class CompiledModel
+    {
+    public:
+        /**
+         * Type of the joint connecting a link to its parent in the traversal.
+         */
+        enum JointType
+        {
+            FIXED_JOINT,
+            REVOLUTE_JOINT,
+            PRISMATIC_JOINT
+        };
+
+    private:
+        bool m_isValid;
+        size_t m_nrOfLinks;
+        size_t m_nrOfPosCoords;
+        size_t m_nrOfDOFs;
+
+        // All this vectors are indexed by the traversal index
+        std::vector<LinkIndex>      m_linkIndex;
+        std::vector<TraversalIndex> m_parent;
+        std::vector<JointType>      m_jointType;
+        std::vector<size_t>         m_posCoordsOffset;
+        std::vector<size_t>         m_DOFsOffset;
+        std::vector<Transform>      m_parent_X_link_at_rest;
+        std::vector<Axis>           m_axisInLinkFrame;
+        std::vector<SpatialMotionVector> m_motionSubspace;
+        std::vector<SpatialInertia> m_inertia;
+
+        // The children of the traversalIndex-th link are the elements of m_children
+        // in the range [m_childrenBegin[traversalIndex], m_childrenBegin[traversalIndex+1])
+        std::vector<size_t>         m_childrenBegin;
+        std::vector<TraversalIndex> m_children;
+
+        // Indexed by the link index, TRAVERSAL_INVALID_INDEX for links not visited by the traversal
+        std::vector<TraversalIndex> m_traversalIndex;
+
+    public:
+        /**
+         * Constructor, the resulting CompiledModel is not valid until compile is called.
+         */
+        CompiledModel();
+
+        /**
+         * Constructor, equivalent to call compile(model,traversal).
+         */
+        CompiledModel(const Model & model, const Traversal & traversal);
+
+        /**
+         * Build the compiled representation of the model, for the given traversal.
+         *
+         * @return true if all went well, false otherwise (for example if the model contains unsupported joints).
+         */
+        bool compile(const Model & model, const Traversal & traversal);
+
+        /**
+         * Return true if compile was called successfully, false otherwise.
+         */
+        bool isValid() const;
+
+        /**
+         * Number of links of the compiled model (i.e. the size of the link arrays used by the algorithms).
+         */
+        size_t getNrOfLinks() const;
+
+        /**
+         * Number of links visited by the compiled traversal.
+         */
+        size_t getNrOfVisitedLinks() const;
+
+        /**
+         * Number of position coordinates of the compiled model.
+         */
+        size_t getNrOfPosCoords() const;
+
+        /**
+         * Number of (internal) degrees of freedom of the compiled model.
+         */
+        size_t getNrOfDOFs() const;
+
+        /**
+         * Get the link index of the traversalIndex-th link of the traversal.
+         */
+        LinkIndex getLinkIndex(const TraversalIndex traversalIndex) const;
+
+        /**
+         * Get the traversal index of a link, or TRAVERSAL_INVALID_INDEX
+         * if the link is not visited by the compiled traversal.
+         */
+        TraversalIndex getTraversalIndexFromLinkIndex(const LinkIndex linkIndex) const;
+
+        /**
+         * Get the traversal index of the parent of the traversalIndex-th link,
+         * or TRAVERSAL_INVALID_INDEX for the base of the traversal.
+         */
+        TraversalIndex getParent(const TraversalIndex traversalIndex) const;
+
+        /**
+         * Get the type of the joint connecting the traversalIndex-th link to its parent.
+         */
+        JointType getJointType(const TraversalIndex traversalIndex) const;
+
+        /**
+         * Get the number of degrees of freedom of the joint connecting the traversalIndex-th link to its parent.
+         */
+        unsigned int getNrOfDOFs(const TraversalIndex traversalIndex) const;
+
+        /**
+         * Get the offset of the position coordinate of the joint connecting the traversalIndex-th link to its parent.
+         */
+        size_t getPosCoordsOffset(const TraversalIndex traversalIndex) const;
+
+        /**
+         * Get the offset of the dof of the joint connecting the traversalIndex-th link to its parent.
+         */
+        size_t getDOFsOffset(const TraversalIndex traversalIndex) const;
+
+        /**
+         * Get the parent_X_link transform of the traversalIndex-th link, when the joint position is 0.
+         */
+        const Transform & getRestTransform(const TraversalIndex traversalIndex) const;
+
+        /**
+         * Get the axis of the joint connecting the traversalIndex-th link to its parent,
+         * expressed in the link frame (with the link considered as "child").
+         */
+        const Axis & getAxis(const TraversalIndex traversalIndex) const;
+
+        /**
+         * Get the motion subspace vector of the joint connecting the traversalIndex-th
+         * link to its parent, expressed in the link frame.
+         */
+        const SpatialMotionVector & getMotionSubspaceVector(const TraversalIndex traversalIndex) const;
+
+        /**
+         * Get the inertia of the traversalIndex-th link.
+         */
+        const SpatialInertia & getInertia(const TraversalIndex traversalIndex) const;
+
+        /**
+         * Get the number of children of the traversalIndex-th link.
+         */
+        size_t getNrOfChildren(const TraversalIndex traversalIndex) const;
+
+        /**
+         * Get the traversal index of the child_i-th children of the traversalIndex-th link.
+         */
+        TraversalIndex getChild(const TraversalIndex traversalIndex, const size_t child_i) const;
+
+        /**
+         * Compute the parent_X_link transform of the traversalIndex-th link, given the
+         * vector of the joint positions.
+         */
+        void computeParentTransform(const TraversalIndex traversalIndex,
+                                    const VectorDynSize & jointPos,
+                                          Transform & parent_X_link) const;
+    };
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Compute for each link visited by the compiled traversal the parent_X_link transform.
+     *
+     * The computed transforms are the input of all the other algorithms that take a CompiledModel,
+     * so that they can be computed once for a given joint configuration and used by several algorithms.
+     * For the base of the traversal the identity transform is returned.
+     *
+     * @param[in]  compiledModel the used compiled model,
+     * @param[in]  jointPos the vector of (internal) joint positions,
+     * @param[out] parent_X_links parent_X_links(l) contains the parent_X_link transform.
+     * @return true if all went well, false otherwise.
+     */
+    bool ComputeJointTransforms(const CompiledModel & compiledModel,
+                                const VectorDynSize & jointPos,
+                                      LinkPositions & parent_X_links);
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Variant of ForwardPositionKinematics that uses a CompiledModel.
+     *
+     * @param[in]  compiledModel the used compiled model,
+     * @param[in]  parent_X_links the parent_X_link transforms computed by ComputeJointTransforms,
+     * @param[in]  worldHbase the world_H_base transform,
+     * @param[out] linkPositions linkPositions(l) contains the world_H_link transform.
+     * @return true if all went well, false otherwise.
+     */
+    bool ForwardPositionKinematics(const CompiledModel & compiledModel,
+                                   const LinkPositions & parent_X_links,
+                                   const Transform & worldHbase,
+                                         LinkPositions & linkPositions);
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Variant of ForwardPosVelKinematics that uses a CompiledModel.
+     */
+    bool ForwardPosVelKinematics(const CompiledModel & compiledModel,
+                                 const LinkPositions & parent_X_links,
+                                 const FreeFloatingPos & robotPos,
+                                 const FreeFloatingVel & robotVel,
+                                       LinkPositions & linkPos,
+                                       LinkVelArray & linkVel);
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Variant of ForwardVelAccKinematics that uses a CompiledModel.
+     */
+    bool ForwardVelAccKinematics(const CompiledModel & compiledModel,
+                                 const LinkPositions & parent_X_links,
+                                 const FreeFloatingVel & robotVel,
+                                 const FreeFloatingAcc & robotAcc,
+                                       LinkVelArray & linkVel,
+                                       LinkAccArray & linkAcc);
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Variant of RNEADynamicPhase that uses a CompiledModel.
+     *
+     * The children of each link are obtained from the precomputed children ranges
+     * of the CompiledModel, instead of scanning the neighbors of the link in the Model.
+     */
+    bool RNEADynamicPhase(const CompiledModel & compiledModel,
+                          const LinkPositions & parent_X_links,
+                          const LinkVelArray & linksVel,
+                          const LinkAccArray & linksAcc,
+                          const LinkNetExternalWrenches & linkExtForces,
+                                LinkInternalWrenches & linkIntWrenches,
+                                FreeFloatingGeneralizedTorques & baseForceAndJointTorques);
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Variant of CompositeRigidBodyAlgorithm that uses a CompiledModel.
+     */
+    bool CompositeRigidBodyAlgorithm(const CompiledModel & compiledModel,
+                                     const LinkPositions & parent_X_links,
+                                           LinkCompositeRigidBodyInertias & linkCRBs,
+                                           FreeFloatingMassMatrix & massMatrix);
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Variant of ArticulatedBodyAlgorithm that uses a CompiledModel.
+     *
+     * The buffers need to be resized with the Model that was used to build compiledModel.
+     */
+    bool ArticulatedBodyAlgorithm(const CompiledModel & compiledModel,
+                                  const LinkPositions & parent_X_links,
+                                  const FreeFloatingVel & robotVel,
+                                  const LinkNetExternalWrenches & linkExtWrenches,
+                                  const JointDOFsDoubleArray & jointTorques,
+                                        ArticulatedBodyAlgorithmInternalBuffers & buffers,
+                                        FreeFloatingAcc & robotAcc);
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Variant of FreeFloatingJacobianUsingLinkPos that uses a CompiledModel.
+     *
+     * @param[in]  compiledModel the used compiled model,
+     * @param[in]  world_H_links the world_H_link transforms computed by ForwardPositionKinematics,
+     * @param[in]  jacobianLinkIndex the link whose velocity is described by the jacobian,
+     * @param[in]  jacobFrame_X_world the transform between the world and the frame in which the jacobian is expressed,
+     * @param[in]  baseFrame_X_jacobBaseFrame the transform used to account for the representation of the base velocity,
+     * @param[out] jacobian the 6 x (6+nrOfDOFs) jacobian.
+     * @return true if all went well, false otherwise.
+     */
+    bool FreeFloatingJacobianUsingLinkPos(const CompiledModel & compiledModel,
+                                          const LinkPositions & world_H_links,
+                                          const LinkIndex jacobianLinkIndex,
+                                          const Transform & jacobFrame_X_world,
+                                          const Transform & baseFrame_X_jacobBaseFrame,
+                                                MatrixDynSize & jacobian);
+}
+
+#endif
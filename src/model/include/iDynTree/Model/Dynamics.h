@@ -82,6 +82,75 @@ namespace iDynTree
                                      FreeFloatingMassMatrix& massMatrix);
 
 
+    /**
+     * Structure of buffers required by ComputeGeneralizedGravityForces.
+     *
+     * A convenient resize(Model) function is provided to automatically resize
+     * the buffers given a Model.
+     */
+    struct GeneralizedGravityForcesInternalBuffers
+    {
+        GeneralizedGravityForcesInternalBuffers() {};
+
+        /**
+         * Call resize(model);
+         */
+        GeneralizedGravityForcesInternalBuffers(const Model & model);
+
+        /**
+         * Resize all the buffers to the right size given the model,
+         * and reset all the buffers to 0.
+         */
+        void resize(const Model& model);
+
+        /**
+         * Check if the dimension of the buffer is consistent
+         * with a model (it should be after a call to resize(model) ).
+         */
+        bool isConsistent(const Model& model);
+
+        /**
+         * subtreeMasses(l) is the total mass of the subtree starting at link l.
+         */
+        VectorDynSize subtreeMasses;
+
+        /**
+         * Elements 3*l, 3*l+1 and 3*l+2 contain the first moment of mass
+         * (mass times center of mass) of the subtree starting at link l, expressed in the world frame.
+         */
+        VectorDynSize subtreeFirstMoments;
+    };
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Compute the generalized gravity forces of a robot, i.e. the generalized
+     * forces returned by the RNEA with zero velocities, zero joint accelerations,
+     * no external wrenches and the base accelerating with the opposite of the gravity.
+     *
+     * Instead of propagating accelerations and link wrenches, the function
+     * accumulates for each link the mass and the first moment of mass of its subtree,
+     * as the gravity wrench of a subtree only depends on them. This only requires
+     * the link positions (as computed by ForwardPositionKinematics) and it is O(n).
+     *
+     * @param[in]  model the used model,
+     * @param[in]  traversal the traversal used for the computation, its base is the floating base,
+     * @param[in]  jointPos the joint positions,
+     * @param[in]  linkPositions linkPositions(l) contains the world_H_link transform,
+     * @param[in]  gravity the gravity acceleration, expressed in the world frame,
+     * @param      buffers the internal buffers used by the algorithm,
+     * @param[out] generalizedGravityForces the joint torques and the base wrench (expressed in the base frame)
+     *                                      that compensate the gravity.
+     * @return true if all went well, false otherwise.
+     */
+    bool ComputeGeneralizedGravityForces(const Model& model,
+                                         const Traversal& traversal,
+                                         const JointPosDoubleArray& jointPos,
+                                         const LinkPositions& linkPositions,
+                                         const Vector3& gravity,
+                                               GeneralizedGravityForcesInternalBuffers& buffers,
+                                               FreeFloatingGeneralizedTorques& generalizedGravityForces);
+
     /**
      * Structure of buffers required by ArticulatedBodyAlgorithm.
      *
@@ -122,6 +191,7 @@ namespace iDynTree
         LinkAccArray linksAccelerations;
         LinkArticulatedBodyInertias linkABIs;
         LinkWrenches linksBiasWrench;
+        LinkPositions parent_X_links;
 
         // Debug quantity
         //LinkWrenches pa;
@@ -143,6 +213,24 @@ namespace iDynTree
                                         ArticulatedBodyAlgorithmInternalBuffers & buffers,
                                         FreeFloatingAcc & robotAcc);
 
+    /**
+     * Variant of ArticulatedBodyAlgorithm that uses the link positions
+     * computed by the forward kinematics, instead of the joint positions.
+     *
+     * The transforms between each link and its parent are obtained from the
+     * link positions, so the transforms of the joints are not computed again.
+     *
+     * @param[in] linkPositions the world_H_link transforms, for example computed by ForwardPositionKinematics.
+     */
+    bool ArticulatedBodyAlgorithm(const Model& model,
+                                  const Traversal& traversal,
+                                  const LinkPositions& linkPositions,
+                                  const FreeFloatingVel& robotVel,
+                                  const LinkNetExternalWrenches & linkExtWrenches,
+                                  const JointDOFsDoubleArray & jointTorques,
+                                        ArticulatedBodyAlgorithmInternalBuffers & buffers,
+                                        FreeFloatingAcc & robotAcc);
+
 
 
 }
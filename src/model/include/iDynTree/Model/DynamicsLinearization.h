@@ -13,9 +13,14 @@
 
 #include <iDynTree/Core/MatrixFixSize.h>
 #include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/VectorFixSize.h>
 
 #include <iDynTree/Model/Dynamics.h>
 #include <iDynTree/Model/DynamicsLinearizationHelpers.h>
+#include <iDynTree/Model/FreeFloatingMatrices.h>
+#include <iDynTree/Model/FreeFloatingState.h>
+
+#include <vector>
 
 namespace iDynTree
 {
@@ -103,6 +108,108 @@ namespace iDynTree
                                             FreeFloatingAcc & robotAcc,
                                             FreeFloatingStateLinearization & A);
 
+    /**
+     * Structure containing the internal buffers used
+     * by the InverseDynamicsDerivatives function.
+     */
+    struct InverseDynamicsDerivativesInternalBuffers
+    {
+        InverseDynamicsDerivativesInternalBuffers() {};
+
+        /**
+         * Call resize(model);
+         */
+        InverseDynamicsDerivativesInternalBuffers(const Model & model);
+
+        /**
+         * Resize all the buffers to the right size given the model,
+         * and reset all the buffers to 0.
+         */
+        void resize(const Model& model);
+
+        /**
+         * Buffers used for computing the RNEA algorithm,
+         * i.e. ForwardVelAccKinematics and RNEADynamicPhase.
+         */
+        FreeFloatingAcc properAcc;
+        LinkVelArray linksVel;
+        LinkAccArray linksProperAcc;
+        LinkInternalWrenches linksIntWrenches;
+        FreeFloatingGeneralizedTorques generalizedTorques;
+
+        /**
+         * For each link, the adjoint matrix link_X_parent
+         * and the 6x6 matrix of the spatial inertia.
+         */
+        std::vector<Matrix6x6> link_X_parent;
+        std::vector<Matrix6x6> linkInertia;
+
+        /**
+         * For each link, the derivative of the bias wrench \f$ v \bar\times^* M v \f$
+         * with respect to the link velocity, and the derivative of the external wrench
+         * with respect to the link velocity, given the frame in which the
+         * external wrench is assumed constant.
+         */
+        std::vector<Matrix6x6> dVl_linkLocalBiasWrench;
+        std::vector<Matrix6x6> dVl_linkExtWrench;
+
+        /**
+         * Derivatives of the link velocities, proper accelerations and internal wrenches
+         * with respect to the generalized coordinate, velocity and acceleration considered in
+         * the current iteration of the algorithm.
+         */
+        std::vector<bool> isLinkInSubtree;
+        std::vector<Vector6> dPos_linksVel;
+        std::vector<Vector6> dPos_linksAcc;
+        std::vector<Vector6> dPos_linksWrench;
+        std::vector<Vector6> dVel_linksVel;
+        std::vector<Vector6> dVel_linksAcc;
+        std::vector<Vector6> dVel_linksWrench;
+        std::vector<Vector6> dAcc_linksAcc;
+        std::vector<Vector6> dAcc_linksWrench;
+    };
+
+    /**
+     * Compute the derivatives of the inverse dynamics (RNEA) with respect to
+     * the robot position, velocity and acceleration.
+     *
+     * The base velocity and acceleration in input (and the base wrench in output) are expressed
+     * in the body-fixed (left-trivialized) representation, and
+     * robotAcc is the acceleration of the robot, i.e. without gravity contribution, that is
+     * instead given by the world gravity vector. The derivatives with respect to the base position are
+     * left-trivialized, i.e. the i-th column of dTau_dq is the derivative of the inverse dynamics
+     * along the position variation obtained moving the robot with the (body-fixed) generalized velocity \f$ e_i \f$.
+     *
+     * The external wrenches are expressed in the link frames. For the derivative with respect to the robot position,
+     * they are assumed constant in the link frame (BODY_FIXED_REPRESENTATION), in the inertial frame (INERTIAL_FIXED_REPRESENTATION)
+     * or in the frame with the origin of the link and the orientation of the inertial frame (MIXED_REPRESENTATION),
+     * depending on linkExtWrenchesRepr.
+     *
+     * The derivatives are computed with one forward and one backward pass on the model for each
+     * column of the output matrices, in which only the quantities that depend on the
+     * considered variable are propagated, for a total cost of \f$ O(n^2) \f$.
+     *
+     * \note Only models with joints with 0 or 1 degrees of freedom are supported.
+     *
+     * @param[out] dTau_dq the (6+n)x(6+n) derivative of the generalized torques with respect to the robot position.
+     * @param[out] dTau_dnu the (6+n)x(6+n) derivative of the generalized torques with respect to the robot velocity.
+     * @param[out] dTau_dnudot the (6+n)x(6+n) derivative of the generalized torques with respect to the robot acceleration
+     *                         (i.e. the free floating mass matrix).
+     * @return true if all went well, false otherwise.
+     */
+    bool InverseDynamicsDerivatives(const Model& model,
+                                    const Traversal& traversal,
+                                    const FreeFloatingPos& robotPos,
+                                    const FreeFloatingVel& robotVel,
+                                    const FreeFloatingAcc& robotAcc,
+                                    const Vector3& worldGravity,
+                                    const LinkNetExternalWrenches & linkExtWrenches,
+                                    const FrameVelocityRepresentation linkExtWrenchesRepr,
+                                          InverseDynamicsDerivativesInternalBuffers & bufs,
+                                          MatrixDynSize & dTau_dq,
+                                          MatrixDynSize & dTau_dnu,
+                                          MatrixDynSize & dTau_dnudot);
+
 }
 
 
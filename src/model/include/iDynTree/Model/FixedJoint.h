@@ -86,9 +86,9 @@ namespace iDynTree
 
 
         // Documentation inherited
-        virtual const Transform & getTransform(const VectorDynSize & jntPos,
-                                               const LinkIndex child,
-                                               const LinkIndex parent) const;
+        virtual Transform getTransform(const VectorDynSize & jntPos,
+                                       const LinkIndex child,
+                                       const LinkIndex parent) const;
 
         // Documentation inherited
         TransformDerivative getTransformDerivative(const VectorDynSize & jntPos,
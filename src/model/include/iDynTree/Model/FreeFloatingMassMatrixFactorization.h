@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_FREE_FLOATING_MASS_MATRIX_FACTORIZATION_H
+#define IDYNTREE_FREE_FLOATING_MASS_MATRIX_FACTORIZATION_H
+
+#include <iDynTree/Core/VectorDynSize.h>
+#include <iDynTree/Core/MatrixDynSize.h>
+
+#include <vector>
+
+namespace iDynTree
+{
+    class Model;
+    class Traversal;
+    class FreeFloatingMassMatrix;
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Sparse \f$ L^\top D L \f$ factorization of the free floating mass matrix.
+     *
+     * The mass matrix of a kinematic tree has a sparsity pattern induced by its branches:
+     * the element \f$ M_{ij} \f$ relative to two joints is different from zero only if one
+     * of the two joints is an ancestor of the other. This class implements the LTDL factorization
+     * described in Featherstone 2008, Section 6.5, that preserves this sparsity pattern, and the
+     * related products with the inverse of the mass matrix, whose cost is proportional to
+     * \f$ (6+n) d \f$, where \f$ d \f$ is the depth of the tree, instead of \f$ (6+n)^2 \f$.
+     *
+     * The 6 degrees of freedom of the floating base are handled as a chain of degrees of freedom
+     * at the root of the tree, while each joint degree of freedom has as parent the degree of freedom of the
+     * first joint (with one degree of freedom) found going from the joint towards the base in the traversal.
+     *
+     * The factorization is performed in place on the output of the CompositeRigidBodyAlgorithm:
+     * the diagonal of the factorized matrix contains \f$ D \f$, while the element \f$ (i,j) \f$ contains
+     * \f$ L_{ij} \f$ if the degree of freedom \f$ j \f$ is an ancestor of \f$ i \f$. The other elements are not modified.
+     *
+     * \note Only models with joints with 0 or 1 degrees of freedom are supported.
+     */
+    class FreeFloatingMassMatrixFactorization
+    {
+    private:
+        // Degrees of freedom (i.e. rows of the mass matrix) in the order in which they are visited
+        // by the traversal: the parent of each degree of freedom comes before it
+        std::vector<int> m_dofsVisitOrder;
+
+        // For each degree of freedom, the parent degree of freedom (-1 for the root)
+        std::vector<int> m_dofParent;
+
+        // Buffer used in computeInverseOperationalSpaceInertia
+        MatrixDynSize m_bufferMatrix;
+
+        // Compute in place D^{-1/2} L^{-T} x
+        void multiplyByInverseSquareRootInPlace(const FreeFloatingMassMatrix & factorizedMassMatrix, double * x) const;
+
+    public:
+        /**
+         * Constructor.
+         */
+        FreeFloatingMassMatrixFactorization();
+
+        /**
+         * Compute the sparsity structure of the mass matrix of a model, given the traversal
+         * used to compute it.
+         *
+         * @return true if all went well, false otherwise (for example if the model contains joints with more than 1 dof).
+         */
+        bool setTraversal(const Model & model, const Traversal & traversal);
+
+        /**
+         * Get the size (6+getNrOfDOFs()) of the mass matrix.
+         */
+        size_t getSize() const;
+
+        /**
+         * Factorize in place a mass matrix as \f$ M = L^\top D L \f$.
+         *
+         * @param[in,out] massMatrix in input the mass matrix (as computed by the CompositeRigidBodyAlgorithm),
+         *                           in output the factorized mass matrix.
+         * @return true if all went well, false otherwise.
+         */
+        bool factorize(FreeFloatingMassMatrix & massMatrix) const;
+
+        /**
+         * Compute \f$ x = M^{-1} b \f$.
+         *
+         * @param[in] factorizedMassMatrix the mass matrix factorized by factorize.
+         * @param[in] b the input vector of size getSize().
+         * @param[out] x the output vector, resized if necessary.
+         * @return true if all went well, false otherwise.
+         */
+        bool multiplyByInverse(const FreeFloatingMassMatrix & factorizedMassMatrix,
+                               const VectorDynSize & b,
+                                     VectorDynSize & x) const;
+
+        /**
+         * Compute \f$ x = M^{-1/2} b \f$, where \f$ M^{-1/2} = D^{-1/2} L^{-\top} \f$,
+         * such that \f$ M^{-1} = M^{-1/2}^\top M^{-1/2} \f$.
+         *
+         * @param[in] factorizedMassMatrix the mass matrix factorized by factorize.
+         * @param[in] b the input vector of size getSize().
+         * @param[out] x the output vector, resized if necessary.
+         * @return true if all went well, false otherwise.
+         */
+        bool multiplyByInverseSquareRoot(const FreeFloatingMassMatrix & factorizedMassMatrix,
+                                         const VectorDynSize & b,
+                                               VectorDynSize & x) const;
+
+        /**
+         * Compute \f$ J M^{-1} J^\top \f$ (i.e. the inverse of the operational space inertia
+         * of the jacobian J), without computing \f$ M^{-1} \f$.
+         *
+         * @param[in] factorizedMassMatrix the mass matrix factorized by factorize.
+         * @param[in] jacobian a m x getSize() matrix.
+         * @param[out] inverseOperationalSpaceInertia the m x m output matrix, resized if necessary.
+         * @return true if all went well, false otherwise.
+         */
+        bool computeInverseOperationalSpaceInertia(const FreeFloatingMassMatrix & factorizedMassMatrix,
+                                                   const MatrixDynSize & jacobian,
+                                                         MatrixDynSize & inverseOperationalSpaceInertia);
+    };
+}
+
+#endif
@@ -24,6 +24,7 @@
 namespace iDynTree
 {
     class Model;
+    class FreeFloatingVel;
 
     /**
      * Class representing the position of a Free Floating robot.
@@ -80,6 +81,34 @@ namespace iDynTree
         */
        unsigned int getNrOfPosCoords() const;
 
+       /**
+        * Integrate the position for a time dt, assuming a constant velocity vel.
+        *
+        * The base pose is integrated on SE(3), i.e.
+        * \f$ {}^A H_B^{next} = {}^A H_B \exp(\mathrm{d}t \, {}^B \mathrm{v}_{A,B}) \f$,
+        * where the base velocity is the body-fixed (left-trivialized) one, as in the rest of
+        * the FreeFloatingVel class. The resulting rotation is orthonormal by construction,
+        * so no normalization is required.
+        * The joint positions are integrated linearly.
+        *
+        * @param[in] vel the velocity of the robot.
+        * @param[in] dt the integration time.
+        * @param[out] nextPos the integrated position (it can be *this).
+        * @return true if all went well, false otherwise (i.e. if the model has joints
+        *         whose number of position coordinates is different from their number of DOFs).
+        */
+       bool integrate(const FreeFloatingVel & vel, const double dt, FreeFloatingPos & nextPos) const;
+
+       /**
+        * Compute the constant velocity that brings this position to otherPos in a time dt,
+        * i.e. the inverse of integrate.
+        *
+        * The base velocity is computed as \f$ \log({}^A H_B^{-1} \, {}^A H_B^{other}) / \mathrm{d}t \f$.
+        *
+        * @return true if all went well, false otherwise.
+        */
+       bool difference(const FreeFloatingPos & otherPos, const double dt, FreeFloatingVel & vel) const;
+
         /**
           * Destructor
           */
@@ -138,10 +138,14 @@ namespace iDynTree
          * p_child = child_H_parent*p_parent,
          * where p_child is a quantity expressed in the child frame,
          * and   p_parent is a quantity expressed in the parent frame.
+         *
+         * The transform is returned by value: joints do not cache any quantity
+         * that depends on the joint position, so that the const methods of a joint
+         * can be called concurrently by several threads.
          */
-        virtual const Transform & getTransform(const VectorDynSize & jntPos,
-                                               const LinkIndex child,
-                                               const LinkIndex parent) const = 0;
+        virtual Transform getTransform(const VectorDynSize & jntPos,
+                                       const LinkIndex child,
+                                       const LinkIndex parent) const = 0;
 
         /**
          * Get the derivative of the transform with
@@ -13,11 +13,17 @@
 
 #include <iDynTree/Model/Indices.h>
 
+#include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/MatrixView.h>
+#include <iDynTree/Core/CompressedColumnJacobian.h>
+#include <iDynTree/Core/Transform.h>
+
+#include <vector>
+
 namespace iDynTree
 {
     class Model;
     class Traversal;
-    class Transform;
     class FreeFloatingPos;
     class FreeFloatingVel;
     class FreeFloatingAcc;
@@ -25,7 +31,6 @@ namespace iDynTree
     class LinkVelArray;
     class LinkAccArray;
     class JointPosDoubleArray;
-    class MatrixDynSize;
 
     /**
      * \ingroup iDynTreeModel
@@ -51,6 +56,128 @@ namespace iDynTree
                                           const Transform & baseFrame_X_jacobBaseFrame,
                                                 MatrixDynSize & jacobian);
 
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Compute a free floating jacobian, writing it in a caller-owned buffer.
+     *
+     * See the MatrixDynSize version of FreeFloatingJacobianUsingLinkPos for the
+     * meaning of the parameters.
+     *
+     * @param[out] jacobian view of the 6 x (6+getNrOfDOFs()) jacobian, with any storage ordering.
+     * @return true if all went well, false otherwise.
+     */
+    bool FreeFloatingJacobianUsingLinkPos(const Model& model,
+                                          const Traversal& traversal,
+                                          const JointPosDoubleArray& jointPositions,
+                                          const LinkPositions& linkPositions,
+                                          const LinkIndex linkIndex,
+                                          const Transform & jacobFrame_X_world,
+                                          const Transform & baseFrame_X_jacobBaseFrame,
+                                                MatrixView<double> jacobian);
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Structure containing the internal buffers used
+     * by the FreeFloatingJacobiansUsingLinkPos function.
+     */
+    struct FreeFloatingJacobiansInternalBuffers
+    {
+        FreeFloatingJacobiansInternalBuffers() {};
+
+        /**
+         * Call resize(model);
+         */
+        FreeFloatingJacobiansInternalBuffers(const Model & model);
+
+        /**
+         * Resize all the buffers to the right size given the model.
+         */
+        void resize(const Model& model);
+
+        /**
+         * For each link, true if the motion subspace vectors of the
+         * joint connecting the link to its parent have already been computed.
+         */
+        std::vector<bool> isLinkVisited;
+
+        /**
+         * 6 x getNrOfDOFs() matrix, whose columns are the motion subspace vectors
+         * of the joint DOFs expressed in the world frame.
+         */
+        MatrixDynSize worldMotionSubspaces;
+
+        /**
+         * Indices of the nonzero columns of a free floating jacobian
+         * (memory for 6+getNrOfDOFs() elements is reserved).
+         */
+        std::vector<int> nonZeroColumns;
+    };
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Compute a free floating jacobian, storing only its nonzero columns.
+     *
+     * The nonzero columns are the 6 columns of the base and the columns of the joint DOFs
+     * in the path between the link and the base: only these columns are computed. If the
+     * link is the same of the previous call, the sparsity pattern of the jacobian is preserved
+     * and no memory allocation is performed.
+     *
+     * @param[in]  model the used model,
+     * @param[in]  traversal the used traversal,
+     * @param[in]  jointPositions the vector of (internal) joint positions,
+     * @param[in]  linkPositions linkPositions(l) contains the world_H_link transform.
+     * @param[in]  linkIndex     the index of the link of which we compute the jacobian.
+     * @param[in]  jacobFrame_X_world see the MatrixDynSize version of FreeFloatingJacobianUsingLinkPos
+     * @param[in]  baseFrame_X_jacobBaseFrame see the MatrixDynSize version of FreeFloatingJacobianUsingLinkPos
+     * @param[in]  bufs the internal buffers, already resized to the model.
+     * @param[out] jacobian the computed Jacobian, resized to 6 x (6+getNrOfDOFs()) if necessary.
+     * @return true if all went well, false otherwise.
+     */
+    bool FreeFloatingJacobianUsingLinkPos(const Model& model,
+                                          const Traversal& traversal,
+                                          const JointPosDoubleArray& jointPositions,
+                                          const LinkPositions& linkPositions,
+                                          const LinkIndex linkIndex,
+                                          const Transform & jacobFrame_X_world,
+                                          const Transform & baseFrame_X_jacobBaseFrame,
+                                                FreeFloatingJacobiansInternalBuffers & bufs,
+                                                CompressedColumnJacobian & jacobian);
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Compute the free floating jacobians of several links, stacked in a single matrix.
+     *
+     * The motion subspace vector of each joint DOF on the path between the links and the base
+     * is computed only once (also if the joint is shared by the path of several links),
+     * and then transformed in the frame of each jacobian.
+     *
+     * @param[in]  model the used model,
+     * @param[in]  traversal the used traversal,
+     * @param[in]  jointPositions the vector of (internal) joint positions,
+     * @param[in]  linkPositions linkPositions(l) contains the world_H_link transform.
+     * @param[in]  linkIndices   the indices of the k links of which we compute the jacobian.
+     * @param[in]  jacobFrames_X_world the k transforms jacobFrame_X_world (see FreeFloatingJacobianUsingLinkPos)
+     *                                 of each link.
+     * @param[in]  baseFrame_X_jacobBaseFrame see FreeFloatingJacobianUsingLinkPos, common to all the jacobians.
+     * @param[in]  bufs the internal buffers, already resized to the model.
+     * @param[out] stackedJacobians the 6k x (6+getNrOfDOFs()) matrix of the jacobians, where rows [6i,6i+6)
+     *                              contain the jacobian of the i-th link. It is resized if necessary.
+     * @return true if all went well, false otherwise.
+     */
+    bool FreeFloatingJacobiansUsingLinkPos(const Model& model,
+                                           const Traversal& traversal,
+                                           const JointPosDoubleArray& jointPositions,
+                                           const LinkPositions& linkPositions,
+                                           const std::vector<LinkIndex> & linkIndices,
+                                           const std::vector<Transform> & jacobFrames_X_world,
+                                           const Transform & baseFrame_X_jacobBaseFrame,
+                                                 FreeFloatingJacobiansInternalBuffers & bufs,
+                                                 MatrixDynSize & stackedJacobians);
+
 
 }
 
@@ -15,6 +15,7 @@
 #include <iDynTree/Model/Model.h>
 #include <iDynTree/Model/FixedJoint.h>
 #include <iDynTree/Model/RevoluteJoint.h>
+#include <iDynTree/Model/PrismaticJoint.h>
 #include <iDynTree/Model/FreeFloatingState.h>
 #include <iDynTree/Model/LinkState.h>
 
@@ -84,6 +85,21 @@ inline void addRandomLinkToModel(Model & model, std::string parentLink, std::str
     }
 }
 
+/**
+ * Add a random link attached to the model with a prismatic joint.
+ */
+inline void addRandomPrismaticLinkToModel(Model & model, std::string parentLink, std::string newLinkName)
+{
+    LinkIndex newLinkIndex = model.addLink(newLinkName,getRandomLink());
+    LinkIndex parentLinkIndex = model.getLinkIndex(parentLink);
+
+    PrismaticJoint prismJoint;
+    prismJoint.setAttachedLinks(parentLinkIndex,newLinkIndex);
+    prismJoint.setRestTransform(getRandomTransform());
+    prismJoint.setAxis(getRandomAxis(),newLinkIndex);
+    model.addJoint(newLinkName+"joint",&prismJoint);
+}
+
 /**
  * Add a random additional frame to a model model.
  */
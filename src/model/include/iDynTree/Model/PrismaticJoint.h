@@ -41,16 +41,13 @@ namespace iDynTree
         double m_minPos;
         double m_maxPos;
 
-        // Cache attributes
-        mutable double q_previous;
-        mutable Transform link1_X_link2;
-        mutable Transform link2_X_link1;
-        mutable SpatialMotionVector S_link1_link2;
-        mutable SpatialMotionVector S_link2_link1;
+        // Motion subspace vectors, that depend only on the structure attributes.
+        // No attribute depends on the joint position, so that a const joint
+        // (and a const Model) can be safely shared by several threads.
+        SpatialMotionVector S_link1_link2;
+        SpatialMotionVector S_link2_link1;
 
-        void updateBuffers(const double new_q) const;
-        void resetBuffers(const double new_q) const;
-        void resetAxisBuffers() const;
+        void resetAxisBuffers();
 
     public:
         /**
@@ -137,9 +134,9 @@ namespace iDynTree
 
 
         // Documentation inherited
-        virtual const Transform & getTransform(const VectorDynSize & jntPos,
-                                               const LinkIndex child,
-                                               const LinkIndex parent) const;
+        virtual Transform getTransform(const VectorDynSize & jntPos,
+                                       const LinkIndex child,
+                                       const LinkIndex parent) const;
 
         // Documentation inherited
         TransformDerivative getTransformDerivative(const VectorDynSize & jntPos,
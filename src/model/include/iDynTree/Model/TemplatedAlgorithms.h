@@ -0,0 +1,626 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#ifndef IDYNTREE_TEMPLATED_ALGORITHMS_H
+#define IDYNTREE_TEMPLATED_ALGORITHMS_H
+
+#include <iDynTree/Model/CompiledModel.h>
+
+#include <iDynTree/Core/EigenHelpers.h>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace iDynTree
+{
+/**
+ * \ingroup iDynTreeModel
+ *
+ * Kinematics and dynamics algorithms templated on the scalar type.
+ *
+ * The classes of iDynTree (Transform, SpatialInertia, VectorDynSize, ...) and the
+ * algorithms that use them are implemented for double. The algorithms in this namespace
+ * implement the same recursions of the CompiledModel variants of ForwardPositionKinematics,
+ * FreeFloatingJacobianUsingLinkPos, RNEA (ForwardVelAccKinematics and RNEADynamicPhase) and
+ * CompositeRigidBodyAlgorithm, but all the quantities that depend on the robot state are
+ * Eigen objects of a generic Scalar type (double by default).
+ *
+ * In this way the algorithms can be instantiated with forward-mode automatic differentiation
+ * scalars (for example Eigen::AutoDiffScalar, defined in unsupported/Eigen/AutoDiff, or any
+ * other dual number type supported by Eigen) to obtain the exact derivatives of their outputs
+ * with respect to any input in a single evaluation, instead of one evaluation for each
+ * finite difference.
+ *
+ * The constant model parameters (rest transforms, joint axes, motion subspace vectors and inertias)
+ * are read from the CompiledModel, and converted to Scalar when used.
+ * As in the other CompiledModel algorithms, the per-link quantities are indexed by the link index,
+ * and 6D vectors are stored with the linear part first. The per-link 6D vectors are stored
+ * as columns of a 6 x nrOfLinks matrix.
+ *
+ * \note When using Eigen::AutoDiffScalar, prefer a derivative vector of fixed size
+ *       (for example Eigen::AutoDiffScalar<Eigen::Matrix<double,N,1> >): with dynamic size derivatives
+ *       the constants have empty derivatives, that Eigen does not resize in all the composite expressions.
+ */
+namespace Templated
+{
+    template<typename Scalar> using Vec3  = Eigen::Matrix<Scalar,3,1>;
+    template<typename Scalar> using Vec6  = Eigen::Matrix<Scalar,6,1>;
+    template<typename Scalar> using VecX  = Eigen::Matrix<Scalar,Eigen::Dynamic,1>;
+    template<typename Scalar> using Mat3  = Eigen::Matrix<Scalar,3,3>;
+    template<typename Scalar> using Mat6  = Eigen::Matrix<Scalar,6,6>;
+    template<typename Scalar> using Mat6X = Eigen::Matrix<Scalar,6,Eigen::Dynamic>;
+    template<typename Scalar> using MatX  = Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic>;
+
+    /**
+     * Cross product matrix S(v), such that S(v)*u = v \times u.
+     */
+    template<typename Scalar>
+    Mat3<Scalar> skew(const Vec3<Scalar> & v)
+    {
+        Mat3<Scalar> ret;
+        ret << Scalar(0), -v(2),     v(1),
+               v(2),      Scalar(0), -v(0),
+               -v(1),     v(0),      Scalar(0);
+        return ret;
+    }
+
+    /**
+     * v \times u, with v and u motion vectors.
+     */
+    template<typename Scalar>
+    Vec6<Scalar> crossMotion(const Vec6<Scalar> & v, const Vec6<Scalar> & u)
+    {
+        Vec6<Scalar> ret;
+        const Vec3<Scalar> vLin = v.template head<3>(), vAng = v.template tail<3>();
+        const Vec3<Scalar> uLin = u.template head<3>(), uAng = u.template tail<3>();
+        ret.template head<3>() = vAng.cross(uLin) + vLin.cross(uAng);
+        ret.template tail<3>() = vAng.cross(uAng);
+        return ret;
+    }
+
+    /**
+     * v \bar{\times}^* f, with v a motion vector and f a force vector.
+     */
+    template<typename Scalar>
+    Vec6<Scalar> crossForce(const Vec6<Scalar> & v, const Vec6<Scalar> & f)
+    {
+        Vec6<Scalar> ret;
+        const Vec3<Scalar> vLin = v.template head<3>(), vAng = v.template tail<3>();
+        const Vec3<Scalar> fLin = f.template head<3>(), fAng = f.template tail<3>();
+        ret.template head<3>() = vAng.cross(fLin);
+        ret.template tail<3>() = vLin.cross(fLin) + vAng.cross(fAng);
+        return ret;
+    }
+
+    /**
+     * Convert a 6D vector of iDynTree (Twist, Wrench, SpatialMotionVector, ...) to a Vec6<Scalar>.
+     */
+    template<typename Scalar, typename SpatialVectorType>
+    Vec6<Scalar> fromSpatialVector(const SpatialVectorType & vec)
+    {
+        return toEigen(vec).template cast<Scalar>();
+    }
+
+    template<typename Scalar> class ScalarSpatialInertia;
+
+    /**
+     * Rigid transform a_H_b (i.e. the transform a_X_b acting on 6D vectors), with
+     * rotation and position of type Scalar.
+     */
+    template<typename Scalar = double>
+    class ScalarTransform
+    {
+    public:
+        /** a_R_b */
+        Mat3<Scalar> rotation;
+        /** Position of the origin of b with respect to the origin of a, expressed in a. */
+        Vec3<Scalar> position;
+
+        ScalarTransform() {}
+
+        ScalarTransform(const Mat3<Scalar> & rot, const Vec3<Scalar> & pos): rotation(rot), position(pos) {}
+
+        /**
+         * Build a ScalarTransform from an iDynTree::Transform.
+         */
+        explicit ScalarTransform(const ::iDynTree::Transform & transform):
+            rotation(toEigen(transform.getRotation()).template cast<Scalar>()),
+            position(toEigen(transform.getPosition()).template cast<Scalar>())
+        {
+        }
+
+        static ScalarTransform Identity()
+        {
+            return ScalarTransform(Mat3<Scalar>::Identity(),Vec3<Scalar>::Zero());
+        }
+
+        /** a_H_b * b_H_c */
+        ScalarTransform operator*(const ScalarTransform & other) const
+        {
+            return ScalarTransform(rotation*other.rotation,rotation*other.position+position);
+        }
+
+        /** b_H_a */
+        ScalarTransform inverse() const
+        {
+            Mat3<Scalar> invRot = rotation.transpose();
+            return ScalarTransform(invRot,-(invRot*position));
+        }
+
+        /** a_X_b * b_v, with b_v a motion vector. */
+        Vec6<Scalar> transformMotion(const Vec6<Scalar> & v) const
+        {
+            Vec6<Scalar> ret;
+            ret.template tail<3>() = rotation*v.template tail<3>();
+            ret.template head<3>() = rotation*v.template head<3>() + position.cross(Vec3<Scalar>(ret.template tail<3>()));
+            return ret;
+        }
+
+        /** b_X_a * a_v, with a_v a motion vector, without computing the inverse. */
+        Vec6<Scalar> inverseTransformMotion(const Vec6<Scalar> & v) const
+        {
+            Vec6<Scalar> ret;
+            const Vec3<Scalar> vAng = v.template tail<3>();
+            ret.template head<3>() = rotation.transpose()*(v.template head<3>() - position.cross(vAng));
+            ret.template tail<3>() = rotation.transpose()*vAng;
+            return ret;
+        }
+
+        /** a_X_b^* * b_f, with b_f a force vector. */
+        Vec6<Scalar> transformForce(const Vec6<Scalar> & f) const
+        {
+            Vec6<Scalar> ret;
+            ret.template head<3>() = rotation*f.template head<3>();
+            ret.template tail<3>() = rotation*f.template tail<3>() + position.cross(Vec3<Scalar>(ret.template head<3>()));
+            return ret;
+        }
+
+        /** a_X_b^* * b_I * b_X_a, with b_I a spatial inertia. */
+        ScalarSpatialInertia<Scalar> transformInertia(const ScalarSpatialInertia<Scalar> & inertia) const;
+
+        /** The 6x6 matrix a_X_b that acts on motion vectors. */
+        Mat6<Scalar> asAdjointTransform() const
+        {
+            Mat6<Scalar> ret;
+            ret.template block<3,3>(0,0) = rotation;
+            ret.template block<3,3>(0,3) = skew(position)*rotation;
+            ret.template block<3,3>(3,0).setZero();
+            ret.template block<3,3>(3,3) = rotation;
+            return ret;
+        }
+    };
+
+    /**
+     * Spatial inertia with parameters of type Scalar, stored as in iDynTree::SpatialInertia:
+     * the mass, the first moment of mass and the rotational inertia with respect to the frame origin.
+     */
+    template<typename Scalar = double>
+    class ScalarSpatialInertia
+    {
+    public:
+        Scalar mass;
+        Vec3<Scalar> mcom;
+        Mat3<Scalar> rotInertia;
+
+        ScalarSpatialInertia() {}
+
+        ScalarSpatialInertia(const Scalar & in_mass, const Vec3<Scalar> & in_mcom, const Mat3<Scalar> & in_rotInertia):
+            mass(in_mass), mcom(in_mcom), rotInertia(in_rotInertia)
+        {
+        }
+
+        /**
+         * Build a ScalarSpatialInertia from an iDynTree::SpatialInertia.
+         */
+        explicit ScalarSpatialInertia(const ::iDynTree::SpatialInertia & inertia):
+            mass(inertia.getMass()),
+            mcom((inertia.getMass()*toEigen(inertia.getCenterOfMass())).template cast<Scalar>()),
+            rotInertia(toEigen(inertia.getRotationalInertiaWrtFrameOrigin()).template cast<Scalar>())
+        {
+        }
+
+        static ScalarSpatialInertia Zero()
+        {
+            return ScalarSpatialInertia(Scalar(0),Vec3<Scalar>::Zero(),Mat3<Scalar>::Zero());
+        }
+
+        ScalarSpatialInertia operator+(const ScalarSpatialInertia & other) const
+        {
+            return ScalarSpatialInertia(mass+other.mass,mcom+other.mcom,rotInertia+other.rotInertia);
+        }
+
+        /** I*v, with v a motion vector (Featherstone 2008, 2.63). */
+        Vec6<Scalar> operator*(const Vec6<Scalar> & v) const
+        {
+            Vec6<Scalar> ret;
+            const Vec3<Scalar> vLin = v.template head<3>(), vAng = v.template tail<3>();
+            ret.template head<3>() = mass*vLin - mcom.cross(vAng);
+            ret.template tail<3>() = mcom.cross(vLin) + rotInertia*vAng;
+            return ret;
+        }
+
+        /** I*a + v \bar{\times}^* (I*v) */
+        Vec6<Scalar> netWrench(const Vec6<Scalar> & a, const Vec6<Scalar> & v) const
+        {
+            return (*this)*a + crossForce(v,Vec6<Scalar>((*this)*v));
+        }
+
+        /** The 6x6 matrix of the spatial inertia. */
+        Mat6<Scalar> asMatrix() const
+        {
+            Mat6<Scalar> ret;
+            ret.template block<3,3>(0,0) = mass*Mat3<Scalar>::Identity();
+            ret.template block<3,3>(0,3) = -skew(mcom);
+            ret.template block<3,3>(3,0) = skew(mcom);
+            ret.template block<3,3>(3,3) = rotInertia;
+            return ret;
+        }
+    };
+
+    template<typename Scalar>
+    ScalarSpatialInertia<Scalar> ScalarTransform<Scalar>::transformInertia(const ScalarSpatialInertia<Scalar> & inertia) const
+    {
+        // As in Transform::operator*(SpatialInertia): being h = R*mcom,
+        // the first moment of mass is h + m*p and the rotational inertia is
+        // R*I*R^T - (S(h)S(p) + S(p)S(h)) - m*S(p)^2
+        const Vec3<Scalar> h = rotation*inertia.mcom;
+        const Mat3<Scalar> Sh = skew(h), Sp = skew(position);
+        return ScalarSpatialInertia<Scalar>(inertia.mass,
+                                            h + inertia.mass*position,
+                                            rotation*inertia.rotInertia*rotation.transpose()
+                                            - (Sh*Sp + Sp*Sh) - inertia.mass*(Sp*Sp));
+    }
+
+    /**
+     * Compute the parent_X_link transform of the traversalIndex-th link, for the joint position jointPos.
+     *
+     * \note For fixed joints jointPos is ignored.
+     */
+    template<typename Scalar>
+    ScalarTransform<Scalar> computeParentTransform(const CompiledModel & compiledModel,
+                                                   const TraversalIndex traversalIndex,
+                                                   const Scalar & jointPos)
+    {
+        ScalarTransform<Scalar> parent_X_link_at_rest(compiledModel.getRestTransform(traversalIndex));
+
+        CompiledModel::JointType jointType = compiledModel.getJointType(traversalIndex);
+        if( jointType == CompiledModel::FIXED_JOINT )
+        {
+            return parent_X_link_at_rest;
+        }
+
+        const Axis & axis = compiledModel.getAxis(traversalIndex);
+        const Vec3<Scalar> direction = toEigen(axis.getDirection()).normalized().template cast<Scalar>();
+
+        // link_at_rest_X_link(q), with the axis expressed in the link frame
+        ScalarTransform<Scalar> link_at_rest_X_link;
+        if( jointType == CompiledModel::REVOLUTE_JOINT )
+        {
+            using std::cos;
+            using std::sin;
+            const Scalar cosq = cos(jointPos);
+            const Scalar sinq = sin(jointPos);
+
+            // Rodrigues formula, for a rotation around an axis passing through the point o:
+            // x' = R*(x-o) + o, i.e. the translation is (1-R)*o
+            link_at_rest_X_link.rotation = cosq*Mat3<Scalar>::Identity() + sinq*skew(direction)
+                                           + (Scalar(1)-cosq)*(direction*direction.transpose());
+            const Vec3<Scalar> origin = toEigen(axis.getOrigin()).template cast<Scalar>();
+            link_at_rest_X_link.position = origin - link_at_rest_X_link.rotation*origin;
+        }
+        else
+        {
+            link_at_rest_X_link.rotation = Mat3<Scalar>::Identity();
+            link_at_rest_X_link.position = direction*jointPos;
+        }
+
+        return parent_X_link_at_rest*link_at_rest_X_link;
+    }
+
+    /**
+     * Templated variant of iDynTree::ComputeJointTransforms(const CompiledModel&, ...).
+     *
+     * @param[in]  compiledModel the used compiled model,
+     * @param[in]  jointPos the vector of (internal) joint positions,
+     * @param[out] parent_X_links parent_X_links[l] contains the parent_X_link transform, resized to the number of links.
+     * @return true if all went well, false otherwise.
+     */
+    template<typename Scalar>
+    bool ComputeJointTransforms(const CompiledModel & compiledModel,
+                                const VecX<Scalar> & jointPos,
+                                      std::vector< ScalarTransform<Scalar> > & parent_X_links)
+    {
+        assert(compiledModel.isValid());
+        assert(static_cast<size_t>(jointPos.size()) == compiledModel.getNrOfPosCoords());
+
+        parent_X_links.resize(compiledModel.getNrOfLinks());
+        parent_X_links[compiledModel.getLinkIndex(0)] = ScalarTransform<Scalar>::Identity();
+
+        for(TraversalIndex traversalEl=1; traversalEl < static_cast<TraversalIndex>(compiledModel.getNrOfVisitedLinks()); traversalEl++)
+        {
+            Scalar q = (compiledModel.getJointType(traversalEl) == CompiledModel::FIXED_JOINT) ?
+                       Scalar(0) : jointPos(compiledModel.getPosCoordsOffset(traversalEl));
+            parent_X_links[compiledModel.getLinkIndex(traversalEl)] = computeParentTransform(compiledModel,traversalEl,q);
+        }
+
+        return true;
+    }
+
+    /**
+     * Templated variant of iDynTree::ForwardPositionKinematics(const CompiledModel&, ...).
+     *
+     * @param[in]  compiledModel the used compiled model,
+     * @param[in]  parent_X_links the parent_X_link transforms computed by ComputeJointTransforms,
+     * @param[in]  worldHbase the world_H_base transform,
+     * @param[out] linkPositions linkPositions[l] contains the world_H_link transform, resized to the number of links.
+     * @return true if all went well, false otherwise.
+     */
+    template<typename Scalar>
+    bool ForwardPositionKinematics(const CompiledModel & compiledModel,
+                                   const std::vector< ScalarTransform<Scalar> > & parent_X_links,
+                                   const ScalarTransform<Scalar> & worldHbase,
+                                         std::vector< ScalarTransform<Scalar> > & linkPositions)
+    {
+        linkPositions.resize(compiledModel.getNrOfLinks());
+        linkPositions[compiledModel.getLinkIndex(0)] = worldHbase;
+
+        for(TraversalIndex traversalEl=1; traversalEl < static_cast<TraversalIndex>(compiledModel.getNrOfVisitedLinks()); traversalEl++)
+        {
+            LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+            LinkIndex parentLinkIndex  = compiledModel.getLinkIndex(compiledModel.getParent(traversalEl));
+
+            // world_H_link = world_H_parentLink * parentLink_H_link
+            linkPositions[visitedLinkIndex] = linkPositions[parentLinkIndex]*parent_X_links[visitedLinkIndex];
+        }
+
+        return true;
+    }
+
+    /**
+     * Templated variant of iDynTree::FreeFloatingJacobianUsingLinkPos(const CompiledModel&, ...).
+     *
+     * @param[in]  compiledModel the used compiled model,
+     * @param[in]  world_H_links the world_H_link transforms computed by ForwardPositionKinematics,
+     * @param[in]  jacobianLinkIndex the link whose velocity is described by the jacobian,
+     * @param[in]  jacobFrame_X_world the transform between the world and the frame in which the jacobian is expressed,
+     * @param[in]  baseFrame_X_jacobBaseFrame the transform used to account for the representation of the base velocity,
+     * @param[out] jacobian the 6 x (6+nrOfDOFs) jacobian, resized if necessary.
+     * @return true if all went well, false otherwise.
+     */
+    template<typename Scalar>
+    bool FreeFloatingJacobianUsingLinkPos(const CompiledModel & compiledModel,
+                                          const std::vector< ScalarTransform<Scalar> > & world_H_links,
+                                          const LinkIndex jacobianLinkIndex,
+                                          const ScalarTransform<Scalar> & jacobFrame_X_world,
+                                          const ScalarTransform<Scalar> & baseFrame_X_jacobBaseFrame,
+                                                Mat6X<Scalar> & jacobian)
+    {
+        jacobian.setZero(6,6+compiledModel.getNrOfDOFs());
+
+        // Compute base part
+        const ScalarTransform<Scalar> & world_H_base = world_H_links[compiledModel.getLinkIndex(0)];
+        jacobian.template block<6,6>(0,0) = (jacobFrame_X_world*world_H_base*baseFrame_X_jacobBaseFrame).asAdjointTransform();
+
+        // Compute joint part, going up in the traversal from the link until we reach the base
+        TraversalIndex visitedTraversalEl = compiledModel.getTraversalIndexFromLinkIndex(jacobianLinkIndex);
+
+        while( visitedTraversalEl > 0 )
+        {
+            if( compiledModel.getJointType(visitedTraversalEl) != CompiledModel::FIXED_JOINT )
+            {
+                LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(visitedTraversalEl);
+                size_t dofOffset = compiledModel.getDOFsOffset(visitedTraversalEl);
+                Vec6<Scalar> S = fromSpatialVector<Scalar>(compiledModel.getMotionSubspaceVector(visitedTraversalEl));
+                jacobian.col(6+dofOffset) = jacobFrame_X_world.transformMotion(world_H_links[visitedLinkIndex].transformMotion(S));
+            }
+
+            visitedTraversalEl = compiledModel.getParent(visitedTraversalEl);
+        }
+
+        return true;
+    }
+
+    /**
+     * Templated variant of iDynTree::ForwardVelAccKinematics(const CompiledModel&, ...),
+     * the first (forward) pass of RNEA.
+     *
+     * @param[in]  compiledModel the used compiled model,
+     * @param[in]  parent_X_links the parent_X_link transforms computed by ComputeJointTransforms,
+     * @param[in]  baseVel the velocity of the base, expressed in the base frame,
+     * @param[in]  jointVel the joint velocities,
+     * @param[in]  baseAcc the acceleration of the base, expressed in the base frame,
+     * @param[in]  jointAcc the joint accelerations,
+     * @param[out] linkVel the column l contains the velocity of the link l, expressed in the link frame,
+     * @param[out] linkAcc the column l contains the acceleration of the link l, expressed in the link frame.
+     * @return true if all went well, false otherwise.
+     */
+    template<typename Scalar>
+    bool ForwardVelAccKinematics(const CompiledModel & compiledModel,
+                                 const std::vector< ScalarTransform<Scalar> > & parent_X_links,
+                                 const Vec6<Scalar> & baseVel,
+                                 const VecX<Scalar> & jointVel,
+                                 const Vec6<Scalar> & baseAcc,
+                                 const VecX<Scalar> & jointAcc,
+                                       Mat6X<Scalar> & linkVel,
+                                       Mat6X<Scalar> & linkAcc)
+    {
+        linkVel.setZero(6,compiledModel.getNrOfLinks());
+        linkAcc.setZero(6,compiledModel.getNrOfLinks());
+
+        LinkIndex baseLinkIndex = compiledModel.getLinkIndex(0);
+        linkVel.col(baseLinkIndex) = baseVel;
+        linkAcc.col(baseLinkIndex) = baseAcc;
+
+        for(TraversalIndex traversalEl=1; traversalEl < static_cast<TraversalIndex>(compiledModel.getNrOfVisitedLinks()); traversalEl++)
+        {
+            LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+            LinkIndex parentLinkIndex  = compiledModel.getLinkIndex(compiledModel.getParent(traversalEl));
+
+            const ScalarTransform<Scalar> & parent_X_link = parent_X_links[visitedLinkIndex];
+            Vec6<Scalar> v = parent_X_link.inverseTransformMotion(linkVel.col(parentLinkIndex));
+            Vec6<Scalar> a = parent_X_link.inverseTransformMotion(linkAcc.col(parentLinkIndex));
+
+            if( compiledModel.getJointType(traversalEl) != CompiledModel::FIXED_JOINT )
+            {
+                // Equation 5.14 and 5.15 of Featherstone RBDA, 2008
+                size_t dofIndex = compiledModel.getDOFsOffset(traversalEl);
+                Vec6<Scalar> S = fromSpatialVector<Scalar>(compiledModel.getMotionSubspaceVector(traversalEl));
+                Vec6<Scalar> vj = S*jointVel(dofIndex);
+                v += vj;
+                a += S*jointAcc(dofIndex) + crossMotion(v,vj);
+            }
+
+            linkVel.col(visitedLinkIndex) = v;
+            linkAcc.col(visitedLinkIndex) = a;
+        }
+
+        return true;
+    }
+
+    /**
+     * Templated variant of iDynTree::RNEADynamicPhase(const CompiledModel&, ...),
+     * the second (backward) pass of RNEA.
+     *
+     * @param[in]  compiledModel the used compiled model,
+     * @param[in]  parent_X_links the parent_X_link transforms computed by ComputeJointTransforms,
+     * @param[in]  linkVel the link velocities computed by ForwardVelAccKinematics,
+     * @param[in]  linkAcc the link accelerations computed by ForwardVelAccKinematics,
+     * @param[in]  linkExtWrenches the column l contains the external wrench acting on the link l, expressed in the link frame,
+     * @param[out] linkIntWrenches the column l contains the wrench exerted by the parent of link l on link l, expressed in the link frame,
+     * @param[out] baseWrenchJointTorques the (6+nrOfDOFs) vector of the base wrench and of the joint torques.
+     * @return true if all went well, false otherwise.
+     */
+    template<typename Scalar>
+    bool RNEADynamicPhase(const CompiledModel & compiledModel,
+                          const std::vector< ScalarTransform<Scalar> > & parent_X_links,
+                          const Mat6X<Scalar> & linkVel,
+                          const Mat6X<Scalar> & linkAcc,
+                          const Mat6X<Scalar> & linkExtWrenches,
+                                Mat6X<Scalar> & linkIntWrenches,
+                                VecX<Scalar> & baseWrenchJointTorques)
+    {
+        assert(static_cast<size_t>(linkExtWrenches.cols()) == compiledModel.getNrOfLinks());
+
+        linkIntWrenches.setZero(6,compiledModel.getNrOfLinks());
+        baseWrenchJointTorques.setZero(6+compiledModel.getNrOfDOFs());
+
+        for(TraversalIndex traversalEl = compiledModel.getNrOfVisitedLinks()-1; traversalEl >= 0; traversalEl--)
+        {
+            LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+
+            // Equation 5.20 in Featherstone 2008, with the external
+            // forces expressed in the link frame
+            ScalarSpatialInertia<Scalar> I(compiledModel.getInertia(traversalEl));
+            Vec6<Scalar> f = I.netWrench(linkAcc.col(visitedLinkIndex),linkVel.col(visitedLinkIndex))
+                             - linkExtWrenches.col(visitedLinkIndex);
+
+            for(size_t child_i=0; child_i < compiledModel.getNrOfChildren(traversalEl); child_i++)
+            {
+                LinkIndex childIndex = compiledModel.getLinkIndex(compiledModel.getChild(traversalEl,child_i));
+                f += parent_X_links[childIndex].transformForce(linkIntWrenches.col(childIndex));
+            }
+
+            linkIntWrenches.col(visitedLinkIndex) = f;
+
+            if( traversalEl == 0 )
+            {
+                baseWrenchJointTorques.template head<6>() = f;
+            }
+            else if( compiledModel.getJointType(traversalEl) != CompiledModel::FIXED_JOINT )
+            {
+                // Equation 5.13 in Featherstone 2008
+                Vec6<Scalar> S = fromSpatialVector<Scalar>(compiledModel.getMotionSubspaceVector(traversalEl));
+                baseWrenchJointTorques(6+compiledModel.getDOFsOffset(traversalEl)) = S.dot(f);
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Templated variant of iDynTree::CompositeRigidBodyAlgorithm(const CompiledModel&, ...).
+     *
+     * @param[in]  compiledModel the used compiled model,
+     * @param[in]  parent_X_links the parent_X_link transforms computed by ComputeJointTransforms,
+     * @param[out] linkCRBs linkCRBs[l] contains the composite rigid body inertia of the subtree starting at link l,
+     * @param[out] massMatrix the (6+nrOfDOFs) x (6+nrOfDOFs) free floating mass matrix, resized if necessary.
+     * @return true if all went well, false otherwise.
+     */
+    template<typename Scalar>
+    bool CompositeRigidBodyAlgorithm(const CompiledModel & compiledModel,
+                                     const std::vector< ScalarTransform<Scalar> > & parent_X_links,
+                                           std::vector< ScalarSpatialInertia<Scalar> > & linkCRBs,
+                                           MatX<Scalar> & massMatrix)
+    {
+        TraversalIndex nrOfVisitedLinks = static_cast<TraversalIndex>(compiledModel.getNrOfVisitedLinks());
+
+        massMatrix.setZero(6+compiledModel.getNrOfDOFs(),6+compiledModel.getNrOfDOFs());
+        linkCRBs.resize(compiledModel.getNrOfLinks());
+
+        for(TraversalIndex traversalEl=0; traversalEl < nrOfVisitedLinks; traversalEl++)
+        {
+            linkCRBs[compiledModel.getLinkIndex(traversalEl)] = ScalarSpatialInertia<Scalar>(compiledModel.getInertia(traversalEl));
+        }
+
+        // See the CompositeRigidBodyAlgorithm in CompiledModel.cpp,
+        // this follows Featherstone 2008, Table 6.2
+        for(TraversalIndex traversalEl = nrOfVisitedLinks-1; traversalEl > 0; traversalEl--)
+        {
+            LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+            LinkIndex parentLinkIndex  = compiledModel.getLinkIndex(compiledModel.getParent(traversalEl));
+
+            linkCRBs[parentLinkIndex] = linkCRBs[parentLinkIndex] +
+                                        parent_X_links[visitedLinkIndex].transformInertia(linkCRBs[visitedLinkIndex]);
+
+            if( compiledModel.getJointType(traversalEl) == CompiledModel::FIXED_JOINT )
+            {
+                continue;
+            }
+
+            Vec6<Scalar> S_visitedDof = fromSpatialVector<Scalar>(compiledModel.getMotionSubspaceVector(traversalEl));
+            Vec6<Scalar> F = linkCRBs[visitedLinkIndex]*S_visitedDof;
+
+            size_t dofIndex = compiledModel.getDOFsOffset(traversalEl);
+            massMatrix(6+dofIndex,6+dofIndex) = S_visitedDof.dot(F);
+
+            TraversalIndex ancestor = traversalEl;
+            while( compiledModel.getParent(compiledModel.getParent(ancestor)) != TRAVERSAL_INVALID_INDEX )
+            {
+                F = parent_X_links[compiledModel.getLinkIndex(ancestor)].transformForce(F);
+                ancestor = compiledModel.getParent(ancestor);
+
+                if( compiledModel.getJointType(ancestor) != CompiledModel::FIXED_JOINT )
+                {
+                    size_t ancestorDofIndex = compiledModel.getDOFsOffset(ancestor);
+                    Vec6<Scalar> S_ancestor = fromSpatialVector<Scalar>(compiledModel.getMotionSubspaceVector(ancestor));
+                    massMatrix(6+dofIndex,6+ancestorDofIndex) = S_ancestor.dot(F);
+                    massMatrix(6+ancestorDofIndex,6+dofIndex) = massMatrix(6+dofIndex,6+ancestorDofIndex);
+                }
+            }
+
+            // Express F in the base link frame for the momentum jacobian part
+            F = parent_X_links[compiledModel.getLinkIndex(ancestor)].transformForce(F);
+
+            massMatrix.template block<6,1>(0,6+dofIndex) = F;
+            massMatrix.template block<1,6>(6+dofIndex,0) = F.transpose();
+        }
+
+        massMatrix.template block<6,6>(0,0) = linkCRBs[compiledModel.getLinkIndex(0)].asMatrix();
+
+        return true;
+    }
+}
+}
+
+#endif
@@ -0,0 +1,628 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Model/CompiledModel.h>
+
+#include <iDynTree/Model/Model.h>
+#include <iDynTree/Model/Traversal.h>
+#include <iDynTree/Model/FixedJoint.h>
+#include <iDynTree/Model/RevoluteJoint.h>
+#include <iDynTree/Model/PrismaticJoint.h>
+#include <iDynTree/Model/FreeFloatingState.h>
+#include <iDynTree/Model/FreeFloatingMatrices.h>
+#include <iDynTree/Model/Dynamics.h>
+
+#include <iDynTree/Core/ArticulatedBodyInertia.h>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/Utils.h>
+
+#include <Eigen/Core>
+
+#include <cassert>
+
+namespace iDynTree
+{
+
+CompiledModel::CompiledModel(): m_isValid(false),
+                                m_nrOfLinks(0),
+                                m_nrOfPosCoords(0),
+                                m_nrOfDOFs(0)
+{
+}
+
+CompiledModel::CompiledModel(const Model& model, const Traversal& traversal): m_isValid(false),
+                                                                             m_nrOfLinks(0),
+                                                                             m_nrOfPosCoords(0),
+                                                                             m_nrOfDOFs(0)
+{
+    compile(model,traversal);
+}
+
+bool CompiledModel::compile(const Model& model, const Traversal& traversal)
+{
+    m_isValid = false;
+
+    size_t nrOfVisitedLinks = traversal.getNrOfVisitedLinks();
+
+    if( nrOfVisitedLinks == 0 )
+    {
+        reportError("CompiledModel","compile","the traversal is empty");
+        return false;
+    }
+
+    m_nrOfLinks     = model.getNrOfLinks();
+    m_nrOfPosCoords = model.getNrOfPosCoords();
+    m_nrOfDOFs      = model.getNrOfDOFs();
+
+    m_linkIndex.resize(nrOfVisitedLinks);
+    m_parent.resize(nrOfVisitedLinks);
+    m_jointType.resize(nrOfVisitedLinks);
+    m_posCoordsOffset.resize(nrOfVisitedLinks);
+    m_DOFsOffset.resize(nrOfVisitedLinks);
+    m_parent_X_link_at_rest.resize(nrOfVisitedLinks);
+    m_axisInLinkFrame.resize(nrOfVisitedLinks);
+    m_motionSubspace.resize(nrOfVisitedLinks);
+    m_inertia.resize(nrOfVisitedLinks);
+    m_childrenBegin.assign(nrOfVisitedLinks+1,0);
+    m_children.resize(nrOfVisitedLinks > 0 ? nrOfVisitedLinks-1 : 0);
+    m_traversalIndex.assign(m_nrOfLinks,TRAVERSAL_INVALID_INDEX);
+
+    for(TraversalIndex traversalEl=0; traversalEl < static_cast<TraversalIndex>(nrOfVisitedLinks); traversalEl++)
+    {
+        LinkConstPtr visitedLink = traversal.getLink(traversalEl);
+        LinkConstPtr parentLink  = traversal.getParentLink(traversalEl);
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+        LinkIndex visitedLinkIndex = visitedLink->getIndex();
+
+        m_linkIndex[traversalEl] = visitedLinkIndex;
+        m_traversalIndex[visitedLinkIndex] = traversalEl;
+        m_inertia[traversalEl] = visitedLink->getInertia();
+        m_posCoordsOffset[traversalEl] = 0;
+        m_DOFsOffset[traversalEl] = 0;
+        m_motionSubspace[traversalEl].zero();
+
+        if( parentLink == 0 )
+        {
+            m_parent[traversalEl] = TRAVERSAL_INVALID_INDEX;
+            m_jointType[traversalEl] = FIXED_JOINT;
+            m_parent_X_link_at_rest[traversalEl] = Transform::Identity();
+            continue;
+        }
+
+        LinkIndex parentLinkIndex = parentLink->getIndex();
+        m_parent[traversalEl] = traversal.getTraversalIndexFromLinkIndex(parentLinkIndex);
+
+        // The children of a link always come after it in the traversal
+        assert(m_parent[traversalEl] < traversalEl);
+        m_childrenBegin[m_parent[traversalEl]+1]++;
+
+        m_parent_X_link_at_rest[traversalEl] = toParentJoint->getRestTransform(parentLinkIndex,visitedLinkIndex);
+        m_posCoordsOffset[traversalEl] = toParentJoint->getPosCoordsOffset();
+        m_DOFsOffset[traversalEl] = toParentJoint->getDOFsOffset();
+
+        // The joint type is resolved once here, so that the algorithms can
+        // dispatch on m_jointType without any virtual call
+        if( dynamic_cast<const FixedJoint*>(toParentJoint) )
+        {
+            m_jointType[traversalEl] = FIXED_JOINT;
+        }
+        else if( dynamic_cast<const RevoluteJoint*>(toParentJoint) )
+        {
+            const RevoluteJoint* revJoint = dynamic_cast<const RevoluteJoint*>(toParentJoint);
+            m_jointType[traversalEl] = REVOLUTE_JOINT;
+            m_axisInLinkFrame[traversalEl] = revJoint->getAxis(visitedLinkIndex,parentLinkIndex);
+            m_motionSubspace[traversalEl] = revJoint->getMotionSubspaceVector(0,visitedLinkIndex,parentLinkIndex);
+        }
+        else if( dynamic_cast<const PrismaticJoint*>(toParentJoint) )
+        {
+            const PrismaticJoint* prismJoint = dynamic_cast<const PrismaticJoint*>(toParentJoint);
+            m_jointType[traversalEl] = PRISMATIC_JOINT;
+            m_axisInLinkFrame[traversalEl] = prismJoint->getAxis(visitedLinkIndex,parentLinkIndex);
+            m_motionSubspace[traversalEl] = prismJoint->getMotionSubspaceVector(0,visitedLinkIndex,parentLinkIndex);
+        }
+        else
+        {
+            std::string errStr = "joint " + model.getJointName(toParentJoint->getIndex()) + " is of an unsupported type";
+            reportError("CompiledModel","compile",errStr.c_str());
+            return false;
+        }
+    }
+
+    // Compute the children ranges from the number of children of each link
+    for(size_t traversalEl=0; traversalEl < nrOfVisitedLinks; traversalEl++)
+    {
+        m_childrenBegin[traversalEl+1] += m_childrenBegin[traversalEl];
+    }
+
+    std::vector<size_t> nextFreeChildSlot(m_childrenBegin.begin(),m_childrenBegin.end()-1);
+    for(TraversalIndex traversalEl=1; traversalEl < static_cast<TraversalIndex>(nrOfVisitedLinks); traversalEl++)
+    {
+        m_children[nextFreeChildSlot[m_parent[traversalEl]]++] = traversalEl;
+    }
+
+    m_isValid = true;
+    return true;
+}
+
+bool CompiledModel::isValid() const
+{
+    return m_isValid;
+}
+
+size_t CompiledModel::getNrOfLinks() const
+{
+    return m_nrOfLinks;
+}
+
+size_t CompiledModel::getNrOfVisitedLinks() const
+{
+    return m_linkIndex.size();
+}
+
+size_t CompiledModel::getNrOfPosCoords() const
+{
+    return m_nrOfPosCoords;
+}
+
+size_t CompiledModel::getNrOfDOFs() const
+{
+    return m_nrOfDOFs;
+}
+
+LinkIndex CompiledModel::getLinkIndex(const TraversalIndex traversalIndex) const
+{
+    return m_linkIndex[traversalIndex];
+}
+
+TraversalIndex CompiledModel::getTraversalIndexFromLinkIndex(const LinkIndex linkIndex) const
+{
+    return m_traversalIndex[linkIndex];
+}
+
+TraversalIndex CompiledModel::getParent(const TraversalIndex traversalIndex) const
+{
+    return m_parent[traversalIndex];
+}
+
+CompiledModel::JointType CompiledModel::getJointType(const TraversalIndex traversalIndex) const
+{
+    return m_jointType[traversalIndex];
+}
+
+unsigned int CompiledModel::getNrOfDOFs(const TraversalIndex traversalIndex) const
+{
+    return (m_jointType[traversalIndex] == FIXED_JOINT) ? 0 : 1;
+}
+
+size_t CompiledModel::getPosCoordsOffset(const TraversalIndex traversalIndex) const
+{
+    return m_posCoordsOffset[traversalIndex];
+}
+
+size_t CompiledModel::getDOFsOffset(const TraversalIndex traversalIndex) const
+{
+    return m_DOFsOffset[traversalIndex];
+}
+
+const Transform& CompiledModel::getRestTransform(const TraversalIndex traversalIndex) const
+{
+    return m_parent_X_link_at_rest[traversalIndex];
+}
+
+const Axis& CompiledModel::getAxis(const TraversalIndex traversalIndex) const
+{
+    return m_axisInLinkFrame[traversalIndex];
+}
+
+const SpatialMotionVector& CompiledModel::getMotionSubspaceVector(const TraversalIndex traversalIndex) const
+{
+    return m_motionSubspace[traversalIndex];
+}
+
+const SpatialInertia& CompiledModel::getInertia(const TraversalIndex traversalIndex) const
+{
+    return m_inertia[traversalIndex];
+}
+
+size_t CompiledModel::getNrOfChildren(const TraversalIndex traversalIndex) const
+{
+    return m_childrenBegin[traversalIndex+1]-m_childrenBegin[traversalIndex];
+}
+
+TraversalIndex CompiledModel::getChild(const TraversalIndex traversalIndex, const size_t child_i) const
+{
+    return m_children[m_childrenBegin[traversalIndex]+child_i];
+}
+
+void CompiledModel::computeParentTransform(const TraversalIndex traversalIndex,
+                                           const VectorDynSize& jointPos,
+                                                 Transform& parent_X_link) const
+{
+    // For 1-dof joints, the joint motion can be applied on the right of the rest transform
+    // if the axis is expressed in the link ("child") frame:
+    // parent_X_link(q) = parent_X_link_at_rest * link_at_rest_X_link(q)
+    switch( m_jointType[traversalIndex] )
+    {
+        case REVOLUTE_JOINT:
+            parent_X_link = m_parent_X_link_at_rest[traversalIndex]*
+                            m_axisInLinkFrame[traversalIndex].getRotationTransform(jointPos(m_posCoordsOffset[traversalIndex]));
+            break;
+        case PRISMATIC_JOINT:
+            parent_X_link = m_parent_X_link_at_rest[traversalIndex]*
+                            m_axisInLinkFrame[traversalIndex].getTranslationTransform(jointPos(m_posCoordsOffset[traversalIndex]));
+            break;
+        case FIXED_JOINT:
+        default:
+            parent_X_link = m_parent_X_link_at_rest[traversalIndex];
+            break;
+    }
+}
+
+bool ComputeJointTransforms(const CompiledModel& compiledModel,
+                            const VectorDynSize& jointPos,
+                                  LinkPositions& parent_X_links)
+{
+    assert(compiledModel.isValid());
+    assert(jointPos.size() == compiledModel.getNrOfPosCoords());
+
+    parent_X_links(compiledModel.getLinkIndex(0)) = Transform::Identity();
+
+    for(TraversalIndex traversalEl=1; traversalEl < static_cast<TraversalIndex>(compiledModel.getNrOfVisitedLinks()); traversalEl++)
+    {
+        compiledModel.computeParentTransform(traversalEl,jointPos,parent_X_links(compiledModel.getLinkIndex(traversalEl)));
+    }
+
+    return true;
+}
+
+bool ForwardPositionKinematics(const CompiledModel& compiledModel,
+                               const LinkPositions& parent_X_links,
+                               const Transform& worldHbase,
+                                     LinkPositions& linkPositions)
+{
+    linkPositions(compiledModel.getLinkIndex(0)) = worldHbase;
+
+    for(TraversalIndex traversalEl=1; traversalEl < static_cast<TraversalIndex>(compiledModel.getNrOfVisitedLinks()); traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+        LinkIndex parentLinkIndex  = compiledModel.getLinkIndex(compiledModel.getParent(traversalEl));
+
+        // world_H_link = world_H_parentLink * parentLink_H_link
+        linkPositions(visitedLinkIndex) = linkPositions(parentLinkIndex)*parent_X_links(visitedLinkIndex);
+    }
+
+    return true;
+}
+
+bool ForwardPosVelKinematics(const CompiledModel& compiledModel,
+                             const LinkPositions& parent_X_links,
+                             const FreeFloatingPos& robotPos,
+                             const FreeFloatingVel& robotVel,
+                                   LinkPositions& linkPos,
+                                   LinkVelArray& linkVel)
+{
+    LinkIndex baseLinkIndex = compiledModel.getLinkIndex(0);
+    linkPos(baseLinkIndex) = robotPos.worldBasePos();
+    linkVel(baseLinkIndex) = robotVel.baseVel();
+
+    for(TraversalIndex traversalEl=1; traversalEl < static_cast<TraversalIndex>(compiledModel.getNrOfVisitedLinks()); traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+        LinkIndex parentLinkIndex  = compiledModel.getLinkIndex(compiledModel.getParent(traversalEl));
+
+        const Transform & parent_X_link = parent_X_links(visitedLinkIndex);
+        linkPos(visitedLinkIndex) = linkPos(parentLinkIndex)*parent_X_link;
+
+        // Equation 5.14 of Featherstone RBDA, 2008
+        linkVel(visitedLinkIndex) = parent_X_link.inverse()*linkVel(parentLinkIndex);
+
+        if( compiledModel.getJointType(traversalEl) != CompiledModel::FIXED_JOINT )
+        {
+            double dq = robotVel.jointVel()(compiledModel.getDOFsOffset(traversalEl));
+            linkVel(visitedLinkIndex) = linkVel(visitedLinkIndex) + compiledModel.getMotionSubspaceVector(traversalEl)*dq;
+        }
+    }
+
+    return true;
+}
+
+bool ForwardVelAccKinematics(const CompiledModel& compiledModel,
+                             const LinkPositions& parent_X_links,
+                             const FreeFloatingVel& robotVel,
+                             const FreeFloatingAcc& robotAcc,
+                                   LinkVelArray& linkVel,
+                                   LinkAccArray& linkAcc)
+{
+    LinkIndex baseLinkIndex = compiledModel.getLinkIndex(0);
+    linkVel(baseLinkIndex) = robotVel.baseVel();
+    linkAcc(baseLinkIndex) = robotAcc.baseAcc();
+
+    for(TraversalIndex traversalEl=1; traversalEl < static_cast<TraversalIndex>(compiledModel.getNrOfVisitedLinks()); traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+        LinkIndex parentLinkIndex  = compiledModel.getLinkIndex(compiledModel.getParent(traversalEl));
+
+        Transform link_X_parent = parent_X_links(visitedLinkIndex).inverse();
+
+        if( compiledModel.getJointType(traversalEl) == CompiledModel::FIXED_JOINT )
+        {
+            linkVel(visitedLinkIndex) = link_X_parent*linkVel(parentLinkIndex);
+            linkAcc(visitedLinkIndex) = link_X_parent*linkAcc(parentLinkIndex);
+        }
+        else
+        {
+            // Equation 5.14 and 5.15 of Featherstone RBDA, 2008
+            size_t dofIndex = compiledModel.getDOFsOffset(traversalEl);
+            double dq  = robotVel.jointVel()(dofIndex);
+            double ddq = robotAcc.jointAcc()(dofIndex);
+            const SpatialMotionVector & S = compiledModel.getMotionSubspaceVector(traversalEl);
+
+            SpatialMotionVector vj = S*dq;
+            linkVel(visitedLinkIndex) = link_X_parent*linkVel(parentLinkIndex) + vj;
+            linkAcc(visitedLinkIndex) = link_X_parent*linkAcc(parentLinkIndex) + S*ddq + linkVel(visitedLinkIndex)*vj;
+        }
+    }
+
+    return true;
+}
+
+bool RNEADynamicPhase(const CompiledModel& compiledModel,
+                      const LinkPositions& parent_X_links,
+                      const LinkVelArray& linksVels,
+                      const LinkAccArray& linksAccs,
+                      const LinkNetExternalWrenches& fext,
+                            LinkInternalWrenches& f,
+                            FreeFloatingGeneralizedTorques& baseWrenchJntTorques)
+{
+    for(TraversalIndex traversalEl = compiledModel.getNrOfVisitedLinks()-1; traversalEl >= 0; traversalEl--)
+    {
+        LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+
+        // Equation 5.20 in Featherstone 2008, with the external
+        // forces expressed in the link frame
+        const SpatialInertia & I = compiledModel.getInertia(traversalEl);
+        const SpatialAcc     & a = linksAccs(visitedLinkIndex);
+        const Twist          & v = linksVels(visitedLinkIndex);
+        f(visitedLinkIndex) = I.netWrench(a,v) - fext(visitedLinkIndex);
+
+        // The children of the link are already available in the compiled model
+        for(size_t child_i=0; child_i < compiledModel.getNrOfChildren(traversalEl); child_i++)
+        {
+            LinkIndex childIndex = compiledModel.getLinkIndex(compiledModel.getChild(traversalEl,child_i));
+            f(visitedLinkIndex) = f(visitedLinkIndex) + parent_X_links(childIndex)*f(childIndex);
+        }
+
+        if( traversalEl == 0 )
+        {
+            baseWrenchJntTorques.baseWrench() = f(visitedLinkIndex);
+        }
+        else if( compiledModel.getJointType(traversalEl) != CompiledModel::FIXED_JOINT )
+        {
+            // Equation 5.13 in Featherstone 2008
+            baseWrenchJntTorques.jointTorques()(compiledModel.getDOFsOffset(traversalEl)) =
+                compiledModel.getMotionSubspaceVector(traversalEl).dot(f(visitedLinkIndex));
+        }
+    }
+
+    return true;
+}
+
+bool CompositeRigidBodyAlgorithm(const CompiledModel& compiledModel,
+                                 const LinkPositions& parent_X_links,
+                                       LinkCompositeRigidBodyInertias& linkCRBs,
+                                       FreeFloatingMassMatrix& massMatrix)
+{
+    Eigen::Map<Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> >
+        massMatrixEigen(massMatrix.data(),massMatrix.rows(),massMatrix.cols());
+
+    TraversalIndex nrOfVisitedLinks = static_cast<TraversalIndex>(compiledModel.getNrOfVisitedLinks());
+
+    for(TraversalIndex traversalEl=0; traversalEl < nrOfVisitedLinks; traversalEl++)
+    {
+        linkCRBs(compiledModel.getLinkIndex(traversalEl)) = compiledModel.getInertia(traversalEl);
+    }
+
+    // See the CompositeRigidBodyAlgorithm in Dynamics.cpp for the details,
+    // this follows Featherstone 2008, Table 6.2
+    for(TraversalIndex traversalEl = nrOfVisitedLinks-1; traversalEl > 0; traversalEl--)
+    {
+        LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+        LinkIndex parentLinkIndex  = compiledModel.getLinkIndex(compiledModel.getParent(traversalEl));
+
+        linkCRBs(parentLinkIndex).addTransformed(parent_X_links(visitedLinkIndex),linkCRBs(visitedLinkIndex));
+
+        if( compiledModel.getJointType(traversalEl) == CompiledModel::FIXED_JOINT )
+        {
+            continue;
+        }
+
+        const SpatialMotionVector & S_visitedDof = compiledModel.getMotionSubspaceVector(traversalEl);
+        SpatialForceVector F = linkCRBs(visitedLinkIndex)*S_visitedDof;
+
+        size_t dofIndex = compiledModel.getDOFsOffset(traversalEl);
+        massMatrix(6+dofIndex,6+dofIndex) = S_visitedDof.dot(F);
+
+        TraversalIndex ancestor = traversalEl;
+        while( compiledModel.getParent(compiledModel.getParent(ancestor)) != TRAVERSAL_INVALID_INDEX )
+        {
+            F = parent_X_links(compiledModel.getLinkIndex(ancestor))*F;
+            ancestor = compiledModel.getParent(ancestor);
+
+            if( compiledModel.getJointType(ancestor) != CompiledModel::FIXED_JOINT )
+            {
+                size_t ancestorDofIndex = compiledModel.getDOFsOffset(ancestor);
+                massMatrix(6+dofIndex,6+ancestorDofIndex) = compiledModel.getMotionSubspaceVector(ancestor).dot(F);
+                massMatrix(6+ancestorDofIndex,6+dofIndex) = massMatrix(6+dofIndex,6+ancestorDofIndex);
+            }
+        }
+
+        // Express F in the base link frame for the momentum jacobian part
+        F = parent_X_links(compiledModel.getLinkIndex(ancestor))*F;
+
+        Eigen::Matrix<double,6,1> FEigen = toEigen(F);
+        massMatrixEigen.block<6,1>(0,6+dofIndex) = FEigen;
+        massMatrixEigen.block<1,6>(6+dofIndex,0) = FEigen;
+    }
+
+    Matrix6x6 lockedInertia = linkCRBs(compiledModel.getLinkIndex(0)).asMatrix();
+    massMatrixEigen.block<6,6>(0,0) = toEigen(lockedInertia);
+
+    return true;
+}
+
+bool ArticulatedBodyAlgorithm(const CompiledModel& compiledModel,
+                              const LinkPositions& parent_X_links,
+                              const FreeFloatingVel& robotVel,
+                              const LinkNetExternalWrenches & linkExtWrenches,
+                              const JointDOFsDoubleArray & jointTorques,
+                                    ArticulatedBodyAlgorithmInternalBuffers & bufs,
+                                    FreeFloatingAcc & robotAcc)
+{
+    TraversalIndex nrOfVisitedLinks = static_cast<TraversalIndex>(compiledModel.getNrOfVisitedLinks());
+
+    // See the ArticulatedBodyAlgorithm in Dynamics.cpp for the details
+
+    // Forward pass: link velocities, bias accelerations, and initialization
+    // of the articulated body inertias and bias wrenches
+    for(TraversalIndex traversalEl=0; traversalEl < nrOfVisitedLinks; traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+
+        if( traversalEl == 0 )
+        {
+            bufs.linksVel(visitedLinkIndex) = robotVel.baseVel();
+            bufs.linksBiasAcceleration(visitedLinkIndex) = SpatialAcc::Zero();
+        }
+        else
+        {
+            LinkIndex parentLinkIndex = compiledModel.getLinkIndex(compiledModel.getParent(traversalEl));
+            Transform link_X_parent = parent_X_links(visitedLinkIndex).inverse();
+
+            if( compiledModel.getJointType(traversalEl) == CompiledModel::FIXED_JOINT )
+            {
+                bufs.linksVel(visitedLinkIndex) = link_X_parent*bufs.linksVel(parentLinkIndex);
+                bufs.linksBiasAcceleration(visitedLinkIndex) = SpatialAcc::Zero();
+            }
+            else
+            {
+                size_t dofIndex = compiledModel.getDOFsOffset(traversalEl);
+                bufs.S(dofIndex) = compiledModel.getMotionSubspaceVector(traversalEl);
+                Twist vj;
+                toEigen(vj.getLinearVec3()) = robotVel.jointVel()(dofIndex)*toEigen(bufs.S(dofIndex).getLinearVec3());
+                toEigen(vj.getAngularVec3()) = robotVel.jointVel()(dofIndex)*toEigen(bufs.S(dofIndex).getAngularVec3());
+                bufs.linksVel(visitedLinkIndex) = link_X_parent*bufs.linksVel(parentLinkIndex) + vj;
+                bufs.linksBiasAcceleration(visitedLinkIndex) = bufs.linksVel(visitedLinkIndex)*vj;
+            }
+        }
+
+        const SpatialInertia & I = compiledModel.getInertia(traversalEl);
+        bufs.linkABIs(visitedLinkIndex) = I;
+        bufs.linksBiasWrench(visitedLinkIndex) = bufs.linksVel(visitedLinkIndex)*(I*bufs.linksVel(visitedLinkIndex))
+                                                 - linkExtWrenches(visitedLinkIndex);
+    }
+
+    // Backward pass: articulated body inertias and bias wrenches
+    for(TraversalIndex traversalEl = nrOfVisitedLinks-1; traversalEl > 0; traversalEl--)
+    {
+        LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+        LinkIndex parentLinkIndex  = compiledModel.getLinkIndex(compiledModel.getParent(traversalEl));
+
+        ArticulatedBodyInertia Ia;
+        Wrench pa;
+
+        if( compiledModel.getJointType(traversalEl) != CompiledModel::FIXED_JOINT )
+        {
+            size_t dofIndex = compiledModel.getDOFsOffset(traversalEl);
+            bufs.U(dofIndex) = bufs.linkABIs(visitedLinkIndex)*bufs.S(dofIndex);
+            bufs.D(dofIndex) = bufs.S(dofIndex).dot(bufs.U(dofIndex));
+            bufs.u(dofIndex) = jointTorques(dofIndex) - bufs.S(dofIndex).dot(bufs.linksBiasWrench(visitedLinkIndex));
+
+            Ia = bufs.linkABIs(visitedLinkIndex);
+            Ia.subtractABADyad(bufs.U(dofIndex),bufs.D(dofIndex));
+
+            pa =   bufs.linksBiasWrench(visitedLinkIndex)
+                 + Ia*bufs.linksBiasAcceleration(visitedLinkIndex)
+                 + bufs.U(dofIndex)*(bufs.u(dofIndex)/bufs.D(dofIndex));
+        }
+        else
+        {
+            Ia = bufs.linkABIs(visitedLinkIndex);
+            pa =   bufs.linksBiasWrench(visitedLinkIndex)
+                 + Ia*bufs.linksBiasAcceleration(visitedLinkIndex);
+        }
+
+        const Transform & parent_X_visited = parent_X_links(visitedLinkIndex);
+        bufs.linkABIs(parentLinkIndex).addTransformed(parent_X_visited,Ia);
+        bufs.linksBiasWrench(parentLinkIndex) = bufs.linksBiasWrench(parentLinkIndex) + parent_X_visited*pa;
+    }
+
+    // Second forward pass: accelerations
+    for(TraversalIndex traversalEl=0; traversalEl < nrOfVisitedLinks; traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(traversalEl);
+
+        if( traversalEl == 0 )
+        {
+            bufs.linksAccelerations(visitedLinkIndex) = -(bufs.linkABIs(visitedLinkIndex).applyInverse(bufs.linksBiasWrench(visitedLinkIndex)));
+            robotAcc.baseAcc() = bufs.linksAccelerations(visitedLinkIndex);
+            continue;
+        }
+
+        LinkIndex parentLinkIndex = compiledModel.getLinkIndex(compiledModel.getParent(traversalEl));
+        bufs.linksAccelerations(visitedLinkIndex) =
+            parent_X_links(visitedLinkIndex).inverse()*bufs.linksAccelerations(parentLinkIndex)
+            + bufs.linksBiasAcceleration(visitedLinkIndex);
+
+        if( compiledModel.getJointType(traversalEl) != CompiledModel::FIXED_JOINT )
+        {
+            size_t dofIndex = compiledModel.getDOFsOffset(traversalEl);
+            robotAcc.jointAcc()(dofIndex) = (bufs.u(dofIndex)-bufs.U(dofIndex).dot(bufs.linksAccelerations(visitedLinkIndex)))/bufs.D(dofIndex);
+            bufs.linksAccelerations(visitedLinkIndex) = bufs.linksAccelerations(visitedLinkIndex) + bufs.S(dofIndex)*robotAcc.jointAcc()(dofIndex);
+        }
+    }
+
+    return true;
+}
+
+bool FreeFloatingJacobianUsingLinkPos(const CompiledModel& compiledModel,
+                                      const LinkPositions& world_H_links,
+                                      const LinkIndex jacobianLinkIndex,
+                                      const Transform& jacobFrame_X_world,
+                                      const Transform& baseFrame_X_jacobBaseFrame,
+                                            MatrixDynSize& jacobian)
+{
+    jacobian.zero();
+
+    // Compute base part
+    const Transform & world_H_base = world_H_links(compiledModel.getLinkIndex(0));
+    toEigen(jacobian).block(0,0,6,6) = toEigen((jacobFrame_X_world*world_H_base*baseFrame_X_jacobBaseFrame).asAdjointTransform());
+
+    // Compute joint part, going up in the traversal from the link until we reach the base
+    TraversalIndex visitedTraversalEl = compiledModel.getTraversalIndexFromLinkIndex(jacobianLinkIndex);
+
+    while( visitedTraversalEl > 0 )
+    {
+        if( compiledModel.getJointType(visitedTraversalEl) != CompiledModel::FIXED_JOINT )
+        {
+            LinkIndex visitedLinkIndex = compiledModel.getLinkIndex(visitedTraversalEl);
+            size_t dofOffset = compiledModel.getDOFsOffset(visitedTraversalEl);
+            toEigen(jacobian).block(0,6+dofOffset,6,1) =
+                toEigen(jacobFrame_X_world*(world_H_links(visitedLinkIndex)*compiledModel.getMotionSubspaceVector(visitedTraversalEl)));
+        }
+
+        visitedTraversalEl = compiledModel.getParent(visitedTraversalEl);
+    }
+
+    return true;
+}
+
+}
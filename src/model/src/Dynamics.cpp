@@ -61,7 +61,7 @@ bool ComputeLinearAndAngularMomentumDerivativeBias(const Model & model,
         const Twist     & v = linkVel(lnkIdx);
         const SpatialAcc & a_bias = linkBiasAcc(lnkIdx);
         const SpatialInertia & I = model.getLink(lnkIdx)->getInertia();
-        totalMomentumBias = totalMomentumBias + commonFrame_X_link*(I*a_bias+v*(I*v));
+        totalMomentumBias = totalMomentumBias + commonFrame_X_link*I.netWrench(a_bias,v);
     }
 
     return true;
@@ -94,7 +94,7 @@ bool RNEADynamicPhase(const Model& model, const Traversal& traversal,
         const iDynTree::SpatialInertia & I = visitedLink->getInertia();
         const iDynTree::SpatialAcc     & a = linksAccs(visitedLinkIndex);
         const iDynTree::Twist          & v = linksVels(visitedLinkIndex);
-        f(visitedLinkIndex) = I*a + v*(I*v) - fext(visitedLinkIndex);
+        f(visitedLinkIndex) = I.netWrench(a,v) - fext(visitedLinkIndex);
 
         // Iterate on childs of visitedLink
         // We obtain all the children as all the neighbors of the link, except
@@ -185,8 +185,8 @@ bool CompositeRigidBodyAlgorithm(const Model& model,
         {
             LinkIndex parentLinkIndex = parentLink->getIndex();
 
-            linkCRBs(parentLinkIndex) = linkCRBs(parentLinkIndex) +
-                (toParentJoint->getTransform(jointPos,parentLinkIndex,visitedLinkIndex))*linkCRBs(visitedLinkIndex);
+            linkCRBs(parentLinkIndex).addTransformed(toParentJoint->getTransform(jointPos,parentLinkIndex,visitedLinkIndex),
+                                                     linkCRBs(visitedLinkIndex));
 
             // For now we just implement the CRBA for 0 or 1 dofs joints.
             assert( toParentJoint->getNrOfDOFs() <= 1 );
@@ -274,6 +274,99 @@ bool CompositeRigidBodyAlgorithm(const Model& model,
     return true;
 }
 
+GeneralizedGravityForcesInternalBuffers::GeneralizedGravityForcesInternalBuffers(const Model& model)
+{
+    resize(model);
+}
+
+void GeneralizedGravityForcesInternalBuffers::resize(const Model& model)
+{
+    subtreeMasses.resize(model.getNrOfLinks());
+    subtreeMasses.zero();
+    subtreeFirstMoments.resize(3*model.getNrOfLinks());
+    subtreeFirstMoments.zero();
+}
+
+bool GeneralizedGravityForcesInternalBuffers::isConsistent(const Model& model)
+{
+    return subtreeMasses.size() == model.getNrOfLinks() &&
+           subtreeFirstMoments.size() == 3*model.getNrOfLinks();
+}
+
+bool ComputeGeneralizedGravityForces(const Model& model,
+                                     const Traversal& traversal,
+                                     const JointPosDoubleArray& jointPos,
+                                     const LinkPositions& linkPositions,
+                                     const Vector3& gravity,
+                                           GeneralizedGravityForcesInternalBuffers& buffers,
+                                           FreeFloatingGeneralizedTorques& generalizedGravityForces)
+{
+    if( !buffers.isConsistent(model) )
+    {
+        buffers.resize(model);
+    }
+    else
+    {
+        buffers.subtreeMasses.zero();
+        buffers.subtreeFirstMoments.zero();
+    }
+
+    Eigen::Map<const Eigen::Vector3d> g(gravity.data());
+    Eigen::Map<Eigen::Matrix<double,3,Eigen::Dynamic> > firstMoments(buffers.subtreeFirstMoments.data(),3,model.getNrOfLinks());
+
+    // We visit the links from the leaves to the base, so when a link is visited
+    // the contribution of all its children is already accumulated in its subtree buffers
+    for(int traversalEl = traversal.getNrOfVisitedLinks()-1; traversalEl >= 0; traversalEl--)
+    {
+        LinkConstPtr visitedLink = traversal.getLink(traversalEl);
+        LinkIndex    visitedLinkIndex = visitedLink->getIndex();
+        LinkConstPtr parentLink  = traversal.getParentLink(traversalEl);
+
+        const Transform & world_H_link = linkPositions(visitedLinkIndex);
+        Eigen::Map<const Eigen::Matrix<double,3,3,Eigen::RowMajor> > world_R_link(world_H_link.getRotation().data());
+        Eigen::Map<const Eigen::Vector3d> world_p_link(world_H_link.getPosition().data());
+
+        // The packed inertial parameters start with the mass and the first moment of mass
+        // expressed in the link frame
+        const double * inertialParams = visitedLink->getInertia().packedData();
+        const double mass = inertialParams[0];
+        Eigen::Map<const Eigen::Vector3d> linkFirstMoment(inertialParams+1);
+
+        buffers.subtreeMasses(visitedLinkIndex) += mass;
+        firstMoments.col(visitedLinkIndex) += mass*world_p_link + world_R_link*linkFirstMoment;
+
+        // The wrench that the parent (or, for the base, the rest of the world) applies
+        // to the subtree is the opposite of the gravity wrench acting on the subtree.
+        // It is expressed in the link frame, as the one computed by the RNEADynamicPhase.
+        const double subtreeMass = buffers.subtreeMasses(visitedLinkIndex);
+        Eigen::Vector3d subtreeWeight = subtreeMass*g;
+        Eigen::Vector3d firstMomentWrtLink = firstMoments.col(visitedLinkIndex) - subtreeMass*world_p_link;
+
+        Wrench f;
+        toEigen(f.getLinearVec3())  = -world_R_link.transpose()*subtreeWeight;
+        toEigen(f.getAngularVec3()) = -world_R_link.transpose()*firstMomentWrtLink.cross(g);
+
+        if( parentLink == 0 )
+        {
+            generalizedGravityForces.baseWrench() = f;
+        }
+        else
+        {
+            LinkIndex parentLinkIndex = parentLink->getIndex();
+            buffers.subtreeMasses(parentLinkIndex) += subtreeMass;
+            firstMoments.col(parentLinkIndex) += firstMoments.col(visitedLinkIndex);
+
+            traversal.getParentJoint(traversalEl)->computeJointTorque(jointPos,
+                                                                      f,
+                                                                      parentLinkIndex,
+                                                                      visitedLinkIndex,
+                                                                      generalizedGravityForces.jointTorques());
+        }
+    }
+
+    return true;
+}
+
 ArticulatedBodyAlgorithmInternalBuffers::ArticulatedBodyAlgorithmInternalBuffers(const Model& model)
 {
     resize(model);
@@ -290,6 +383,7 @@ void ArticulatedBodyAlgorithmInternalBuffers::resize(const Model& model)
     linksAccelerations.resize(model);
     linkABIs.resize(model);
     linksBiasWrench.resize(model);
+    parent_X_links.resize(model);
     // debug
     //pa.resize(model);
 }
@@ -306,18 +400,25 @@ bool ArticulatedBodyAlgorithmInternalBuffers::isConsistent(const Model& model)
     ok = ok && linksBiasAcceleration.isConsistent(model);
     ok = ok && linkABIs.isConsistent(model);
     ok = ok && linksBiasWrench.isConsistent(model);
+    ok = ok && parent_X_links.isConsistent(model);
 
     return ok;
 }
 
-bool ArticulatedBodyAlgorithm(const Model& model,
-                              const Traversal& traversal,
-                              const FreeFloatingPos& robotPos,
-                              const FreeFloatingVel& robotVel,
-                              const LinkNetExternalWrenches & linkExtWrenches,
-                              const JointDOFsDoubleArray & jointTorques,
-                                    ArticulatedBodyAlgorithmInternalBuffers & bufs,
-                                    FreeFloatingAcc & robotAcc)
+namespace
+{
+
+/**
+ * Body of the ArticulatedBodyAlgorithm, that uses the
+ * parent_X_link transforms already stored in bufs.parent_X_links .
+ */
+bool ArticulatedBodyAlgorithmUsingJointTransforms(const Model& model,
+                                                  const Traversal& traversal,
+                                                  const FreeFloatingVel& robotVel,
+                                                  const LinkNetExternalWrenches & linkExtWrenches,
+                                                  const JointDOFsDoubleArray & jointTorques,
+                                                        ArticulatedBodyAlgorithmInternalBuffers & bufs,
+                                                        FreeFloatingAcc & robotAcc)
 {
     /**
      * Forward pass: compute the link velocities and the link bias accelerations
@@ -346,7 +447,7 @@ bool ArticulatedBodyAlgorithm(const Model& model,
             if( toParentJoint->getNrOfDOFs() == 0 )
             {
                 bufs.linksVel(visitedLinkIndex) =
-                    toParentJoint->getTransform(robotPos.jointPos(),visitedLinkIndex,parentLink->getIndex())*bufs.linksVel(parentLinkIndex);
+                    bufs.parent_X_links(visitedLinkIndex).inverse()*bufs.linksVel(parentLinkIndex);
                 bufs.linksBiasAcceleration(visitedLinkIndex) = SpatialAcc::Zero();
             }
             else
@@ -357,7 +458,7 @@ bool ArticulatedBodyAlgorithm(const Model& model,
                 toEigen(vj.getLinearVec3()) = robotVel.jointVel()(dofIndex)*toEigen(bufs.S(dofIndex).getLinearVec3());
                 toEigen(vj.getAngularVec3()) = robotVel.jointVel()(dofIndex)*toEigen(bufs.S(dofIndex).getAngularVec3());
                 bufs.linksVel(visitedLinkIndex) =
-                    toParentJoint->getTransform(robotPos.jointPos(),visitedLinkIndex,parentLinkIndex)*bufs.linksVel(parentLinkIndex)
+                    bufs.parent_X_links(visitedLinkIndex).inverse()*bufs.linksVel(parentLinkIndex)
                     + vj;
                 bufs.linksBiasAcceleration(visitedLinkIndex) = bufs.linksVel(visitedLinkIndex)*vj;
 
@@ -403,7 +504,8 @@ bool ArticulatedBodyAlgorithm(const Model& model,
                 bufs.D(dofIndex) = bufs.S(dofIndex).dot(bufs.U(dofIndex));
                 bufs.u(dofIndex) = jointTorques(dofIndex) - bufs.S(dofIndex).dot(bufs.linksBiasWrench(visitedLinkIndex));
 
-                Ia = bufs.linkABIs(visitedLinkIndex) - ArticulatedBodyInertia::ABADyadHelper(bufs.U(dofIndex),bufs.D(dofIndex));
+                Ia = bufs.linkABIs(visitedLinkIndex);
+                Ia.subtractABADyad(bufs.U(dofIndex),bufs.D(dofIndex));
 
                 pa                 =   bufs.linksBiasWrench(visitedLinkIndex)
                                      + Ia*bufs.linksBiasAcceleration(visitedLinkIndex)
@@ -425,8 +527,8 @@ bool ArticulatedBodyAlgorithm(const Model& model,
 
             // Propagate
             LinkIndex parentLinkIndex = parentLink->getIndex();
-            Transform parent_X_visited = toParentJoint->getTransform(robotPos.jointPos(),parentLinkIndex,visitedLinkIndex);
-            bufs.linkABIs(parentLinkIndex)        += parent_X_visited*Ia;
+            const Transform & parent_X_visited = bufs.parent_X_links(visitedLinkIndex);
+            bufs.linkABIs(parentLinkIndex).addTransformed(parent_X_visited,Ia);
             bufs.linksBiasWrench(parentLinkIndex) = bufs.linksBiasWrench(parentLinkIndex) + parent_X_visited*pa;
         }
     }
@@ -458,7 +560,7 @@ bool ArticulatedBodyAlgorithm(const Model& model,
                size_t dofIndex = toParentJoint->getDOFsOffset();
                assert(toParentJoint->getNrOfDOFs()==1);
                bufs.linksAccelerations(visitedLinkIndex) =
-                   toParentJoint->getTransform(robotPos.jointPos(),visitedLinkIndex,parentLinkIndex)*bufs.linksAccelerations(parentLinkIndex)
+                   bufs.parent_X_links(visitedLinkIndex).inverse()*bufs.linksAccelerations(parentLinkIndex)
                    + bufs.linksBiasAcceleration(visitedLinkIndex);
                robotAcc.jointAcc()(dofIndex) = (bufs.u(dofIndex)-bufs.U(dofIndex).dot(bufs.linksAccelerations(visitedLinkIndex)))/bufs.D(dofIndex);
                bufs.linksAccelerations(visitedLinkIndex) = bufs.linksAccelerations(visitedLinkIndex) + bufs.S(dofIndex)*robotAcc.jointAcc()(dofIndex);
@@ -467,7 +569,7 @@ bool ArticulatedBodyAlgorithm(const Model& model,
            {
                //for fixed joints we just propagate the acceleration
                bufs.linksAccelerations(visitedLinkIndex) =
-                   toParentJoint->getTransform(robotPos.jointPos(),visitedLinkIndex,parentLinkIndex)*bufs.linksAccelerations(parentLinkIndex)
+                   bufs.parent_X_links(visitedLinkIndex).inverse()*bufs.linksAccelerations(parentLinkIndex)
                    + bufs.linksBiasAcceleration(visitedLinkIndex);
            }
        }
@@ -476,12 +578,48 @@ bool ArticulatedBodyAlgorithm(const Model& model,
     return true;
 }
 
+}
 
+bool ArticulatedBodyAlgorithm(const Model& model,
+                              const Traversal& traversal,
+                              const FreeFloatingPos& robotPos,
+                              const FreeFloatingVel& robotVel,
+                              const LinkNetExternalWrenches & linkExtWrenches,
+                              const JointDOFsDoubleArray & jointTorques,
+                                    ArticulatedBodyAlgorithmInternalBuffers & bufs,
+                                    FreeFloatingAcc & robotAcc)
+{
+    // Compute each joint transform once, instead of once for each pass of the algorithm
+    for(unsigned int traversalEl=1; traversalEl < traversal.getNrOfVisitedLinks(); traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+        LinkIndex parentLinkIndex = traversal.getParentLink(traversalEl)->getIndex();
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+        bufs.parent_X_links(visitedLinkIndex) = toParentJoint->getTransform(robotPos.jointPos(),parentLinkIndex,visitedLinkIndex);
+    }
 
+    return ArticulatedBodyAlgorithmUsingJointTransforms(model,traversal,robotVel,linkExtWrenches,jointTorques,bufs,robotAcc);
 }
 
+bool ArticulatedBodyAlgorithm(const Model& model,
+                              const Traversal& traversal,
+                              const LinkPositions& linkPositions,
+                              const FreeFloatingVel& robotVel,
+                              const LinkNetExternalWrenches & linkExtWrenches,
+                              const JointDOFsDoubleArray & jointTorques,
+                                    ArticulatedBodyAlgorithmInternalBuffers & bufs,
+                                    FreeFloatingAcc & robotAcc)
+{
+    for(unsigned int traversalEl=1; traversalEl < traversal.getNrOfVisitedLinks(); traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+        LinkIndex parentLinkIndex = traversal.getParentLink(traversalEl)->getIndex();
+        bufs.parent_X_links(visitedLinkIndex) = linkPositions(parentLinkIndex).inverse()*linkPositions(visitedLinkIndex);
+    }
 
+    return ArticulatedBodyAlgorithmUsingJointTransforms(model,traversal,robotVel,linkExtWrenches,jointTorques,bufs,robotAcc);
+}
 
 
 
-
+}
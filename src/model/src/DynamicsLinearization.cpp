@@ -16,9 +16,11 @@
 #include <iDynTree/Model/Traversal.h>
 
 #include <iDynTree/Model/FreeFloatingState.h>
+#include <iDynTree/Model/ForwardKinematics.h>
 
 #include <iDynTree/Core/EigenHelpers.h>
 #include <iDynTree/Core/TransformDerivative.h>
+#include <iDynTree/Core/Utils.h>
 
 #include <Eigen/Core>
 
@@ -207,8 +209,8 @@ void ForwardDynamicsLinearizationWrtJointPos(const Model& model,
                 dPos_Ia = bufs.dPos[dofDeriv].linkABIs(visitedLinkIndex) -
                         ArticulatedBodyInertia::ABADyadHelperLin(bufs.aba.U(dofIndex),invD,
                                                                  bufs.dPos[dofDeriv].U(dofIndex),d_invD);
-                Ia = bufs.aba.linkABIs(visitedLinkIndex)
-                    - ArticulatedBodyInertia::ABADyadHelper(bufs.aba.U(dofIndex),bufs.aba.D(dofIndex));
+                Ia = bufs.aba.linkABIs(visitedLinkIndex);
+                Ia.subtractABADyad(bufs.aba.U(dofIndex),bufs.aba.D(dofIndex));
                 dPos_pa    =  bufs.dPos[dofDeriv].linksBiasWrench(visitedLinkIndex)
                                      + dPos_Ia*bufs.aba.linksBiasAcceleration(visitedLinkIndex)
                                      + Ia*bufs.dPos[dofDeriv].linksBiasAcceleration(visitedLinkIndex)
@@ -234,7 +236,7 @@ void ForwardDynamicsLinearizationWrtJointPos(const Model& model,
             // Propagate
             LinkIndex parentLinkIndex = parentLink->getIndex();
             Transform parent_X_visited = toParentJoint->getTransform(robotPos.jointPos(),parentLinkIndex,visitedLinkIndex);
-            bufs.dPos[dofDeriv].linkABIs(parentLinkIndex)        += parent_X_visited*dPos_Ia;
+            bufs.dPos[dofDeriv].linkABIs(parentLinkIndex).addTransformed(parent_X_visited,dPos_Ia);
             bufs.dPos[dofDeriv].linksBiasWrench(parentLinkIndex) = bufs.dPos[dofDeriv].linksBiasWrench(parentLinkIndex) + parent_X_visited*dPos_pa;
 
             // if the visited link is connected to the parent with the joint wrt we are computing the
@@ -426,8 +428,8 @@ void ForwardDynamicsLinearizationWrtBaseTwist(const Model& model,
                 assert(toParentJoint->getNrOfDOFs()==1);
                 size_t dofIndex = toParentJoint->getDOFsOffset();
 
-                Ia = bufs.aba.linkABIs(visitedLinkIndex)
-                    - ArticulatedBodyInertia::ABADyadHelper(bufs.aba.U(dofIndex),bufs.aba.D(dofIndex));
+                Ia = bufs.aba.linkABIs(visitedLinkIndex);
+                Ia.subtractABADyad(bufs.aba.U(dofIndex),bufs.aba.D(dofIndex));
 
                 toEigen(bufs.dVb_u[dofIndex]) = -toEigen(bufs.aba.S(dofIndex)).transpose()*toEigen(bufs.dVb_linkBiasWrench[visitedLinkIndex]);
                 toEigen(dVb_pa)  =  toEigen(bufs.dVb_linkBiasWrench[visitedLinkIndex])
@@ -604,7 +606,8 @@ void ForwardDynamicsLinearizationWrtJointVel(const Model& model,
                 size_t dofIndex = toParentJoint->getDOFsOffset();
                 bufs.dVel[dofDeriv].u(dofIndex) = -bufs.aba.S(dofIndex).dot(bufs.dVel[dofDeriv].linksBiasWrench(visitedLinkIndex));
 
-                Ia = bufs.aba.linkABIs(visitedLinkIndex) - ArticulatedBodyInertia::ABADyadHelper(bufs.aba.U(dofIndex),bufs.aba.D(dofIndex));
+                Ia = bufs.aba.linkABIs(visitedLinkIndex);
+                Ia.subtractABADyad(bufs.aba.U(dofIndex),bufs.aba.D(dofIndex));
 
                 dVel_dofDeriv_pa   =   bufs.dVel[dofDeriv].linksBiasWrench(visitedLinkIndex)
                                      + Ia*bufs.dVel[dofDeriv].linksBiasAcceleration(visitedLinkIndex)
@@ -793,10 +796,338 @@ bool ForwardDynamicsLinearization(const Model& model,
     return ok;
 }
 
+InverseDynamicsDerivativesInternalBuffers::InverseDynamicsDerivativesInternalBuffers(const Model& model)
+{
+    resize(model);
+}
+
+void InverseDynamicsDerivativesInternalBuffers::resize(const Model& model)
+{
+    properAcc.resize(model);
+    linksVel.resize(model);
+    linksProperAcc.resize(model);
+    linksIntWrenches.resize(model);
+    generalizedTorques.resize(model);
+
+    size_t nrOfLinks = model.getNrOfLinks();
+
+    link_X_parent.resize(nrOfLinks);
+    linkInertia.resize(nrOfLinks);
+    dVl_linkLocalBiasWrench.resize(nrOfLinks);
+    dVl_linkExtWrench.resize(nrOfLinks);
+    isLinkInSubtree.assign(nrOfLinks,false);
+    dPos_linksVel.resize(nrOfLinks);
+    dPos_linksAcc.resize(nrOfLinks);
+    dPos_linksWrench.resize(nrOfLinks);
+    dVel_linksVel.resize(nrOfLinks);
+    dVel_linksAcc.resize(nrOfLinks);
+    dVel_linksWrench.resize(nrOfLinks);
+    dAcc_linksAcc.resize(nrOfLinks);
+    dAcc_linksWrench.resize(nrOfLinks);
+
+    for(size_t link = 0; link < nrOfLinks; link++ )
+    {
+        link_X_parent[link].zero();
+        linkInertia[link].zero();
+        dVl_linkLocalBiasWrench[link].zero();
+        dVl_linkExtWrench[link].zero();
+        dPos_linksVel[link].zero();
+        dPos_linksAcc[link].zero();
+        dPos_linksWrench[link].zero();
+        dVel_linksVel[link].zero();
+        dVel_linksAcc[link].zero();
+        dVel_linksWrench[link].zero();
+        dAcc_linksAcc[link].zero();
+        dAcc_linksWrench[link].zero();
+    }
+}
+
+/**
+ * Cross product (v \times) u between two spatial motion vectors.
+ */
+inline Eigen::Matrix<double,6,1> idDerivMotionCross(const Eigen::Matrix<double,6,1> & v,
+                                                    const Eigen::Matrix<double,6,1> & u)
+{
+    Eigen::Matrix<double,6,1> ret;
+    ret.segment<3>(0) = v.segment<3>(3).cross(u.segment<3>(0)) + v.segment<3>(0).cross(u.segment<3>(3));
+    ret.segment<3>(3) = v.segment<3>(3).cross(u.segment<3>(3));
+    return ret;
+}
+
+/**
+ * Cross product (v \bar\times^*) f between a spatial motion vector and a spatial force vector.
+ */
+inline Eigen::Matrix<double,6,1> idDerivForceCross(const Eigen::Matrix<double,6,1> & v,
+                                                   const Eigen::Matrix<double,6,1> & f)
+{
+    Eigen::Matrix<double,6,1> ret;
+    ret.segment<3>(0) = v.segment<3>(3).cross(f.segment<3>(0));
+    ret.segment<3>(3) = v.segment<3>(3).cross(f.segment<3>(3)) + v.segment<3>(0).cross(f.segment<3>(0));
+    return ret;
 }
 
+bool InverseDynamicsDerivatives(const Model& model,
+                                const Traversal& traversal,
+                                const FreeFloatingPos& robotPos,
+                                const FreeFloatingVel& robotVel,
+                                const FreeFloatingAcc& robotAcc,
+                                const Vector3& worldGravity,
+                                const LinkNetExternalWrenches& linkExtWrenches,
+                                const FrameVelocityRepresentation linkExtWrenchesRepr,
+                                      InverseDynamicsDerivativesInternalBuffers& bufs,
+                                      MatrixDynSize& dTau_dq,
+                                      MatrixDynSize& dTau_dnu,
+                                      MatrixDynSize& dTau_dnudot)
+{
+    const size_t nDof = model.getNrOfDOFs();
+    const size_t size = 6+nDof;
+
+    if( robotPos.jointPos().size() != model.getNrOfPosCoords() ||
+        robotVel.jointVel().size() != nDof ||
+        robotAcc.jointAcc().size() != nDof ||
+        !linkExtWrenches.isConsistent(model) ||
+        bufs.link_X_parent.size() != model.getNrOfLinks() )
+    {
+        reportError("","InverseDynamicsDerivatives","Inputs or buffers are not consistent with the model");
+        return false;
+    }
+
+    dTau_dq.resize(size,size);
+    dTau_dnu.resize(size,size);
+    dTau_dnudot.resize(size,size);
+
+    Eigen::Map< Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > dTau_dqEig = toEigen(dTau_dq);
+    Eigen::Map< Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > dTau_dnuEig = toEigen(dTau_dnu);
+    Eigen::Map< Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > dTau_dnudotEig = toEigen(dTau_dnudot);
 
+    // The gravity acts on the robot as a base acceleration of opposite sign,
+    // so we run the RNEA with the proper acceleration of the base
+    Eigen::Vector3d gravityInBase =
+        toEigen(robotPos.worldBasePos().getRotation()).transpose()*toEigen(worldGravity);
+    bufs.properAcc.baseAcc() = robotAcc.baseAcc();
+    toEigen(bufs.properAcc.baseAcc().getLinearVec3()) = toEigen(robotAcc.baseAcc().getLinearVec3()) - gravityInBase;
+    toEigen(bufs.properAcc.jointAcc()) = toEigen(robotAcc.jointAcc());
 
+    bool ok = ForwardVelAccKinematics(model,traversal,robotPos,robotVel,bufs.properAcc,bufs.linksVel,bufs.linksProperAcc);
+    ok = ok && RNEADynamicPhase(model,traversal,robotPos.jointPos(),bufs.linksVel,bufs.linksProperAcc,
+                                linkExtWrenches,bufs.linksIntWrenches,bufs.generalizedTorques);
 
+    if( !ok )
+    {
+        reportError("","InverseDynamicsDerivatives","Error in computing the inverse dynamics");
+        return false;
+    }
+
+    // Compute the quantities that do not depend on the variable with respect to which we are differentiating
+    for(unsigned int traversalEl=0; traversalEl < traversal.getNrOfVisitedLinks(); traversalEl++)
+    {
+        LinkConstPtr visitedLink = traversal.getLink(traversalEl);
+        LinkIndex visitedLinkIndex = visitedLink->getIndex();
+        LinkConstPtr parentLink  = traversal.getParentLink(traversalEl);
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+        if( parentLink )
+        {
+            if( toParentJoint->getNrOfDOFs() > 1 )
+            {
+                reportError("","InverseDynamicsDerivatives","Joints with more than 1 dof are not supported");
+                return false;
+            }
+
+            bufs.link_X_parent[visitedLinkIndex] =
+                toParentJoint->getTransform(robotPos.jointPos(),visitedLinkIndex,parentLink->getIndex()).asAdjointTransform();
+        }
+
+        const SpatialInertia & M = visitedLink->getInertia();
+        bufs.linkInertia[visitedLinkIndex] = M.asMatrix();
+        bufs.dVl_linkLocalBiasWrench[visitedLinkIndex] = M.biasWrenchDerivative(bufs.linksVel(visitedLinkIndex));
+
+        // If the external wrench is constant in the inertial frame (or in the mixed frame), its expression in the
+        // link frame changes as the link moves: for a variation of the link position corresponding to a
+        // link velocity dv, the external wrench changes by -dv \bar\times^* f (only the angular part of dv for the mixed case),
+        // and so the internal wrench of the link changes by dv \bar\times^* f
+        Eigen::Map< Eigen::Matrix<double,6,6,Eigen::RowMajor> > dVl_extWrench = toEigen(bufs.dVl_linkExtWrench[visitedLinkIndex]);
+        dVl_extWrench.setZero();
+        if( linkExtWrenchesRepr != BODY_FIXED_REPRESENTATION )
+        {
+            Eigen::Vector3d fLin = toEigen(linkExtWrenches(visitedLinkIndex).getLinearVec3());
+            Eigen::Vector3d fAng = toEigen(linkExtWrenches(visitedLinkIndex).getAngularVec3());
+            dVl_extWrench.block<3,3>(0,3) = -skew(fLin);
+            dVl_extWrench.block<3,3>(3,3) = -skew(fAng);
+            if( linkExtWrenchesRepr == INERTIAL_FIXED_REPRESENTATION )
+            {
+                dVl_extWrench.block<3,3>(3,0) = -skew(fLin);
+            }
+        }
+    }
 
+    // Each column of the output matrices is computed with a forward pass that computes the derivative of the
+    // link velocities and proper accelerations, and a backward pass that computes the derivative of the
+    // internal wrenches, as in the RNEA. The derivatives are non-zero only for the links in the
+    // subtree of the joint with respect to which we are differentiating (all the links for the base) in the forward pass,
+    // and for the links in the subtree and their ancestors in the backward pass.
+    for(size_t col = 0; col < size; col++)
+    {
+        bool isBaseCol = (col < 6);
 
+        // Forward pass
+        for(unsigned int traversalEl=0; traversalEl < traversal.getNrOfVisitedLinks(); traversalEl++)
+        {
+            LinkConstPtr visitedLink = traversal.getLink(traversalEl);
+            LinkIndex visitedLinkIndex = visitedLink->getIndex();
+            LinkConstPtr parentLink  = traversal.getParentLink(traversalEl);
+            IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+            Eigen::Map<Eigen::Matrix<double,6,1> > dPos_v = toEigen(bufs.dPos_linksVel[visitedLinkIndex]);
+            Eigen::Map<Eigen::Matrix<double,6,1> > dPos_a = toEigen(bufs.dPos_linksAcc[visitedLinkIndex]);
+            Eigen::Map<Eigen::Matrix<double,6,1> > dVel_v = toEigen(bufs.dVel_linksVel[visitedLinkIndex]);
+            Eigen::Map<Eigen::Matrix<double,6,1> > dVel_a = toEigen(bufs.dVel_linksAcc[visitedLinkIndex]);
+            Eigen::Map<Eigen::Matrix<double,6,1> > dAcc_a = toEigen(bufs.dAcc_linksAcc[visitedLinkIndex]);
+
+            if( parentLink == 0 )
+            {
+                // The base velocity and acceleration are inputs, that do not depend
+                // on the base position
+                bufs.isLinkInSubtree[visitedLinkIndex] = isBaseCol;
+                dPos_v.setZero();
+                dPos_a.setZero();
+                dVel_v.setZero();
+                dVel_a.setZero();
+                dAcc_a.setZero();
+
+                if( isBaseCol )
+                {
+                    dVel_v(col) = 1.0;
+                    dAcc_a(col) = 1.0;
+                }
+
+                continue;
+            }
+
+            LinkIndex parentLinkIndex = parentLink->getIndex();
+            bool isDerivJoint = (toParentJoint->getNrOfDOFs() == 1 &&
+                                 !isBaseCol && toParentJoint->getDOFsOffset() == col-6);
+
+            bufs.isLinkInSubtree[visitedLinkIndex] = bufs.isLinkInSubtree[parentLinkIndex] || isDerivJoint;
+
+            if( !bufs.isLinkInSubtree[visitedLinkIndex] )
+            {
+                continue;
+            }
+
+            Eigen::Map< Eigen::Matrix<double,6,6,Eigen::RowMajor> > X = toEigen(bufs.link_X_parent[visitedLinkIndex]);
+
+            if( isDerivJoint )
+            {
+                // The parent link is not in the subtree, so its derivatives are zero
+                Eigen::Matrix<double,6,1> S = toEigen(toParentJoint->getMotionSubspaceVector(0,visitedLinkIndex,parentLinkIndex));
+                Eigen::Matrix<double,6,1> v = toEigen(bufs.linksVel(visitedLinkIndex));
+                double dq = robotVel.jointVel()(col-6);
+
+                // Derivative of the link_X_parent transform: d(link_X_parent)/dq = -(S \times) link_X_parent
+                Eigen::Matrix<double,6,1> aFromParent = X*toEigen(bufs.linksProperAcc(parentLinkIndex));
+                dPos_v = idDerivMotionCross(v,S);
+                dPos_a = idDerivMotionCross(aFromParent,S) + idDerivMotionCross(dPos_v,S)*dq;
+
+                dVel_v = S;
+                dVel_a = idDerivMotionCross(v,S);
+
+                dAcc_a = S;
+            }
+            else
+            {
+                dPos_v = X*toEigen(bufs.dPos_linksVel[parentLinkIndex]);
+                dPos_a = X*toEigen(bufs.dPos_linksAcc[parentLinkIndex]);
+                dVel_v = X*toEigen(bufs.dVel_linksVel[parentLinkIndex]);
+                dVel_a = X*toEigen(bufs.dVel_linksAcc[parentLinkIndex]);
+                dAcc_a = X*toEigen(bufs.dAcc_linksAcc[parentLinkIndex]);
+
+                if( toParentJoint->getNrOfDOFs() == 1 )
+                {
+                    Eigen::Matrix<double,6,1> vj =
+                        toEigen(toParentJoint->getMotionSubspaceVector(0,visitedLinkIndex,parentLinkIndex))*
+                        robotVel.jointVel()(toParentJoint->getDOFsOffset());
+                    dPos_a += idDerivMotionCross(dPos_v,vj);
+                    dVel_a += idDerivMotionCross(dVel_v,vj);
+                }
+            }
+        }
+
+        // Backward pass
+        for(int traversalEl = traversal.getNrOfVisitedLinks()-1; traversalEl >= 0; traversalEl--)
+        {
+            LinkConstPtr visitedLink = traversal.getLink(traversalEl);
+            LinkIndex    visitedLinkIndex = visitedLink->getIndex();
+            LinkConstPtr parentLink  = traversal.getParentLink(traversalEl);
+            IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+            Eigen::Map<Eigen::Matrix<double,6,1> > dPos_f = toEigen(bufs.dPos_linksWrench[visitedLinkIndex]);
+            Eigen::Map<Eigen::Matrix<double,6,1> > dVel_f = toEigen(bufs.dVel_linksWrench[visitedLinkIndex]);
+            Eigen::Map<Eigen::Matrix<double,6,1> > dAcc_f = toEigen(bufs.dAcc_linksWrench[visitedLinkIndex]);
+
+            // The derivative of the wrenches of the children have already been summed in the
+            // buffers of the visited link, we add the derivative of the local terms
+            if( bufs.isLinkInSubtree[visitedLinkIndex] )
+            {
+                Eigen::Map< Eigen::Matrix<double,6,6,Eigen::RowMajor> > M = toEigen(bufs.linkInertia[visitedLinkIndex]);
+                Eigen::Map< Eigen::Matrix<double,6,6,Eigen::RowMajor> > dVl_biasWrench = toEigen(bufs.dVl_linkLocalBiasWrench[visitedLinkIndex]);
+                Eigen::Map< Eigen::Matrix<double,6,6,Eigen::RowMajor> > dVl_extWrench = toEigen(bufs.dVl_linkExtWrench[visitedLinkIndex]);
+
+                dPos_f += M*toEigen(bufs.dPos_linksAcc[visitedLinkIndex])
+                          + dVl_biasWrench*toEigen(bufs.dPos_linksVel[visitedLinkIndex])
+                          + dVl_extWrench*toEigen(bufs.dVel_linksVel[visitedLinkIndex]);
+                dVel_f += M*toEigen(bufs.dVel_linksAcc[visitedLinkIndex])
+                          + dVl_biasWrench*toEigen(bufs.dVel_linksVel[visitedLinkIndex]);
+                dAcc_f += M*toEigen(bufs.dAcc_linksAcc[visitedLinkIndex]);
+            }
+
+            if( parentLink == 0 )
+            {
+                dTau_dqEig.block<6,1>(0,col) = dPos_f;
+                dTau_dnuEig.block<6,1>(0,col) = dVel_f;
+                dTau_dnudotEig.block<6,1>(0,col) = dAcc_f;
+            }
+            else
+            {
+                LinkIndex parentLinkIndex = parentLink->getIndex();
+
+                if( toParentJoint->getNrOfDOFs() == 1 )
+                {
+                    size_t dofIndex = toParentJoint->getDOFsOffset();
+                    Eigen::Matrix<double,6,1> S = toEigen(toParentJoint->getMotionSubspaceVector(0,visitedLinkIndex,parentLinkIndex));
+                    dTau_dqEig(6+dofIndex,col) = S.dot(dPos_f);
+                    dTau_dnuEig(6+dofIndex,col) = S.dot(dVel_f);
+                    dTau_dnudotEig(6+dofIndex,col) = S.dot(dAcc_f);
+
+                    // Derivative of the parent_X_link transform used to propagate the wrench to the parent:
+                    // d(parent_X_link^*)/dq f = parent_X_link^* (S \bar\times^* f)
+                    if( !isBaseCol && dofIndex == col-6 )
+                    {
+                        dPos_f += idDerivForceCross(S,toEigen(bufs.linksIntWrenches(visitedLinkIndex)));
+                    }
+                }
+
+                // Propagate the derivatives to the parent (the adjoint wrench transform parent_X_link^* is
+                // the transpose of link_X_parent)
+                Eigen::Map< Eigen::Matrix<double,6,6,Eigen::RowMajor> > X = toEigen(bufs.link_X_parent[visitedLinkIndex]);
+                toEigen(bufs.dPos_linksWrench[parentLinkIndex]) += X.transpose()*dPos_f;
+                toEigen(bufs.dVel_linksWrench[parentLinkIndex]) += X.transpose()*dVel_f;
+                toEigen(bufs.dAcc_linksWrench[parentLinkIndex]) += X.transpose()*dAcc_f;
+            }
+
+            // Reset the buffers for the next column
+            dPos_f.setZero();
+            dVel_f.setZero();
+            dAcc_f.setZero();
+        }
+    }
+
+    // The base position affects the inverse dynamics (with external wrenches constant in the link frame)
+    // only through the gravity expressed in the base frame, i.e. through the base proper acceleration:
+    // d(base_R_world g) = (base_R_world g) \times d\theta, and the linear part of the proper acceleration is a_b - base_R_world g
+    dTau_dqEig.block(0,3,size,3) -= dTau_dnudotEig.block(0,0,size,3)*skew(gravityInBase);
+
+    return true;
+}
+
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Model/FreeFloatingMassMatrixFactorization.h>
+
+#include <iDynTree/Model/Model.h>
+#include <iDynTree/Model/Traversal.h>
+#include <iDynTree/Model/FreeFloatingMatrices.h>
+
+#include <iDynTree/Core/Utils.h>
+
+#include <cmath>
+
+namespace iDynTree
+{
+
+FreeFloatingMassMatrixFactorization::FreeFloatingMassMatrixFactorization()
+{
+}
+
+bool FreeFloatingMassMatrixFactorization::setTraversal(const Model& model, const Traversal& traversal)
+{
+    size_t size = 6+model.getNrOfDOFs();
+
+    m_dofsVisitOrder.clear();
+    m_dofsVisitOrder.reserve(size);
+    m_dofParent.assign(size,-1);
+
+    // The base degrees of freedom form a chain at the root of the tree
+    for(int baseDof=0; baseDof < 6; baseDof++)
+    {
+        m_dofsVisitOrder.push_back(baseDof);
+        m_dofParent[baseDof] = baseDof-1;
+    }
+
+    // For each link, the last degree of freedom found in the path from the link to the base
+    std::vector<int> linkLastDOF(model.getNrOfLinks(),5);
+
+    for(TraversalIndex traversalEl=1; traversalEl < static_cast<TraversalIndex>(traversal.getNrOfVisitedLinks()); traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+        LinkIndex parentLinkIndex = traversal.getParentLink(traversalEl)->getIndex();
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+        if( toParentJoint->getNrOfDOFs() > 1 )
+        {
+            reportError("FreeFloatingMassMatrixFactorization","setTraversal","joints with more than 1 dof are not supported");
+            m_dofsVisitOrder.clear();
+            m_dofParent.clear();
+            return false;
+        }
+
+        linkLastDOF[visitedLinkIndex] = linkLastDOF[parentLinkIndex];
+
+        if( toParentJoint->getNrOfDOFs() == 1 )
+        {
+            int dof = 6+toParentJoint->getDOFsOffset();
+            m_dofsVisitOrder.push_back(dof);
+            m_dofParent[dof] = linkLastDOF[parentLinkIndex];
+            linkLastDOF[visitedLinkIndex] = dof;
+        }
+    }
+
+    if( m_dofsVisitOrder.size() != size )
+    {
+        reportError("FreeFloatingMassMatrixFactorization","setTraversal","the traversal does not visit all the joints of the model");
+        m_dofsVisitOrder.clear();
+        m_dofParent.clear();
+        return false;
+    }
+
+    return true;
+}
+
+size_t FreeFloatingMassMatrixFactorization::getSize() const
+{
+    return m_dofsVisitOrder.size();
+}
+
+bool FreeFloatingMassMatrixFactorization::factorize(FreeFloatingMassMatrix& massMatrix) const
+{
+    size_t size = getSize();
+    if( size == 0 || massMatrix.rows() != size || massMatrix.cols() != size )
+    {
+        reportError("FreeFloatingMassMatrixFactorization","factorize","the size of the mass matrix is not consistent with the traversal");
+        return false;
+    }
+
+    // LTDL factorization, Featherstone 2008, Table 6.3
+    for(int visitEl=static_cast<int>(size)-1; visitEl >= 0; visitEl--)
+    {
+        int k = m_dofsVisitOrder[visitEl];
+
+        if( massMatrix(k,k) <= 0.0 )
+        {
+            reportError("FreeFloatingMassMatrixFactorization","factorize","the mass matrix is not positive definite");
+            return false;
+        }
+
+        for(int i=m_dofParent[k]; i >= 0; i=m_dofParent[i])
+        {
+            double a = massMatrix(k,i)/massMatrix(k,k);
+            for(int j=i; j >= 0; j=m_dofParent[j])
+            {
+                massMatrix(i,j) = massMatrix(i,j) - a*massMatrix(k,j);
+            }
+            massMatrix(k,i) = a;
+        }
+    }
+
+    return true;
+}
+
+void FreeFloatingMassMatrixFactorization::multiplyByInverseSquareRootInPlace(const FreeFloatingMassMatrix& factorizedMassMatrix,
+                                                                             double* x) const
+{
+    // x = L^{-T} x , Featherstone 2008, Table 6.4
+    for(int visitEl=static_cast<int>(getSize())-1; visitEl >= 0; visitEl--)
+    {
+        int i = m_dofsVisitOrder[visitEl];
+        for(int j=m_dofParent[i]; j >= 0; j=m_dofParent[j])
+        {
+            x[j] = x[j] - factorizedMassMatrix(i,j)*x[i];
+        }
+    }
+
+    // x = D^{-1/2} x
+    for(size_t i=0; i < getSize(); i++)
+    {
+        x[i] = x[i]/std::sqrt(factorizedMassMatrix(i,i));
+    }
+}
+
+bool FreeFloatingMassMatrixFactorization::multiplyByInverse(const FreeFloatingMassMatrix& factorizedMassMatrix,
+                                                            const VectorDynSize& b,
+                                                                  VectorDynSize& x) const
+{
+    size_t size = getSize();
+    if( size == 0 || b.size() != size || factorizedMassMatrix.rows() != size )
+    {
+        reportError("FreeFloatingMassMatrixFactorization","multiplyByInverse","wrong size of the inputs");
+        return false;
+    }
+
+    x = b;
+
+    // x = L^{-T} x
+    for(int visitEl=static_cast<int>(size)-1; visitEl >= 0; visitEl--)
+    {
+        int i = m_dofsVisitOrder[visitEl];
+        for(int j=m_dofParent[i]; j >= 0; j=m_dofParent[j])
+        {
+            x(j) = x(j) - factorizedMassMatrix(i,j)*x(i);
+        }
+    }
+
+    // x = D^{-1} x
+    for(size_t i=0; i < size; i++)
+    {
+        x(i) = x(i)/factorizedMassMatrix(i,i);
+    }
+
+    // x = L^{-1} x
+    for(size_t visitEl=0; visitEl < size; visitEl++)
+    {
+        int i = m_dofsVisitOrder[visitEl];
+        for(int j=m_dofParent[i]; j >= 0; j=m_dofParent[j])
+        {
+            x(i) = x(i) - factorizedMassMatrix(i,j)*x(j);
+        }
+    }
+
+    return true;
+}
+
+bool FreeFloatingMassMatrixFactorization::multiplyByInverseSquareRoot(const FreeFloatingMassMatrix& factorizedMassMatrix,
+                                                                      const VectorDynSize& b,
+                                                                            VectorDynSize& x) const
+{
+    size_t size = getSize();
+    if( size == 0 || b.size() != size || factorizedMassMatrix.rows() != size )
+    {
+        reportError("FreeFloatingMassMatrixFactorization","multiplyByInverseSquareRoot","wrong size of the inputs");
+        return false;
+    }
+
+    x = b;
+    multiplyByInverseSquareRootInPlace(factorizedMassMatrix,x.data());
+
+    return true;
+}
+
+bool FreeFloatingMassMatrixFactorization::computeInverseOperationalSpaceInertia(const FreeFloatingMassMatrix& factorizedMassMatrix,
+                                                                                const MatrixDynSize& jacobian,
+                                                                                      MatrixDynSize& inverseOperationalSpaceInertia)
+{
+    size_t size = getSize();
+    if( size == 0 || jacobian.cols() != size || factorizedMassMatrix.rows() != size )
+    {
+        reportError("FreeFloatingMassMatrixFactorization","computeInverseOperationalSpaceInertia","wrong size of the inputs");
+        return false;
+    }
+
+    size_t m = jacobian.rows();
+
+    // Each row of m_bufferMatrix contains M^{-1/2} J^T_i , where J^T_i is the i-th column of J^T
+    // (as MatrixDynSize is row major, each row is contiguous in memory)
+    m_bufferMatrix.resize(m,size);
+    for(size_t row=0; row < m; row++)
+    {
+        for(size_t col=0; col < size; col++)
+        {
+            m_bufferMatrix(row,col) = jacobian(row,col);
+        }
+        multiplyByInverseSquareRootInPlace(factorizedMassMatrix,m_bufferMatrix.data()+row*size);
+    }
+
+    // J M^{-1} J^T = (M^{-1/2} J^T)^T (M^{-1/2} J^T)
+    inverseOperationalSpaceInertia.resize(m,m);
+    for(size_t i=0; i < m; i++)
+    {
+        for(size_t j=0; j <= i; j++)
+        {
+            double dot = 0.0;
+            for(size_t k=0; k < size; k++)
+            {
+                dot += m_bufferMatrix(i,k)*m_bufferMatrix(j,k);
+            }
+            inverseOperationalSpaceInertia(i,j) = dot;
+            inverseOperationalSpaceInertia(j,i) = dot;
+        }
+    }
+
+    return true;
+}
+
+}
@@ -12,6 +12,10 @@
 #include <iDynTree/Model/FreeFloatingState.h>
 #include <iDynTree/Model/Model.h>
 
+#include <iDynTree/Core/ExpLog.h>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/Core/Utils.h>
+
 #include <cassert>
 
 namespace iDynTree
@@ -62,6 +66,53 @@ unsigned int FreeFloatingPos::getNrOfPosCoords() const
     return this->m_jointPos.size();
 }
 
+bool FreeFloatingPos::integrate(const FreeFloatingVel& vel, const double dt, FreeFloatingPos& nextPos) const
+{
+    if( vel.getNrOfDOFs() != this->getNrOfPosCoords() )
+    {
+        reportError("FreeFloatingPos","integrate","size of the joint velocities is different from the size of the joint positions, models with joints with different number of position coordinates and DOFs are not supported");
+        return false;
+    }
+
+    SpatialMotionVector baseDisplacement;
+    toEigen(baseDisplacement.getLinearVec3()) = dt*toEigen(vel.baseVel().getLinearVec3());
+    toEigen(baseDisplacement.getAngularVec3()) = dt*toEigen(vel.baseVel().getAngularVec3());
+    nextPos.m_worldBasePos = this->m_worldBasePos*expSE3(baseDisplacement);
+
+    // JointPosDoubleArray::resize wipes the content, so it is called only if needed (nextPos can be *this)
+    if( nextPos.m_jointPos.size() != this->m_jointPos.size() )
+    {
+        nextPos.m_jointPos.resize(this->getNrOfPosCoords());
+    }
+    toEigen(nextPos.m_jointPos) = toEigen(this->m_jointPos) + dt*toEigen(vel.jointVel());
+
+    return true;
+}
+
+bool FreeFloatingPos::difference(const FreeFloatingPos& otherPos, const double dt, FreeFloatingVel& vel) const
+{
+    if( otherPos.getNrOfPosCoords() != this->getNrOfPosCoords() )
+    {
+        reportError("FreeFloatingPos","difference","the two positions have joint positions of different size");
+        return false;
+    }
+
+    if( dt == 0.0 )
+    {
+        reportError("FreeFloatingPos","difference","dt is zero");
+        return false;
+    }
+
+    SpatialMotionVector baseDisplacement = logSE3(this->m_worldBasePos.inverse()*otherPos.m_worldBasePos);
+    toEigen(vel.baseVel().getLinearVec3()) = toEigen(baseDisplacement.getLinearVec3())/dt;
+    toEigen(vel.baseVel().getAngularVec3()) = toEigen(baseDisplacement.getAngularVec3())/dt;
+
+    vel.jointVel().resize(this->getNrOfPosCoords());
+    toEigen(vel.jointVel()) = (toEigen(otherPos.m_jointPos) - toEigen(this->m_jointPos))/dt;
+
+    return true;
+}
+
 FreeFloatingPos::~FreeFloatingPos()
 {
 }
@@ -12,11 +12,14 @@
 #include <iDynTree/Model/Jacobians.h>
 
 #include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/Core/Utils.h>
 
 #include <iDynTree/Model/Model.h>
 #include <iDynTree/Model/Traversal.h>
 #include <iDynTree/Model/LinkState.h>
 
+#include <algorithm>
+
 namespace iDynTree
 {
 
@@ -29,8 +32,28 @@ bool FreeFloatingJacobianUsingLinkPos(const Model& model,
                                       const Transform& baseFrame_X_jacobBaseFrame,
                                             MatrixDynSize& jacobian)
 {
+    return FreeFloatingJacobianUsingLinkPos(model,traversal,jointPositions,world_H_links,jacobianLinkIndex,
+                                            jacobFrame_X_world,baseFrame_X_jacobBaseFrame,MatrixView<double>(jacobian));
+}
+
+bool FreeFloatingJacobianUsingLinkPos(const Model& model,
+                                      const Traversal& traversal,
+                                      const JointPosDoubleArray& /*jointPositions*/,
+                                      const LinkPositions& world_H_links,
+                                      const LinkIndex jacobianLinkIndex,
+                                      const Transform& jacobFrame_X_world,
+                                      const Transform& baseFrame_X_jacobBaseFrame,
+                                            MatrixView<double> jacobian)
+{
+    if( jacobian.rows() != 6 ||
+        jacobian.cols() != static_cast<MatrixView<double>::index_type>(6+model.getNrOfDOFs()) )
+    {
+        reportError("","FreeFloatingJacobianUsingLinkPos","Wrong size in output jacobian");
+        return false;
+    }
+
     // We zero the jacobian
-    jacobian.zero();
+    toEigen(jacobian).setZero();
 
     // Compute base part
     const Transform & world_H_base = world_H_links(traversal.getBaseLink()->getIndex());
@@ -58,5 +81,185 @@ bool FreeFloatingJacobianUsingLinkPos(const Model& model,
     return true;
 }
 
+FreeFloatingJacobiansInternalBuffers::FreeFloatingJacobiansInternalBuffers(const Model& model)
+{
+    resize(model);
+}
+
+void FreeFloatingJacobiansInternalBuffers::resize(const Model& model)
+{
+    isLinkVisited.assign(model.getNrOfLinks(),false);
+    worldMotionSubspaces.resize(6,model.getNrOfDOFs());
+    worldMotionSubspaces.zero();
+    nonZeroColumns.clear();
+    nonZeroColumns.reserve(6+model.getNrOfDOFs());
+}
+
+bool FreeFloatingJacobianUsingLinkPos(const Model& model,
+                                      const Traversal& traversal,
+                                      const JointPosDoubleArray& /*jointPositions*/,
+                                      const LinkPositions& world_H_links,
+                                      const LinkIndex linkIndex,
+                                      const Transform& jacobFrame_X_world,
+                                      const Transform& baseFrame_X_jacobBaseFrame,
+                                            FreeFloatingJacobiansInternalBuffers& bufs,
+                                            CompressedColumnJacobian& jacobian)
+{
+    if( !model.isValidLinkIndex(linkIndex) )
+    {
+        reportError("","FreeFloatingJacobianUsingLinkPos","Link index out of bounds");
+        return false;
+    }
+
+    LinkIndex baseLinkIdx = traversal.getBaseLink()->getIndex();
+
+    // Compute the sparsity pattern: the base columns and the columns of the DOFs
+    // in the path between the link and the base
+    bufs.nonZeroColumns.clear();
+    for(int baseCol=0; baseCol < 6; baseCol++)
+    {
+        bufs.nonZeroColumns.push_back(baseCol);
+    }
+
+    for(LinkIndex visitedLinkIdx = linkIndex;
+        visitedLinkIdx != baseLinkIdx;
+        visitedLinkIdx = traversal.getParentLinkFromLinkIndex(visitedLinkIdx)->getIndex())
+    {
+        IJointConstPtr joint = traversal.getParentJointFromLinkIndex(visitedLinkIdx);
+        for(unsigned int i=0; i < joint->getNrOfDOFs(); i++)
+        {
+            bufs.nonZeroColumns.push_back(6+joint->getDOFsOffset()+i);
+        }
+    }
+
+    std::sort(bufs.nonZeroColumns.begin(),bufs.nonZeroColumns.end());
+
+    jacobian.resize(6,6+model.getNrOfDOFs());
+    if( !jacobian.setNonZeroColumns(bufs.nonZeroColumns) )
+    {
+        return false;
+    }
+
+    // Each nonzero column is stored contiguously
+    Eigen::Map< Eigen::Matrix<double,6,Eigen::Dynamic,Eigen::ColMajor> >
+        nonZeroColumns(jacobian.valuesBuffer(),6,jacobian.getNrOfNonZeroColumns());
+
+    // Compute base part (the first 6 nonzero columns)
+    const Transform & world_H_base = world_H_links(baseLinkIdx);
+    nonZeroColumns.leftCols<6>() = toEigen((jacobFrame_X_world*world_H_base*baseFrame_X_jacobBaseFrame).asAdjointTransform());
+
+    // Compute joint part
+    // We iterate from the link up in the traveral until we reach the base
+    for(LinkIndex visitedLinkIdx = linkIndex;
+        visitedLinkIdx != baseLinkIdx;
+        visitedLinkIdx = traversal.getParentLinkFromLinkIndex(visitedLinkIdx)->getIndex())
+    {
+        LinkIndex parentLinkIdx = traversal.getParentLinkFromLinkIndex(visitedLinkIdx)->getIndex();
+        IJointConstPtr joint = traversal.getParentJointFromLinkIndex(visitedLinkIdx);
+
+        for(unsigned int i=0; i < joint->getNrOfDOFs(); i++)
+        {
+            int col = 6+joint->getDOFsOffset()+i;
+            int k = std::lower_bound(bufs.nonZeroColumns.begin(),bufs.nonZeroColumns.end(),col)-bufs.nonZeroColumns.begin();
+            nonZeroColumns.col(k) =
+                toEigen(jacobFrame_X_world*(world_H_links(visitedLinkIdx)*joint->getMotionSubspaceVector(i,visitedLinkIdx,parentLinkIdx)));
+        }
+    }
+
+    return true;
+}
+
+bool FreeFloatingJacobiansUsingLinkPos(const Model& model,
+                                       const Traversal& traversal,
+                                       const JointPosDoubleArray& /*jointPositions*/,
+                                       const LinkPositions& world_H_links,
+                                       const std::vector<LinkIndex>& linkIndices,
+                                       const std::vector<Transform>& jacobFrames_X_world,
+                                       const Transform& baseFrame_X_jacobBaseFrame,
+                                             FreeFloatingJacobiansInternalBuffers& bufs,
+                                             MatrixDynSize& stackedJacobians)
+{
+    if( linkIndices.size() != jacobFrames_X_world.size() ||
+        bufs.isLinkVisited.size() != model.getNrOfLinks() ||
+        bufs.worldMotionSubspaces.cols() != model.getNrOfDOFs() )
+    {
+        reportError("","FreeFloatingJacobiansUsingLinkPos","Inputs or buffers are not consistent with the model");
+        return false;
+    }
+
+    LinkIndex baseLinkIdx = traversal.getBaseLink()->getIndex();
+    size_t nrOfJacobians = linkIndices.size();
+
+    // We zero the jacobians
+    stackedJacobians.resize(6*nrOfJacobians,6+model.getNrOfDOFs());
+    stackedJacobians.zero();
+
+    Eigen::Map< Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > jacobians = toEigen(stackedJacobians);
+    Eigen::Map< Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > worldMotionSubspaces = toEigen(bufs.worldMotionSubspaces);
+
+    // First pass: compute the motion subspace vectors (expressed in the world frame) of all the
+    // joints in the path between the links and the base. We iterate from each link up in the traversal
+    // until we reach the base or a link already visited by the path of a previous link,
+    // so each motion subspace vector is computed only once
+    std::fill(bufs.isLinkVisited.begin(),bufs.isLinkVisited.end(),false);
+    for(size_t jac=0; jac < nrOfJacobians; jac++)
+    {
+        if( !model.isValidLinkIndex(linkIndices[jac]) )
+        {
+            reportError("","FreeFloatingJacobiansUsingLinkPos","Link index out of bounds");
+            return false;
+        }
+
+        LinkIndex visitedLinkIdx = linkIndices[jac];
+
+        while (visitedLinkIdx != baseLinkIdx && !bufs.isLinkVisited[visitedLinkIdx])
+        {
+            LinkIndex parentLinkIdx = traversal.getParentLinkFromLinkIndex(visitedLinkIdx)->getIndex();
+            IJointConstPtr joint = traversal.getParentJointFromLinkIndex(visitedLinkIdx);
+
+            size_t dofOffset = joint->getDOFsOffset();
+            for(unsigned int i=0; i < joint->getNrOfDOFs(); i++)
+            {
+                worldMotionSubspaces.col(dofOffset+i) =
+                    toEigen(world_H_links(visitedLinkIdx)*joint->getMotionSubspaceVector(i,visitedLinkIdx,parentLinkIdx));
+            }
+
+            bufs.isLinkVisited[visitedLinkIdx] = true;
+            visitedLinkIdx = parentLinkIdx;
+        }
+    }
+
+    // Second pass: transform the motion subspace vectors in the frame of each jacobian
+    const Transform & world_H_base = world_H_links(baseLinkIdx);
+    Transform world_H_jacobBaseFrame = world_H_base*baseFrame_X_jacobBaseFrame;
+
+    for(size_t jac=0; jac < nrOfJacobians; jac++)
+    {
+        const Transform & jacobFrame_X_world = jacobFrames_X_world[jac];
+        Matrix6x6 jacobFrame_X_world_adj = jacobFrame_X_world.asAdjointTransform();
+
+        // Compute base part
+        jacobians.block<6,6>(6*jac,0) = toEigen((jacobFrame_X_world*world_H_jacobBaseFrame).asAdjointTransform());
+
+        // Compute joint part
+        LinkIndex visitedLinkIdx = linkIndices[jac];
+
+        while (visitedLinkIdx != baseLinkIdx)
+        {
+            IJointConstPtr joint = traversal.getParentJointFromLinkIndex(visitedLinkIdx);
+
+            size_t dofOffset = joint->getDOFsOffset();
+            for(unsigned int i=0; i < joint->getNrOfDOFs(); i++)
+            {
+                jacobians.block<6,1>(6*jac,6+dofOffset+i) =
+                    toEigen(jacobFrame_X_world_adj)*worldMotionSubspaces.col(dofOffset+i);
+            }
+
+            visitedLinkIdx = traversal.getParentLinkFromLinkIndex(visitedLinkIdx)->getIndex();
+        }
+    }
+
+    return true;
+}
 
 }
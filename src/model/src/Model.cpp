@@ -818,9 +818,9 @@ bool Model::getInertialParameters(VectorDynSize& modelInertialParams) const
 
     for(LinkIndex linkIdx = 0; linkIdx < this->getNrOfLinks(); linkIdx++ )
     {
-        Vector10       inertiaParamsBuf = links[linkIdx].inertia().asVector();
-
-        toEigen(modelInertialParams).segment<10>(10*linkIdx) = toEigen(inertiaParamsBuf);
+        // The spatial inertia is stored as its inertial parameters, so no conversion is needed
+        toEigen(modelInertialParams).segment<10>(10*linkIdx) =
+            Eigen::Map<const Eigen::Matrix<double,10,1> >(links[linkIdx].inertia().packedData());
     }
 
     return true;
@@ -837,10 +837,8 @@ bool Model::updateInertialParameters(const VectorDynSize& modelInertialParams)
 
     for(LinkIndex linkIdx = 0; linkIdx < this->getNrOfLinks(); linkIdx++ )
     {
-        Vector10       inertiaParamsBuf;
-        toEigen(inertiaParamsBuf) = toEigen(modelInertialParams).segment<10>(10*linkIdx);
-
-        links[linkIdx].inertia().fromVector(inertiaParamsBuf);
+        Eigen::Map<Eigen::Matrix<double,10,1> >(links[linkIdx].inertia().packedData()) =
+            toEigen(modelInertialParams).segment<10>(10*linkIdx);
     }
 
     return true;
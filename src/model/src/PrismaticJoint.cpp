@@ -32,7 +32,6 @@ PrismaticJoint::PrismaticJoint():
     this->setDOFsOffset(0);
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
     this->disablePosLimits();
 }
 
@@ -45,7 +44,6 @@ PrismaticJoint::PrismaticJoint(const LinkIndex _link1, const LinkIndex _link2,
     this->setDOFsOffset(0);
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
     this->disablePosLimits();
 }
 
@@ -60,7 +58,6 @@ PrismaticJoint::PrismaticJoint(const PrismaticJoint& other):
     this->setDOFsOffset(other.getDOFsOffset());
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
 }
 
 PrismaticJoint::~PrismaticJoint()
@@ -105,46 +102,28 @@ Transform PrismaticJoint::getRestTransform(const LinkIndex p_linkA, const LinkIn
     }
 }
 
-void PrismaticJoint::updateBuffers(const double new_q) const
-{
-    if( new_q != q_previous )
-    {
-        resetBuffers(new_q);
-    }
-
-    return;
-}
-
-void PrismaticJoint::resetBuffers(const double new_q) const
-{
-    this->link1_X_link2 = translation_axis_wrt_link1.getTranslationTransform(new_q)*link1_X_link2_at_rest;
-    this->link2_X_link1 = link1_X_link2.inverse();
-
-    q_previous = new_q;
-}
-
-void PrismaticJoint::resetAxisBuffers() const
+void PrismaticJoint::resetAxisBuffers()
 {
     this->S_link1_link2 = -translation_axis_wrt_link1.getTranslationTwist(1.0);
     this->S_link2_link1 = (link1_X_link2_at_rest.inverse()*translation_axis_wrt_link1).getTranslationTwist(1.0);
 }
 
-const Transform & PrismaticJoint::getTransform(const VectorDynSize& jntPos,
-                                              const LinkIndex p_linkA,
-                                              const LinkIndex p_linkB) const
+Transform PrismaticJoint::getTransform(const VectorDynSize& jntPos,
+                                       const LinkIndex p_linkA,
+                                       const LinkIndex p_linkB) const
 {
     const double dist = jntPos(this->getPosCoordsOffset());
-    updateBuffers(dist);
+    Transform link1_X_link2 = translation_axis_wrt_link1.getTranslationTransform(dist)*link1_X_link2_at_rest;
     if( p_linkA == link1 )
     {
         assert(p_linkB == link2);
-        return this->link1_X_link2;
+        return link1_X_link2;
     }
     else
     {
         assert(p_linkA == link2);
         assert(p_linkB == link1);
-        return this->link2_X_link1;
+        return link1_X_link2.inverse();
     }
 }
 
@@ -163,8 +142,8 @@ TransformDerivative PrismaticJoint::getTransformDerivative(const VectorDynSize&
     }
     else
     {
-        updateBuffers(dist);
-        TransformDerivative linkA_dX_linkB = link1_dX_link2.derivativeOfInverse(this->link1_X_link2);
+        Transform link1_X_link2 = translation_axis_wrt_link1.getTranslationTransform(dist)*link1_X_link2_at_rest;
+        TransformDerivative linkA_dX_linkB = link1_dX_link2.derivativeOfInverse(link1_X_link2);
         return linkA_dX_linkB;
     }
 }
@@ -236,7 +215,7 @@ void PrismaticJoint::computeChildVelAcc(const VectorDynSize & jntPos,
     double ddist = jntVel(this->getDOFsOffset());
     double d2dist = jntAcc(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
+    Transform child_X_parent = this->getTransform(jntPos,child,parent);
 
     // Propagate twist and spatial acceleration: for a prismatic joint (as for any 1 dof joint)
     // we implement equation 5.14 and 5.15 of Feathestone RBDA, 2008
@@ -257,7 +236,7 @@ void PrismaticJoint::computeChildVel(const VectorDynSize & jntPos,
 {
     double ddist = jntVel(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
+    Transform child_X_parent = this->getTransform(jntPos,child,parent);
 
     // Propagate twist and spatial acceleration: for a prismatic joint (as for any 1 dof joint)
     // we implement equation 5.14 and 5.15 of Feathestone RBDA, 2008
@@ -281,8 +260,8 @@ void PrismaticJoint::computeChildPosVelAcc(const VectorDynSize & jntPos,
     double ddist = jntVel(this->getDOFsOffset());
     double d2dist = jntAcc(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
+    Transform parent_X_child = this->getTransform(jntPos,parent,child);
+    Transform child_X_parent = parent_X_child.inverse();
 
     // Propagate position : position of the frame is expressed as
     // transform between the link frame and a reference frame :
@@ -306,8 +285,7 @@ void PrismaticJoint::computeChildAcc(const VectorDynSize &jntPos, const VectorDy
 {
     double ddist = jntVel(this->getDOFsOffset());
     double d2dist = jntAcc(this->getDOFsOffset());
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
+    Transform child_X_parent = this->getTransform(jntPos,child,parent);
     iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
     SpatialMotionVector vj = S*ddist;
     linkAccs(child) = child_X_parent*linkAccs(parent) + S*d2dist + linkVels(child)*vj;
@@ -320,8 +298,7 @@ void PrismaticJoint::computeChildBiasAcc(const VectorDynSize &jntPos,
                                          const LinkIndex child, const LinkIndex parent) const
 {
     double ddist = jntVel(this->getDOFsOffset());
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
+    Transform child_X_parent = this->getTransform(jntPos,child,parent);
     iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
     SpatialMotionVector vj = S*ddist;
     linkBiasAccs(child) = child_X_parent*linkBiasAccs(parent) + linkVels(child)*vj;
@@ -32,7 +32,6 @@ RevoluteJoint::RevoluteJoint():
     this->setDOFsOffset(0);
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
     this->disablePosLimits();
 }
 
@@ -45,7 +44,6 @@ RevoluteJoint::RevoluteJoint(const LinkIndex _link1, const LinkIndex _link2,
     this->setDOFsOffset(0);
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
     this->disablePosLimits();
 }
 
@@ -57,7 +55,6 @@ RevoluteJoint::RevoluteJoint(const Transform& _link1_X_link2, const Axis& _rotat
     this->setDOFsOffset(0);
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
     this->disablePosLimits();
 }
 
@@ -72,7 +69,6 @@ RevoluteJoint::RevoluteJoint(const RevoluteJoint& other):
     this->setDOFsOffset(other.getDOFsOffset());
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
 }
 
 RevoluteJoint::~RevoluteJoint()
@@ -117,46 +113,28 @@ Transform RevoluteJoint::getRestTransform(const LinkIndex p_linkA, const LinkInd
     }
 }
 
-void RevoluteJoint::updateBuffers(const double new_q) const
-{
-    if( new_q != q_previous )
-    {
-        resetBuffers(new_q);
-    }
-
-    return;
-}
-
-void RevoluteJoint::resetBuffers(const double new_q) const
-{
-    this->link1_X_link2 = rotation_axis_wrt_link1.getRotationTransform(new_q)*link1_X_link2_at_rest;
-    this->link2_X_link1 = link1_X_link2.inverse();
-
-    q_previous = new_q;
-}
-
-void RevoluteJoint::resetAxisBuffers() const
+void RevoluteJoint::resetAxisBuffers()
 {
     this->S_link1_link2 = -(rotation_axis_wrt_link1).getRotationTwist(1.0);
     this->S_link2_link1 = (link1_X_link2_at_rest.inverse()*rotation_axis_wrt_link1).getRotationTwist(1.0);
 }
 
-const Transform & RevoluteJoint::getTransform(const VectorDynSize& jntPos,
-                                              const LinkIndex p_linkA,
-                                              const LinkIndex p_linkB) const
+Transform RevoluteJoint::getTransform(const VectorDynSize& jntPos,
+                                      const LinkIndex p_linkA,
+                                      const LinkIndex p_linkB) const
 {
     const double ang = jntPos(this->getPosCoordsOffset());
-    updateBuffers(ang);
+    Transform link1_X_link2 = rotation_axis_wrt_link1.getRotationTransform(ang)*link1_X_link2_at_rest;
     if( p_linkA == link1 )
     {
         assert(p_linkB == link2);
-        return this->link1_X_link2;
+        return link1_X_link2;
     }
     else
     {
         assert(p_linkA == link2);
         assert(p_linkB == link1);
-        return this->link2_X_link1;
+        return link1_X_link2.inverse();
     }
 }
 
@@ -175,8 +153,8 @@ TransformDerivative RevoluteJoint::getTransformDerivative(const VectorDynSize& j
     }
     else
     {
-        updateBuffers(ang);
-        TransformDerivative linkA_dX_linkB = link1_dX_link2.derivativeOfInverse(this->link1_X_link2);
+        Transform link1_X_link2 = rotation_axis_wrt_link1.getRotationTransform(ang)*link1_X_link2_at_rest;
+        TransformDerivative linkA_dX_linkB = link1_dX_link2.derivativeOfInverse(link1_X_link2);
         return linkA_dX_linkB;
     }
 }
@@ -250,7 +228,7 @@ void RevoluteJoint::computeChildVelAcc(const VectorDynSize & jntPos,
     double dang = jntVel(this->getDOFsOffset());
     double d2ang = jntAcc(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
+    Transform child_X_parent = this->getTransform(jntPos,child,parent);
 
     // Propagate twist and spatial acceleration: for a revolute joint (as for any 1 dof joint)
     // we implement equation 5.14 and 5.15 of Feathestone RBDA, 2008
@@ -271,7 +249,7 @@ void RevoluteJoint::computeChildVel(const VectorDynSize & jntPos,
 {
     double dang = jntVel(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
+    Transform child_X_parent = this->getTransform(jntPos,child,parent);
 
     // Propagate twist and spatial acceleration: for a revolute joint (as for any 1 dof joint)
     // we implement equation 5.14 and 5.15 of Feathestone RBDA, 2008
@@ -295,8 +273,8 @@ void RevoluteJoint::computeChildPosVelAcc(const VectorDynSize & jntPos,
     double dang = jntVel(this->getDOFsOffset());
     double d2ang = jntAcc(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
+    Transform parent_X_child = this->getTransform(jntPos,parent,child);
+    Transform child_X_parent = parent_X_child.inverse();
 
     // Propagate position : position of the frame is expressed as
     // transform between the link frame and a reference frame :
@@ -320,8 +298,7 @@ void RevoluteJoint::computeChildAcc(const VectorDynSize &jntPos, const VectorDyn
 {
     double dang = jntVel(this->getDOFsOffset());
     double d2ang = jntAcc(this->getDOFsOffset());
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
+    Transform child_X_parent = this->getTransform(jntPos,child,parent);
     iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
     SpatialMotionVector vj = S*dang;
     linkAccs(child) = child_X_parent*linkAccs(parent) + S*d2ang + linkVels(child)*vj;
@@ -334,8 +311,7 @@ void RevoluteJoint::computeChildBiasAcc(const VectorDynSize &jntPos,
                                          const LinkIndex child, const LinkIndex parent) const
 {
     double dang = jntVel(this->getDOFsOffset());
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
+    Transform child_X_parent = this->getTransform(jntPos,child,parent);
     iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
     SpatialMotionVector vj = S*dang;
     linkBiasAccs(child) = child_X_parent*linkBiasAccs(parent) + linkVels(child)*vj;
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Model/CompiledModel.h>
+#include <iDynTree/Model/Model.h>
+#include <iDynTree/Model/ModelTestUtils.h>
+#include <iDynTree/Model/Traversal.h>
+#include <iDynTree/Model/ForwardKinematics.h>
+#include <iDynTree/Model/Dynamics.h>
+#include <iDynTree/Model/Jacobians.h>
+#include <iDynTree/Model/FreeFloatingState.h>
+#include <iDynTree/Model/FreeFloatingMatrices.h>
+
+#include <iDynTree/Core/TestUtils.h>
+
+#include <cstdlib>
+
+using namespace iDynTree;
+
+void checkCompiledModelAlgorithms(const Model & model)
+{
+    Traversal traversal;
+    model.computeFullTreeTraversal(traversal,getRandomLinkIndexOfModel(model));
+
+    CompiledModel compiledModel;
+    ASSERT_IS_TRUE(compiledModel.compile(model,traversal));
+    ASSERT_IS_TRUE(compiledModel.isValid());
+    ASSERT_EQUAL_DOUBLE(compiledModel.getNrOfVisitedLinks(),traversal.getNrOfVisitedLinks());
+    ASSERT_EQUAL_DOUBLE(compiledModel.getNrOfDOFs(),model.getNrOfDOFs());
+
+    // Check the children ranges
+    for(TraversalIndex t=1; t < static_cast<TraversalIndex>(compiledModel.getNrOfVisitedLinks()); t++)
+    {
+        TraversalIndex parent = compiledModel.getParent(t);
+        bool found = false;
+        for(size_t child_i=0; child_i < compiledModel.getNrOfChildren(parent); child_i++)
+        {
+            found = found || (compiledModel.getChild(parent,child_i) == t);
+        }
+        ASSERT_IS_TRUE(found);
+    }
+
+    FreeFloatingPos pos(model);
+    FreeFloatingVel vel(model);
+    FreeFloatingAcc acc(model);
+    LinkNetExternalWrenches extWrenches(model);
+    getRandomInverseDynamicsInputs(pos,vel,acc,extWrenches);
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+    {
+        extWrenches(lnk) = getRandomWrench();
+    }
+
+    LinkPositions parent_X_links(model);
+    ASSERT_IS_TRUE(ComputeJointTransforms(compiledModel,pos.jointPos(),parent_X_links));
+
+    // Forward kinematics
+    LinkPositions linkPos(model), linkPosCompiled(model);
+    LinkVelArray linkVel(model), linkVelCompiled(model);
+    LinkAccArray linkAcc(model), linkAccCompiled(model);
+    ASSERT_IS_TRUE(ForwardPosVelAccKinematics(model,traversal,pos,vel,acc,linkPos,linkVel,linkAcc));
+    ASSERT_IS_TRUE(ForwardPositionKinematics(compiledModel,parent_X_links,pos.worldBasePos(),linkPosCompiled));
+    ASSERT_IS_TRUE(ForwardVelAccKinematics(compiledModel,parent_X_links,vel,acc,linkVelCompiled,linkAccCompiled));
+
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+    {
+        ASSERT_EQUAL_TRANSFORM(linkPos(lnk),linkPosCompiled(lnk));
+        ASSERT_EQUAL_SPATIAL_MOTION(linkVel(lnk),linkVelCompiled(lnk));
+        ASSERT_EQUAL_SPATIAL_MOTION(linkAcc(lnk),linkAccCompiled(lnk));
+    }
+
+    ASSERT_IS_TRUE(ForwardPosVelKinematics(compiledModel,parent_X_links,pos,vel,linkPosCompiled,linkVelCompiled));
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+    {
+        ASSERT_EQUAL_TRANSFORM(linkPos(lnk),linkPosCompiled(lnk));
+        ASSERT_EQUAL_SPATIAL_MOTION(linkVel(lnk),linkVelCompiled(lnk));
+    }
+
+    // Jacobians
+    MatrixDynSize jac(6,6+model.getNrOfDOFs()), jacCompiled(6,6+model.getNrOfDOFs());
+    LinkIndex jacobLink = getRandomLinkIndexOfModel(model);
+    Transform jacobFrame_X_world = linkPos(jacobLink).inverse();
+    Transform baseFrame_X_jacobBaseFrame = getRandomTransform();
+    ASSERT_IS_TRUE(FreeFloatingJacobianUsingLinkPos(model,traversal,pos.jointPos(),linkPos,jacobLink,
+                                                    jacobFrame_X_world,baseFrame_X_jacobBaseFrame,jac));
+    ASSERT_IS_TRUE(FreeFloatingJacobianUsingLinkPos(compiledModel,linkPos,jacobLink,
+                                                    jacobFrame_X_world,baseFrame_X_jacobBaseFrame,jacCompiled));
+    ASSERT_EQUAL_MATRIX(jac,jacCompiled);
+
+    // RNEA
+    LinkInternalWrenches intWrenches(model), intWrenchesCompiled(model);
+    FreeFloatingGeneralizedTorques genTrqs(model), genTrqsCompiled(model);
+    ASSERT_IS_TRUE(RNEADynamicPhase(model,traversal,pos.jointPos(),linkVel,linkAcc,extWrenches,intWrenches,genTrqs));
+    ASSERT_IS_TRUE(RNEADynamicPhase(compiledModel,parent_X_links,linkVel,linkAcc,extWrenches,intWrenchesCompiled,genTrqsCompiled));
+
+    ASSERT_EQUAL_SPATIAL_FORCE(genTrqs.baseWrench(),genTrqsCompiled.baseWrench());
+    ASSERT_EQUAL_VECTOR(genTrqs.jointTorques(),genTrqsCompiled.jointTorques());
+
+    // CRBA
+    LinkCompositeRigidBodyInertias crbs(model), crbsCompiled(model);
+    FreeFloatingMassMatrix massMatrix(model), massMatrixCompiled(model);
+    massMatrix.zero();
+    massMatrixCompiled.zero();
+    ASSERT_IS_TRUE(CompositeRigidBodyAlgorithm(model,traversal,pos.jointPos(),crbs,massMatrix));
+    ASSERT_IS_TRUE(CompositeRigidBodyAlgorithm(compiledModel,parent_X_links,crbsCompiled,massMatrixCompiled));
+    ASSERT_EQUAL_MATRIX(massMatrix,massMatrixCompiled);
+
+    // ABA
+    ArticulatedBodyAlgorithmInternalBuffers bufs(model), bufsCompiled(model);
+    FreeFloatingAcc robotAcc(model), robotAccCompiled(model);
+    ASSERT_IS_TRUE(ArticulatedBodyAlgorithm(model,traversal,pos,vel,extWrenches,genTrqs.jointTorques(),bufs,robotAcc));
+    ASSERT_IS_TRUE(ArticulatedBodyAlgorithm(compiledModel,parent_X_links,vel,extWrenches,genTrqs.jointTorques(),bufsCompiled,robotAccCompiled));
+
+    ASSERT_EQUAL_SPATIAL_MOTION(robotAcc.baseAcc(),robotAccCompiled.baseAcc());
+    ASSERT_EQUAL_VECTOR_TOL(robotAcc.jointAcc(),robotAccCompiled.jointAcc(),1e-7);
+}
+
+int main()
+{
+    for(unsigned int i=2; i <= 60; i += 15)
+    {
+        Model randomModel = getRandomModel(i);
+        checkCompiledModelAlgorithms(randomModel);
+
+        addRandomPrismaticLinkToModel(randomModel,getRandomLinkOfModel(randomModel),"prismaticLink");
+        checkCompiledModelAlgorithms(randomModel);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Model/FreeFloatingMassMatrixFactorization.h>
+#include <iDynTree/Model/Model.h>
+#include <iDynTree/Model/ModelTestUtils.h>
+#include <iDynTree/Model/Traversal.h>
+#include <iDynTree/Model/Dynamics.h>
+#include <iDynTree/Model/FreeFloatingState.h>
+#include <iDynTree/Model/FreeFloatingMatrices.h>
+
+#include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/Core/TestUtils.h>
+
+#include <Eigen/Dense>
+
+#include <cstdlib>
+
+using namespace iDynTree;
+
+/**
+ * The links generated by getRandomLink are not guaranteed to have a
+ * physically consistent inertia, so the mass matrix of a random model
+ * could be not positive definite. This function sets the inertia of
+ * each link to a physically consistent one.
+ */
+void setPhysicallyConsistentInertias(Model & model)
+{
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+    {
+        double mass = getRandomDouble(0.5,4);
+        Position com(getRandomDouble(-2,2),getRandomDouble(-2,2),getRandomDouble(-2,2));
+
+        double cxx = getRandomDouble(0.1,3);
+        double cyy = getRandomDouble(0.1,4);
+        double czz = getRandomDouble(0.1,6);
+        Eigen::Matrix3d inertiaWrtCoM = Eigen::Vector3d(czz+cyy,cxx+czz,cxx+cyy).asDiagonal();
+        Eigen::Matrix3d rot = toEigen(getRandomRotation());
+        inertiaWrtCoM = rot*inertiaWrtCoM*rot.transpose();
+
+        // Parallel axis theorem, to express the rotational inertia w.r.t. to the link frame origin
+        Eigen::Vector3d c = toEigen(com);
+        RotationalInertiaRaw inertiaWrtOrigin;
+        toEigen(inertiaWrtOrigin) = inertiaWrtCoM + mass*(c.dot(c)*Eigen::Matrix3d::Identity() - c*c.transpose());
+
+        SpatialInertia inertia(mass,com,inertiaWrtOrigin);
+        model.getLink(lnk)->setInertia(inertia);
+    }
+}
+
+void checkMassMatrixFactorization(const Model & model)
+{
+    Traversal traversal;
+    model.computeFullTreeTraversal(traversal,getRandomLinkIndexOfModel(model));
+
+    FreeFloatingPos pos(model);
+    getRandomVector(pos.jointPos());
+
+    LinkCompositeRigidBodyInertias crbs(model);
+    FreeFloatingMassMatrix massMatrix(model);
+    massMatrix.zero();
+    ASSERT_IS_TRUE(CompositeRigidBodyAlgorithm(model,traversal,pos.jointPos(),crbs,massMatrix));
+
+    FreeFloatingMassMatrixFactorization factorization;
+    ASSERT_IS_TRUE(factorization.setTraversal(model,traversal));
+    ASSERT_EQUAL_DOUBLE(factorization.getSize(),6+model.getNrOfDOFs());
+
+    FreeFloatingMassMatrix factorizedMassMatrix = massMatrix;
+    ASSERT_IS_TRUE(factorization.factorize(factorizedMassMatrix));
+
+    size_t size = factorization.getSize();
+    Eigen::MatrixXd massMatrixEigen = toEigen(massMatrix);
+    Eigen::MatrixXd massMatrixInverse = massMatrixEigen.inverse();
+
+    // M^{-1} b
+    VectorDynSize b(size), x(size);
+    getRandomVector(b,-1.0,1.0);
+    ASSERT_IS_TRUE(factorization.multiplyByInverse(factorizedMassMatrix,b,x));
+
+    VectorDynSize xCheck(size);
+    toEigen(xCheck) = massMatrixEigen.ldlt().solve(toEigen(b));
+    ASSERT_EQUAL_VECTOR_TOL(x,xCheck,1e-6);
+
+    // M^{-1} = M^{-1/2}^T M^{-1/2}
+    MatrixDynSize inverseSquareRoot(size,size);
+    VectorDynSize unitVector(size), column(size);
+    for(size_t col=0; col < size; col++)
+    {
+        unitVector.zero();
+        unitVector(col) = 1.0;
+        ASSERT_IS_TRUE(factorization.multiplyByInverseSquareRoot(factorizedMassMatrix,unitVector,column));
+        toEigen(inverseSquareRoot).col(col) = toEigen(column);
+    }
+
+    MatrixDynSize inverseFromSquareRoot(size,size), inverseCheck(size,size);
+    toEigen(inverseFromSquareRoot) = toEigen(inverseSquareRoot).transpose()*toEigen(inverseSquareRoot);
+    toEigen(inverseCheck) = massMatrixInverse;
+    ASSERT_EQUAL_MATRIX_TOL(inverseFromSquareRoot,inverseCheck,1e-6);
+
+    // J M^{-1} J^T
+    MatrixDynSize jacobian(12,size);
+    getRandomMatrix(jacobian);
+    MatrixDynSize invOpSpaceInertia, invOpSpaceInertiaCheck(12,12);
+    ASSERT_IS_TRUE(factorization.computeInverseOperationalSpaceInertia(factorizedMassMatrix,jacobian,invOpSpaceInertia));
+    toEigen(invOpSpaceInertiaCheck) = toEigen(jacobian)*massMatrixInverse*toEigen(jacobian).transpose();
+    ASSERT_EQUAL_MATRIX_TOL(invOpSpaceInertia,invOpSpaceInertiaCheck,1e-6);
+}
+
+int main()
+{
+    for(unsigned int i=2; i <= 60; i += 15)
+    {
+        Model randomModel = getRandomModel(i);
+        setPhysicallyConsistentInertias(randomModel);
+        checkMassMatrixFactorization(randomModel);
+
+        addRandomPrismaticLinkToModel(randomModel,getRandomLinkOfModel(randomModel),"prismaticLink");
+        setPhysicallyConsistentInertias(randomModel);
+        checkMassMatrixFactorization(randomModel);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -15,6 +15,7 @@
 #include <iDynTree/Model/ModelTestUtils.h>
 #include <iDynTree/Model/Traversal.h>
 
+#include <iDynTree/Core/EigenHelpers.h>
 #include <iDynTree/Core/TestUtils.h>
 
 #include <algorithm>
@@ -382,11 +383,54 @@ void checkRandomModels()
 
 }
 
+void checkFreeFloatingPosIntegration()
+{
+    Model model = getRandomModel(10);
+    FreeFloatingPos pos(model);
+    FreeFloatingVel vel(model);
+    pos.worldBasePos() = getRandomTransform();
+    getRandomVector(pos.jointPos());
+    vel.baseVel() = getRandomTwist();
+    getRandomVector(vel.jointVel());
+
+    // difference is the inverse of integrate
+    const double dt = 0.7;
+    FreeFloatingPos nextPos(model);
+    FreeFloatingVel velCheck(model);
+    ASSERT_IS_TRUE(pos.integrate(vel,dt,nextPos));
+    ASSERT_IS_TRUE(pos.difference(nextPos,dt,velCheck));
+    ASSERT_EQUAL_VECTOR_TOL(velCheck.baseVel(),vel.baseVel(),1e-10);
+    ASSERT_EQUAL_VECTOR_TOL(velCheck.jointVel(),vel.jointVel(),1e-10);
+
+    // Integrating two times for dt/2 is the same as integrating once for dt (also in place)
+    FreeFloatingPos halfStepPos = pos;
+    ASSERT_IS_TRUE(halfStepPos.integrate(vel,dt/2,halfStepPos));
+    ASSERT_IS_TRUE(halfStepPos.integrate(vel,dt/2,halfStepPos));
+    ASSERT_EQUAL_TRANSFORM_TOL(halfStepPos.worldBasePos(),nextPos.worldBasePos(),1e-10);
+    ASSERT_EQUAL_VECTOR_TOL(halfStepPos.jointPos(),nextPos.jointPos(),1e-10);
+
+    // The base velocity is the body-fixed one: d(A_p_B)/dt = A_R_B v and d(A_R_B)/dt = A_R_B S(omega)
+    const double eps = 1e-7;
+    ASSERT_IS_TRUE(pos.integrate(vel,eps,nextPos));
+    Eigen::Vector3d linearVel = toEigen(pos.worldBasePos().getRotation())*toEigen(vel.baseVel().getLinearVec3());
+    Eigen::Matrix3d rotDerivative = toEigen(pos.worldBasePos().getRotation())*skew(toEigen(vel.baseVel().getAngularVec3()));
+    Eigen::Vector3d linearVelNumerical = (toEigen(nextPos.worldBasePos().getPosition())-toEigen(pos.worldBasePos().getPosition()))/eps;
+    Eigen::Matrix3d rotDerivativeNumerical = (toEigen(nextPos.worldBasePos().getRotation())-toEigen(pos.worldBasePos().getRotation()))/eps;
+    ASSERT_IS_TRUE((linearVel-linearVelNumerical).norm() < 1e-5);
+    ASSERT_IS_TRUE((rotDerivative-rotDerivativeNumerical).norm() < 1e-5);
+
+    // Wrong sizes
+    FreeFloatingVel wrongVel;
+    ASSERT_IS_FALSE(pos.integrate(wrongVel,dt,nextPos));
+    ASSERT_IS_FALSE(pos.difference(FreeFloatingPos(),dt,velCheck));
+}
+
 int main()
 {
     checkSimpleModel();
     checkRandomChains();
     checkRandomModels();
     checkInsertJointAndLink();
+    checkFreeFloatingPosIntegration();
     return EXIT_SUCCESS;
 }
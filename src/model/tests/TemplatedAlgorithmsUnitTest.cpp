@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include <iDynTree/Model/TemplatedAlgorithms.h>
+#include <iDynTree/Model/CompiledModel.h>
+#include <iDynTree/Model/Model.h>
+#include <iDynTree/Model/ModelTestUtils.h>
+#include <iDynTree/Model/Traversal.h>
+#include <iDynTree/Model/FreeFloatingState.h>
+#include <iDynTree/Model/FreeFloatingMatrices.h>
+
+#include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/Core/TestUtils.h>
+
+#include <unsupported/Eigen/AutoDiff>
+
+#include <cstdlib>
+
+using namespace iDynTree;
+
+// Forward-mode autodiff scalar, with up to MaxDerivatives directions.
+// The derivatives have fixed size, so that the constants have zero derivatives
+// of the same size of the seeded variables.
+const int MaxDerivatives = 64;
+typedef Eigen::AutoDiffScalar<Eigen::Matrix<double,MaxDerivatives,1> > ADScalar;
+
+// Dual number, i.e. forward-mode autodiff scalar with a single direction
+typedef Eigen::AutoDiffScalar<Eigen::Matrix<double,1,1> > DualScalar;
+
+template<typename EigenType>
+void assertEqualEigen(const EigenType & expected, const MatrixDynSize & actual, double tol)
+{
+    ASSERT_EQUAL_DOUBLE(expected.rows(), actual.rows());
+    ASSERT_EQUAL_DOUBLE(expected.cols(), actual.cols());
+    ASSERT_EQUAL_DOUBLE_TOL((toEigen(actual)-expected).cwiseAbs().maxCoeff(), 0.0, tol);
+}
+
+void checkDoubleInstantiation(const Model & model, const CompiledModel & compiledModel)
+{
+    FreeFloatingPos pos(model);
+    FreeFloatingVel vel(model);
+    FreeFloatingAcc acc(model);
+    LinkNetExternalWrenches extWrenches(model);
+    getRandomInverseDynamicsInputs(pos,vel,acc,extWrenches);
+
+    size_t nrOfLinks = model.getNrOfLinks();
+    size_t nrOfDOFs  = model.getNrOfDOFs();
+
+    // Reference results of the double-only algorithms
+    LinkPositions parent_X_links(model), linkPos(model);
+    LinkVelArray linkVel(model);
+    LinkAccArray linkAcc(model);
+    LinkInternalWrenches intWrenches(model);
+    FreeFloatingGeneralizedTorques genTrqs(model);
+    LinkCompositeRigidBodyInertias crbs(model);
+    FreeFloatingMassMatrix massMatrix(model);
+    MatrixDynSize jac(6,6+nrOfDOFs);
+    massMatrix.zero();
+
+    LinkIndex jacobLink = getRandomLinkIndexOfModel(model);
+    Transform baseFrame_X_jacobBaseFrame = getRandomTransform();
+    ASSERT_IS_TRUE(ComputeJointTransforms(compiledModel,pos.jointPos(),parent_X_links));
+    ASSERT_IS_TRUE(ForwardPositionKinematics(compiledModel,parent_X_links,pos.worldBasePos(),linkPos));
+    Transform jacobFrame_X_world = linkPos(jacobLink).inverse();
+    ASSERT_IS_TRUE(FreeFloatingJacobianUsingLinkPos(compiledModel,linkPos,jacobLink,jacobFrame_X_world,baseFrame_X_jacobBaseFrame,jac));
+    ASSERT_IS_TRUE(ForwardVelAccKinematics(compiledModel,parent_X_links,vel,acc,linkVel,linkAcc));
+    ASSERT_IS_TRUE(RNEADynamicPhase(compiledModel,parent_X_links,linkVel,linkAcc,extWrenches,intWrenches,genTrqs));
+    ASSERT_IS_TRUE(CompositeRigidBodyAlgorithm(compiledModel,parent_X_links,crbs,massMatrix));
+
+    // Templated algorithms, instantiated with the default scalar
+    std::vector< Templated::ScalarTransform<> > parent_X_linksT, linkPosT;
+    Templated::Mat6X<double> jacT, linkVelT, linkAccT, intWrenchesT, extWrenchesT(6,nrOfLinks);
+    Templated::VecX<double> genTrqsT;
+    std::vector< Templated::ScalarSpatialInertia<> > crbsT;
+    Templated::MatX<double> massMatrixT;
+
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(nrOfLinks); lnk++)
+    {
+        extWrenchesT.col(lnk) = toEigen(extWrenches(lnk));
+    }
+
+    ASSERT_IS_TRUE(Templated::ComputeJointTransforms(compiledModel,Templated::VecX<double>(toEigen(pos.jointPos())),parent_X_linksT));
+    ASSERT_IS_TRUE(Templated::ForwardPositionKinematics(compiledModel,parent_X_linksT,
+                                                       Templated::ScalarTransform<>(pos.worldBasePos()),linkPosT));
+    ASSERT_IS_TRUE(Templated::FreeFloatingJacobianUsingLinkPos(compiledModel,linkPosT,jacobLink,
+                                                              Templated::ScalarTransform<>(jacobFrame_X_world),
+                                                              Templated::ScalarTransform<>(baseFrame_X_jacobBaseFrame),jacT));
+    ASSERT_IS_TRUE(Templated::ForwardVelAccKinematics(compiledModel,parent_X_linksT,
+                                                     Templated::fromSpatialVector<double>(vel.baseVel()),
+                                                     Templated::VecX<double>(toEigen(vel.jointVel())),
+                                                     Templated::fromSpatialVector<double>(acc.baseAcc()),
+                                                     Templated::VecX<double>(toEigen(acc.jointAcc())),
+                                                     linkVelT,linkAccT));
+    ASSERT_IS_TRUE(Templated::RNEADynamicPhase(compiledModel,parent_X_linksT,linkVelT,linkAccT,extWrenchesT,intWrenchesT,genTrqsT));
+    ASSERT_IS_TRUE(Templated::CompositeRigidBodyAlgorithm(compiledModel,parent_X_linksT,crbsT,massMatrixT));
+
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(nrOfLinks); lnk++)
+    {
+        ASSERT_EQUAL_DOUBLE_TOL((toEigen(linkPos(lnk).asAdjointTransform())-linkPosT[lnk].asAdjointTransform()).cwiseAbs().maxCoeff(),0.0,1e-9);
+        ASSERT_EQUAL_DOUBLE_TOL((toEigen(linkVel(lnk))-linkVelT.col(lnk)).cwiseAbs().maxCoeff(),0.0,1e-9);
+        ASSERT_EQUAL_DOUBLE_TOL((toEigen(linkAcc(lnk))-linkAccT.col(lnk)).cwiseAbs().maxCoeff(),0.0,1e-9);
+        ASSERT_EQUAL_DOUBLE_TOL((toEigen(crbs(lnk).asMatrix())-crbsT[lnk].asMatrix()).cwiseAbs().maxCoeff(),0.0,1e-9);
+    }
+
+    assertEqualEigen(jacT,jac,1e-9);
+    assertEqualEigen(massMatrixT,massMatrix,1e-9);
+
+    VectorDynSize genTrqsVec(6+nrOfDOFs);
+    toEigen(genTrqsVec).head<6>() = toEigen(genTrqs.baseWrench());
+    toEigen(genTrqsVec).tail(nrOfDOFs) = toEigen(genTrqs.jointTorques());
+    ASSERT_EQUAL_DOUBLE_TOL((toEigen(genTrqsVec)-genTrqsT).cwiseAbs().maxCoeff(),0.0,1e-9);
+}
+
+void checkAutoDiffInstantiation(const Model & model, const CompiledModel & compiledModel)
+{
+    size_t nrOfLinks = model.getNrOfLinks();
+    size_t nrOfDOFs  = model.getNrOfDOFs();
+
+    FreeFloatingPos pos(model);
+    FreeFloatingVel vel(model);
+    FreeFloatingAcc acc(model);
+    LinkNetExternalWrenches extWrenches(model);
+    getRandomInverseDynamicsInputs(pos,vel,acc,extWrenches);
+    ASSERT_IS_TRUE(6+nrOfDOFs <= static_cast<size_t>(MaxDerivatives));
+
+    // Joint positions, seeded with the canonical directions
+    Templated::VecX<ADScalar> jointPos(nrOfDOFs);
+    for(size_t i=0; i < nrOfDOFs; i++)
+    {
+        jointPos(i) = ADScalar(pos.jointPos()(i),MaxDerivatives,i);
+    }
+
+    std::vector< Templated::ScalarTransform<ADScalar> > parent_X_links, linkPos;
+    ASSERT_IS_TRUE(Templated::ComputeJointTransforms(compiledModel,jointPos,parent_X_links));
+    ASSERT_IS_TRUE(Templated::ForwardPositionKinematics(compiledModel,parent_X_links,
+                                                       Templated::ScalarTransform<ADScalar>(pos.worldBasePos()),linkPos));
+
+    // The derivatives of the position of a link with respect to the joint positions
+    // are the linear part of the mixed jacobian (i.e. with the origin of the link and the orientation of the world)
+    std::vector< Templated::ScalarTransform<> > linkPosDouble;
+    std::vector< Templated::ScalarTransform<> > parent_X_linksDouble;
+    ASSERT_IS_TRUE(Templated::ComputeJointTransforms(compiledModel,Templated::VecX<double>(toEigen(pos.jointPos())),parent_X_linksDouble));
+    ASSERT_IS_TRUE(Templated::ForwardPositionKinematics(compiledModel,parent_X_linksDouble,
+                                                       Templated::ScalarTransform<>(pos.worldBasePos()),linkPosDouble));
+
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(nrOfLinks); lnk++)
+    {
+        Templated::ScalarTransform<> mixed_X_world(Templated::Mat3<double>::Identity(),-linkPosDouble[lnk].position);
+        Templated::Mat6X<double> jac;
+        ASSERT_IS_TRUE(Templated::FreeFloatingJacobianUsingLinkPos(compiledModel,linkPosDouble,lnk,mixed_X_world,
+                                                                  Templated::ScalarTransform<>::Identity(),jac));
+
+        if( nrOfDOFs == 0 )
+        {
+            continue;
+        }
+
+        for(int i=0; i < 3; i++)
+        {
+            ASSERT_EQUAL_DOUBLE_TOL((linkPos[lnk].position(i).derivatives().head(nrOfDOFs).transpose()
+                                     -jac.block(i,6,1,nrOfDOFs)).cwiseAbs().maxCoeff(),0.0,1e-9);
+        }
+
+        // A dual number gives the directional derivative in a single pass
+        Templated::VecX<DualScalar> jointPosDual(nrOfDOFs);
+        Eigen::VectorXd direction = toEigen(vel.jointVel());
+        for(size_t i=0; i < nrOfDOFs; i++)
+        {
+            jointPosDual(i) = DualScalar(pos.jointPos()(i),Eigen::Matrix<double,1,1>(direction(i)));
+        }
+        std::vector< Templated::ScalarTransform<DualScalar> > parent_X_linksDual, linkPosDual;
+        ASSERT_IS_TRUE(Templated::ComputeJointTransforms(compiledModel,jointPosDual,parent_X_linksDual));
+        ASSERT_IS_TRUE(Templated::ForwardPositionKinematics(compiledModel,parent_X_linksDual,
+                                                           Templated::ScalarTransform<DualScalar>(pos.worldBasePos()),linkPosDual));
+        Eigen::Vector3d linVel = jac.block(0,6,3,nrOfDOFs)*direction;
+        for(int i=0; i < 3; i++)
+        {
+            ASSERT_EQUAL_DOUBLE_TOL(linkPosDual[lnk].position(i).derivatives()(0),linVel(i),1e-9);
+        }
+    }
+
+    // The derivatives of the inverse dynamics with respect to the
+    // base and joint accelerations are the columns of the mass matrix
+    std::vector< Templated::ScalarTransform<ADScalar> > parent_X_linksConst;
+    ASSERT_IS_TRUE(Templated::ComputeJointTransforms(compiledModel,
+                                                    Templated::VecX<ADScalar>(toEigen(pos.jointPos()).cast<ADScalar>()),
+                                                    parent_X_linksConst));
+
+    Templated::Vec6<ADScalar> baseVel, baseAcc;
+    Templated::VecX<ADScalar> jointVel(nrOfDOFs), jointAcc(nrOfDOFs);
+    for(int i=0; i < 6; i++)
+    {
+        baseVel(i) = ADScalar(toEigen(vel.baseVel())(i));
+        baseAcc(i) = ADScalar(toEigen(acc.baseAcc())(i),MaxDerivatives,i);
+    }
+    for(size_t i=0; i < nrOfDOFs; i++)
+    {
+        jointVel(i) = ADScalar(vel.jointVel()(i));
+        jointAcc(i) = ADScalar(acc.jointAcc()(i),MaxDerivatives,6+i);
+    }
+
+    Templated::Mat6X<ADScalar> linkVel, linkAcc, intWrenches;
+    Templated::Mat6X<ADScalar> extWrenchesAD = Templated::Mat6X<ADScalar>::Zero(6,nrOfLinks);
+    Templated::VecX<ADScalar> genTrqs;
+    ASSERT_IS_TRUE(Templated::ForwardVelAccKinematics(compiledModel,parent_X_linksConst,baseVel,jointVel,baseAcc,jointAcc,linkVel,linkAcc));
+    ASSERT_IS_TRUE(Templated::RNEADynamicPhase(compiledModel,parent_X_linksConst,linkVel,linkAcc,extWrenchesAD,intWrenches,genTrqs));
+
+    std::vector< Templated::ScalarSpatialInertia<> > crbs;
+    Templated::MatX<double> massMatrix;
+    ASSERT_IS_TRUE(Templated::CompositeRigidBodyAlgorithm(compiledModel,parent_X_linksDouble,crbs,massMatrix));
+
+    for(size_t row=0; row < 6+nrOfDOFs; row++)
+    {
+        ASSERT_EQUAL_DOUBLE_TOL((genTrqs(row).derivatives().head(6+nrOfDOFs).transpose()-massMatrix.row(row)).cwiseAbs().maxCoeff(),0.0,1e-8);
+    }
+}
+
+void checkTemplatedAlgorithms(const Model & model)
+{
+    Traversal traversal;
+    model.computeFullTreeTraversal(traversal,getRandomLinkIndexOfModel(model));
+
+    CompiledModel compiledModel;
+    ASSERT_IS_TRUE(compiledModel.compile(model,traversal));
+
+    checkDoubleInstantiation(model,compiledModel);
+    checkAutoDiffInstantiation(model,compiledModel);
+}
+
+int main()
+{
+    for(unsigned int i=2; i <= 47; i += 15)
+    {
+        Model randomModel = getRandomModel(i);
+        checkTemplatedAlgorithms(randomModel);
+
+        addRandomPrismaticLinkToModel(randomModel,getRandomLinkOfModel(randomModel),"prismaticLink");
+        checkTemplatedAlgorithms(randomModel);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,342 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ *
+ * Licensed under either the GNU Lesser General Public License v3.0 :
+ * https://www.gnu.org/licenses/lgpl-3.0.html
+ * or the GNU Lesser General Public License v2.1 :
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ * at your option.
+ */
+
+#include "testModels.h"
+
+#include <iDynTree/Core/Transform.h>
+#include <iDynTree/Core/SpatialInertia.h>
+#include <iDynTree/Core/ArticulatedBodyInertia.h>
+#include <iDynTree/Core/SpatialAcc.h>
+#include <iDynTree/Core/Twist.h>
+#include <iDynTree/Core/Wrench.h>
+#include <iDynTree/Core/TestUtils.h>
+#include <iDynTree/Core/EigenHelpers.h>
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <ctime>
+#include <limits>
+#include <iostream>
+#include <vector>
+
+using namespace iDynTree;
+
+/**
+ * Return the current time in seconds, with respect
+ * to an arbitrary point in time.
+ */
+inline double clockInSec()
+{
+    clock_t ret = clock();
+    return ((double)ret)/((double)CLOCKS_PER_SEC);
+}
+
+// The baseline implementations are not inlined in the benchmark loops,
+// as the iDynTree operations are compiled in the idyntree-core library
+#if defined(_MSC_VER)
+#define IDYNTREE_BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#define IDYNTREE_BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+typedef Eigen::Matrix<double,3,3,Eigen::RowMajor> Matrix3dRowMajor;
+
+/*
+ * Baseline implementations, i.e. the Eigen implementations of the iDynTree operations
+ * before the introduction of the spatial algebra kernels.
+ */
+
+inline Matrix3dRowMajor baselineSkew(const Eigen::Vector3d & v)
+{
+    Matrix3dRowMajor ret;
+    ret <<     0.0, -v(2),  v(1),
+              v(2),   0.0, -v(0),
+             -v(1),  v(0),   0.0;
+    return ret;
+}
+
+/**
+ * Spatial inertia, stored as it was stored before the introduction of the kernels.
+ */
+struct BaselineInertia
+{
+    double mass;
+    Eigen::Vector3d mcom;
+    Matrix3dRowMajor rotInertia;
+
+    BaselineInertia() {}
+
+    BaselineInertia(const SpatialInertia & I)
+    {
+        mass = I.getMass();
+        mcom = mass*toEigen(I.getCenterOfMass());
+        rotInertia = toEigen(I.getRotationalInertiaWrtFrameOrigin());
+    }
+};
+
+/**
+ * Articulated body inertia, stored as it was stored before the introduction of the kernels.
+ */
+struct BaselineArticulatedBodyInertia
+{
+    Matrix3dRowMajor linearLinear;
+    Matrix3dRowMajor linearAngular;
+    Matrix3dRowMajor angularAngular;
+
+    BaselineArticulatedBodyInertia() {}
+
+    BaselineArticulatedBodyInertia(const ArticulatedBodyInertia & I)
+    {
+        linearLinear = toEigen(I.getLinearLinearSubmatrix());
+        linearAngular = toEigen(I.getLinearAngularSubmatrix());
+        angularAngular = toEigen(I.getAngularAngularSubmatrix());
+    }
+};
+
+IDYNTREE_BENCHMARK_NOINLINE Twist baselineTransformTwist(const Transform & trans, const Twist & in)
+{
+    Twist out;
+    Eigen::Map<const Matrix3dRowMajor> R(trans.getRotation().data());
+    Eigen::Map<const Eigen::Vector3d> p(trans.getPosition().data());
+
+    toEigen(out.getAngularVec3()) = R*toEigen(in.getAngularVec3());
+    toEigen(out.getLinearVec3())  = R*toEigen(in.getLinearVec3()) + p.cross(toEigen(out.getAngularVec3()));
+    return out;
+}
+
+IDYNTREE_BENCHMARK_NOINLINE Wrench baselineTransformWrench(const Transform & trans, const Wrench & in)
+{
+    Wrench out;
+    Eigen::Map<const Matrix3dRowMajor> R(trans.getRotation().data());
+    Eigen::Map<const Eigen::Vector3d> p(trans.getPosition().data());
+
+    toEigen(out.getLinearVec3())  = R*toEigen(in.getLinearVec3());
+    toEigen(out.getAngularVec3()) = R*toEigen(in.getAngularVec3()) + p.cross(toEigen(out.getLinearVec3()));
+    return out;
+}
+
+IDYNTREE_BENCHMARK_NOINLINE Transform baselineInverse(const Transform & trans)
+{
+    Transform result;
+    result.setRotation(trans.getRotation().inverse());
+    result.setPosition(-(result.getRotation()*trans.getPosition()));
+    return result;
+}
+
+IDYNTREE_BENCHMARK_NOINLINE Twist baselineMotionCross(const Twist & v, const Twist & u)
+{
+    Twist res;
+    toEigen(res.getLinearVec3())  = toEigen(v.getAngularVec3()).cross(toEigen(u.getLinearVec3()))
+                                  + toEigen(v.getLinearVec3()).cross(toEigen(u.getAngularVec3()));
+    toEigen(res.getAngularVec3()) = toEigen(v.getAngularVec3()).cross(toEigen(u.getAngularVec3()));
+    return res;
+}
+
+IDYNTREE_BENCHMARK_NOINLINE Wrench baselineForceCross(const Twist & v, const Wrench & f)
+{
+    Wrench res;
+    toEigen(res.getLinearVec3())  = toEigen(v.getAngularVec3()).cross(toEigen(f.getLinearVec3()));
+    toEigen(res.getAngularVec3()) = toEigen(v.getLinearVec3()).cross(toEigen(f.getLinearVec3()))
+                                  + toEigen(v.getAngularVec3()).cross(toEigen(f.getAngularVec3()));
+    return res;
+}
+
+IDYNTREE_BENCHMARK_NOINLINE Wrench baselineInertiaTimesMotion(const BaselineInertia & I, const SpatialMotionVector & v)
+{
+    Wrench ret;
+    Eigen::Map<const Eigen::Vector3d> linearMotion(v.getLinearVec3().data());
+    Eigen::Map<const Eigen::Vector3d> angularMotion(v.getAngularVec3().data());
+
+    toEigen(ret.getLinearVec3())  = I.mass*linearMotion - I.mcom.cross(angularMotion);
+    toEigen(ret.getAngularVec3()) = I.mcom.cross(linearMotion) + I.rotInertia*angularMotion;
+    return ret;
+}
+
+IDYNTREE_BENCHMARK_NOINLINE Wrench baselineBiasWrench(const BaselineInertia & I, const Twist & V)
+{
+    Wrench ret;
+    Eigen::Map<const Eigen::Vector3d> linearVel(V.getLinearVec3().data());
+    Eigen::Map<const Eigen::Vector3d> angularVel(V.getAngularVec3().data());
+
+    toEigen(ret.getLinearVec3())  = I.mass*(angularVel.cross(linearVel)) - angularVel.cross(I.mcom.cross(angularVel));
+    toEigen(ret.getAngularVec3()) = I.mcom.cross(angularVel.cross(linearVel)) + angularVel.cross(I.rotInertia*angularVel);
+    return ret;
+}
+
+IDYNTREE_BENCHMARK_NOINLINE BaselineInertia baselineTransformInertia(const Transform & trans, const BaselineInertia & I)
+{
+    Eigen::Map<const Matrix3dRowMajor> R(trans.getRotation().data());
+    Eigen::Map<const Eigen::Vector3d> p(trans.getPosition().data());
+
+    // The baseline used the center of mass and the parallel axis theorem
+    Eigen::Vector3d com = I.mcom/I.mass;
+    Matrix3dRowMajor skewCom = baselineSkew(com);
+    Matrix3dRowMajor rotInertiaWrtCom = I.rotInertia + I.mass*skewCom*skewCom;
+
+    Eigen::Vector3d newCom = R*com + p;
+    Matrix3dRowMajor skewNewCom = baselineSkew(newCom);
+
+    BaselineInertia ret;
+    ret.mass = I.mass;
+    ret.mcom = I.mass*newCom;
+    ret.rotInertia = R*rotInertiaWrtCom*R.transpose() - I.mass*skewNewCom*skewNewCom;
+    return ret;
+}
+
+IDYNTREE_BENCHMARK_NOINLINE BaselineArticulatedBodyInertia baselineTransformABI(const Transform & trans,
+                                                                               const BaselineArticulatedBodyInertia & I)
+{
+    Eigen::Map<const Matrix3dRowMajor> R(trans.getRotation().data());
+    Eigen::Map<const Eigen::Vector3d> p(trans.getPosition().data());
+
+    BaselineArticulatedBodyInertia ret;
+    ret.linearLinear = R*I.linearLinear*R.transpose();
+
+    Matrix3dRowMajor skewP = baselineSkew(p);
+    Matrix3dRowMajor rotatedLinearAngular = R*I.linearAngular*R.transpose();
+
+    ret.linearAngular = rotatedLinearAngular - ret.linearLinear*skewP;
+
+    Matrix3dRowMajor skewPtimesrotatedLinearAngular = skewP*rotatedLinearAngular;
+
+    ret.angularAngular =   R*I.angularAngular*R.transpose()
+                         + skewPtimesrotatedLinearAngular
+                         + skewPtimesrotatedLinearAngular.transpose()
+                         - skewP*ret.linearLinear*skewP;
+    return ret;
+}
+
+/**
+ * Average time in seconds of operation(i), for i in [0,nrOfSamples), over nrOfTrials repetitions.
+ * The measurement is repeated nrOfRepetitions times and the minimum is returned, to reduce the noise.
+ * operation returns a value that is accumulated in checksum, to avoid that the compiler
+ * optimizes away the computations.
+ */
+template<typename Operation>
+double averageTime(Operation operation, unsigned int nrOfSamples, unsigned int nrOfTrials, double & checksum)
+{
+    const unsigned int nrOfRepetitions = 5;
+    double minTime = std::numeric_limits<double>::max();
+    for (unsigned int repetition = 0; repetition < nrOfRepetitions; repetition++)
+    {
+        double tic = clockInSec();
+        for (unsigned int trial = 0; trial < nrOfTrials; trial++)
+        {
+            for (unsigned int i = 0; i < nrOfSamples; i++)
+            {
+                checksum += operation(i);
+            }
+        }
+        double toc = clockInSec();
+        minTime = std::min(minTime,toc-tic);
+    }
+    return minTime/(nrOfSamples*nrOfTrials);
+}
+
+void printResult(const std::string & name, double iDynTreeTime, double baselineTime)
+{
+    std::cout << name << " : " << std::endl;
+    std::cout << "\tiDynTree average time " << iDynTreeTime*1e9 << " nanoseconds" << std::endl;
+    std::cout << "\tbaseline average time " << baselineTime*1e9 << " nanoseconds" << std::endl;
+    std::cout << "\tiDynTree/baseline ratio " << iDynTreeTime/baselineTime << std::endl;
+}
+
+void spatialAlgebraBenchmark(unsigned int nrOfTrials)
+{
+    const unsigned int nrOfSamples = 1000;
+    std::vector<Transform> transforms(nrOfSamples);
+    std::vector<SpatialInertia> inertias(nrOfSamples);
+    std::vector<BaselineInertia> baselineInertias(nrOfSamples);
+    std::vector<ArticulatedBodyInertia> abis(nrOfSamples);
+    std::vector<BaselineArticulatedBodyInertia> baselineABIs(nrOfSamples);
+    std::vector<Twist> twists(nrOfSamples);
+    std::vector<Twist> otherTwists(nrOfSamples);
+    std::vector<SpatialAcc> accs(nrOfSamples);
+    std::vector<Wrench> wrenches(nrOfSamples);
+
+    for (unsigned int i = 0; i < nrOfSamples; i++)
+    {
+        transforms[i] = getRandomTransform();
+        inertias[i] = getRandomInertia();
+        baselineInertias[i] = BaselineInertia(inertias[i]);
+        abis[i] = ArticulatedBodyInertia(getRandomInertia());
+        baselineABIs[i] = BaselineArticulatedBodyInertia(abis[i]);
+        twists[i] = getRandomTwist();
+        otherTwists[i] = getRandomTwist();
+        accs[i] = getRandomTwist();
+        wrenches[i] = getRandomWrench();
+    }
+
+    double checksum = 0.0;
+    double iDynTreeTime, baselineTime;
+
+    iDynTreeTime = averageTime([&](unsigned int i) { return (transforms[i]*twists[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    baselineTime = averageTime([&](unsigned int i) { return baselineTransformTwist(transforms[i],twists[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    printResult("Transform*Twist",iDynTreeTime,baselineTime);
+
+    iDynTreeTime = averageTime([&](unsigned int i) { return (transforms[i]*wrenches[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    baselineTime = averageTime([&](unsigned int i) { return baselineTransformWrench(transforms[i],wrenches[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    printResult("Transform*Wrench",iDynTreeTime,baselineTime);
+
+    // The baseline of applyInverse is the transformation by the inverse transform
+    iDynTreeTime = averageTime([&](unsigned int i) { return transforms[i].applyInverse(twists[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    baselineTime = averageTime([&](unsigned int i) { return baselineTransformTwist(baselineInverse(transforms[i]),twists[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    printResult("Transform::applyInverse(Twist)",iDynTreeTime,baselineTime);
+
+    iDynTreeTime = averageTime([&](unsigned int i) { return transforms[i].applyInverse(wrenches[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    baselineTime = averageTime([&](unsigned int i) { return baselineTransformWrench(baselineInverse(transforms[i]),wrenches[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    printResult("Transform::applyInverse(Wrench)",iDynTreeTime,baselineTime);
+
+    iDynTreeTime = averageTime([&](unsigned int i) { return twists[i].cross(otherTwists[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    baselineTime = averageTime([&](unsigned int i) { return baselineMotionCross(twists[i],otherTwists[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    printResult("Twist x Twist",iDynTreeTime,baselineTime);
+
+    iDynTreeTime = averageTime([&](unsigned int i) { return twists[i].cross(wrenches[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    baselineTime = averageTime([&](unsigned int i) { return baselineForceCross(twists[i],wrenches[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    printResult("Twist x* Wrench",iDynTreeTime,baselineTime);
+
+    iDynTreeTime = averageTime([&](unsigned int i) { return (inertias[i]*twists[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    baselineTime = averageTime([&](unsigned int i) { return baselineInertiaTimesMotion(baselineInertias[i],twists[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    printResult("SpatialInertia*Twist",iDynTreeTime,baselineTime);
+
+    iDynTreeTime = averageTime([&](unsigned int i) { return inertias[i].biasWrench(twists[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    baselineTime = averageTime([&](unsigned int i) { return baselineBiasWrench(baselineInertias[i],twists[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    printResult("SpatialInertia::biasWrench",iDynTreeTime,baselineTime);
+
+    // The baseline of netWrench is I*a + v x* (I*v), as computed by the RNEA before the introduction of netWrench
+    iDynTreeTime = averageTime([&](unsigned int i) { return inertias[i].netWrench(accs[i],twists[i])(0); }, nrOfSamples, nrOfTrials, checksum);
+    baselineTime = averageTime([&](unsigned int i)
+                               {
+                                   Wrench Ia = baselineInertiaTimesMotion(baselineInertias[i],accs[i]);
+                                   Wrench crossTerm = baselineForceCross(twists[i],baselineInertiaTimesMotion(baselineInertias[i],twists[i]));
+                                   return Ia(0) + crossTerm(0);
+                               }, nrOfSamples, nrOfTrials, checksum);
+    printResult("SpatialInertia::netWrench",iDynTreeTime,baselineTime);
+
+    iDynTreeTime = averageTime([&](unsigned int i) { return (transforms[i]*inertias[i]).getMass(); }, nrOfSamples, nrOfTrials, checksum);
+    baselineTime = averageTime([&](unsigned int i) { return baselineTransformInertia(transforms[i],baselineInertias[i]).mass; }, nrOfSamples, nrOfTrials, checksum);
+    printResult("Transform*SpatialInertia",iDynTreeTime,baselineTime);
+
+    iDynTreeTime = averageTime([&](unsigned int i) { return (transforms[i]*abis[i]).getLinearLinearSubmatrix()(0,0); }, nrOfSamples, nrOfTrials, checksum);
+    baselineTime = averageTime([&](unsigned int i) { return baselineTransformABI(transforms[i],baselineABIs[i]).linearLinear(0,0); }, nrOfSamples, nrOfTrials, checksum);
+    printResult("Transform*ArticulatedBodyInertia",iDynTreeTime,baselineTime);
+
+    // Print the checksum to avoid that the compiler optimizes away the loops
+    std::cout << "Checksum " << checksum << std::endl;
+}
+
+int main()
+{
+    std::cout << "Spatial algebra benchmark, iDynTree built in " << IDYNTREE_CMAKE_BUILD_TYPE << " mode " << std::endl;
+    spatialAlgebraBenchmark(200);
+
+    return EXIT_SUCCESS;
+}
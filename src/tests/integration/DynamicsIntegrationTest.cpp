@@ -10,6 +10,7 @@
 
 
 #include <iDynTree/Core/TestUtils.h>
+#include <iDynTree/Core/EigenHelpers.h>
 
 #include <iDynTree/Model/Model.h>
 #include <iDynTree/Model/Traversal.h>
@@ -26,6 +27,7 @@
 
 #include "testModels.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
@@ -109,6 +111,26 @@ void checkInverseAndForwardDynamicsAreIdempotent(const Model & model,
                         zeroVec,1e-6);
     std::cout << "Check joint torques" << std::endl;
     ASSERT_EQUAL_VECTOR_TOL(RNEA_baseForceAndJointTorques.jointTorques(),ABA_jntTorques,1e-07);
+
+    // Check the variant of ABA that uses the link positions
+    LinkPositions linkPositions(model);
+    ForwardPositionKinematics(model,traversal,robotPos,linkPositions);
+
+    FreeFloatingAcc ABA_robotAccFromLinkPos(model);
+    ArticulatedBodyAlgorithm(model,
+                             traversal,
+                             linkPositions,
+                             robotVel,
+                             linkExtWrenches,
+                             ABA_jntTorques,
+                             ABAbufs,
+                             ABA_robotAccFromLinkPos);
+
+    // The accelerations of models with light links can be large, so the tolerance is relative
+    std::cout << "Check ABA from link positions" << std::endl;
+    double tol = 1e-10*std::max(1.0,toEigen(ABA_robotAcc.baseAcc().asVector()).norm()+toEigen(ABA_robotAcc.jointAcc()).norm());
+    ASSERT_EQUAL_VECTOR_TOL(ABA_robotAccFromLinkPos.baseAcc().asVector(),ABA_robotAcc.baseAcc().asVector(),tol);
+    ASSERT_EQUAL_VECTOR_TOL(ABA_robotAccFromLinkPos.jointAcc(),ABA_robotAcc.jointAcc(),tol);
 }
 
 int main()